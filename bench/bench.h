@@ -0,0 +1,93 @@
+#ifndef _OCTOPUS_BENCH_BENCH_H_
+#define _OCTOPUS_BENCH_BENCH_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <inttypes.h>
+#include <time.h>
+#include <pthread.h>
+
+/**
+ * @brief Retrieve the monotonic time in seconds.
+ */
+static inline double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Parse the command line argument at the given position.
+ * @param [in] argc argument count.
+ * @param [in] argv argument vector.
+ * @param [in] at position of the argument.
+ * @param [in] otherwise value to use if the argument is absent.
+ * @return parsed value.
+ */
+static inline uintmax_t bench_argument(const int argc,
+                                       char *const argv[],
+                                       const int at,
+                                       const uintmax_t otherwise) {
+    return argc > at ? strtoumax(argv[at], NULL, 10) : otherwise;
+}
+
+struct bench_thread {
+    void (*func)(void *, uintmax_t);
+    void *arg;
+    uintmax_t index;
+    atomic_bool *start;
+};
+
+static inline void *bench_thread(void *const arg) {
+    struct bench_thread *const thread = arg;
+    while (!atomic_load_explicit(thread->start, memory_order_acquire)) {
+        /* wait for the other threads to be created */
+    }
+    thread->func(thread->arg, thread->index);
+    return NULL;
+}
+
+/**
+ * @brief Run func on the given number of threads and time them.
+ * <p>The threads are released together once they have all been created and
+ * the elapsed time is measured until the last one has finished.</p>
+ * @param [in] threads number of threads to run.
+ * @param [in] func executed by each thread, receives its index.
+ * @param [in] arg passed through to func.
+ * @return elapsed time in seconds.
+ */
+static inline double bench_run(const uintmax_t threads,
+                               void (*const func)(void *, uintmax_t),
+                               void *const arg) {
+    pthread_t *const ids = calloc(threads, sizeof(pthread_t));
+    struct bench_thread *const items = calloc(threads,
+                                              sizeof(struct bench_thread));
+    if (!ids || !items) {
+        abort();
+    }
+    atomic_bool start = false;
+    for (uintmax_t i = 0; i < threads; i++) {
+        items[i] = (struct bench_thread) {
+                .func = func,
+                .arg = arg,
+                .index = i,
+                .start = &start
+        };
+        if (pthread_create(&ids[i], NULL, bench_thread, &items[i])) {
+            abort();
+        }
+    }
+    const double begin = bench_now();
+    atomic_store_explicit(&start, true, memory_order_release);
+    for (uintmax_t i = 0; i < threads; i++) {
+        pthread_join(ids[i], NULL);
+    }
+    const double seconds = bench_now() - begin;
+    free(items);
+    free(ids);
+    return seconds;
+}
+
+#endif /* _OCTOPUS_BENCH_BENCH_H_ */
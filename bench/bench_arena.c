@@ -0,0 +1,95 @@
+#include <octopus.h>
+
+#include "bench.h"
+
+struct context {
+    struct octopus_concurrent_linked_queue queue;
+    uintmax_t depth;
+    uintmax_t rounds;
+};
+
+static void deep(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    for (uintmax_t round = 0; round < context->rounds; round++) {
+        for (uintmax_t i = 0; i < context->depth; i++) {
+            if (!octopus_concurrent_linked_queue_add(&context->queue, &i)) {
+                abort();
+            }
+        }
+        for (uintmax_t i = 0; i < context->depth; i++) {
+            uintmax_t out;
+            if (!octopus_concurrent_linked_queue_remove(&context->queue,
+                                                        (void **) &out)) {
+                abort();
+            }
+        }
+    }
+}
+
+static bool report(const char *const mode,
+                   struct context *const context,
+                   const uintmax_t concurrency,
+                   const struct octopus_allocator *const allocator) {
+    if (!octopus_concurrent_linked_queue_init_with_allocator(
+            &context->queue, sizeof(uintmax_t), concurrency, 0, allocator)) {
+        return false;
+    }
+    const double seconds = bench_run(1, deep, context);
+    const double operations = 2.0 * (double) context->depth
+                              * (double) context->rounds;
+    printf("%s,%ju,%ju,%.0f,%.6f,%.2f\n", mode, concurrency, context->depth,
+           operations, seconds, 1e9 * seconds / operations);
+    return octopus_concurrent_linked_queue_invalidate(&context->queue, NULL);
+}
+
+/*
+ * usage: bench_arena [depth] [rounds] [concurrency]
+ *
+ * Fills a concurrent linked queue to the given depth and then drains it
+ * again, with its memory coming from the C library and then from an arena
+ * backed by default, transparent huge and reserved huge pages. The first
+ * round allocates the nodes while the later ones walk through them again,
+ * which is where huge pages save TLB misses. Modes that cannot be set up on
+ * this machine are skipped. The results are printed as comma separated
+ * values.
+ */
+int main(int argc, char *argv[]) {
+    struct context context = {
+            .depth = bench_argument(argc, argv, 1, 4000000),
+            .rounds = bench_argument(argc, argv, 2, 4)
+    };
+    const uintmax_t concurrency = bench_argument(argc, argv, 3, 4);
+    if (!context.depth || !context.rounds || !concurrency) {
+        fprintf(stderr, "usage: %s [depth] [rounds] [concurrency]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+    printf("mode,concurrency,depth,operations,seconds,ns_per_operation\n");
+    if (!report("malloc", &context, concurrency, NULL)) {
+        return EXIT_FAILURE;
+    }
+    const struct {
+        const char *mode;
+        int pages;
+    } modes[] = {
+            {"arena", OCTOPUS_ARENA_PAGES_DEFAULT},
+            {"arena_thp", OCTOPUS_ARENA_PAGES_TRANSPARENT_HUGE},
+            {"arena_hugetlb", OCTOPUS_ARENA_PAGES_HUGE}
+    };
+    for (uintmax_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+        struct octopus_arena arena;
+        if (!octopus_arena_init(&arena, OCTOPUS_ARENA_HUGE_PAGE_SIZE * 16,
+                                modes[i].pages)) {
+            fprintf(stderr, "%s: skipped, error %ju\n", modes[i].mode,
+                    octopus_error);
+            continue;
+        }
+        struct octopus_allocator allocator;
+        if (!octopus_arena_allocator(&arena, &allocator)
+            || !report(modes[i].mode, &context, concurrency, &allocator)) {
+            return EXIT_FAILURE;
+        }
+        octopus_arena_invalidate(&arena);
+    }
+    return EXIT_SUCCESS;
+}
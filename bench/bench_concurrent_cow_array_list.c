@@ -0,0 +1,128 @@
+#include <octopus.h>
+
+#include "bench.h"
+
+#define LISTENERS 16
+
+struct context {
+    pthread_mutex_t lock;
+    struct coral_array_list locked;
+    struct octopus_concurrent_cow_array_list cow;
+    uintmax_t operations;
+    uintmax_t interval;
+    atomic_uintmax_t sink;
+};
+
+/* the first thread replaces a listener every interval iterations */
+static bool is_writer(const struct context *const context,
+                      const uintmax_t index,
+                      const uintmax_t i) {
+    return !index && context->interval && !(i % context->interval);
+}
+
+static void locked(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    uintmax_t sum = 0;
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        if (pthread_mutex_lock(&context->lock)) {
+            abort();
+        }
+        if (is_writer(context, index, i)
+            && !coral_array_list_set(&context->locked, 0, &i)) {
+            abort();
+        }
+        for (uintmax_t o = 0; o < LISTENERS; o++) {
+            uintmax_t *item;
+            if (!coral_array_list_get(&context->locked, o, (void **) &item)) {
+                abort();
+            }
+            sum += *item;
+        }
+        if (pthread_mutex_unlock(&context->lock)) {
+            abort();
+        }
+    }
+    atomic_fetch_add_explicit(&context->sink, sum, memory_order_relaxed);
+}
+
+static void cow(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    uintmax_t sum = 0;
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        if (is_writer(context, index, i)
+            && !octopus_concurrent_cow_array_list_set(&context->cow, 0, &i)) {
+            abort();
+        }
+        const struct octopus_concurrent_cow_array_list_snapshot *snapshot;
+        if (!octopus_concurrent_cow_array_list_acquire(&context->cow,
+                                                       &snapshot)) {
+            abort();
+        }
+        for (uintmax_t o = 0; o < LISTENERS; o++) {
+            const uintmax_t *item;
+            if (!octopus_concurrent_cow_array_list_snapshot_get(
+                    snapshot, o, (const void **) &item)) {
+                abort();
+            }
+            sum += *item;
+        }
+        if (!octopus_concurrent_cow_array_list_release(snapshot)) {
+            abort();
+        }
+    }
+    atomic_fetch_add_explicit(&context->sink, sum, memory_order_relaxed);
+}
+
+static void report(const char *const mode,
+                   const struct context *const context,
+                   const uintmax_t threads,
+                   const double seconds) {
+    const double operations = (double) threads
+                              * (double) context->operations;
+    printf("%s,%ju,%ju,%.0f,%.6f,%.2f\n", mode, threads, context->interval,
+           operations, seconds, 1e9 * seconds / operations);
+}
+
+/*
+ * usage: bench_concurrent_cow_array_list [max threads] [interval]
+ *                                        [operations]
+ *
+ * For one thread up to the given number of threads, each thread repeatedly
+ * iterates a list of listeners, first held in an array list behind a mutex
+ * and then in a concurrent copy-on-write array list. The first thread also
+ * replaces a listener every interval iterations, zero for never. The results
+ * are printed as comma separated values.
+ */
+int main(int argc, char *argv[]) {
+    const uintmax_t threads = bench_argument(argc, argv, 1, 8);
+    struct context context = {
+            .interval = bench_argument(argc, argv, 2, 1000),
+            .operations = bench_argument(argc, argv, 3, 1000000)
+    };
+    if (!threads
+        || pthread_mutex_init(&context.lock, NULL)
+        || !coral_array_list_init(&context.locked, sizeof(uintmax_t),
+                                  LISTENERS)
+        || !coral_array_list_set_length(&context.locked, LISTENERS)
+        || !octopus_concurrent_cow_array_list_init(&context.cow,
+                                                   sizeof(uintmax_t))) {
+        fprintf(stderr, "usage: %s [max threads] [interval] [operations]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+    for (uintmax_t i = 0; i < LISTENERS; i++) {
+        if (!coral_array_list_set(&context.locked, i, &i)
+            || !octopus_concurrent_cow_array_list_add(&context.cow, &i)) {
+            return EXIT_FAILURE;
+        }
+    }
+    printf("mode,threads,interval,operations,seconds,ns_per_operation\n");
+    for (uintmax_t i = 1; i <= threads; i++) {
+        report("mutex", &context, i, bench_run(i, locked, &context));
+        report("cow", &context, i, bench_run(i, cow, &context));
+    }
+    octopus_concurrent_cow_array_list_invalidate(&context.cow, NULL);
+    coral_array_list_invalidate(&context.locked, NULL);
+    pthread_mutex_destroy(&context.lock);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,91 @@
+#include <octopus.h>
+
+#include "bench.h"
+
+#define TICK                                    UINT64_C(1000000)
+
+struct context {
+    struct octopus_concurrent_delay_queue queue;
+    uintmax_t operations;
+};
+
+static void schedule_cancel(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    uint64_t seed = 0x9e3779b97f4a7c15u * (index + 1);
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        /* anywhere from 1 tick up to roughly 4 hours away */
+        const uint64_t delay = (1 + seed % (UINT64_C(1) << 24)) * TICK;
+        struct octopus_concurrent_delay_queue_timer timer;
+        uintmax_t out;
+        if (!octopus_concurrent_delay_queue_schedule(
+                &context->queue, &i, delay, &timer)
+            || !octopus_concurrent_delay_queue_cancel(
+                    &context->queue, &timer, (void **) &out)) {
+            abort();
+        }
+    }
+}
+
+static void schedule_take(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        if (!octopus_concurrent_delay_queue_schedule(
+                &context->queue, &i, 0, NULL)) {
+            abort();
+        }
+        uintmax_t out;
+        while (!octopus_concurrent_delay_queue_take(
+                &context->queue, (void **) &out)) {
+            /* another thread took our item, retry until one is found */
+        }
+    }
+}
+
+/*
+ * usage: bench_concurrent_delay_queue [threads] [concurrency] [operations]
+ *
+ * For a growing number of pending far future items each thread repeatedly
+ * schedules and cancels an item, and schedules an item that is due at once
+ * and takes one. The results are printed as comma separated values.
+ */
+int main(int argc, char *argv[]) {
+    const uintmax_t threads = bench_argument(argc, argv, 1, 4);
+    const uintmax_t concurrency = bench_argument(argc, argv, 2, 8);
+    struct context context = {
+            .operations = bench_argument(argc, argv, 3, 1000000)
+    };
+    if (!threads
+        || !octopus_concurrent_delay_queue_init(
+                &context.queue, sizeof(uintmax_t), concurrency, TICK)) {
+        fprintf(stderr, "usage: %s [threads] [concurrency] [operations]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+    printf("mode,threads,concurrency,pending,operations,seconds,"
+           "ns_per_operation\n");
+    const double operations = (double) threads * (double) context.operations;
+    uintmax_t pending = 0;
+    for (uintmax_t target = 1000; target <= 1000000; target *= 10) {
+        for (; pending < target; pending++) {
+            /* one day away so that none of these become due */
+            if (!octopus_concurrent_delay_queue_schedule(
+                    &context.queue, &pending, UINT64_C(86400000000000),
+                    NULL)) {
+                abort();
+            }
+        }
+        double seconds = bench_run(threads, schedule_cancel, &context);
+        printf("schedule_cancel,%ju,%ju,%ju,%.0f,%.6f,%.2f\n", threads,
+               concurrency, pending, operations, seconds,
+               1e9 * seconds / operations);
+        seconds = bench_run(threads, schedule_take, &context);
+        printf("schedule_take,%ju,%ju,%ju,%.0f,%.6f,%.2f\n", threads,
+               concurrency, pending, operations, seconds,
+               1e9 * seconds / operations);
+    }
+    octopus_concurrent_delay_queue_invalidate(&context.queue, NULL);
+    return EXIT_SUCCESS;
+}
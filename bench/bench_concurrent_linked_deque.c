@@ -0,0 +1,72 @@
+#include <octopus.h>
+
+#include "bench.h"
+
+struct context {
+    struct octopus_concurrent_linked_deque deque;
+    uintmax_t operations;
+};
+
+/* even threads work at the front of the deque and odd ones at the end */
+static void ends(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        uintmax_t out;
+        if (index % 2
+            ? !octopus_concurrent_linked_deque_add_last(&context->deque, &i)
+              || !octopus_concurrent_linked_deque_remove_last(
+                    &context->deque, (void **) &out)
+            : !octopus_concurrent_linked_deque_add_first(&context->deque, &i)
+              || !octopus_concurrent_linked_deque_remove_first(
+                    &context->deque, (void **) &out)) {
+            abort();
+        }
+    }
+}
+
+/*
+ * usage: bench_concurrent_linked_deque [max threads] [concurrency] [items]
+ *                                      [operations]
+ *
+ * For one thread up to the given number of threads, half of the threads add
+ * and remove items at the front of a deque holding the given number of
+ * items and the other half at its end. This is done with a single shard,
+ * where both ends share one lock, and then with the shards for the given
+ * concurrency. The results are printed as comma separated values.
+ */
+int main(int argc, char *argv[]) {
+    const uintmax_t threads = bench_argument(argc, argv, 1, 8);
+    const uintmax_t concurrency = bench_argument(argc, argv, 2, 16);
+    const uintmax_t items = bench_argument(argc, argv, 3, 1024);
+    struct context context = {
+            .operations = bench_argument(argc, argv, 4, 1000000)
+    };
+    if (!threads || !concurrency) {
+        fprintf(stderr, "usage: %s [max threads] [concurrency] [items] "
+                        "[operations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    printf("concurrency,threads,operations,seconds,ns_per_operation\n");
+    const uintmax_t concurrencies[] = {1, concurrency};
+    for (uintmax_t i = 1; i <= threads; i++) {
+        for (uintmax_t o = 0; o < 2; o++) {
+            if (!octopus_concurrent_linked_deque_init(
+                    &context.deque, sizeof(uintmax_t), concurrencies[o])) {
+                return EXIT_FAILURE;
+            }
+            for (uintmax_t p = 0; p < items; p++) {
+                if (!octopus_concurrent_linked_deque_add_last(
+                        &context.deque, &p)) {
+                    return EXIT_FAILURE;
+                }
+            }
+            const double seconds = bench_run(i, ends, &context);
+            const double operations = 2.0 * (double) i
+                                      * (double) context.operations;
+            printf("%ju,%ju,%.0f,%.6f,%.2f\n", concurrencies[o], i,
+                   operations, seconds, 1e9 * seconds / operations);
+            octopus_concurrent_linked_deque_invalidate(&context.deque, NULL);
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,83 @@
+#include <octopus.h>
+
+#include "bench.h"
+
+OCTOPUS_DEFINE_CONCURRENT_QUEUE(bench_queue, uintmax_t)
+
+struct context {
+    struct octopus_concurrent_linked_queue generic;
+    struct bench_queue typed;
+    uintmax_t operations;
+};
+
+static void generic(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        if (!octopus_concurrent_linked_queue_add(&context->generic, &i)) {
+            abort();
+        }
+        uintmax_t out;
+        while (!octopus_concurrent_linked_queue_remove(
+                &context->generic, (void **) &out)) {
+            /* another thread took our item, retry until one is found */
+        }
+    }
+}
+
+static void typed(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        if (!bench_queue_add(&context->typed, i)) {
+            abort();
+        }
+        uintmax_t out;
+        while (!bench_queue_remove(&context->typed, &out)) {
+            /* another thread took our item, retry until one is found */
+        }
+    }
+}
+
+static void report(const char *const mode,
+                   const struct context *const context,
+                   const uintmax_t threads,
+                   const uintmax_t concurrency,
+                   const double seconds) {
+    const double operations = 2.0 * (double) threads
+                              * (double) context->operations;
+    printf("%s,%ju,%ju,%.0f,%.6f,%.2f\n", mode, threads, concurrency,
+           operations, seconds, 1e9 * seconds / operations);
+}
+
+/*
+ * usage: bench_concurrent_linked_queue [threads] [concurrency] [operations]
+ *
+ * Each thread repeatedly adds an item and then removes one, the results are
+ * printed as comma separated values. The probes mode is the generic queue
+ * trying every shard before waiting on a busy one.
+ */
+int main(int argc, char *argv[]) {
+    const uintmax_t threads = bench_argument(argc, argv, 1, 4);
+    const uintmax_t concurrency = bench_argument(argc, argv, 2, 8);
+    struct context context = {
+            .operations = bench_argument(argc, argv, 3, 1000000)
+    };
+    if (!threads
+        || !octopus_concurrent_linked_queue_init(
+                &context.generic, sizeof(uintmax_t), concurrency)
+        || !bench_queue_init(&context.typed, concurrency)) {
+        fprintf(stderr, "usage: %s [threads] [concurrency] [operations]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+    printf("mode,threads,concurrency,operations,seconds,ns_per_operation\n");
+    report("generic", &context, threads, concurrency,
+           bench_run(threads, generic, &context));
+    report("typed", &context, threads, concurrency,
+           bench_run(threads, typed, &context));
+    octopus_concurrent_linked_queue_set_probes(&context.generic, concurrency);
+    report("probes", &context, threads, concurrency,
+           bench_run(threads, generic, &context));
+    octopus_concurrent_linked_queue_invalidate(&context.generic, NULL);
+    bench_queue_invalidate(&context.typed, NULL);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,76 @@
+#include <octopus.h>
+
+#include "bench.h"
+
+enum mode {
+    MUTEX,
+    PROBES,
+    COMBINING
+};
+
+static const char *const modes[] = {"mutex", "probes", "combining"};
+
+struct context {
+    struct octopus_concurrent_linked_queue queue;
+    uintmax_t operations;
+};
+
+static void work(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        if (!octopus_concurrent_linked_queue_add(&context->queue, &i)) {
+            abort();
+        }
+        uintmax_t out;
+        while (!octopus_concurrent_linked_queue_remove(
+                &context->queue, (void **) &out)) {
+            /* another thread took our item, retry until one is found */
+        }
+    }
+}
+
+/*
+ * usage: bench_concurrent_linked_queue_combining [max threads] [concurrency]
+ *                                                [operations]
+ *
+ * For one thread up to the given number of threads, each thread repeatedly
+ * adds an item and then removes one. This is done with threads waiting on
+ * the lock of the selected shard, probing for a shard that is not busy and
+ * combining the operations on each shard. The results are printed as comma
+ * separated values.
+ */
+int main(int argc, char *argv[]) {
+    const uintmax_t threads = bench_argument(argc, argv, 1, 8);
+    const uintmax_t concurrency = bench_argument(argc, argv, 2, 4);
+    struct context context = {
+            .operations = bench_argument(argc, argv, 3, 1000000)
+    };
+    if (!threads || !concurrency) {
+        fprintf(stderr, "usage: %s [max threads] [concurrency] "
+                        "[operations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    printf("mode,threads,concurrency,operations,seconds,ns_per_operation\n");
+    for (uintmax_t i = 1; i <= threads; i <<= 1) {
+        for (enum mode mode = MUTEX; mode <= COMBINING; mode++) {
+            if (!octopus_concurrent_linked_queue_init(
+                    &context.queue, sizeof(uintmax_t), concurrency)
+                || (PROBES == mode
+                    && !octopus_concurrent_linked_queue_set_probes(
+                        &context.queue, concurrency))
+                || (COMBINING == mode
+                    && !octopus_concurrent_linked_queue_attach_combining(
+                        &context.queue))) {
+                return EXIT_FAILURE;
+            }
+            const double seconds = bench_run(i, work, &context);
+            const double operations = 2.0 * (double) i
+                                      * (double) context.operations;
+            printf("%s,%ju,%ju,%.0f,%.6f,%.2f\n", modes[mode], i,
+                   concurrency, operations, seconds,
+                   1e9 * seconds / operations);
+            octopus_concurrent_linked_queue_invalidate(&context.queue, NULL);
+        }
+    }
+    return EXIT_SUCCESS;
+}
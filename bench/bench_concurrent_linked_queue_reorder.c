@@ -0,0 +1,119 @@
+#include <octopus.h>
+
+#include "bench.h"
+
+struct context {
+    struct octopus_concurrent_linked_queue queue;
+    uintmax_t producers;
+    uintmax_t items;
+    uintmax_t *distances;
+    atomic_uintmax_t tickets;
+    atomic_uintmax_t positions;
+};
+
+static void producer(struct context *const context) {
+    const uintmax_t items = context->items / context->producers;
+    for (uintmax_t i = 0; i < items; i++) {
+        const uintmax_t ticket = atomic_fetch_add_explicit(
+                &context->tickets, 1, memory_order_relaxed);
+        if (!octopus_concurrent_linked_queue_add(&context->queue, &ticket)) {
+            abort();
+        }
+    }
+}
+
+static void consumer(struct context *const context) {
+    const uintmax_t items = context->items / context->producers
+                            * context->producers;
+    uintmax_t ticket;
+    for (;;) {
+        if (!octopus_concurrent_linked_queue_remove(&context->queue,
+                                                    (void **) &ticket)) {
+            if (items == atomic_load_explicit(&context->positions,
+                                              memory_order_relaxed)) {
+                return;
+            }
+            continue;
+        }
+        const uintmax_t position = atomic_fetch_add_explicit(
+                &context->positions, 1, memory_order_relaxed);
+        context->distances[position] = position > ticket
+                                       ? position - ticket
+                                       : ticket - position;
+    }
+}
+
+static void mixed(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    if (index < context->producers) {
+        producer(context);
+    } else {
+        consumer(context);
+    }
+}
+
+static int compare(const void *const a, const void *const b) {
+    const uintmax_t x = *(const uintmax_t *) a;
+    const uintmax_t y = *(const uintmax_t *) b;
+    return (x > y) - (x < y);
+}
+
+static void report(struct context *const context,
+                   const uintmax_t threads,
+                   const uintmax_t concurrency,
+                   const double seconds) {
+    const uintmax_t items = atomic_load(&context->positions);
+    qsort(context->distances, items, sizeof(uintmax_t), compare);
+    double sum = 0;
+    for (uintmax_t i = 0; i < items; i++) {
+        sum += (double) context->distances[i];
+    }
+    printf("%ju,%ju,%ju,%.6f,%.2f,%.2f,%ju,%ju\n", threads, concurrency,
+           items, seconds, 1e9 * seconds / (double) items,
+           sum / (double) items, context->distances[99 * (items - 1) / 100],
+           context->distances[items - 1]);
+}
+
+/*
+ * usage: bench_concurrent_linked_queue_reorder [threads] [concurrency]
+ *                                              [items]
+ *
+ * Half of the threads add items tagged with a ticket taken from a shared
+ * counter and the other half remove them, taking a position from another
+ * shared counter as they do so. The reorder distance of an item is how far
+ * its position is from its ticket, zero for a strictly first in first out
+ * queue. Every power of two number of threads from two up to threads is run
+ * against every power of two concurrency up to concurrency, and the mean,
+ * 99th percentile and maximum distance are printed next to the throughput
+ * as comma separated values.
+ */
+int main(int argc, char *argv[]) {
+    const uintmax_t threads = bench_argument(argc, argv, 1, 8);
+    const uintmax_t concurrency = bench_argument(argc, argv, 2, 16);
+    const uintmax_t items = bench_argument(argc, argv, 3, 1000000);
+    uintmax_t *const distances = calloc(items, sizeof(uintmax_t));
+    if (threads < 2 || !concurrency || items < threads || !distances) {
+        fprintf(stderr, "usage: %s [threads] [concurrency] [items]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+    printf("threads,concurrency,items,seconds,ns_per_item,mean_distance,"
+           "p99_distance,max_distance\n");
+    for (uintmax_t t = 2; t <= threads; t <<= 1) {
+        for (uintmax_t c = 1; c <= concurrency; c <<= 1) {
+            struct context context = {
+                    .producers = t / 2,
+                    .items = items,
+                    .distances = distances
+            };
+            if (!octopus_concurrent_linked_queue_init(
+                    &context.queue, sizeof(uintmax_t), c)) {
+                abort();
+            }
+            report(&context, t, c, bench_run(t, mixed, &context));
+            octopus_concurrent_linked_queue_invalidate(&context.queue, NULL);
+        }
+    }
+    free(distances);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,98 @@
+#include <octopus.h>
+
+#include "bench.h"
+
+struct context {
+    struct octopus_concurrent_linked_queue queue;
+    uintmax_t producers;
+    uintmax_t items;
+    bool staged;
+};
+
+/* the first thread consumes what the others produce */
+static void work(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    if (!index) {
+        uintmax_t out;
+        for (uintmax_t i = 0; i < context->producers * context->items; i++) {
+            while (!octopus_concurrent_linked_queue_remove(
+                    &context->queue, (void **) &out)) {
+                /* wait for the producers to catch up */
+            }
+        }
+        return;
+    }
+    for (uintmax_t i = 0; i < context->items; i++) {
+        if (!(context->staged
+              ? octopus_concurrent_linked_queue_stage(&context->queue, &i)
+              : octopus_concurrent_linked_queue_add(&context->queue, &i))) {
+            abort();
+        }
+    }
+    if (context->staged
+        && !octopus_concurrent_linked_queue_flush(&context->queue)) {
+        abort();
+    }
+}
+
+static void run(const uintmax_t producers,
+                const uintmax_t concurrency,
+                const uintmax_t items,
+                const uintmax_t count,
+                const struct timespec *const latency) {
+    struct context context = {
+            .producers = producers,
+            .items = items,
+            .staged = count > 0
+    };
+    if (!octopus_concurrent_linked_queue_init(
+            &context.queue, sizeof(uintmax_t), concurrency)
+        || (count && !octopus_concurrent_linked_queue_attach_staging(
+                &context.queue, count, latency))) {
+        abort();
+    }
+    const double seconds = bench_run(1 + producers, work, &context);
+    const double total = (double) producers * (double) items;
+    printf("%s,%ju,%ju,%ju,%ju,%.0f,%.6f,%.2f\n", count ? "stage" : "add",
+           producers, concurrency, count,
+           latency ? (uintmax_t) latency->tv_sec * 1000000
+                     + (uintmax_t) latency->tv_nsec / 1000 : 0,
+           total, seconds, 1e9 * seconds / total);
+    octopus_concurrent_linked_queue_invalidate(&context.queue, NULL);
+}
+
+/*
+ * usage: bench_concurrent_linked_queue_staging [producers] [concurrency]
+ *                                              [count] [latency] [items]
+ *
+ * Each producer thread adds items to the queue, either one at a time or
+ * through its staging buffer, while one more thread removes them, and the
+ * time until the last item has been removed is measured. Staging is run for
+ * every power of two buffer size up to count with the given latency in
+ * microseconds, zero for none. The results are printed as comma separated
+ * values, a count of zero being items added one at a time.
+ */
+int main(int argc, char *argv[]) {
+    const uintmax_t producers = bench_argument(argc, argv, 1, 4);
+    const uintmax_t concurrency = bench_argument(argc, argv, 2, 8);
+    const uintmax_t count = bench_argument(argc, argv, 3, 64);
+    const uintmax_t microseconds = bench_argument(argc, argv, 4, 10000);
+    const uintmax_t items = bench_argument(argc, argv, 5, 1000000);
+    if (!producers || !concurrency || !count) {
+        fprintf(stderr, "usage: %s [producers] [concurrency] [count] "
+                        "[latency] [items]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    const struct timespec latency = {
+            .tv_sec = (time_t) (microseconds / 1000000),
+            .tv_nsec = (long) (microseconds % 1000000) * 1000
+    };
+    printf("mode,producers,concurrency,count,latency_us,items,seconds,"
+           "ns_per_item\n");
+    run(producers, concurrency, items, 0, NULL);
+    for (uintmax_t c = 1; c <= count; c <<= 1) {
+        run(producers, concurrency, items, c,
+            microseconds ? &latency : NULL);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,116 @@
+#include <string.h>
+#include <octopus.h>
+
+#include "bench.h"
+
+struct context {
+    struct octopus_concurrent_linked_queue queue;
+    struct octopus_concurrent_pool pool;
+    bool pooled;
+    size_t size;
+    uintmax_t producers;
+    uintmax_t operations;
+    atomic_uintmax_t removed;
+};
+
+static void *acquire(struct context *const context) {
+    void *item;
+    if (!context->pooled) {
+        item = malloc(context->size);
+    } else if (!octopus_concurrent_pool_allocate(&context->pool, &item)) {
+        item = NULL;
+    }
+    if (!item) {
+        abort();
+    }
+    return item;
+}
+
+static void release(struct context *const context, void *const item) {
+    if (!context->pooled) {
+        free(item);
+    } else if (!octopus_concurrent_pool_release(&context->pool, item)) {
+        abort();
+    }
+}
+
+static void producer(struct context *const context) {
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        void *const item = acquire(context);
+        memset(item, (int) i, context->size);
+        if (!octopus_concurrent_linked_queue_add(&context->queue, &item)) {
+            abort();
+        }
+    }
+}
+
+static void consumer(struct context *const context) {
+    const uintmax_t total = context->producers * context->operations;
+    while (atomic_load_explicit(&context->removed, memory_order_relaxed)
+           < total) {
+        unsigned char *item;
+        if (!octopus_concurrent_linked_queue_remove(&context->queue,
+                                                    (void **) &item)) {
+            continue;
+        }
+        /* touch the buffer like a consumer would */
+        volatile unsigned char sink = item[context->size - 1];
+        (void) sink;
+        release(context, item);
+        atomic_fetch_add_explicit(&context->removed, 1,
+                                  memory_order_relaxed);
+    }
+}
+
+static void mixed(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    if (index < context->producers) {
+        producer(context);
+    } else {
+        consumer(context);
+    }
+}
+
+static void report(const char *const mode,
+                   struct context *const context,
+                   const uintmax_t threads) {
+    atomic_store(&context->removed, 0);
+    const double seconds = bench_run(threads, mixed, context);
+    const double operations = (double) context->producers
+                              * (double) context->operations;
+    printf("%s,%ju,%zu,%.0f,%.6f,%.2f\n", mode, threads, context->size,
+           operations, seconds, 1e9 * seconds / operations);
+}
+
+/*
+ * usage: bench_concurrent_pool [threads] [size] [operations]
+ *
+ * Half of the threads allocate buffers, fill them and pass them through a
+ * concurrent linked queue to the other half which release them, first using
+ * malloc and free and then a concurrent pool. The results are printed as
+ * comma separated values.
+ */
+int main(int argc, char *argv[]) {
+    const uintmax_t threads = bench_argument(argc, argv, 1, 4);
+    struct context context = {
+            .size = bench_argument(argc, argv, 2, 256),
+            .producers = threads / 2,
+            .operations = bench_argument(argc, argv, 3, 1000000)
+    };
+    if (threads < 2
+        || !context.size
+        || !octopus_concurrent_linked_queue_init(
+                &context.queue, sizeof(void *), threads)
+        || !octopus_concurrent_pool_init(&context.pool, context.size, 64)) {
+        fprintf(stderr, "usage: %s [threads] [size] [operations]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+    printf("mode,threads,size,operations,seconds,ns_per_operation\n");
+    report("malloc", &context, threads);
+    context.pooled = true;
+    report("pool", &context, threads);
+    octopus_concurrent_pool_invalidate(&context.pool);
+    octopus_concurrent_linked_queue_invalidate(&context.queue, NULL);
+    return EXIT_SUCCESS;
+}
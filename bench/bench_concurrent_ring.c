@@ -0,0 +1,132 @@
+#include <sched.h>
+#include <octopus.h>
+
+#include "bench.h"
+
+#define CONSUMERS                               64
+
+struct context {
+    struct octopus_concurrent_ring ring;
+    struct octopus_concurrent_ring_consumer consumers[CONSUMERS];
+    struct octopus_concurrent_linked_queue queues[CONSUMERS];
+    uintmax_t count;
+    uintmax_t operations;
+};
+
+/* thread 0 publishes, every other thread consumes all that is published */
+static void ring(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    if (!index) {
+        for (uintmax_t i = 0; i < context->operations; i++) {
+            if (!octopus_concurrent_ring_publish(&context->ring, &i)) {
+                abort();
+            }
+        }
+        return;
+    }
+    struct octopus_concurrent_ring_consumer *const consumer
+            = &context->consumers[index - 1];
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        uintmax_t out;
+        if (!octopus_concurrent_ring_consumer_take(consumer, (void **) &out)
+            || out != i) {
+            abort();
+        }
+    }
+}
+
+/* the same with a queue per consumer and the item added to each of them */
+static void queues(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    if (!index) {
+        for (uintmax_t i = 0; i < context->operations; i++) {
+            for (uintmax_t o = 0; o < context->count; o++) {
+                if (!octopus_concurrent_linked_queue_add(
+                        &context->queues[o], &i)) {
+                    abort();
+                }
+            }
+        }
+        return;
+    }
+    struct octopus_concurrent_linked_queue *const queue
+            = &context->queues[index - 1];
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        uintmax_t out;
+        while (!octopus_concurrent_linked_queue_remove(queue,
+                                                       (void **) &out)) {
+            sched_yield();
+        }
+    }
+}
+
+static void run(struct context *const context,
+                const char *const mode,
+                const int wait,
+                const uintmax_t capacity) {
+    if (!octopus_concurrent_ring_init(&context->ring, sizeof(uintmax_t),
+                                      capacity, wait)) {
+        abort();
+    }
+    for (uintmax_t i = 0; i < context->count; i++) {
+        if (!octopus_concurrent_ring_consumer_init(
+                &context->consumers[i], &context->ring, NULL, 0)) {
+            abort();
+        }
+    }
+    const double seconds = bench_run(1 + context->count, ring, context);
+    for (uintmax_t i = 0; i < context->count; i++) {
+        octopus_concurrent_ring_consumer_invalidate(&context->consumers[i]);
+    }
+    octopus_concurrent_ring_invalidate(&context->ring);
+    printf("%s,%ju,%ju,%ju,%.6f,%.2f\n", mode, context->count, capacity,
+           context->operations, seconds,
+           1e9 * seconds / (double) context->operations);
+}
+
+/*
+ * usage: bench_concurrent_ring [consumers] [capacity] [operations]
+ *
+ * For 1 up to the given number of consumers a single producer publishes
+ * items that every consumer has to see, once through the ring with each of
+ * its wait strategies and once through a concurrent linked queue per
+ * consumer. The results are printed as comma separated values.
+ */
+int main(int argc, char *argv[]) {
+    const uintmax_t consumers = bench_argument(argc, argv, 1, 4);
+    const uintmax_t capacity = bench_argument(argc, argv, 2, 1024);
+    struct context context = {
+            .operations = bench_argument(argc, argv, 3, 1000000)
+    };
+    if (!consumers || consumers > CONSUMERS || !capacity) {
+        fprintf(stderr, "usage: %s [consumers] [capacity] [operations]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+    printf("mode,consumers,capacity,operations,seconds,"
+           "ns_per_operation\n");
+    for (context.count = 1; context.count <= consumers; context.count *= 2) {
+        run(&context, "ring_busy_spin",
+            OCTOPUS_CONCURRENT_RING_WAIT_BUSY_SPIN, capacity);
+        run(&context, "ring_yield",
+            OCTOPUS_CONCURRENT_RING_WAIT_YIELD, capacity);
+        run(&context, "ring_block",
+            OCTOPUS_CONCURRENT_RING_WAIT_BLOCK, capacity);
+        for (uintmax_t i = 0; i < context.count; i++) {
+            if (!octopus_concurrent_linked_queue_init(
+                    &context.queues[i], sizeof(uintmax_t), 1)) {
+                abort();
+            }
+        }
+        const double seconds = bench_run(1 + context.count, queues,
+                                         &context);
+        for (uintmax_t i = 0; i < context.count; i++) {
+            octopus_concurrent_linked_queue_invalidate(&context.queues[i],
+                                                       NULL);
+        }
+        printf("queues,%ju,%ju,%ju,%.6f,%.2f\n", context.count, capacity,
+               context.operations, seconds,
+               1e9 * seconds / (double) context.operations);
+    }
+    return EXIT_SUCCESS;
+}
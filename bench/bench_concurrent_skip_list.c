@@ -0,0 +1,130 @@
+#include <search.h>
+#include <octopus.h>
+
+#include "bench.h"
+
+struct context {
+    struct octopus_concurrent_skip_list list;
+    pthread_mutex_t lock;
+    void *tree;
+    uintmax_t keys;
+    uintmax_t operations;
+    uintmax_t *nodes;
+};
+
+static int compare(const void *const first, const void *const second) {
+    const uintmax_t a = *(const uintmax_t *) first;
+    const uintmax_t b = *(const uintmax_t *) second;
+    return a < b ? -1 : a > b;
+}
+
+static uint64_t next(uint64_t *const seed) {
+    *seed ^= *seed << 13;
+    *seed ^= *seed >> 7;
+    *seed ^= *seed << 17;
+    return *seed;
+}
+
+/* 80% lookups, 10% inserts and 10% removals of uniformly chosen keys */
+static void skip_list(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    uint64_t seed = 0x9e3779b97f4a7c15u * (index + 1);
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        const uint64_t random = next(&seed);
+        const uintmax_t key = random % context->keys;
+        uintmax_t out;
+        switch ((random >> 32) % 10) {
+            case 0:
+                octopus_concurrent_skip_list_insert(&context->list, &key,
+                                                    &key);
+                break;
+            case 1:
+                octopus_concurrent_skip_list_remove(&context->list, &key,
+                                                    NULL);
+                break;
+            default:
+                octopus_concurrent_skip_list_get(&context->list, &key,
+                                                 (void **) &out);
+        }
+    }
+}
+
+/* same mix against glibc's red-black tree behind a single mutex */
+static void locked_tree(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    uint64_t seed = 0x9e3779b97f4a7c15u * (index + 1);
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        const uint64_t random = next(&seed);
+        uintmax_t *const key = &context->nodes[random % context->keys];
+        pthread_mutex_lock(&context->lock);
+        switch ((random >> 32) % 10) {
+            case 0:
+                tsearch(key, &context->tree, compare);
+                break;
+            case 1:
+                tdelete(key, &context->tree, compare);
+                break;
+            default:
+                tfind(key, &context->tree, compare);
+        }
+        pthread_mutex_unlock(&context->lock);
+    }
+}
+
+/*
+ * usage: bench_concurrent_skip_list [threads] [keys] [operations]
+ *
+ * For 1 up to the given number of threads each thread performs a mix of
+ * lookups, inserts and removals against the lock-free skip list and
+ * against a mutex protected red-black tree, both prefilled with half of the
+ * keys. The results are printed as comma separated values.
+ */
+int main(int argc, char *argv[]) {
+    const uintmax_t threads = bench_argument(argc, argv, 1, 8);
+    struct context context = {
+            .lock = PTHREAD_MUTEX_INITIALIZER,
+            .keys = bench_argument(argc, argv, 2, 100000),
+            .operations = bench_argument(argc, argv, 3, 1000000)
+    };
+    if (!threads || !context.keys
+        || !(context.nodes = calloc(context.keys, sizeof(uintmax_t)))) {
+        fprintf(stderr, "usage: %s [threads] [keys] [operations]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+    for (uintmax_t key = 0; key < context.keys; key++) {
+        context.nodes[key] = key;
+    }
+    printf("mode,threads,keys,operations,seconds,ns_per_operation,"
+           "operations_per_second\n");
+    for (uintmax_t count = 1; count <= threads; count *= 2) {
+        if (!octopus_concurrent_skip_list_init(
+                &context.list, sizeof(uintmax_t), sizeof(uintmax_t),
+                compare)) {
+            abort();
+        }
+        for (uintmax_t key = 0; key < context.keys; key += 2) {
+            if (!octopus_concurrent_skip_list_insert(&context.list, &key,
+                                                     &key)
+                || !tsearch(&context.nodes[key], &context.tree, compare)) {
+                abort();
+            }
+        }
+        const double operations = (double) count
+                                  * (double) context.operations;
+        double seconds = bench_run(count, skip_list, &context);
+        printf("skip_list,%ju,%ju,%.0f,%.6f,%.2f,%.0f\n", count,
+               context.keys, operations, seconds,
+               1e9 * seconds / operations, operations / seconds);
+        seconds = bench_run(count, locked_tree, &context);
+        printf("locked_tree,%ju,%ju,%.0f,%.6f,%.2f,%.0f\n", count,
+               context.keys, operations, seconds,
+               1e9 * seconds / operations, operations / seconds);
+        octopus_concurrent_skip_list_invalidate(&context.list, NULL);
+        for (uintmax_t key = 0; key < context.keys; key++) {
+            tdelete(&context.nodes[key], &context.tree, compare);
+        }
+    }
+    free(context.nodes);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,111 @@
+#include <octopus.h>
+
+#include "bench.h"
+
+#define BATCH                                       64
+
+enum mode {
+    LINKED,
+    MPSC,
+    MPSC_BATCH
+};
+
+struct context {
+    struct octopus_concurrent_linked_queue linked;
+    struct octopus_mpsc_queue mpsc;
+    enum mode mode;
+    uintmax_t producers;
+    uintmax_t operations;
+};
+
+static void producer(struct context *const context) {
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        if (LINKED == context->mode
+            ? !octopus_concurrent_linked_queue_add(&context->linked, &i)
+            : !octopus_mpsc_queue_add(&context->mpsc, &i)) {
+            abort();
+        }
+    }
+}
+
+static void consumer(struct context *const context) {
+    const uintmax_t total = context->producers * context->operations;
+    uintmax_t out[BATCH];
+    uintmax_t removed;
+    for (uintmax_t i = 0; i < total; i += removed) {
+        removed = 1;
+        switch (context->mode) {
+            case LINKED:
+                if (!octopus_concurrent_linked_queue_remove(
+                        &context->linked, (void **) out)) {
+                    removed = 0;
+                }
+                break;
+            case MPSC:
+                if (!octopus_mpsc_queue_remove(&context->mpsc,
+                                               (void **) out)) {
+                    removed = 0;
+                }
+                break;
+            case MPSC_BATCH:
+                if (!octopus_mpsc_queue_remove_batch(&context->mpsc, out,
+                                                     BATCH, &removed)) {
+                    removed = 0;
+                }
+                break;
+        }
+    }
+}
+
+static void mailbox(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    if (index < context->producers) {
+        producer(context);
+    } else {
+        consumer(context);
+    }
+}
+
+static void report(const char *const mode,
+                   struct context *const context,
+                   const uintmax_t threads) {
+    const double seconds = bench_run(threads, mailbox, context);
+    const double operations = (double) context->producers
+                              * (double) context->operations;
+    printf("%s,%ju,%.0f,%.6f,%.2f\n", mode, context->producers, operations,
+           seconds, 1e9 * seconds / operations);
+}
+
+/*
+ * usage: bench_mpsc_queue [producers] [operations]
+ *
+ * The producers add items to a single mailbox which one consumer drains,
+ * first through a concurrent linked queue with a shard per producer, then
+ * through a multiple producer single consumer queue removing an item at a
+ * time and finally removing batches of items. The results are printed as
+ * comma separated values.
+ */
+int main(int argc, char *argv[]) {
+    struct context context = {
+            .producers = bench_argument(argc, argv, 1, 4),
+            .operations = bench_argument(argc, argv, 2, 1000000)
+    };
+    if (!context.producers
+        || !octopus_concurrent_linked_queue_init(
+                &context.linked, sizeof(uintmax_t), context.producers)
+        || !octopus_mpsc_queue_init(&context.mpsc, sizeof(uintmax_t))) {
+        fprintf(stderr, "usage: %s [producers] [operations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    const uintmax_t threads = 1 + context.producers;
+    printf("mode,producers,operations,seconds,ns_per_operation\n");
+    context.mode = LINKED;
+    report("linked", &context, threads);
+    context.mode = MPSC;
+    report("mpsc", &context, threads);
+    context.mode = MPSC_BATCH;
+    report("mpsc_batch", &context, threads);
+    octopus_concurrent_linked_queue_invalidate(&context.linked, NULL);
+    octopus_mpsc_queue_invalidate(&context.mpsc, NULL);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,97 @@
+#include <octopus.h>
+
+#include "bench.h"
+
+struct table {
+    uintmax_t routes[8];
+};
+
+struct context {
+    pthread_rwlock_t lock;
+    struct table *table;
+    struct octopus_rcu rcu;
+    uintmax_t operations;
+    atomic_uintmax_t sink;
+};
+
+static void rwlock(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    uintmax_t sum = 0;
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        if (pthread_rwlock_rdlock(&context->lock)) {
+            abort();
+        }
+        sum += context->table->routes[i % 8];
+        if (pthread_rwlock_unlock(&context->lock)) {
+            abort();
+        }
+    }
+    atomic_fetch_add_explicit(&context->sink, sum, memory_order_relaxed);
+}
+
+static void rcu(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    struct octopus_rcu_reader *reader;
+    if (!octopus_rcu_register(&context->rcu, &reader)) {
+        abort();
+    }
+    uintmax_t sum = 0;
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        struct table *table;
+        if (!octopus_rcu_read_lock(reader)
+            || !octopus_rcu_dereference(reader, (void **) &table)) {
+            abort();
+        }
+        sum += table->routes[i % 8];
+        if (!octopus_rcu_read_unlock(reader)) {
+            abort();
+        }
+    }
+    atomic_fetch_add_explicit(&context->sink, sum, memory_order_relaxed);
+    if (!octopus_rcu_unregister(&context->rcu, reader)) {
+        abort();
+    }
+}
+
+static void report(const char *const mode,
+                   const struct context *const context,
+                   const uintmax_t threads,
+                   const double seconds) {
+    const double operations = (double) threads
+                              * (double) context->operations;
+    printf("%s,%ju,%.0f,%.6f,%.2f\n", mode, threads, operations, seconds,
+           1e9 * seconds / operations);
+}
+
+/*
+ * usage: bench_rcu [max threads] [operations]
+ *
+ * For one thread up to the given number of threads, each thread repeatedly
+ * looks up an entry in a shared table, first under the read lock of a
+ * pthread rwlock and then inside a read-side critical section of an rcu.
+ * The results are printed as comma separated values.
+ */
+int main(int argc, char *argv[]) {
+    const uintmax_t threads = bench_argument(argc, argv, 1, 8);
+    static struct table table = {
+            .routes = {1, 2, 3, 4, 5, 6, 7, 8}
+    };
+    struct context context = {
+            .table = &table,
+            .operations = bench_argument(argc, argv, 2, 10000000)
+    };
+    if (!threads
+        || pthread_rwlock_init(&context.lock, NULL)
+        || !octopus_rcu_init(&context.rcu, &table)) {
+        fprintf(stderr, "usage: %s [max threads] [operations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    printf("mode,threads,operations,seconds,ns_per_operation\n");
+    for (uintmax_t i = 1; i <= threads; i++) {
+        report("rwlock", &context, i, bench_run(i, rwlock, &context));
+        report("rcu", &context, i, bench_run(i, rcu, &context));
+    }
+    octopus_rcu_invalidate(&context.rcu, NULL);
+    pthread_rwlock_destroy(&context.lock);
+    return EXIT_SUCCESS;
+}
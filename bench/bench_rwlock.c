@@ -0,0 +1,116 @@
+#include <octopus.h>
+
+#include "bench.h"
+
+struct table {
+    uintmax_t routes[8];
+};
+
+struct context {
+    pthread_rwlock_t lock;
+    struct octopus_rwlock rwlock;
+    struct table table;
+    uintmax_t operations;
+    uintmax_t interval;
+    atomic_uintmax_t sink;
+};
+
+/* every interval-th operation of a thread updates the table instead */
+static bool is_write(const struct context *const context,
+                     const uintmax_t i) {
+    return context->interval && context->interval - 1 == i % context->interval;
+}
+
+static void baseline(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    uintmax_t sum = 0;
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        if (is_write(context, i)) {
+            if (pthread_rwlock_wrlock(&context->lock)) {
+                abort();
+            }
+            context->table.routes[i % 8]++;
+        } else {
+            if (pthread_rwlock_rdlock(&context->lock)) {
+                abort();
+            }
+            sum += context->table.routes[i % 8];
+        }
+        if (pthread_rwlock_unlock(&context->lock)) {
+            abort();
+        }
+    }
+    atomic_fetch_add_explicit(&context->sink, sum, memory_order_relaxed);
+}
+
+static void octopus(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    uintmax_t sum = 0;
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        if (is_write(context, i)) {
+            if (!octopus_rwlock_write_lock(&context->rwlock)) {
+                abort();
+            }
+            context->table.routes[i % 8]++;
+            if (!octopus_rwlock_write_unlock(&context->rwlock)) {
+                abort();
+            }
+        } else {
+            if (!octopus_rwlock_read_lock(&context->rwlock)) {
+                abort();
+            }
+            sum += context->table.routes[i % 8];
+            if (!octopus_rwlock_read_unlock(&context->rwlock)) {
+                abort();
+            }
+        }
+    }
+    atomic_fetch_add_explicit(&context->sink, sum, memory_order_relaxed);
+}
+
+static void report(const char *const mode,
+                   const struct context *const context,
+                   const uintmax_t threads,
+                   const double seconds) {
+    const double operations = (double) threads
+                              * (double) context->operations;
+    printf("%s,%ju,%.0f,%.6f,%.2f\n", mode, threads, operations, seconds,
+           1e9 * seconds / operations);
+}
+
+/*
+ * usage: bench_rwlock [max threads] [concurrency] [operations] [interval]
+ *
+ * For one thread up to the given number of threads, each thread repeatedly
+ * looks up an entry in a shared table, first under the read lock of a
+ * pthread rwlock and then under the read lock of an octopus rwlock with the
+ * given number of reader slots. With a non-zero interval every interval-th
+ * operation of each thread updates the table under the write lock instead.
+ * The results are printed as comma separated values.
+ */
+int main(int argc, char *argv[]) {
+    const uintmax_t threads = bench_argument(argc, argv, 1, 8);
+    struct context context = {
+            .table = {
+                    .routes = {1, 2, 3, 4, 5, 6, 7, 8}
+            },
+            .operations = bench_argument(argc, argv, 3, 10000000),
+            .interval = bench_argument(argc, argv, 4, 0)
+    };
+    if (!threads
+        || pthread_rwlock_init(&context.lock, NULL)
+        || !octopus_rwlock_init(&context.rwlock,
+                                bench_argument(argc, argv, 2, threads))) {
+        fprintf(stderr, "usage: %s [max threads] [concurrency] [operations]"
+                        " [interval]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    printf("mode,threads,operations,seconds,ns_per_operation\n");
+    for (uintmax_t i = 1; i <= threads; i++) {
+        report("pthread", &context, i, bench_run(i, baseline, &context));
+        report("octopus", &context, i, bench_run(i, octopus, &context));
+    }
+    octopus_rwlock_invalidate(&context.rwlock);
+    pthread_rwlock_destroy(&context.lock);
+    return EXIT_SUCCESS;
+}
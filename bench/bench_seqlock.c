@@ -0,0 +1,130 @@
+#include <octopus.h>
+
+#include "bench.h"
+
+struct snapshot {
+    uintmax_t bid;
+    uintmax_t ask;
+    uintmax_t volume;
+    uintmax_t time;
+};
+
+enum mode {
+    RWLOCK,
+    SEQLOCK
+};
+
+struct context {
+    pthread_rwlock_t lock;
+    struct snapshot snapshot;
+    struct octopus_seqlock seqlock;
+    enum mode mode;
+    uintmax_t readers;
+    uintmax_t operations;
+    atomic_uintmax_t done;
+    atomic_uintmax_t writes;
+    atomic_uintmax_t sink;
+};
+
+static void writer(struct context *const context) {
+    uintmax_t i = 0;
+    while (atomic_load_explicit(&context->done, memory_order_relaxed)
+           < context->readers) {
+        i++;
+        const struct snapshot value = {
+                .bid = i,
+                .ask = i + 1,
+                .volume = 2 * i,
+                .time = i
+        };
+        if (RWLOCK == context->mode) {
+            if (pthread_rwlock_wrlock(&context->lock)) {
+                abort();
+            }
+            context->snapshot = value;
+            if (pthread_rwlock_unlock(&context->lock)) {
+                abort();
+            }
+        } else if (!octopus_seqlock_write(&context->seqlock, &value)) {
+            abort();
+        }
+    }
+    atomic_store_explicit(&context->writes, i, memory_order_relaxed);
+}
+
+static void reader(struct context *const context) {
+    uintmax_t sum = 0;
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        struct snapshot out;
+        if (RWLOCK == context->mode) {
+            if (pthread_rwlock_rdlock(&context->lock)) {
+                abort();
+            }
+            out = context->snapshot;
+            if (pthread_rwlock_unlock(&context->lock)) {
+                abort();
+            }
+        } else if (!octopus_seqlock_read(&context->seqlock, &out)) {
+            abort();
+        }
+        sum += out.ask - out.bid;
+    }
+    atomic_fetch_add_explicit(&context->sink, sum, memory_order_relaxed);
+    atomic_fetch_add_explicit(&context->done, 1, memory_order_relaxed);
+}
+
+/* the first thread writes for as long as the others are reading */
+static void work(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    if (index) {
+        reader(context);
+    } else {
+        writer(context);
+    }
+}
+
+static void report(const char *const mode,
+                   struct context *const context,
+                   const uintmax_t readers) {
+    context->readers = readers;
+    atomic_store(&context->done, 0);
+    const double seconds = bench_run(1 + readers, work, context);
+    const double operations = (double) readers
+                              * (double) context->operations;
+    printf("%s,%ju,%.0f,%ju,%.6f,%.2f\n", mode, readers, operations,
+           atomic_load(&context->writes), seconds,
+           1e9 * seconds / operations);
+}
+
+/*
+ * usage: bench_seqlock [max readers] [operations]
+ *
+ * For one reader up to the given number of readers, each reader repeatedly
+ * copies a small snapshot while one more thread keeps replacing it, first
+ * under a pthread rwlock and then through a seqlock. The number of writes
+ * made while the readers ran is printed along with the time per read, as
+ * comma separated values.
+ */
+int main(int argc, char *argv[]) {
+    const uintmax_t readers = bench_argument(argc, argv, 1, 8);
+    struct context context = {
+            .operations = bench_argument(argc, argv, 2, 10000000)
+    };
+    if (!readers
+        || pthread_rwlock_init(&context.lock, NULL)
+        || !octopus_seqlock_init(&context.seqlock,
+                                 sizeof(struct snapshot))) {
+        fprintf(stderr, "usage: %s [max readers] [operations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    printf("mode,readers,operations,writes,seconds,ns_per_operation\n");
+    for (uintmax_t i = 1; i <= readers; i++) {
+        context.mode = RWLOCK;
+        report("rwlock", &context, i);
+        context.mode = SEQLOCK;
+        report("seqlock", &context, i);
+    }
+    octopus_seqlock_invalidate(&context.seqlock);
+    pthread_rwlock_destroy(&context.lock);
+    return EXIT_SUCCESS;
+}
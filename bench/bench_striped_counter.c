@@ -0,0 +1,76 @@
+#include <octopus.h>
+
+#include "bench.h"
+
+struct context {
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) atomic_uintmax_t single;
+    struct octopus_striped_counter striped;
+    uintmax_t operations;
+};
+
+static void single(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        atomic_fetch_add_explicit(&context->single, 1, memory_order_relaxed);
+    }
+}
+
+static void striped(void *const arg, const uintmax_t index) {
+    struct context *const context = arg;
+    for (uintmax_t i = 0; i < context->operations; i++) {
+        if (!octopus_striped_counter_add(&context->striped, 1)) {
+            abort();
+        }
+    }
+}
+
+static void report(const char *const mode,
+                   const struct context *const context,
+                   const uintmax_t threads,
+                   const uintmax_t cells,
+                   const double seconds) {
+    const double operations = (double) threads
+                              * (double) context->operations;
+    printf("%s,%ju,%ju,%.0f,%.6f,%.2f\n", mode, threads, cells,
+           operations, seconds, 1e9 * seconds / operations);
+}
+
+/*
+ * usage: bench_striped_counter [max threads] [concurrency] [operations]
+ *
+ * For one thread up to the given number of threads, each thread repeatedly
+ * adds one to a single atomic counter and then to a striped counter, along
+ * with how many cells the striped counter ended up with. The results are
+ * printed as comma separated values.
+ */
+int main(int argc, char *argv[]) {
+    const uintmax_t threads = bench_argument(argc, argv, 1, 8);
+    const uintmax_t concurrency = bench_argument(argc, argv, 2, 16);
+    struct context context = {
+            .operations = bench_argument(argc, argv, 3, 10000000)
+    };
+    if (!threads || !concurrency) {
+        fprintf(stderr, "usage: %s [max threads] [concurrency] "
+                        "[operations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    printf("mode,threads,cells,operations,seconds,ns_per_operation\n");
+    for (uintmax_t i = 1; i <= threads; i++) {
+        atomic_store(&context.single, 0);
+        report("atomic", &context, i, 1, bench_run(i, single, &context));
+        if (!octopus_striped_counter_init(&context.striped, concurrency)) {
+            return EXIT_FAILURE;
+        }
+        const double seconds = bench_run(i, striped, &context);
+        uintmax_t cells;
+        uintmax_t sum;
+        if (!octopus_striped_counter_cells(&context.striped, &cells)
+            || !octopus_striped_counter_sum(&context.striped, &sum)
+            || sum != i * context.operations) {
+            return EXIT_FAILURE;
+        }
+        report("striped", &context, i, cells, seconds);
+        octopus_striped_counter_invalidate(&context.striped);
+    }
+    return EXIT_SUCCESS;
+}
@@ -5,7 +5,24 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include <octopus/allocator.h>
+#include <octopus/arena.h>
+#include <octopus/cache_line.h>
+#include <octopus/concurrent_cow_array_list.h>
+#include <octopus/concurrent_delay_queue.h>
+#include <octopus/concurrent_intrusive_queue.h>
+#include <octopus/concurrent_linked_deque.h>
 #include <octopus/concurrent_linked_queue.h>
+#include <octopus/concurrent_pool.h>
+#include <octopus/concurrent_queue.h>
+#include <octopus/concurrent_ring.h>
+#include <octopus/concurrent_skip_list.h>
 #include <octopus/error.h>
+#include <octopus/mpsc_queue.h>
+#include <octopus/rcu.h>
+#include <octopus/rwlock.h>
+#include <octopus/select.h>
+#include <octopus/seqlock.h>
+#include <octopus/striped_counter.h>
 
 #endif /* _OCTOPUS_OCTOPUS_H_ */
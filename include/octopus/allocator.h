@@ -0,0 +1,17 @@
+#ifndef _OCTOPUS_ALLOCATOR_H_
+#define _OCTOPUS_ALLOCATOR_H_
+
+#include <stddef.h>
+
+/*
+ * Memory source for a data structure. alloc returns size bytes aligned to
+ * alignment, which is always a power of two, or NULL if there is not enough
+ * memory. free receives the same size that was given to alloc.
+ */
+struct octopus_allocator {
+    void *(*alloc)(void *context, size_t size, size_t alignment);
+    void (*free)(void *context, void *pointer, size_t size);
+    void *context;
+};
+
+#endif /* _OCTOPUS_ALLOCATOR_H_ */
@@ -0,0 +1,110 @@
+#ifndef _OCTOPUS_ARENA_H_
+#define _OCTOPUS_ARENA_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <octopus/allocator.h>
+
+#define OCTOPUS_ARENA_ERROR_OBJECT_IS_NULL                              1
+#define OCTOPUS_ARENA_ERROR_SIZE_IS_ZERO                                2
+#define OCTOPUS_ARENA_ERROR_SIZE_IS_TOO_LARGE                           3
+#define OCTOPUS_ARENA_ERROR_PAGES_IS_INVALID                            4
+#define OCTOPUS_ARENA_ERROR_MEMORY_ALLOCATION_FAILED                    5
+#define OCTOPUS_ARENA_ERROR_HUGE_PAGES_ARE_UNAVAILABLE                  6
+#define OCTOPUS_ARENA_ERROR_OUT_IS_NULL                                 7
+
+/* regions are mapped with the default page size */
+#define OCTOPUS_ARENA_PAGES_DEFAULT                                     0
+/* regions are mapped from the reserved huge pages, see MAP_HUGETLB */
+#define OCTOPUS_ARENA_PAGES_HUGE                                        1
+/* regions are aligned to and advised for transparent huge pages */
+#define OCTOPUS_ARENA_PAGES_TRANSPARENT_HUGE                            2
+
+/* size in bytes of a huge page, regions backed by huge pages are a multiple
+ * of it */
+#define OCTOPUS_ARENA_HUGE_PAGE_SIZE                    (UINTMAX_C(1) << 21)
+
+/* number of size classes, blocks are a power of two in size */
+#define OCTOPUS_ARENA_CLASSES                                           64
+
+struct octopus_arena_region;
+struct octopus_arena_block;
+
+struct octopus_arena {
+    pthread_mutex_t lock;
+    size_t region;
+    int pages;
+    struct octopus_arena_region *regions;
+    unsigned char *cursor;
+    unsigned char *end;
+    struct octopus_arena_block *blocks[OCTOPUS_ARENA_CLASSES];
+};
+
+/**
+ * @brief Initialize arena.
+ * <p>Memory is mapped from the operating system one region at a time and
+ * handed out by bumping a cursor through the current region. Released
+ * blocks are kept on a free list for their power of two size class and are
+ * reused before the cursor moves on. Nothing is returned to the operating
+ * system until the arena is invalidated.</p>
+ * <p>Backing the regions with huge pages lowers the number of TLB misses
+ * taken when walking through a lot of memory, such as a very deep
+ * queue.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] region size in bytes of each region, this will be rounded up
+ * to a whole number of pages.
+ * @param [in] pages one of <i>OCTOPUS_ARENA_PAGES_DEFAULT</i>,
+ * <i>OCTOPUS_ARENA_PAGES_HUGE</i> or
+ * <i>OCTOPUS_ARENA_PAGES_TRANSPARENT_HUGE</i>.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_ARENA_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_ARENA_ERROR_SIZE_IS_ZERO if region is zero.
+ * @throws OCTOPUS_ARENA_ERROR_SIZE_IS_TOO_LARGE if region is too large.
+ * @throws OCTOPUS_ARENA_ERROR_PAGES_IS_INVALID if pages is not one of the
+ * above.
+ * @throws OCTOPUS_ARENA_ERROR_HUGE_PAGES_ARE_UNAVAILABLE if huge pages were
+ * requested but none could be mapped.
+ * @throws OCTOPUS_ARENA_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to initialize instance.
+ */
+bool octopus_arena_init(struct octopus_arena *object,
+                        size_t region,
+                        int pages);
+
+/**
+ * @brief Invalidate arena.
+ * <p>Every region is unmapped, including those holding blocks that are
+ * still in use. The actual <u>arena instance is not deallocated</u> since
+ * it may have been embedded in a larger structure.</p>
+ * @param [in] object instance to be invalidated.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_ARENA_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ */
+bool octopus_arena_invalidate(struct octopus_arena *object);
+
+/**
+ * @brief Retrieve an allocator that takes its memory from the arena.
+ * <p>The allocator may be used from several threads at once and must not
+ * be used once the arena has been invalidated.</p>
+ * @param [in] object arena instance.
+ * @param [out] out receive the allocator.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_ARENA_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_ARENA_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ */
+bool octopus_arena_allocator(struct octopus_arena *object,
+                             struct octopus_allocator *out);
+
+/**
+ * @brief Retrieve the number of bytes mapped by the arena.
+ * @param [in] object arena instance.
+ * @param [out] out receive the number of bytes.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_ARENA_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_ARENA_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ */
+bool octopus_arena_mapped(struct octopus_arena *object, uintmax_t *out);
+
+#endif /* _OCTOPUS_ARENA_H_ */
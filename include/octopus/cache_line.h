@@ -0,0 +1,7 @@
+#ifndef _OCTOPUS_CACHE_LINE_H_
+#define _OCTOPUS_CACHE_LINE_H_
+
+/* size in bytes of a cache line, used to keep hot data apart */
+#define OCTOPUS_CACHE_LINE_SIZE                                 64
+
+#endif /* _OCTOPUS_CACHE_LINE_H_ */
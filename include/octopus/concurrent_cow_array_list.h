@@ -0,0 +1,238 @@
+#ifndef _OCTOPUS_CONCURRENT_COW_ARRAY_LIST_H_
+#define _OCTOPUS_CONCURRENT_COW_ARRAY_LIST_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <octopus/cache_line.h>
+
+#define OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL          1
+#define OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_SIZE_IS_ZERO            2
+#define OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED 3
+#define OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_ITEM_IS_NULL            4
+#define OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OUT_IS_NULL             5
+#define OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_INDEX_IS_OUT_OF_BOUNDS  6
+#define OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_SNAPSHOT_IS_NULL        7
+
+struct octopus_concurrent_cow_array_list_snapshot;
+
+struct octopus_concurrent_cow_array_list {
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE)
+    _Atomic(struct octopus_concurrent_cow_array_list_snapshot *) snapshot;
+    size_t size;
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) pthread_mutex_t lock;
+};
+
+/**
+ * @brief Initialize concurrent copy-on-write array list.
+ * <p>An array list for collections which are iterated far more often than
+ * they are changed, such as lists of listeners. The items are kept in an
+ * immutable snapshot which readers iterate without taking any locks or
+ * writing to shared memory. Every change copies the items into a new
+ * snapshot which is then published in place of the previous one, the
+ * previous snapshot is released once no reader can still be iterating
+ * it.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] size of the items.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_SIZE_IS_ZERO if size is
+ * zero.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED if
+ * there is insufficient memory to initialize instance.
+ */
+bool octopus_concurrent_cow_array_list_init(
+        struct octopus_concurrent_cow_array_list *object,
+        size_t size);
+
+/**
+ * @brief Invalidate concurrent copy-on-write array list.
+ * <p>The items in the list will have the given <i>on destroy</i> callback
+ * invoked upon them. No snapshot may still be acquired. The actual <u>list
+ * instance is not deallocated</u> since it may have been embedded in a
+ * larger structure.</p>
+ * @param [in] object instance to be invalidated.
+ * @param [in] on_destroy called just before the item is to be destroyed.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ */
+bool octopus_concurrent_cow_array_list_invalidate(
+        struct octopus_concurrent_cow_array_list *object,
+        void (*on_destroy)(void *));
+
+/**
+ * @brief Retrieve the size of the items.
+ * @param [in] object list instance.
+ * @param [out] out receive the size.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OUT_IS_NULL if out is
+ * <i>NULL</i>.
+ */
+bool octopus_concurrent_cow_array_list_size(
+        const struct octopus_concurrent_cow_array_list *object,
+        size_t *out);
+
+/**
+ * @brief Retrieve the number of items.
+ * @param [in] object list instance.
+ * @param [out] out receive the number of items.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OUT_IS_NULL if out is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED if
+ * there is insufficient memory to register the calling thread as a reader.
+ */
+bool octopus_concurrent_cow_array_list_length(
+        struct octopus_concurrent_cow_array_list *object,
+        uintmax_t *out);
+
+/**
+ * @brief Add an item to the end of the list.
+ * @param [in] object list instance.
+ * @param [in] item to be copied into the list.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_ITEM_IS_NULL if item is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED if
+ * there is insufficient memory to copy the list.
+ */
+bool octopus_concurrent_cow_array_list_add(
+        struct octopus_concurrent_cow_array_list *object,
+        const void *item);
+
+/**
+ * @brief Insert an item at the given index.
+ * @param [in] object list instance.
+ * @param [in] at index to insert the item at, items from here onwards are
+ * moved up by one.
+ * @param [in] item to be copied into the list.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_ITEM_IS_NULL if item is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_INDEX_IS_OUT_OF_BOUNDS if
+ * at is greater than the number of items.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED if
+ * there is insufficient memory to copy the list.
+ */
+bool octopus_concurrent_cow_array_list_insert(
+        struct octopus_concurrent_cow_array_list *object,
+        uintmax_t at,
+        const void *item);
+
+/**
+ * @brief Replace the item at the given index.
+ * @param [in] object list instance.
+ * @param [in] at index of the item to replace.
+ * @param [in] item to be copied into the list.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_ITEM_IS_NULL if item is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_INDEX_IS_OUT_OF_BOUNDS if
+ * there is no item at the given index.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED if
+ * there is insufficient memory to copy the list.
+ */
+bool octopus_concurrent_cow_array_list_set(
+        struct octopus_concurrent_cow_array_list *object,
+        uintmax_t at,
+        const void *item);
+
+/**
+ * @brief Remove the item at the given index.
+ * @param [in] object list instance.
+ * @param [in] at index of the item to remove, items after it are moved down
+ * by one.
+ * @param [out] out receive a copy of the removed item, may be <i>NULL</i>.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_INDEX_IS_OUT_OF_BOUNDS if
+ * there is no item at the given index.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED if
+ * there is insufficient memory to copy the list.
+ */
+bool octopus_concurrent_cow_array_list_remove(
+        struct octopus_concurrent_cow_array_list *object,
+        uintmax_t at,
+        void *out);
+
+/**
+ * @brief Acquire the current snapshot.
+ * <p>The snapshot does not change while it is acquired, even as writers
+ * publish newer ones. It must be released by the same thread and should be
+ * held only for as long as it takes to iterate it, since no memory retired
+ * by the library is released while it is held. A thread may acquire more
+ * than one snapshot at a time.</p>
+ * @param [in] object list instance.
+ * @param [out] out receive the snapshot.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OUT_IS_NULL if out is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED if
+ * there is insufficient memory to register the calling thread as a reader.
+ */
+bool octopus_concurrent_cow_array_list_acquire(
+        struct octopus_concurrent_cow_array_list *object,
+        const struct octopus_concurrent_cow_array_list_snapshot **out);
+
+/**
+ * @brief Release a snapshot.
+ * @param [in] snapshot acquired by the calling thread, it must not be used
+ * afterwards.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_SNAPSHOT_IS_NULL if
+ * snapshot is <i>NULL</i>.
+ */
+bool octopus_concurrent_cow_array_list_release(
+        const struct octopus_concurrent_cow_array_list_snapshot *snapshot);
+
+/**
+ * @brief Retrieve the number of items in a snapshot.
+ * @param [in] snapshot acquired by the calling thread.
+ * @param [out] out receive the number of items.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_SNAPSHOT_IS_NULL if
+ * snapshot is <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OUT_IS_NULL if out is
+ * <i>NULL</i>.
+ */
+bool octopus_concurrent_cow_array_list_snapshot_length(
+        const struct octopus_concurrent_cow_array_list_snapshot *snapshot,
+        uintmax_t *out);
+
+/**
+ * @brief Retrieve an item from a snapshot.
+ * @param [in] snapshot acquired by the calling thread.
+ * @param [in] at index of the item.
+ * @param [out] out receive the address of the item, valid until the
+ * snapshot is released.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_SNAPSHOT_IS_NULL if
+ * snapshot is <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OUT_IS_NULL if out is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_INDEX_IS_OUT_OF_BOUNDS if
+ * there is no item at the given index.
+ */
+bool octopus_concurrent_cow_array_list_snapshot_get(
+        const struct octopus_concurrent_cow_array_list_snapshot *snapshot,
+        uintmax_t at,
+        const void **out);
+
+#endif /* _OCTOPUS_CONCURRENT_COW_ARRAY_LIST_H_ */
@@ -0,0 +1,141 @@
+#ifndef _OCTOPUS_CONCURRENT_DELAY_QUEUE_H_
+#define _OCTOPUS_CONCURRENT_DELAY_QUEUE_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#define OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OBJECT_IS_NULL             1
+#define OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_SIZE_IS_ZERO               2
+#define OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_SIZE_IS_TOO_LARGE          3
+#define OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_CONCURRENCY_IS_ZERO        4
+#define OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_TICK_IS_ZERO               5
+#define OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED   6
+#define OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_ITEM_IS_NULL               7
+#define OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_TIMER_IS_NULL              8
+#define OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_TIMER_IS_NOT_PENDING       9
+#define OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OUT_IS_NULL                10
+#define OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_NOTHING_IS_DUE             11
+
+struct octopus_concurrent_delay_queue_shard;
+
+struct octopus_concurrent_delay_queue {
+    struct octopus_concurrent_delay_queue_shard *shards;
+    size_t size;
+    uintmax_t mask;
+    uint64_t tick;
+    uint64_t epoch;
+    atomic_uintmax_t schedule;
+    atomic_uintmax_t take;
+};
+
+struct octopus_concurrent_delay_queue_timer {
+    uintmax_t shard;
+    uintmax_t index;
+    uintmax_t generation;
+};
+
+/**
+ * @brief Initialize concurrent delay queue.
+ * <p>Items are kept in a hierarchical timing wheel per shard so that
+ * scheduling and cancelling are constant time regardless of how many items
+ * are pending, and items become due a whole tick at a time.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] size of item to be contained within the queue.
+ * @param [in] concurrency maximum number of concurrent reads or writes that
+ * can occur, this will be rounded up to the next power of two.
+ * @param [in] tick resolution of the timing wheel in nanoseconds.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_SIZE_IS_ZERO if size is zero.
+ * @throws OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_SIZE_IS_TOO_LARGE if size is
+ * too large.
+ * @throws OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_CONCURRENCY_IS_ZERO if
+ * concurrency is zero.
+ * @throws OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_TICK_IS_ZERO if tick is zero.
+ * @throws OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED if
+ * there is insufficient memory to initialize instance.
+ */
+bool octopus_concurrent_delay_queue_init(
+        struct octopus_concurrent_delay_queue *object,
+        size_t size,
+        uintmax_t concurrency,
+        uint64_t tick);
+
+/**
+ * @brief Invalidate concurrent delay queue.
+ * <p>All the items contained within the queue, whether due or not, will have
+ * the given <i>on destroy</i> callback invoked upon itself. The actual
+ * <u>concurrent delay queue instance is not deallocated</u> since it may have
+ * been embedded in a larger structure.</p>
+ * @param [in] object instance to be invalidated.
+ * @param [in] on_destroy called just before the item is to be destroyed.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ */
+bool octopus_concurrent_delay_queue_invalidate(
+        struct octopus_concurrent_delay_queue *object,
+        void (*on_destroy)(void *));
+
+/**
+ * @brief Schedule item to become due after a delay.
+ * @param [in] object queue instance.
+ * @param [in] item to schedule.
+ * @param [in] delay in nanoseconds after which the item becomes due, this is
+ * rounded up to a whole number of ticks.
+ * @param [out] out receive the timer that may be used to cancel the item,
+ * <i>NULL</i> if it will not be cancelled.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_ITEM_IS_NULL if item is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED if
+ * there is insufficient memory to schedule item.
+ */
+bool octopus_concurrent_delay_queue_schedule(
+        struct octopus_concurrent_delay_queue *object,
+        const void *item,
+        uint64_t delay,
+        struct octopus_concurrent_delay_queue_timer *out);
+
+/**
+ * @brief Cancel a scheduled item.
+ * @param [in] object queue instance.
+ * @param [in] timer of the item to cancel.
+ * @param [out] out receive the cancelled item.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_TIMER_IS_NULL if timer is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OUT_IS_NULL if out is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_TIMER_IS_NOT_PENDING if the
+ * item has already been taken or cancelled.
+ */
+bool octopus_concurrent_delay_queue_cancel(
+        struct octopus_concurrent_delay_queue *object,
+        const struct octopus_concurrent_delay_queue_timer *timer,
+        void **out);
+
+/**
+ * @brief Take an item whose delay has elapsed.
+ * @param [in] object queue instance.
+ * @param [out] out receive the due item.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OUT_IS_NULL if out is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_NOTHING_IS_DUE if no item has
+ * become due yet.
+ */
+bool octopus_concurrent_delay_queue_take(
+        struct octopus_concurrent_delay_queue *object,
+        void **out);
+
+#endif /* _OCTOPUS_CONCURRENT_DELAY_QUEUE_H_ */
@@ -0,0 +1,122 @@
+#ifndef _OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_H_
+#define _OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#define OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OBJECT_IS_NULL         1
+#define OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_CONCURRENCY_IS_ZERO    2
+#define OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED 3
+#define OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_LINK_IS_NULL           4
+#define OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OUT_IS_NULL            5
+#define OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_QUEUE_IS_EMPTY         6
+
+/**
+ * @brief Retrieve the structure that a queue link is embedded in.
+ * @param [in] link address of the embedded queue link.
+ * @param [in] type of the structure containing the queue link.
+ * @param [in] member name of the queue link within the structure.
+ */
+#define OCTOPUS_QUEUE_LINK_ENTRY(link, type, member) \
+    ((type *) ((unsigned char *) (link) - offsetof(type, member)))
+
+/* embedded by the caller in each item, owned by the queue while the item is
+ * contained within it */
+struct octopus_queue_link {
+    _Atomic(struct octopus_queue_link *) next;
+};
+
+struct octopus_concurrent_intrusive_queue_shard;
+
+struct octopus_concurrent_intrusive_queue {
+    struct octopus_concurrent_intrusive_queue_shard *shards;
+    uintmax_t mask;
+    atomic_uintmax_t enqueue;
+    atomic_uintmax_t dequeue;
+};
+
+/**
+ * @brief Initialize concurrent intrusive queue.
+ * <p>Items are linked into the queue through a queue link embedded within
+ * them rather than being copied, so adding and removing never allocate.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] concurrency maximum number of concurrent reads or writes that
+ * can occur, this will be rounded up to the next power of two.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OBJECT_IS_NULL if object
+ * is <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_CONCURRENCY_IS_ZERO if
+ * concurrency is zero.
+ * @throws OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED
+ * if there is insufficient memory to initialize instance.
+ */
+bool octopus_concurrent_intrusive_queue_init(
+        struct octopus_concurrent_intrusive_queue *object,
+        uintmax_t concurrency);
+
+/**
+ * @brief Invalidate concurrent intrusive queue.
+ * <p>The links of all the items contained within the queue will have the
+ * given <i>on destroy</i> callback invoked upon them, after which the queue
+ * no longer refers to them. The actual <u>queue instance is not
+ * deallocated</u> since it may have been embedded in a larger
+ * structure.</p>
+ * @param [in] object instance to be invalidated.
+ * @param [in] on_destroy called with the link of each contained item.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OBJECT_IS_NULL if object
+ * is <i>NULL</i>.
+ */
+bool octopus_concurrent_intrusive_queue_invalidate(
+        struct octopus_concurrent_intrusive_queue *object,
+        void (*on_destroy)(struct octopus_queue_link *));
+
+/**
+ * @brief Retrieve the concurrency.
+ * @param [in] object queue instance.
+ * @param [out] out receive the number of shards.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OBJECT_IS_NULL if object
+ * is <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OUT_IS_NULL if out is
+ * <i>NULL</i>.
+ */
+bool octopus_concurrent_intrusive_queue_concurrency(
+        const struct octopus_concurrent_intrusive_queue *object,
+        uintmax_t *out);
+
+/**
+ * @brief Add item to the queue.
+ * <p>The link must not already be contained within a queue and the item
+ * must stay valid until it has been removed again.</p>
+ * @param [in] object queue instance.
+ * @param [in] link embedded in the item to add.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OBJECT_IS_NULL if object
+ * is <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_LINK_IS_NULL if link is
+ * <i>NULL</i>.
+ */
+bool octopus_concurrent_intrusive_queue_add(
+        struct octopus_concurrent_intrusive_queue *object,
+        struct octopus_queue_link *link);
+
+/**
+ * @brief Remove item from the queue.
+ * @param [in] object queue instance.
+ * @param [out] out receive the link embedded in the removed item.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OBJECT_IS_NULL if object
+ * is <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OUT_IS_NULL if out is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_QUEUE_IS_EMPTY if queue
+ * is empty.
+ */
+bool octopus_concurrent_intrusive_queue_remove(
+        struct octopus_concurrent_intrusive_queue *object,
+        struct octopus_queue_link **out);
+
+#endif /* _OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_H_ */
@@ -0,0 +1,185 @@
+#ifndef _OCTOPUS_CONCURRENT_LINKED_DEQUE_H_
+#define _OCTOPUS_CONCURRENT_LINKED_DEQUE_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <octopus/cache_line.h>
+
+#define OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL            1
+#define OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_SIZE_IS_ZERO              2
+#define OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_SIZE_IS_TOO_LARGE         3
+#define OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_CONCURRENCY_IS_ZERO       4
+#define OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED  5
+#define OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OUT_IS_NULL               6
+#define OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_ITEM_IS_NULL              7
+#define OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_DEQUE_IS_EMPTY            8
+
+struct octopus_concurrent_linked_deque_shard;
+
+struct octopus_concurrent_linked_deque {
+    struct octopus_concurrent_linked_deque_shard *shards;
+    uintmax_t mask;
+    size_t size;
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) atomic_uintmax_t first;
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) atomic_uintmax_t last;
+};
+
+/**
+ * @brief Initialize concurrent linked deque.
+ * <p>The items are spread over a number of shards, each a linked deque
+ * behind its own lock. Each end of the deque has its own cursor which picks
+ * the shard the next item at that end is added to or removed from, so that
+ * operations on the two ends only take the same lock when they meet on the
+ * same shard. As with the concurrent linked queue, order is only kept
+ * exactly while operations do not overlap.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] size of item to be contained within the deque.
+ * @param [in] concurrency maximum number of concurrent operations that can
+ * occur, this will be rounded up to the next power of two.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_SIZE_IS_ZERO if size is zero.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_SIZE_IS_TOO_LARGE if size is
+ * too large.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_CONCURRENCY_IS_ZERO if
+ * concurrency is zero.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED if
+ * there is insufficient memory to initialize instance.
+ */
+bool octopus_concurrent_linked_deque_init(
+        struct octopus_concurrent_linked_deque *object,
+        size_t size,
+        uintmax_t concurrency);
+
+/**
+ * @brief Invalidate concurrent linked deque.
+ * <p>All the items contained within the deque will have the given <i>on
+ * destroy</i> callback invoked upon itself. The actual <u>deque instance is
+ * not deallocated</u> since it may have been embedded in a larger
+ * structure.</p>
+ * @param [in] object instance to be invalidated.
+ * @param [in] on_destroy called just before the item is to be destroyed.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ */
+bool octopus_concurrent_linked_deque_invalidate(
+        struct octopus_concurrent_linked_deque *object,
+        void (*on_destroy)(void *));
+
+/**
+ * @brief Retrieve the size of an item.
+ * @param [in] object deque instance.
+ * @param [out] out receive the size of an item.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OUT_IS_NULL if out is
+ * <i>NULL</i>.
+ */
+bool octopus_concurrent_linked_deque_size(
+        const struct octopus_concurrent_linked_deque *object,
+        size_t *out);
+
+/**
+ * @brief Add item to the front of the deque.
+ * @param [in] object deque instance.
+ * @param [in] item to add to the front of the deque.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_ITEM_IS_NULL if item is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED if
+ * there is insufficient memory to add item.
+ */
+bool octopus_concurrent_linked_deque_add_first(
+        struct octopus_concurrent_linked_deque *object,
+        const void *item);
+
+/**
+ * @brief Add item to the end of the deque.
+ * @param [in] object deque instance.
+ * @param [in] item to add to the end of the deque.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_ITEM_IS_NULL if item is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED if
+ * there is insufficient memory to add item.
+ */
+bool octopus_concurrent_linked_deque_add_last(
+        struct octopus_concurrent_linked_deque *object,
+        const void *item);
+
+/**
+ * @brief Remove item from the front of the deque.
+ * @param [in] object deque instance.
+ * @param [in] out receive the item in the front of the deque.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OUT_IS_NULL if out is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_DEQUE_IS_EMPTY if deque is
+ * empty.
+ */
+bool octopus_concurrent_linked_deque_remove_first(
+        struct octopus_concurrent_linked_deque *object,
+        void **out);
+
+/**
+ * @brief Remove item from the end of the deque.
+ * @param [in] object deque instance.
+ * @param [in] out receive the item in the end of the deque.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OUT_IS_NULL if out is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_DEQUE_IS_EMPTY if deque is
+ * empty.
+ */
+bool octopus_concurrent_linked_deque_remove_last(
+        struct octopus_concurrent_linked_deque *object,
+        void **out);
+
+/**
+ * @brief Retrieve the item from the front of the deque without removing it.
+ * @param [in] object deque instance.
+ * @param [in] out receive the item in the front of the deque without
+ * removing it.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OUT_IS_NULL if out is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_DEQUE_IS_EMPTY if deque is
+ * empty.
+ */
+bool octopus_concurrent_linked_deque_peek_first(
+        struct octopus_concurrent_linked_deque *object,
+        void **out);
+
+/**
+ * @brief Retrieve the item from the end of the deque without removing it.
+ * @param [in] object deque instance.
+ * @param [in] out receive the item in the end of the deque without removing
+ * it.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OUT_IS_NULL if out is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_DEQUE_IS_EMPTY if deque is
+ * empty.
+ */
+bool octopus_concurrent_linked_deque_peek_last(
+        struct octopus_concurrent_linked_deque *object,
+        void **out);
+
+#endif /* _OCTOPUS_CONCURRENT_LINKED_DEQUE_H_ */
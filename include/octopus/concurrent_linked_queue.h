@@ -5,7 +5,10 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdatomic.h>
+#include <time.h>
+#include <pthread.h>
 #include <coral.h>
+#include <octopus/allocator.h>
 
 #define OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL            1
 #define OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_SIZE_IS_ZERO              2
@@ -15,11 +18,56 @@
 #define OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OUT_IS_NULL               6
 #define OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_ITEM_IS_NULL              7
 #define OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY            8
+#define OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_EVENT_FD_FAILED           9
+#define OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_EVENT_FD_IS_NOT_ATTACHED  10
+#define OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_FULL             11
+#define OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_TIMED_OUT                 12
+#define OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_SPILL_FAILED              13
+#define OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_DIRECTORY_IS_NULL         14
+#define OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_ALLOCATOR_IS_INVALID      15
+#define OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_COUNT_IS_ZERO             16
+#define OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_STAGING_IS_ATTACHED       17
+#define OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_STAGING_IS_NOT_ATTACHED   18
+#define OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_COMBINING_IS_ATTACHED     19
+#define OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_TIMEOUT_IS_INVALID       20
+
+/* size in bytes of each segment file created by a spill */
+#define OCTOPUS_CONCURRENT_LINKED_QUEUE_SPILL_SEGMENT_SIZE \
+    (UINTMAX_C(1) << 22)
+
+struct octopus_linked_queue;
+struct octopus_select_entry;
+struct octopus_concurrent_linked_queue_counter;
+struct octopus_concurrent_linked_queue_stage;
+struct octopus_concurrent_linked_queue_combiner;
+struct octopus_concurrent_linked_queue_record;
 
 struct octopus_concurrent_linked_queue {
-    struct coral_array_list queues;
+    struct octopus_linked_queue *queues;
+    struct octopus_concurrent_linked_queue_counter *counters;
+    uintmax_t mask;
+    uintmax_t capacity;
     atomic_uintmax_t enqueue;
     atomic_uintmax_t dequeue;
+    int event_fd;
+    atomic_intmax_t count;
+    atomic_uintmax_t debits;
+    atomic_uintmax_t settling;
+    atomic_uintmax_t waiters;
+    struct octopus_select_entry *waiting;
+    pthread_mutex_t lock;
+    atomic_uintmax_t blocked;
+    pthread_cond_t space;
+    struct octopus_allocator allocator;
+    uintmax_t probes;
+    uintmax_t staging;
+    uintmax_t latency;
+    clockid_t clock;
+    pthread_key_t key;
+    _Atomic(struct octopus_concurrent_linked_queue_stage *) stages;
+    struct octopus_concurrent_linked_queue_combiner *combiners;
+    pthread_key_t record;
+    _Atomic(struct octopus_concurrent_linked_queue_record *) records;
 };
 
 /**
@@ -27,7 +75,7 @@ struct octopus_concurrent_linked_queue {
  * @param [in] object instance to be initialized.
  * @param [in] size of item to be contained within the queue.
  * @param [in] concurrency maximum number of concurrent reads or writes that
- * can occur.
+ * can occur, this will be rounded up to the next power of two.
  * @return On success true, otherwise false if an error has occurred.
  * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is
  * <i>NULL</i>.
@@ -44,6 +92,67 @@ bool octopus_concurrent_linked_queue_init(
         size_t size,
         uintmax_t concurrency);
 
+/**
+ * @brief Initialize concurrent linked queue with a capacity.
+ * <p>The capacity is split between the shards and each shard keeps count of
+ * its own items so that producers do not contend on a single counter. Adding
+ * to a full shard moves on to the next one and only once all the shards are
+ * full will the queue be considered full.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] size of item to be contained within the queue.
+ * @param [in] concurrency maximum number of concurrent reads or writes that
+ * can occur, this will be rounded up to the next power of two.
+ * @param [in] capacity maximum number of items the queue may contain, zero
+ * for an unbounded queue.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_SIZE_IS_ZERO if size is zero.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_SIZE_IS_TOO_LARGE if size is
+ * too large.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_CONCURRENCY_IS_ZERO if
+ * concurrency is zero.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED if
+ * there is insufficient memory to initialize instance.
+ */
+bool octopus_concurrent_linked_queue_init_with_capacity(
+        struct octopus_concurrent_linked_queue *object,
+        size_t size,
+        uintmax_t concurrency,
+        uintmax_t capacity);
+
+/**
+ * @brief Initialize concurrent linked queue with an allocator.
+ * <p>Every allocation made by the queue and its shards, from the shards
+ * themselves to the nodes holding the items, is taken from the given
+ * allocator, which must be safe to use from several threads at once.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] size of item to be contained within the queue.
+ * @param [in] concurrency maximum number of concurrent reads or writes that
+ * can occur, this will be rounded up to the next power of two.
+ * @param [in] capacity maximum number of items the queue may contain, zero
+ * for an unbounded queue.
+ * @param [in] allocator memory source or <i>NULL</i> for the C library.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_SIZE_IS_ZERO if size is zero.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_SIZE_IS_TOO_LARGE if size is
+ * too large.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_CONCURRENCY_IS_ZERO if
+ * concurrency is zero.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_ALLOCATOR_IS_INVALID if the
+ * allocator lacks either its alloc or free function.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED if
+ * there is insufficient memory to initialize instance.
+ */
+bool octopus_concurrent_linked_queue_init_with_allocator(
+        struct octopus_concurrent_linked_queue *object,
+        size_t size,
+        uintmax_t concurrency,
+        uintmax_t capacity,
+        const struct octopus_allocator *allocator);
+
 /**
  * @brief Invalidate concurrent linked queue.
  * <p>All the items contained within the queue will have the given <i>on
@@ -76,6 +185,8 @@ bool octopus_concurrent_linked_queue_size(
 
 /**
  * @brief Retrieve the concurrency limit.
+ * <p>This is the concurrency given at initialization rounded up to the next
+ * power of two.</p>
  * @param [in] object instance whose concurrency limit we are to retrieve.
  * @param [out] out receive the concurrency limit.
  * @return On success true, otherwise false if an error has occurred.
@@ -88,8 +199,25 @@ bool octopus_concurrent_linked_queue_concurrency(
         const struct octopus_concurrent_linked_queue *object,
         uintmax_t *out);
 
+/**
+ * @brief Retrieve capacity.
+ * @param [in] object queue instance.
+ * @param [out] out receive capacity, zero if the queue is unbounded.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OUT_IS_NULL if out is
+ * <i>NULL</i>.
+ */
+bool octopus_concurrent_linked_queue_capacity(
+        const struct octopus_concurrent_linked_queue *object,
+        uintmax_t *out);
+
 /**
  * @brief Add item to the end of the queue.
+ * <p>Never waits for space. If the queue was initialized with a capacity and
+ * every shard is full it fails with QUEUE_IS_FULL straight away, use
+ * @ref octopus_concurrent_linked_queue_put to wait for space instead.</p>
  * @param [in] object queue instance.
  * @param [in] item to add to the end of the queue.
  * @return On success true, otherwise false if an error has occurred.
@@ -99,11 +227,40 @@ bool octopus_concurrent_linked_queue_concurrency(
  * <i>NULL</i>.
  * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED if
  * there is insufficient memory to add item.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_SPILL_FAILED if a spill is
+ * attached and a segment file could not be created.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_FULL if queue is
+ * full.
  */
 bool octopus_concurrent_linked_queue_add(
         struct octopus_concurrent_linked_queue *object,
         const void *item);
 
+/**
+ * @brief Add item to the end of the queue waiting for space if it is full.
+ * @param [in] object queue instance.
+ * @param [in] item to add to the end of the queue.
+ * @param [in] timeout maximum time to wait for, <i>NULL</i> to wait
+ * indefinitely.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_ITEM_IS_NULL if item is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_TIMEOUT_IS_INVALID if
+ * timeout is negative or has a nanosecond part of a second or more.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED if
+ * there is insufficient memory to add item.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_SPILL_FAILED if a spill is
+ * attached and a segment file could not be created.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_TIMED_OUT if no space became
+ * available before the timeout elapsed.
+ */
+bool octopus_concurrent_linked_queue_put(
+        struct octopus_concurrent_linked_queue *object,
+        const void *item,
+        const struct timespec *timeout);
+
 /**
  * @brief Remove item from the front of the queue.
  * @param [in] object queue instance.
@@ -137,4 +294,247 @@ bool octopus_concurrent_linked_queue_peek(
         struct octopus_concurrent_linked_queue *object,
         void **out);
 
+/**
+ * @brief Retrieve the number of bytes of memory held by the queue.
+ * <p>This includes the sub-queues, the nodes holding items and the nodes
+ * kept for reuse but excludes the queue instance itself and any overhead of
+ * the allocator.</p>
+ * @param [in] object queue instance.
+ * @param [out] out receive the number of bytes.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OUT_IS_NULL if out is
+ * <i>NULL</i>.
+ */
+bool octopus_concurrent_linked_queue_memory_usage(
+        const struct octopus_concurrent_linked_queue *object,
+        uintmax_t *out);
+
+/**
+ * @brief Return memory held for reuse back to the allocator.
+ * <p>Nodes released by <i>remove</i> are kept so that subsequent <i>add</i>
+ * operations do not have to allocate. Calling this after a burst releases
+ * them, sub-queues which are empty release all of their nodes.</p>
+ * @param [in] object queue instance.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ */
+bool octopus_concurrent_linked_queue_trim(
+        struct octopus_concurrent_linked_queue *object);
+
+/**
+ * @brief Attach an eventfd which is readable while the queue is not empty.
+ * <p>The eventfd is only written to when the queue goes from empty to not
+ * empty and read from when it goes from not empty to empty, other
+ * <i>add</i> and <i>remove</i> operations do not make any system calls.
+ * The eventfd is non-blocking, a <i>remove</i> which empties the queue
+ * before the matching write has been made leaves the read to be settled
+ * once it has, rather than waiting for it. This allows the queue to be
+ * waited upon by <i>epoll</i>, <i>poll</i> or <i>select</i> together with
+ * other file descriptors. The eventfd must not be read from or written to
+ * by anything other than the queue.</p>
+ * <p>This must be called before the queue is shared with other threads. The
+ * eventfd is closed when the queue is invalidated. It is only supported on
+ * Linux.</p>
+ * @param [in] object queue instance.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_EVENT_FD_FAILED if the eventfd
+ * could not be created.
+ */
+bool octopus_concurrent_linked_queue_attach_event_fd(
+        struct octopus_concurrent_linked_queue *object);
+
+/**
+ * @brief Retrieve the attached eventfd.
+ * @param [in] object queue instance.
+ * @param [out] out receive the eventfd.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OUT_IS_NULL if out is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_EVENT_FD_IS_NOT_ATTACHED if
+ * an eventfd has not been attached.
+ */
+bool octopus_concurrent_linked_queue_event_fd(
+        const struct octopus_concurrent_linked_queue *object,
+        int *out);
+
+/**
+ * @brief Attach a spill so that bursts overflow to disk.
+ * <p>Once <i>threshold</i> items are held in memory further items are
+ * appended to memory mapped segment files in <i>directory</i> instead, and
+ * keep being so until those have been drained. The threshold is split
+ * between the shards and each shard spills on its own, so the order of items
+ * within a shard is preserved. Consumers read the segments back in order and
+ * each segment is deleted as soon as it has been drained.</p>
+ * <p>This must be called before the queue is shared with other threads.</p>
+ * @param [in] object queue instance.
+ * @param [in] directory in which the segment files are created, it should be
+ * on a local disk.
+ * @param [in] threshold number of items to keep in memory.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_DIRECTORY_IS_NULL if
+ * directory is <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_SIZE_IS_TOO_LARGE if the
+ * size of an item is too large to be spilled.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_SPILL_FAILED if directory is
+ * not a writable directory.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED if
+ * there is insufficient memory to attach the spill.
+ */
+bool octopus_concurrent_linked_queue_attach_spill(
+        struct octopus_concurrent_linked_queue *object,
+        const char *directory,
+        uintmax_t threshold);
+
+/**
+ * @brief Avoid waiting on shards which are busy.
+ * <p>By default <i>add</i> and <i>remove</i> wait for the lock of the shard
+ * their ticket selects even when the neighbouring shards are idle. After
+ * this has been called they try the lock of the selected shard and, if
+ * another thread holds it, move on to the next shard. Only after the given
+ * number of busy shards, or once every shard has been tried, do they wait,
+ * on the last shard they tried when adding and on the selected shard when
+ * removing. A <i>remove</i> which
+ * comes across an empty shard while probing also stops and waits on the
+ * selected shard.</p>
+ * <p>This should be called before the queue is shared with other
+ * threads.</p>
+ * @param [in] object queue instance.
+ * @param [in] probes number of shards to try before waiting, zero to always
+ * wait on the selected shard.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ */
+bool octopus_concurrent_linked_queue_set_probes(
+        struct octopus_concurrent_linked_queue *object,
+        uintmax_t probes);
+
+/**
+ * @brief Attach a staging buffer in front of the queue for each producer.
+ * <p>Items given to @ref octopus_concurrent_linked_queue_stage are gathered
+ * in a buffer belonging to the calling thread and are only added to the
+ * queue once the buffer is full, once the oldest of them has waited for
+ * <i>latency</i>, or when the thread calls
+ * @ref octopus_concurrent_linked_queue_flush or exits. They are then added
+ * to a single shard taking one ticket and one lock for all of them, rather
+ * than one of each per item. Items that are staged are not seen by
+ * consumers and the items of different producers are not ordered with
+ * respect to each other.</p>
+ * <p>The latency is looked at when the thread stages its next item and
+ * whenever a consumer finds the queue empty, in which case the consumer adds
+ * the items of every buffer past its latency before looking again. Items of
+ * a producer that stops producing therefore wait no longer than the latency
+ * once consumers are looking for them. Each buffer is guarded by a flag of
+ * its own that its producer only waits on while a consumer is adding its
+ * items. Where a coarse clock is available whose resolution is no longer
+ * than the latency, it is used as it is much cheaper to read, and items may
+ * then wait for up to that resolution longer. Items still
+ * staged when the queue is invalidated are destroyed along with the
+ * others. Adding items with @ref octopus_concurrent_linked_queue_add is not
+ * affected.</p>
+ * <p>This must be called before the queue is shared with other threads.</p>
+ * @param [in] object queue instance.
+ * @param [in] count number of items each buffer holds.
+ * @param [in] latency longest time an item waits in a buffer before it is
+ * added by the next item staged or the next consumer to find the queue
+ * empty, <i>NULL</i> to only add items once the buffer is full or flushed.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_COUNT_IS_ZERO if count is
+ * zero.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_SIZE_IS_TOO_LARGE if a
+ * buffer of count items would be too large.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_STAGING_IS_ATTACHED if
+ * staging has already been attached.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED if
+ * there is insufficient memory to attach staging.
+ */
+bool octopus_concurrent_linked_queue_attach_staging(
+        struct octopus_concurrent_linked_queue *object,
+        uintmax_t count,
+        const struct timespec *latency);
+
+/**
+ * @brief Stage item to be added to the end of the queue.
+ * <p>The item is copied into the calling thread's buffer. If the buffer is
+ * full, or the latency of the items in it has passed, they are added to the
+ * queue first and should that fail the item is not staged.</p>
+ * @param [in] object queue instance.
+ * @param [in] item to stage.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_ITEM_IS_NULL if item is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_STAGING_IS_NOT_ATTACHED if
+ * staging has not been attached.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED if
+ * there is insufficient memory to set up the calling thread's buffer or to
+ * add the staged items.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_SPILL_FAILED if a spill is
+ * attached and a segment file could not be created.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_FULL if queue is
+ * full.
+ */
+bool octopus_concurrent_linked_queue_stage(
+        struct octopus_concurrent_linked_queue *object,
+        const void *item);
+
+/**
+ * @brief Add the items staged by the calling thread to the queue.
+ * <p>Should only some of them fit in a queue with a capacity, those are
+ * added and the others stay staged.</p>
+ * @param [in] object queue instance.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_STAGING_IS_NOT_ATTACHED if
+ * staging has not been attached.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED if
+ * there is insufficient memory to add the staged items.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_SPILL_FAILED if a spill is
+ * attached and a segment file could not be created.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_FULL if queue is
+ * full.
+ */
+bool octopus_concurrent_linked_queue_flush(
+        struct octopus_concurrent_linked_queue *object);
+
+/**
+ * @brief Combine the operations on each shard.
+ * <p>Rather than each <i>add</i> and <i>remove</i> taking the lock of its
+ * shard in turn, they publish what they are to do in a record belonging to
+ * the calling thread. Whichever thread finds the shard without a combiner
+ * becomes its combiner and carries out every operation published for that
+ * shard in one pass, while the others wait for their record to be marked
+ * done. The shard's nodes then stay in the combiner's cache instead of
+ * moving from thread to thread along with the lock. Probes set with
+ * @ref octopus_concurrent_linked_queue_set_probes are not used by combined
+ * operations.</p>
+ * <p>A thread whose record cannot be allocated takes the shard's lock itself
+ * instead, so <i>add</i> and <i>remove</i> fail for the same reasons as
+ * before.</p>
+ * <p>This must be called before the queue is shared with other threads.</p>
+ * @param [in] object queue instance.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_COMBINING_IS_ATTACHED if
+ * combining has already been attached.
+ * @throws OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED if
+ * there is insufficient memory to attach combining.
+ */
+bool octopus_concurrent_linked_queue_attach_combining(
+        struct octopus_concurrent_linked_queue *object);
+
 #endif /* _OCTOPUS_CONCURRENT_LINKED_QUEUE_H_ */
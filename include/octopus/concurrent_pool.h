@@ -0,0 +1,120 @@
+#ifndef _OCTOPUS_CONCURRENT_POOL_H_
+#define _OCTOPUS_CONCURRENT_POOL_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <octopus/cache_line.h>
+
+#define OCTOPUS_CONCURRENT_POOL_ERROR_OBJECT_IS_NULL                    1
+#define OCTOPUS_CONCURRENT_POOL_ERROR_SIZE_IS_ZERO                      2
+#define OCTOPUS_CONCURRENT_POOL_ERROR_SIZE_IS_TOO_LARGE                 3
+#define OCTOPUS_CONCURRENT_POOL_ERROR_BATCH_IS_ZERO                     4
+#define OCTOPUS_CONCURRENT_POOL_ERROR_MEMORY_ALLOCATION_FAILED          5
+#define OCTOPUS_CONCURRENT_POOL_ERROR_OUT_IS_NULL                       6
+#define OCTOPUS_CONCURRENT_POOL_ERROR_ITEM_IS_NULL                      7
+
+struct octopus_concurrent_pool_cache;
+struct octopus_concurrent_pool_table;
+
+struct octopus_concurrent_pool {
+    size_t size;
+    size_t stride;
+    size_t header;
+    uintmax_t batch;
+    uintmax_t objects;
+    uintmax_t slab;
+    pthread_key_t key;
+    _Atomic(struct octopus_concurrent_pool_table *) table;
+    _Atomic(struct octopus_concurrent_pool_cache *) caches;
+    pthread_mutex_t lock;
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) atomic_uint_least64_t depot;
+};
+
+/**
+ * @brief Initialize concurrent pool.
+ * <p>A pool of fixed size objects. Each thread keeps a cache of free objects
+ * so that allocating and releasing normally only touch thread local state,
+ * objects are handed between the caches a batch at a time through a lock
+ * free global list. Objects are carved from cache line aligned slabs.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] size of the objects handed out by the pool.
+ * @param [in] batch number of objects moved between a thread's cache and the
+ * global list at a time, each cache holds at most twice this many.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_POOL_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_POOL_ERROR_SIZE_IS_ZERO if size is zero.
+ * @throws OCTOPUS_CONCURRENT_POOL_ERROR_SIZE_IS_TOO_LARGE if size or batch
+ * is too large.
+ * @throws OCTOPUS_CONCURRENT_POOL_ERROR_BATCH_IS_ZERO if batch is zero.
+ * @throws OCTOPUS_CONCURRENT_POOL_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to initialize instance.
+ */
+bool octopus_concurrent_pool_init(struct octopus_concurrent_pool *object,
+                                  size_t size,
+                                  uintmax_t batch);
+
+/**
+ * @brief Invalidate concurrent pool.
+ * <p>Every slab is released, including those holding objects which are still
+ * in use. No other thread may be using the pool. The actual <u>concurrent
+ * pool instance is not deallocated</u> since it may have been embedded in a
+ * larger structure.</p>
+ * @param [in] object instance to be invalidated.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_POOL_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ */
+bool octopus_concurrent_pool_invalidate(struct octopus_concurrent_pool *object);
+
+/**
+ * @brief Allocate an object from the pool.
+ * <p>The object is taken from the calling thread's cache, which is refilled
+ * with a batch from the global list or a new slab when it runs dry. The
+ * object starts on a cache line boundary, so it is aligned for any type,
+ * and its contents are undefined.</p>
+ * @param [in] object pool instance.
+ * @param [out] out receive the address of the object.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_POOL_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_POOL_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_POOL_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to allocate an object.
+ */
+bool octopus_concurrent_pool_allocate(struct octopus_concurrent_pool *object,
+                                      void **out);
+
+/**
+ * @brief Release an object back to the pool.
+ * <p>Any thread may release an object, not just the one that allocated it.
+ * It is added to the calling thread's cache and once that holds twice the
+ * batch size a batch is moved over to the global list.</p>
+ * @param [in] object pool instance.
+ * @param [in] item object previously allocated from this pool.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_POOL_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_POOL_ERROR_ITEM_IS_NULL if item is <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_POOL_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to set up the calling thread's cache.
+ */
+bool octopus_concurrent_pool_release(struct octopus_concurrent_pool *object,
+                                     void *item);
+
+/**
+ * @brief Move the objects in the calling thread's cache to the global list.
+ * <p>This happens anyway when the thread exits, a thread that is about to
+ * stop using the pool for a while may call this so that others can have its
+ * objects.</p>
+ * @param [in] object pool instance.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_POOL_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ */
+bool octopus_concurrent_pool_flush(struct octopus_concurrent_pool *object);
+
+#endif /* _OCTOPUS_CONCURRENT_POOL_H_ */
@@ -0,0 +1,298 @@
+#ifndef _OCTOPUS_CONCURRENT_QUEUE_H_
+#define _OCTOPUS_CONCURRENT_QUEUE_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <octopus/cache_line.h>
+#include <octopus/error.h>
+
+#define OCTOPUS_CONCURRENT_QUEUE_ERROR_OBJECT_IS_NULL                   1
+#define OCTOPUS_CONCURRENT_QUEUE_ERROR_CONCURRENCY_IS_ZERO              2
+#define OCTOPUS_CONCURRENT_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED         3
+#define OCTOPUS_CONCURRENT_QUEUE_ERROR_OUT_IS_NULL                      4
+#define OCTOPUS_CONCURRENT_QUEUE_ERROR_QUEUE_IS_EMPTY                   5
+
+/**
+ * @brief Retrieve the number of sub-queues for the given concurrency.
+ * <p>The concurrency is rounded up to the next power of two so that a
+ * sub-queue can be selected from a ticket using a mask.</p>
+ * @param [in] concurrency maximum number of concurrent reads or writes that
+ * can occur.
+ * @param [out] out receive the number of sub-queues.
+ * @return On success true, otherwise false if the number of sub-queues cannot
+ * be represented.
+ */
+static inline bool octopus_concurrent_queue_shards(
+        const uintmax_t concurrency,
+        uintmax_t *const out) {
+    uintmax_t count = 1;
+    while (count < concurrency && count <= (UINTMAX_MAX >> 1)) {
+        count <<= 1;
+    }
+    *out = count;
+    return count >= concurrency;
+}
+
+/**
+ * @brief Check if a dequeue ticket is still within the probe window.
+ * <p>A remove operation probes at most one window of sub-queues starting from
+ * the ticket it was given, the window may wrap around on integer
+ * overflow.</p>
+ * @param [in] begin first ticket of the window.
+ * @param [in] end one past the last ticket of the window.
+ * @param [in] at ticket to check.
+ * @return true if <i>at</i> is within the window, otherwise false.
+ */
+static inline bool octopus_concurrent_queue_in_window(
+        const uintmax_t begin,
+        const uintmax_t end,
+        const uintmax_t at) {
+    return (begin < end && at < end)
+           || ((begin > end && at >= begin) || at < end);
+}
+
+/**
+ * @brief Define a concurrent queue specialized for items of type <i>type</i>.
+ * <p>This uses the same sharding as <i>octopus_concurrent_linked_queue</i> but
+ * items are passed by value and the compiler knows their size, so small
+ * items are moved in registers instead of copied with memcpy.</p>
+ * <p>The following are defined, all are <i>static inline</i>:</p>
+ * <ul>
+ * <li><i>struct name</i></li>
+ * <li><i>bool name_init(struct name *object, uintmax_t concurrency)</i></li>
+ * <li><i>bool name_invalidate(struct name *object,
+ * void (*on_destroy)(type *))</i></li>
+ * <li><i>bool name_concurrency(const struct name *object,
+ * uintmax_t *out)</i></li>
+ * <li><i>bool name_add(struct name *object, type item)</i></li>
+ * <li><i>bool name_remove(struct name *object, type *out)</i></li>
+ * <li><i>bool name_peek(struct name *object, type *out)</i></li>
+ * </ul>
+ * <p>Errors are reported with the <i>OCTOPUS_CONCURRENT_QUEUE_ERROR_</i>
+ * codes.</p>
+ * @param name prefix for the defined structures and functions.
+ * @param type of item to be contained within the queue.
+ */
+#define OCTOPUS_DEFINE_CONCURRENT_QUEUE(name, type)                            \
+                                                                               \
+struct name##_node {                                                           \
+    _Atomic(struct name##_node *) next;                                        \
+    type item;                                                                 \
+};                                                                             \
+                                                                               \
+struct name##_shard {                                                          \
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) pthread_mutex_t dequeue;                 \
+    struct name##_node *head;                                                  \
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) pthread_mutex_t enqueue;                 \
+    struct name##_node *tail;                                                  \
+};                                                                             \
+                                                                               \
+struct name {                                                                  \
+    struct name##_shard *shards;                                               \
+    uintmax_t mask;                                                            \
+    atomic_uintmax_t enqueue;                                                  \
+    atomic_uintmax_t dequeue;                                                  \
+};                                                                             \
+                                                                               \
+static inline bool name##_shard_init(struct name##_shard *const shard) {       \
+    if (!(shard->head = shard->tail = malloc(sizeof(struct name##_node)))) {   \
+        return false;                                                          \
+    }                                                                          \
+    atomic_init(&shard->head->next, NULL);                                     \
+    if (pthread_mutex_init(&shard->dequeue, NULL)) {                           \
+        free(shard->head);                                                     \
+        return false;                                                          \
+    }                                                                          \
+    if (pthread_mutex_init(&shard->enqueue, NULL)) {                           \
+        pthread_mutex_destroy(&shard->dequeue);                                \
+        free(shard->head);                                                     \
+        return false;                                                          \
+    }                                                                          \
+    return true;                                                               \
+}                                                                              \
+                                                                               \
+static inline void name##_shard_invalidate(struct name##_shard *const shard,   \
+                                           void (*const on_destroy)(type *)) { \
+    struct name##_node *node = shard->head;                                    \
+    while (node) {                                                             \
+        struct name##_node *const next = atomic_load(&node->next);             \
+        if (on_destroy && node != shard->head) {                               \
+            on_destroy(&node->item);                                           \
+        }                                                                      \
+        free(node);                                                            \
+        node = next;                                                           \
+    }                                                                          \
+    pthread_mutex_destroy(&shard->enqueue);                                    \
+    pthread_mutex_destroy(&shard->dequeue);                                    \
+}                                                                              \
+                                                                               \
+static inline bool name##_shard_retrieve(struct name##_shard *const shard,     \
+                                         type *const out,                      \
+                                         const bool remove) {                  \
+    pthread_mutex_lock(&shard->dequeue);                                       \
+    struct name##_node *const node = shard->head;                              \
+    struct name##_node *const next = atomic_load_explicit(                     \
+            &node->next, memory_order_acquire);                                \
+    if (!next) {                                                               \
+        pthread_mutex_unlock(&shard->dequeue);                                 \
+        return false;                                                          \
+    }                                                                          \
+    *out = next->item;                                                         \
+    if (remove) {                                                              \
+        shard->head = next;                                                    \
+    }                                                                          \
+    pthread_mutex_unlock(&shard->dequeue);                                     \
+    if (remove) {                                                              \
+        free(node);                                                            \
+    }                                                                          \
+    return true;                                                               \
+}                                                                              \
+                                                                               \
+static inline bool name##_init(struct name *const object,                     \
+                               const uintmax_t concurrency) {                  \
+    if (!object) {                                                             \
+        octopus_error = OCTOPUS_CONCURRENT_QUEUE_ERROR_OBJECT_IS_NULL;         \
+        return false;                                                          \
+    }                                                                          \
+    if (!concurrency) {                                                        \
+        octopus_error = OCTOPUS_CONCURRENT_QUEUE_ERROR_CONCURRENCY_IS_ZERO;    \
+        return false;                                                          \
+    }                                                                          \
+    *object = (struct name) {0};                                               \
+    uintmax_t count;                                                           \
+    if (!octopus_concurrent_queue_shards(concurrency, &count)                  \
+        || count > SIZE_MAX / sizeof(struct name##_shard)                      \
+        || posix_memalign((void **) &object->shards,                           \
+                          OCTOPUS_CACHE_LINE_SIZE,                             \
+                          count * sizeof(struct name##_shard))) {              \
+        *object = (struct name) {0};                                           \
+        octopus_error =                                                        \
+                OCTOPUS_CONCURRENT_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;       \
+        return false;                                                          \
+    }                                                                          \
+    for (uintmax_t i = 0; i < count; i++) {                                    \
+        if (!name##_shard_init(&object->shards[i])) {                          \
+            for (uintmax_t o = 0; o < i; o++) {                                \
+                name##_shard_invalidate(&object->shards[o], NULL);             \
+            }                                                                  \
+            free(object->shards);                                              \
+            *object = (struct name) {0};                                       \
+            octopus_error =                                                    \
+                    OCTOPUS_CONCURRENT_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;   \
+            return false;                                                      \
+        }                                                                      \
+    }                                                                          \
+    object->mask = count - 1;                                                  \
+    return true;                                                               \
+}                                                                              \
+                                                                               \
+static inline bool name##_invalidate(struct name *const object,               \
+                                     void (*const on_destroy)(type *)) {       \
+    if (!object) {                                                             \
+        octopus_error = OCTOPUS_CONCURRENT_QUEUE_ERROR_OBJECT_IS_NULL;         \
+        return false;                                                          \
+    }                                                                          \
+    if (object->shards) {                                                      \
+        for (uintmax_t i = 0; i <= object->mask; i++) {                        \
+            name##_shard_invalidate(&object->shards[i], on_destroy);           \
+        }                                                                      \
+        free(object->shards);                                                  \
+    }                                                                          \
+    *object = (struct name) {0};                                               \
+    return true;                                                               \
+}                                                                              \
+                                                                               \
+static inline bool name##_concurrency(const struct name *const object,        \
+                                      uintmax_t *const out) {                  \
+    if (!object) {                                                             \
+        octopus_error = OCTOPUS_CONCURRENT_QUEUE_ERROR_OBJECT_IS_NULL;         \
+        return false;                                                          \
+    }                                                                          \
+    if (!out) {                                                                \
+        octopus_error = OCTOPUS_CONCURRENT_QUEUE_ERROR_OUT_IS_NULL;            \
+        return false;                                                          \
+    }                                                                          \
+    *out = 1 + object->mask;                                                   \
+    return true;                                                               \
+}                                                                              \
+                                                                               \
+static inline bool name##_add(struct name *const object, const type item) {   \
+    if (!object) {                                                             \
+        octopus_error = OCTOPUS_CONCURRENT_QUEUE_ERROR_OBJECT_IS_NULL;         \
+        return false;                                                          \
+    }                                                                          \
+    struct name##_node *const node = malloc(sizeof(*node));                    \
+    if (!node) {                                                               \
+        octopus_error =                                                        \
+                OCTOPUS_CONCURRENT_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;       \
+        return false;                                                          \
+    }                                                                          \
+    atomic_init(&node->next, NULL);                                            \
+    node->item = item;                                                         \
+    struct name##_shard *const shard = &object->shards[                       \
+            atomic_fetch_add(&object->enqueue, 1) & object->mask];            \
+    pthread_mutex_lock(&shard->enqueue);                                       \
+    atomic_store_explicit(&shard->tail->next, node, memory_order_release);     \
+    shard->tail = node;                                                        \
+    pthread_mutex_unlock(&shard->enqueue);                                     \
+    return true;                                                               \
+}                                                                              \
+                                                                               \
+static inline bool name##_remove(struct name *const object, type *const out) { \
+    if (!object) {                                                             \
+        octopus_error = OCTOPUS_CONCURRENT_QUEUE_ERROR_OBJECT_IS_NULL;         \
+        return false;                                                          \
+    }                                                                          \
+    if (!out) {                                                                \
+        octopus_error = OCTOPUS_CONCURRENT_QUEUE_ERROR_OUT_IS_NULL;            \
+        return false;                                                          \
+    }                                                                          \
+    const uintmax_t begin = atomic_fetch_add(&object->dequeue, 1);             \
+    const uintmax_t end = begin + 1 + object->mask; /* allow overflow */       \
+    uintmax_t at = begin;                                                      \
+    while (octopus_concurrent_queue_in_window(begin, end, at)) {               \
+        if (name##_shard_retrieve(&object->shards[at & object->mask],         \
+                                  out, true)) {                                \
+            return true;                                                       \
+        }                                                                      \
+        at = atomic_fetch_add(&object->dequeue, 1);                            \
+    }                                                                          \
+    if (name##_shard_retrieve(&object->shards[at & object->mask],             \
+                              out, true)) {                                    \
+        return true;                                                           \
+    }                                                                          \
+    octopus_error = OCTOPUS_CONCURRENT_QUEUE_ERROR_QUEUE_IS_EMPTY;             \
+    return false;                                                              \
+}                                                                              \
+                                                                               \
+static inline bool name##_peek(struct name *const object, type *const out) {   \
+    if (!object) {                                                             \
+        octopus_error = OCTOPUS_CONCURRENT_QUEUE_ERROR_OBJECT_IS_NULL;         \
+        return false;                                                          \
+    }                                                                          \
+    if (!out) {                                                                \
+        octopus_error = OCTOPUS_CONCURRENT_QUEUE_ERROR_OUT_IS_NULL;            \
+        return false;                                                          \
+    }                                                                          \
+    const uintmax_t begin = atomic_load(&object->dequeue);                     \
+    const uintmax_t end = begin + 1 + object->mask; /* allow overflow */       \
+    uintmax_t at = begin;                                                      \
+    for (; octopus_concurrent_queue_in_window(begin, end, at); at++) {         \
+        if (name##_shard_retrieve(&object->shards[at & object->mask],         \
+                                  out, false)) {                               \
+            return true;                                                       \
+        }                                                                      \
+    }                                                                          \
+    if (name##_shard_retrieve(&object->shards[at & object->mask],             \
+                              out, false)) {                                   \
+        return true;                                                           \
+    }                                                                          \
+    octopus_error = OCTOPUS_CONCURRENT_QUEUE_ERROR_QUEUE_IS_EMPTY;             \
+    return false;                                                              \
+}
+
+#endif /* _OCTOPUS_CONCURRENT_QUEUE_H_ */
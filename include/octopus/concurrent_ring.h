@@ -0,0 +1,196 @@
+#ifndef _OCTOPUS_CONCURRENT_RING_H_
+#define _OCTOPUS_CONCURRENT_RING_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <octopus/cache_line.h>
+
+#define OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL                    1
+#define OCTOPUS_CONCURRENT_RING_ERROR_SIZE_IS_ZERO                      2
+#define OCTOPUS_CONCURRENT_RING_ERROR_SIZE_IS_TOO_LARGE                 3
+#define OCTOPUS_CONCURRENT_RING_ERROR_CAPACITY_IS_ZERO                  4
+#define OCTOPUS_CONCURRENT_RING_ERROR_WAIT_IS_INVALID                   5
+#define OCTOPUS_CONCURRENT_RING_ERROR_MEMORY_ALLOCATION_FAILED          6
+#define OCTOPUS_CONCURRENT_RING_ERROR_ITEM_IS_NULL                      7
+#define OCTOPUS_CONCURRENT_RING_ERROR_RING_IS_FULL                      8
+#define OCTOPUS_CONCURRENT_RING_ERROR_RING_IS_NULL                      9
+#define OCTOPUS_CONCURRENT_RING_ERROR_DEPENDENCIES_IS_NULL              10
+#define OCTOPUS_CONCURRENT_RING_ERROR_DEPENDENCY_IS_INVALID             11
+#define OCTOPUS_CONCURRENT_RING_ERROR_OUT_IS_NULL                       12
+#define OCTOPUS_CONCURRENT_RING_ERROR_NOTHING_IS_AVAILABLE              13
+
+/* spin on the cursors, lowest latency at the cost of a busy core */
+#define OCTOPUS_CONCURRENT_RING_WAIT_BUSY_SPIN                          0
+/* give up the processor between checks of the cursors */
+#define OCTOPUS_CONCURRENT_RING_WAIT_YIELD                              1
+/* sleep on a condition variable until woken up */
+#define OCTOPUS_CONCURRENT_RING_WAIT_BLOCK                              2
+
+struct octopus_concurrent_ring_consumer;
+
+struct octopus_concurrent_ring {
+    unsigned char *items;
+    atomic_uintmax_t *published;
+    struct octopus_concurrent_ring_consumer *consumers;
+    size_t size;
+    uintmax_t mask;
+    int wait;
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) atomic_uintmax_t claim;
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) atomic_uintmax_t gate;
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) atomic_uintmax_t waiters;
+    pthread_mutex_t lock;
+    pthread_cond_t condition;
+};
+
+struct octopus_concurrent_ring_consumer {
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) atomic_uintmax_t cursor;
+    uintmax_t available;
+    struct octopus_concurrent_ring *ring;
+    struct octopus_concurrent_ring_consumer **dependencies;
+    uintmax_t count;
+    struct octopus_concurrent_ring_consumer *next;
+};
+
+/**
+ * @brief Initialize concurrent ring.
+ * <p>A bounded ring of items in which every registered consumer sees every
+ * published item. Producers claim the next sequence and each consumer moves
+ * its own cursor along the ring, so a single write serves all of them.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] size of item to be contained within the ring.
+ * @param [in] capacity number of items the ring can hold, this will be
+ * rounded up to the next power of two.
+ * @param [in] wait strategy used by producers waiting for space and
+ * consumers waiting for items, one of the OCTOPUS_CONCURRENT_RING_WAIT_*
+ * values.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_SIZE_IS_ZERO if size is zero.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_SIZE_IS_TOO_LARGE if size or
+ * capacity is too large.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_CAPACITY_IS_ZERO if capacity is zero.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_WAIT_IS_INVALID if wait is not a
+ * known wait strategy.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to initialize instance.
+ */
+bool octopus_concurrent_ring_init(struct octopus_concurrent_ring *object,
+                                  size_t size,
+                                  uintmax_t capacity,
+                                  int wait);
+
+/**
+ * @brief Invalidate concurrent ring.
+ * <p>All consumers must have been invalidated beforehand. The actual
+ * <u>concurrent ring instance is not deallocated</u> since it may have been
+ * embedded in a larger structure.</p>
+ * @param [in] object instance to be invalidated.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ */
+bool octopus_concurrent_ring_invalidate(struct octopus_concurrent_ring *object);
+
+/**
+ * @brief Publish item to every consumer.
+ * <p>If the slowest consumer is a whole ring behind then we will wait, using
+ * the ring's wait strategy, until it has moved on.</p>
+ * @param [in] object ring instance.
+ * @param [in] item to publish.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_ITEM_IS_NULL if item is <i>NULL</i>.
+ */
+bool octopus_concurrent_ring_publish(struct octopus_concurrent_ring *object,
+                                     const void *item);
+
+/**
+ * @brief Publish item to every consumer if there is space.
+ * @param [in] object ring instance.
+ * @param [in] item to publish.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_ITEM_IS_NULL if item is <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_RING_IS_FULL if the slowest consumer
+ * is a whole ring behind.
+ */
+bool octopus_concurrent_ring_try_publish(struct octopus_concurrent_ring *object,
+                                         const void *item);
+
+/**
+ * @brief Initialize and register consumer.
+ * <p>The consumer sees every item that is published from now on. If it has
+ * dependencies it will only see an item after each of them has consumed it,
+ * which allows consumers to be arranged in stages.</p>
+ * @param [in] object consumer instance to be initialized.
+ * @param [in] ring to consume from.
+ * @param [in] dependencies consumers of the same ring that must consume an
+ * item before this one does, <i>NULL</i> if count is zero.
+ * @param [in] count number of dependencies.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_RING_IS_NULL if ring is <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_DEPENDENCIES_IS_NULL if dependencies
+ * is <i>NULL</i> while count is not zero.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_DEPENDENCY_IS_INVALID if a dependency
+ * is <i>NULL</i> or belongs to another ring.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to initialize instance.
+ */
+bool octopus_concurrent_ring_consumer_init(
+        struct octopus_concurrent_ring_consumer *object,
+        struct octopus_concurrent_ring *ring,
+        struct octopus_concurrent_ring_consumer *const *dependencies,
+        uintmax_t count);
+
+/**
+ * @brief Unregister and invalidate consumer.
+ * <p>Producers no longer wait on this consumer. Consumers that depend on it
+ * must have been invalidated beforehand.</p>
+ * @param [in] object consumer instance to be invalidated.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ */
+bool octopus_concurrent_ring_consumer_invalidate(
+        struct octopus_concurrent_ring_consumer *object);
+
+/**
+ * @brief Consume the next item if it is available.
+ * <p>A consumer must only be used by one thread at a time.</p>
+ * @param [in] object consumer instance.
+ * @param [out] out receive the next item.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_NOTHING_IS_AVAILABLE if the next item
+ * has not been published yet or a dependency has yet to consume it.
+ */
+bool octopus_concurrent_ring_consumer_poll(
+        struct octopus_concurrent_ring_consumer *object,
+        void **out);
+
+/**
+ * @brief Consume the next item, waiting until it is available.
+ * <p>A consumer must only be used by one thread at a time. Waiting is done
+ * using the ring's wait strategy.</p>
+ * @param [in] object consumer instance.
+ * @param [out] out receive the next item.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_RING_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ */
+bool octopus_concurrent_ring_consumer_take(
+        struct octopus_concurrent_ring_consumer *object,
+        void **out);
+
+#endif /* _OCTOPUS_CONCURRENT_RING_H_ */
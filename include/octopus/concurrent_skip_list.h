@@ -0,0 +1,169 @@
+#ifndef _OCTOPUS_CONCURRENT_SKIP_LIST_H_
+#define _OCTOPUS_CONCURRENT_SKIP_LIST_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#define OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OBJECT_IS_NULL               1
+#define OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_SIZE_IS_ZERO             2
+#define OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_SIZE_IS_TOO_LARGE            3
+#define OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_COMPARE_IS_NULL              4
+#define OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_MEMORY_ALLOCATION_FAILED     5
+#define OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_IS_NULL                  6
+#define OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_VALUE_IS_NULL                7
+#define OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OUT_IS_NULL                  8
+#define OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_FUNC_IS_NULL                 9
+#define OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_ALREADY_EXISTS           10
+#define OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_NOT_FOUND                11
+
+struct octopus_concurrent_skip_list_node;
+
+struct octopus_concurrent_skip_list {
+    struct octopus_concurrent_skip_list_node *head;
+    int (*compare)(const void *first, const void *second);
+    size_t key;
+    size_t value;
+    size_t next;
+    atomic_uintmax_t height;
+};
+
+/**
+ * @brief Initialize concurrent skip list.
+ * <p>The skip list is an ordered map where insert, remove and lookups do not
+ * take any locks. Each entry is kept in a single allocation with the key
+ * immediately followed by its tower of next pointers so that a search
+ * touches as few cache lines as possible.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] key size of the keys.
+ * @param [in] value size of the values, may be zero for a set.
+ * @param [in] compare orders the keys, returns a negative number, zero or a
+ * positive number if first is less than, equal to or greater than second.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_SIZE_IS_ZERO if key is zero.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_SIZE_IS_TOO_LARGE if key or
+ * value is too large.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_COMPARE_IS_NULL if compare is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_MEMORY_ALLOCATION_FAILED if there
+ * is insufficient memory to initialize instance.
+ */
+bool octopus_concurrent_skip_list_init(
+        struct octopus_concurrent_skip_list *object,
+        size_t key,
+        size_t value,
+        int (*compare)(const void *first, const void *second));
+
+/**
+ * @brief Invalidate concurrent skip list.
+ * <p>All the entries contained within the skip list will have the given
+ * <i>on destroy</i> callback invoked upon them. The actual <u>concurrent
+ * skip list instance is not deallocated</u> since it may have been embedded
+ * in a larger structure.</p>
+ * @param [in] object instance to be invalidated.
+ * @param [in] on_destroy called just before the entry is to be destroyed.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ */
+bool octopus_concurrent_skip_list_invalidate(
+        struct octopus_concurrent_skip_list *object,
+        void (*on_destroy)(void *key, void *value));
+
+/**
+ * @brief Insert an entry.
+ * @param [in] object skip list instance.
+ * @param [in] key of the entry.
+ * @param [in] value of the entry, ignored if the value size is zero.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_IS_NULL if key is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_VALUE_IS_NULL if value is
+ * <i>NULL</i> and the value size is not zero.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_ALREADY_EXISTS if there is
+ * already an entry for key.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_MEMORY_ALLOCATION_FAILED if there
+ * is insufficient memory to insert the entry.
+ */
+bool octopus_concurrent_skip_list_insert(
+        struct octopus_concurrent_skip_list *object,
+        const void *key,
+        const void *value);
+
+/**
+ * @brief Remove an entry.
+ * @param [in] object skip list instance.
+ * @param [in] key of the entry.
+ * @param [out] out receive the value of the removed entry, may be
+ * <i>NULL</i>.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_IS_NULL if key is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_NOT_FOUND if there is no
+ * entry for key.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_MEMORY_ALLOCATION_FAILED if there
+ * is insufficient memory to register the calling thread.
+ */
+bool octopus_concurrent_skip_list_remove(
+        struct octopus_concurrent_skip_list *object,
+        const void *key,
+        void **out);
+
+/**
+ * @brief Retrieve the value of an entry.
+ * @param [in] object skip list instance.
+ * @param [in] key of the entry.
+ * @param [out] out receive the value of the entry.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_IS_NULL if key is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OUT_IS_NULL if out is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_NOT_FOUND if there is no
+ * entry for key.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_MEMORY_ALLOCATION_FAILED if there
+ * is insufficient memory to register the calling thread.
+ */
+bool octopus_concurrent_skip_list_get(
+        struct octopus_concurrent_skip_list *object,
+        const void *key,
+        void **out);
+
+/**
+ * @brief Visit the entries within a range in ascending key order.
+ * <p>The range is weakly consistent, every entry that is present for the
+ * whole of the iteration is visited exactly once while entries inserted or
+ * removed concurrently may or may not be visited. The key and value given to
+ * <i>func</i> remain valid until it returns.</p>
+ * @param [in] object skip list instance.
+ * @param [in] first inclusive lower bound, <i>NULL</i> to start from the
+ * smallest key.
+ * @param [in] last exclusive upper bound, <i>NULL</i> to continue to the
+ * largest key.
+ * @param [in] func called for each entry, return false to stop.
+ * @param [in] arg passed through to func.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_FUNC_IS_NULL if func is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_MEMORY_ALLOCATION_FAILED if there
+ * is insufficient memory to register the calling thread.
+ */
+bool octopus_concurrent_skip_list_range(
+        struct octopus_concurrent_skip_list *object,
+        const void *first,
+        const void *last,
+        bool (*func)(const void *key, const void *value, void *arg),
+        void *arg);
+
+#endif /* _OCTOPUS_CONCURRENT_SKIP_LIST_H_ */
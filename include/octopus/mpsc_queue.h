@@ -0,0 +1,118 @@
+#ifndef _OCTOPUS_MPSC_QUEUE_H_
+#define _OCTOPUS_MPSC_QUEUE_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <octopus/cache_line.h>
+
+#define OCTOPUS_MPSC_QUEUE_ERROR_OBJECT_IS_NULL                         1
+#define OCTOPUS_MPSC_QUEUE_ERROR_SIZE_IS_ZERO                           2
+#define OCTOPUS_MPSC_QUEUE_ERROR_SIZE_IS_TOO_LARGE                      3
+#define OCTOPUS_MPSC_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED               4
+#define OCTOPUS_MPSC_QUEUE_ERROR_ITEM_IS_NULL                           5
+#define OCTOPUS_MPSC_QUEUE_ERROR_OUT_IS_NULL                            6
+#define OCTOPUS_MPSC_QUEUE_ERROR_QUEUE_IS_EMPTY                         7
+
+struct octopus_mpsc_queue_node;
+
+struct octopus_mpsc_queue {
+    size_t size;
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE)
+    _Atomic(struct octopus_mpsc_queue_node *) head;
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) struct octopus_mpsc_queue_node *tail;
+};
+
+/**
+ * @brief Initialize multiple producer single consumer queue.
+ * <p>Any number of threads may add items but only a single thread at a time
+ * may remove them, as is the case for an actor's mailbox. Adding is a single
+ * atomic exchange and so never waits for other producers, while removing
+ * needs no atomic read-modify-write instructions at all.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] size of item to be contained within the queue.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_MPSC_QUEUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_MPSC_QUEUE_ERROR_SIZE_IS_ZERO if size is zero.
+ * @throws OCTOPUS_MPSC_QUEUE_ERROR_SIZE_IS_TOO_LARGE if size is too large.
+ * @throws OCTOPUS_MPSC_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to initialize instance.
+ */
+bool octopus_mpsc_queue_init(struct octopus_mpsc_queue *object, size_t size);
+
+/**
+ * @brief Invalidate multiple producer single consumer queue.
+ * <p>All the items contained within the queue will have the given <i>on
+ * destroy</i> callback invoked upon itself. The actual <u>queue instance is
+ * not deallocated</u> since it may have been embedded in a larger
+ * structure.</p>
+ * @param [in] object instance to be invalidated.
+ * @param [in] on_destroy called just before the item is to be destroyed.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_MPSC_QUEUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ */
+bool octopus_mpsc_queue_invalidate(struct octopus_mpsc_queue *object,
+                                   void (*on_destroy)(void *));
+
+/**
+ * @brief Add item to the queue.
+ * <p>May be called by any number of threads at once.</p>
+ * @param [in] object queue instance.
+ * @param [in] item to add.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_MPSC_QUEUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_MPSC_QUEUE_ERROR_ITEM_IS_NULL if item is <i>NULL</i>.
+ * @throws OCTOPUS_MPSC_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to add item.
+ */
+bool octopus_mpsc_queue_add(struct octopus_mpsc_queue *object,
+                            const void *item);
+
+/**
+ * @brief Remove the oldest item from the queue.
+ * <p>Must only be called by a single thread at a time. Items are removed in
+ * the order they were added, an item whose add has not yet returned may not
+ * be seen yet.</p>
+ * @param [in] object queue instance.
+ * @param [out] out receive the oldest item.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_MPSC_QUEUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_MPSC_QUEUE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws OCTOPUS_MPSC_QUEUE_ERROR_QUEUE_IS_EMPTY if queue is empty.
+ */
+bool octopus_mpsc_queue_remove(struct octopus_mpsc_queue *object, void **out);
+
+/**
+ * @brief Remove up to count of the oldest items from the queue.
+ * <p>Must only be called by a single thread at a time.</p>
+ * @param [in] object queue instance.
+ * @param [out] out array of at least count items to receive the oldest
+ * items in order.
+ * @param [in] count maximum number of items to remove.
+ * @param [out] removed receive the number of items removed.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_MPSC_QUEUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_MPSC_QUEUE_ERROR_OUT_IS_NULL if out or removed is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_MPSC_QUEUE_ERROR_QUEUE_IS_EMPTY if queue is empty or
+ * count is zero.
+ */
+bool octopus_mpsc_queue_remove_batch(struct octopus_mpsc_queue *object,
+                                     void *out,
+                                     uintmax_t count,
+                                     uintmax_t *removed);
+
+/**
+ * @brief Retrieve the oldest item from the queue without removing it.
+ * <p>Must only be called by the thread that removes items.</p>
+ * @param [in] object queue instance.
+ * @param [out] out receive the oldest item.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_MPSC_QUEUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_MPSC_QUEUE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws OCTOPUS_MPSC_QUEUE_ERROR_QUEUE_IS_EMPTY if queue is empty.
+ */
+bool octopus_mpsc_queue_peek(struct octopus_mpsc_queue *object, void **out);
+
+#endif /* _OCTOPUS_MPSC_QUEUE_H_ */
@@ -0,0 +1,200 @@
+#ifndef _OCTOPUS_RCU_H_
+#define _OCTOPUS_RCU_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <octopus/cache_line.h>
+
+#define OCTOPUS_RCU_ERROR_OBJECT_IS_NULL                                1
+#define OCTOPUS_RCU_ERROR_MEMORY_ALLOCATION_FAILED                      2
+#define OCTOPUS_RCU_ERROR_OUT_IS_NULL                                   3
+#define OCTOPUS_RCU_ERROR_READER_IS_NULL                                4
+#define OCTOPUS_RCU_ERROR_READER_IS_ACTIVE                              5
+#define OCTOPUS_RCU_ERROR_READER_IS_NOT_ACTIVE                          6
+#define OCTOPUS_RCU_ERROR_HEAD_IS_NULL                                  7
+#define OCTOPUS_RCU_ERROR_FUNC_IS_NULL                                  8
+
+struct octopus_rcu;
+
+/* registered by each thread which reads from the rcu, only that thread may
+ * use it */
+struct octopus_rcu_reader {
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) atomic_uintmax_t state;
+    uintmax_t depth;
+    struct octopus_rcu *rcu;
+    struct octopus_rcu_reader *next;
+    atomic_bool used;
+};
+
+/* embedded in memory whose release has been deferred */
+struct octopus_rcu_head {
+    struct octopus_rcu_head *next;
+    void (*func)(struct octopus_rcu_head *);
+    uintmax_t grace;
+};
+
+struct octopus_rcu {
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) _Atomic(void *) pointer;
+    atomic_uintmax_t grace;
+    bool expedited;
+    _Atomic(struct octopus_rcu_reader *) readers;
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) pthread_mutex_t lock;
+    struct octopus_rcu_head *first;
+    struct octopus_rcu_head *last;
+};
+
+/**
+ * @brief Initialize rcu.
+ * <p>Publishes a pointer to threads which read it far more often than it is
+ * replaced. Readers do not write to any memory shared with other threads,
+ * they only record in their own cache line that they are reading. A writer
+ * replaces the pointer and then either waits for the readers which may
+ * still be using the previous version or defers its release until they
+ * have moved on.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] pointer first version to publish, may be <i>NULL</i>.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_RCU_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_RCU_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to initialize instance.
+ */
+bool octopus_rcu_init(struct octopus_rcu *object, void *pointer);
+
+/**
+ * @brief Invalidate rcu.
+ * <p>Every deferred release is carried out and the published pointer has
+ * the given <i>on destroy</i> callback invoked upon it. Readers which are
+ * still registered are unregistered, none of them may be reading. The
+ * actual <u>rcu instance is not deallocated</u> since it may have been
+ * embedded in a larger structure.</p>
+ * @param [in] object instance to be invalidated.
+ * @param [in] on_destroy called with the published pointer if it is not
+ * <i>NULL</i>.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_RCU_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ */
+bool octopus_rcu_invalidate(struct octopus_rcu *object,
+                            void (*on_destroy)(void *));
+
+/**
+ * @brief Register the calling thread as a reader.
+ * <p>Each thread registers once and keeps the reader for as long as it
+ * reads from the rcu.</p>
+ * @param [in] object rcu instance.
+ * @param [out] out receive the reader.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_RCU_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_RCU_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws OCTOPUS_RCU_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to register the reader.
+ */
+bool octopus_rcu_register(struct octopus_rcu *object,
+                          struct octopus_rcu_reader **out);
+
+/**
+ * @brief Unregister a reader.
+ * @param [in] object rcu instance.
+ * @param [in] reader to unregister, it must not be used afterwards.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_RCU_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_RCU_ERROR_READER_IS_NULL if reader is <i>NULL</i>.
+ * @throws OCTOPUS_RCU_ERROR_READER_IS_ACTIVE if reader is inside a read-side
+ * critical section.
+ */
+bool octopus_rcu_unregister(struct octopus_rcu *object,
+                            struct octopus_rcu_reader *reader);
+
+/**
+ * @brief Enter a read-side critical section.
+ * <p>Any version read inside the critical section remains valid until it is
+ * left. Critical sections may be nested, they must not wait on a writer of
+ * the same rcu.</p>
+ * @param [in] reader registered by the calling thread.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_RCU_ERROR_READER_IS_NULL if reader is <i>NULL</i>.
+ */
+bool octopus_rcu_read_lock(struct octopus_rcu_reader *reader);
+
+/**
+ * @brief Leave a read-side critical section.
+ * @param [in] reader registered by the calling thread.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_RCU_ERROR_READER_IS_NULL if reader is <i>NULL</i>.
+ * @throws OCTOPUS_RCU_ERROR_READER_IS_NOT_ACTIVE if reader is not inside a
+ * read-side critical section.
+ */
+bool octopus_rcu_read_unlock(struct octopus_rcu_reader *reader);
+
+/**
+ * @brief Retrieve the published pointer.
+ * @param [in] reader registered by the calling thread.
+ * @param [out] out receive the published pointer.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_RCU_ERROR_READER_IS_NULL if reader is <i>NULL</i>.
+ * @throws OCTOPUS_RCU_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws OCTOPUS_RCU_ERROR_READER_IS_NOT_ACTIVE if reader is not inside a
+ * read-side critical section.
+ */
+bool octopus_rcu_dereference(struct octopus_rcu_reader *reader, void **out);
+
+/**
+ * @brief Publish a new version of the pointer.
+ * <p>Readers entering a critical section from now on see the new version.
+ * The previous version must not be released until a grace period has
+ * passed, see <i>octopus_rcu_synchronize</i> and
+ * <i>octopus_rcu_defer</i>.</p>
+ * @param [in] object rcu instance.
+ * @param [in] pointer new version to publish, may be <i>NULL</i>.
+ * @param [out] out receive the previous version.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_RCU_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_RCU_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ */
+bool octopus_rcu_publish(struct octopus_rcu *object,
+                         void *pointer,
+                         void **out);
+
+/**
+ * @brief Wait for a grace period.
+ * <p>Returns once every reader that was inside a critical section when this
+ * was called has left it, after which nobody can still be using a version
+ * replaced before the call. Must not be called from inside a critical
+ * section.</p>
+ * @param [in] object rcu instance.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_RCU_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ */
+bool octopus_rcu_synchronize(struct octopus_rcu *object);
+
+/**
+ * @brief Defer a release until after a grace period.
+ * <p>The <i>func</i> callback is invoked once every reader that was inside
+ * a critical section when this was called has left it. It is invoked by a
+ * later call to this function, <i>octopus_rcu_barrier</i> or
+ * <i>octopus_rcu_invalidate</i>, on whichever thread made that call. This
+ * never waits for readers.</p>
+ * @param [in] object rcu instance.
+ * @param [in] head embedded in the memory to release.
+ * @param [in] func called to release the memory.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_RCU_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_RCU_ERROR_HEAD_IS_NULL if head is <i>NULL</i>.
+ * @throws OCTOPUS_RCU_ERROR_FUNC_IS_NULL if func is <i>NULL</i>.
+ */
+bool octopus_rcu_defer(struct octopus_rcu *object,
+                       struct octopus_rcu_head *head,
+                       void (*func)(struct octopus_rcu_head *));
+
+/**
+ * @brief Wait for every deferred release to be carried out.
+ * <p>Must not be called from inside a critical section.</p>
+ * @param [in] object rcu instance.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_RCU_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ */
+bool octopus_rcu_barrier(struct octopus_rcu *object);
+
+#endif /* _OCTOPUS_RCU_H_ */
@@ -0,0 +1,104 @@
+#ifndef _OCTOPUS_RWLOCK_H_
+#define _OCTOPUS_RWLOCK_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <octopus/cache_line.h>
+
+#define OCTOPUS_RWLOCK_ERROR_OBJECT_IS_NULL                             1
+#define OCTOPUS_RWLOCK_ERROR_CONCURRENCY_IS_ZERO                        2
+#define OCTOPUS_RWLOCK_ERROR_MEMORY_ALLOCATION_FAILED                   3
+#define OCTOPUS_RWLOCK_ERROR_LOCK_IS_NOT_HELD                           4
+
+struct octopus_rwlock_slot;
+
+struct octopus_rwlock {
+    struct octopus_rwlock_slot *slots;
+    uintmax_t mask;
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) atomic_bool writer;
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) pthread_mutex_t lock;
+    pthread_cond_t readable;
+    pthread_cond_t writable;
+    uintmax_t waiting;
+    bool held;
+};
+
+/**
+ * @brief Initialize rwlock.
+ * <p>A reader-writer lock for read-heavy paths. Rather than every reader
+ * updating one shared count, each thread counts itself in one of a number
+ * of cache line sized slots, so readers on different cores do not contend
+ * with each other. Writers are preferred, once a writer is waiting no new
+ * reader gets in and the writer only waits for the readers which were
+ * already holding the lock.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] concurrency number of reader slots, this will be rounded up
+ * to the next power of two.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_RWLOCK_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_RWLOCK_ERROR_CONCURRENCY_IS_ZERO if concurrency is zero.
+ * @throws OCTOPUS_RWLOCK_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to initialize instance.
+ */
+bool octopus_rwlock_init(struct octopus_rwlock *object,
+                         uintmax_t concurrency);
+
+/**
+ * @brief Invalidate rwlock.
+ * <p>No thread may be holding or waiting for the lock. The actual
+ * <u>rwlock instance is not deallocated</u> since it may have been embedded
+ * in a larger structure.</p>
+ * @param [in] object instance to be invalidated.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_RWLOCK_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ */
+bool octopus_rwlock_invalidate(struct octopus_rwlock *object);
+
+/**
+ * @brief Acquire the lock for reading.
+ * <p>Waits for as long as a writer holds or is waiting for the lock. The
+ * lock must be released by the same thread and may not be acquired for
+ * reading again by a thread that already holds it, as a writer waiting in
+ * between would wait for that thread while it waits for the writer.</p>
+ * @param [in] object rwlock instance.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_RWLOCK_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ */
+bool octopus_rwlock_read_lock(struct octopus_rwlock *object);
+
+/**
+ * @brief Release the lock held for reading by the calling thread.
+ * @param [in] object rwlock instance.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_RWLOCK_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_RWLOCK_ERROR_LOCK_IS_NOT_HELD if no thread counted in the
+ * calling thread's slot holds the lock for reading.
+ */
+bool octopus_rwlock_read_unlock(struct octopus_rwlock *object);
+
+/**
+ * @brief Acquire the lock for writing.
+ * <p>Waits for the writers before it, then stops new readers from getting
+ * in and waits for those already holding the lock to release it. Writers
+ * waiting when the lock is released get it before any reader does, so a
+ * steady stream of writers keeps readers waiting.</p>
+ * @param [in] object rwlock instance.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_RWLOCK_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ */
+bool octopus_rwlock_write_lock(struct octopus_rwlock *object);
+
+/**
+ * @brief Release the lock held for writing.
+ * @param [in] object rwlock instance.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_RWLOCK_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_RWLOCK_ERROR_LOCK_IS_NOT_HELD if the lock is not held for
+ * writing.
+ */
+bool octopus_rwlock_write_unlock(struct octopus_rwlock *object);
+
+#endif /* _OCTOPUS_RWLOCK_H_ */
@@ -0,0 +1,93 @@
+#ifndef _OCTOPUS_SELECT_H_
+#define _OCTOPUS_SELECT_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+
+#define OCTOPUS_SELECT_ERROR_OBJECT_IS_NULL                             1
+#define OCTOPUS_SELECT_ERROR_QUEUES_IS_NULL                             2
+#define OCTOPUS_SELECT_ERROR_COUNT_IS_ZERO                              3
+#define OCTOPUS_SELECT_ERROR_MEMORY_ALLOCATION_FAILED                   4
+#define OCTOPUS_SELECT_ERROR_AT_IS_NULL                                 5
+#define OCTOPUS_SELECT_ERROR_OUT_IS_NULL                                6
+#define OCTOPUS_SELECT_ERROR_TIMED_OUT                                  7
+#define OCTOPUS_SELECT_ERROR_TIMEOUT_IS_INVALID                         8
+
+struct octopus_concurrent_linked_queue;
+struct octopus_select;
+
+struct octopus_select_entry {
+    struct octopus_select_entry *prev;
+    struct octopus_select_entry *next;
+    struct octopus_select *select;
+};
+
+struct octopus_select {
+    struct octopus_concurrent_linked_queue **queues;
+    struct octopus_select_entry *entries;
+    uintmax_t count;
+    uintmax_t next;
+    bool priority;
+    bool signalled;
+    pthread_mutex_t lock;
+    pthread_cond_t condition;
+};
+
+/**
+ * @brief Initialize select.
+ * <p>A select waits on a number of queues at once, it is meant to be used by
+ * a single consumer thread. Several selects may wait on the same queue.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] queues to wait upon, these must outlive the select.
+ * @param [in] count number of queues.
+ * @param [in] priority if true queues earlier in <i>queues</i> are always
+ * preferred, otherwise the queues are taken from in turn.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_SELECT_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_SELECT_ERROR_QUEUES_IS_NULL if queues is <i>NULL</i>.
+ * @throws OCTOPUS_SELECT_ERROR_COUNT_IS_ZERO if count is zero.
+ * @throws OCTOPUS_SELECT_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to initialize instance.
+ */
+bool octopus_select_init(struct octopus_select *object,
+                         struct octopus_concurrent_linked_queue *const *queues,
+                         uintmax_t count,
+                         bool priority);
+
+/**
+ * @brief Invalidate select.
+ * <p>The queues are not invalidated.</p>
+ * @param [in] object instance to be invalidated.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_SELECT_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ */
+bool octopus_select_invalidate(struct octopus_select *object);
+
+/**
+ * @brief Remove an item from the first of the queues to have one.
+ * <p>If all the queues are empty the calling thread will wait until an item
+ * is added to any of them, measured against the monotonic clock. Producers
+ * only pay for a wake up while a select is actually waiting.</p>
+ * @param [in] object select instance.
+ * @param [in] timeout maximum time to wait for, <i>NULL</i> to wait
+ * indefinitely.
+ * @param [out] at receive the index of the queue the item was removed from.
+ * @param [out] out receive the item.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_SELECT_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_SELECT_ERROR_AT_IS_NULL if at is <i>NULL</i>.
+ * @throws OCTOPUS_SELECT_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws OCTOPUS_SELECT_ERROR_TIMEOUT_IS_INVALID if timeout is negative or
+ * has a nanosecond part of a second or more.
+ * @throws OCTOPUS_SELECT_ERROR_TIMED_OUT if no item was added to any of the
+ * queues before the timeout elapsed.
+ */
+bool octopus_select_remove(struct octopus_select *object,
+                           const struct timespec *timeout,
+                           uintmax_t *at,
+                           void **out);
+
+#endif /* _OCTOPUS_SELECT_H_ */
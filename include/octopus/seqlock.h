@@ -0,0 +1,90 @@
+#ifndef _OCTOPUS_SEQLOCK_H_
+#define _OCTOPUS_SEQLOCK_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <octopus/cache_line.h>
+
+#define OCTOPUS_SEQLOCK_ERROR_OBJECT_IS_NULL                            1
+#define OCTOPUS_SEQLOCK_ERROR_SIZE_IS_ZERO                              2
+#define OCTOPUS_SEQLOCK_ERROR_SIZE_IS_TOO_LARGE                         3
+#define OCTOPUS_SEQLOCK_ERROR_MEMORY_ALLOCATION_FAILED                  4
+#define OCTOPUS_SEQLOCK_ERROR_OUT_IS_NULL                               5
+#define OCTOPUS_SEQLOCK_ERROR_VALUE_IS_NULL                             6
+
+struct octopus_seqlock {
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) atomic_uintmax_t sequence;
+    size_t size;
+    atomic_uintmax_t *words;
+};
+
+/**
+ * @brief Initialize seqlock.
+ * <p>Holds a value of a fixed size which one thread writes and any number
+ * of threads read. Writing makes the sequence odd, stores the value and then
+ * makes the sequence even again. Readers copy the value out between two
+ * reads of the sequence and retry if it was odd or has changed, so they
+ * never write to memory shared with other threads nor hold up the writer.
+ * The value starts out as all zero bytes.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] size of the value in bytes.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_SEQLOCK_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_SEQLOCK_ERROR_SIZE_IS_ZERO if size is zero.
+ * @throws OCTOPUS_SEQLOCK_ERROR_SIZE_IS_TOO_LARGE if size is too large.
+ * @throws OCTOPUS_SEQLOCK_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to initialize instance.
+ */
+bool octopus_seqlock_init(struct octopus_seqlock *object, size_t size);
+
+/**
+ * @brief Invalidate seqlock.
+ * <p>No other thread may be using the seqlock. The actual <u>seqlock
+ * instance is not deallocated</u> since it may have been embedded in a
+ * larger structure.</p>
+ * @param [in] object instance to be invalidated.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_SEQLOCK_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ */
+bool octopus_seqlock_invalidate(struct octopus_seqlock *object);
+
+/**
+ * @brief Retrieve the size of the value.
+ * @param [in] object seqlock instance.
+ * @param [out] out receive the size of the value.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_SEQLOCK_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_SEQLOCK_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ */
+bool octopus_seqlock_size(const struct octopus_seqlock *object,
+                          size_t *out);
+
+/**
+ * @brief Replace the value.
+ * <p>Only one thread may write at a time, writers which may overlap must be
+ * serialized by the caller. Writing never waits for readers.</p>
+ * @param [in] object seqlock instance.
+ * @param [in] value size bytes to copy in.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_SEQLOCK_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_SEQLOCK_ERROR_VALUE_IS_NULL if value is <i>NULL</i>.
+ */
+bool octopus_seqlock_write(struct octopus_seqlock *object,
+                           const void *value);
+
+/**
+ * @brief Retrieve a copy of the value.
+ * <p>The copy is retried for as long as a write overlaps it, yielding the
+ * processor after a number of attempts in case the writer has been
+ * preempted. The copy is always of a value as it was written as a whole.</p>
+ * @param [in] object seqlock instance.
+ * @param [out] out receive size bytes of the value.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_SEQLOCK_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_SEQLOCK_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ */
+bool octopus_seqlock_read(const struct octopus_seqlock *object, void *out);
+
+#endif /* _OCTOPUS_SEQLOCK_H_ */
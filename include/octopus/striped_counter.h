@@ -0,0 +1,104 @@
+#ifndef _OCTOPUS_STRIPED_COUNTER_H_
+#define _OCTOPUS_STRIPED_COUNTER_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <octopus/cache_line.h>
+
+#define OCTOPUS_STRIPED_COUNTER_ERROR_OBJECT_IS_NULL                    1
+#define OCTOPUS_STRIPED_COUNTER_ERROR_CONCURRENCY_IS_ZERO               2
+#define OCTOPUS_STRIPED_COUNTER_ERROR_MEMORY_ALLOCATION_FAILED          3
+#define OCTOPUS_STRIPED_COUNTER_ERROR_OUT_IS_NULL                       4
+
+struct octopus_striped_counter_cell;
+
+struct octopus_striped_counter {
+    struct octopus_striped_counter_cell *cells;
+    uintmax_t limit;
+    atomic_uintmax_t count;
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) atomic_uintmax_t base;
+};
+
+/**
+ * @brief Initialize striped counter.
+ * <p>A counter which many threads may add to at once without contending on
+ * a single cache line. Additions go to a base value until two threads are
+ * seen adding at the same time, after which each thread adds to one of a
+ * number of cache line sized cells picked by a per thread hash. The number
+ * of cells in use doubles whenever a thread keeps colliding with others, up
+ * to the given concurrency. Every cell is allocated here so that adding
+ * never allocates.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] concurrency maximum number of cells, this will be rounded up
+ * to the next power of two.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_STRIPED_COUNTER_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_STRIPED_COUNTER_ERROR_CONCURRENCY_IS_ZERO if concurrency
+ * is zero.
+ * @throws OCTOPUS_STRIPED_COUNTER_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to initialize instance.
+ */
+bool octopus_striped_counter_init(struct octopus_striped_counter *object,
+                                  uintmax_t concurrency);
+
+/**
+ * @brief Invalidate striped counter.
+ * <p>No other thread may be using the counter. The actual <u>striped
+ * counter instance is not deallocated</u> since it may have been embedded
+ * in a larger structure.</p>
+ * @param [in] object instance to be invalidated.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_STRIPED_COUNTER_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ */
+bool octopus_striped_counter_invalidate(
+        struct octopus_striped_counter *object);
+
+/**
+ * @brief Add to the counter.
+ * <p>This is wait-free, it makes at most one attempt to update a value
+ * without contention before adding to it unconditionally, and at most one
+ * attempt to put more of the cells allocated at initialization to use. The
+ * counter wraps around on overflow, so adding <i>UINTMAX_MAX</i> subtracts
+ * one.</p>
+ * @param [in] object counter instance.
+ * @param [in] delta amount to add.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_STRIPED_COUNTER_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ */
+bool octopus_striped_counter_add(struct octopus_striped_counter *object,
+                                 uintmax_t delta);
+
+/**
+ * @brief Retrieve the sum of all additions.
+ * <p>The base and each cell are read one after another, additions made
+ * while they are being read may or may not be included. Once no thread is
+ * adding the sum is exact.</p>
+ * @param [in] object counter instance.
+ * @param [out] out receive the sum.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_STRIPED_COUNTER_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_STRIPED_COUNTER_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ */
+bool octopus_striped_counter_sum(struct octopus_striped_counter *object,
+                                 uintmax_t *out);
+
+/**
+ * @brief Retrieve the number of cells in use.
+ * @param [in] object counter instance.
+ * @param [out] out receive the number of cells, zero while all additions go
+ * to the base.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_STRIPED_COUNTER_ERROR_OBJECT_IS_NULL if object is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_STRIPED_COUNTER_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ */
+bool octopus_striped_counter_cells(struct octopus_striped_counter *object,
+                                   uintmax_t *out);
+
+#endif /* _OCTOPUS_STRIPED_COUNTER_H_ */
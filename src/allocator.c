@@ -0,0 +1,39 @@
+#include <stdlib.h>
+#include <assert.h>
+#include <octopus.h>
+
+#include "private/allocator.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+void *octopus_allocate(const struct octopus_allocator *const allocator,
+                       const size_t size,
+                       const size_t alignment) {
+    assert(allocator);
+    assert(size);
+    assert(alignment && !(alignment & (alignment - 1)));
+    if (allocator->alloc) {
+        return allocator->alloc(allocator->context, size, alignment);
+    }
+    if (alignment <= _Alignof(max_align_t)) {
+        return malloc(size);
+    }
+    void *pointer;
+    return posix_memalign(&pointer, alignment, size) ? NULL : pointer;
+}
+
+void octopus_deallocate(const struct octopus_allocator *const allocator,
+                        void *const pointer,
+                        const size_t size) {
+    assert(allocator);
+    if (!pointer) {
+        return;
+    }
+    if (allocator->free) {
+        allocator->free(allocator->context, pointer, size);
+        return;
+    }
+    free(pointer);
+}
@@ -0,0 +1,280 @@
+#include <stdlib.h>
+#include <assert.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <seagrass.h>
+#include <octopus.h>
+
+#include "private/arena.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+static size_t page_size(void) {
+    const long size = sysconf(_SC_PAGESIZE);
+    return size > 0 ? (size_t) size : 4096;
+}
+
+static size_t granule_of(const struct octopus_arena *const object) {
+    assert(object);
+    return OCTOPUS_ARENA_PAGES_DEFAULT == object->pages
+           ? page_size()
+           : OCTOPUS_ARENA_HUGE_PAGE_SIZE;
+}
+
+static uintptr_t round_up(const uintptr_t value, const uintptr_t multiple) {
+    assert(multiple && !(multiple & (multiple - 1)));
+    return (value + multiple - 1) & ~(multiple - 1);
+}
+
+/* smallest size class whose blocks hold size bytes */
+static unsigned class_of(const size_t size) {
+    unsigned class = 0;
+    while (((size_t) 1 << class) < size) {
+        class++;
+    }
+    return class;
+}
+
+static void *map(const int pages, const size_t size) {
+    const int protection = PROT_READ | PROT_WRITE;
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    switch (pages) {
+        default: {
+            return mmap(NULL, size, protection, flags, -1, 0);
+        }
+        case OCTOPUS_ARENA_PAGES_HUGE: {
+#ifdef MAP_HUGETLB
+            return mmap(NULL, size, protection, flags | MAP_HUGETLB, -1, 0);
+#else
+            return MAP_FAILED;
+#endif
+        }
+        case OCTOPUS_ARENA_PAGES_TRANSPARENT_HUGE: {
+            /* over map so that the region can start on a huge page
+             * boundary, which the kernel needs to back it with huge pages */
+            const size_t huge = OCTOPUS_ARENA_HUGE_PAGE_SIZE;
+            unsigned char *const raw = mmap(NULL, size + huge, protection,
+                                            flags, -1, 0);
+            if (MAP_FAILED == raw) {
+                return MAP_FAILED;
+            }
+            unsigned char *const aligned
+                    = (unsigned char *) round_up((uintptr_t) raw, huge);
+            if (aligned != raw) {
+                seagrass_required_true(!munmap(raw, aligned - raw));
+            }
+            const size_t tail = huge - (aligned - raw);
+            if (tail) {
+                seagrass_required_true(!munmap(aligned + size, tail));
+            }
+#ifdef MADV_HUGEPAGE
+            /* advisory only, without transparent huge pages the region is
+             * still usable */
+            (void) madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+            return aligned;
+        }
+    }
+}
+
+/* must hold the lock */
+static struct octopus_arena_region *add_region(
+        struct octopus_arena *const object,
+        const size_t size) {
+    assert(object);
+    assert(size);
+    struct octopus_arena_region *const region = map(object->pages, size);
+    if (MAP_FAILED == (void *) region) {
+        return NULL;
+    }
+    region->next = object->regions;
+    region->size = size;
+    object->regions = region;
+    return region;
+}
+
+static void *arena_alloc(void *const context,
+                         const size_t size,
+                         const size_t alignment) {
+    struct octopus_arena *const object = context;
+    assert(object);
+    assert(alignment && !(alignment & (alignment - 1)));
+    const size_t page = page_size();
+    if (!size || alignment > page || size > SIZE_MAX / 4) {
+        return NULL;
+    }
+    const unsigned class = class_of(
+            size < sizeof(struct octopus_arena_block)
+            ? sizeof(struct octopus_arena_block)
+            : size);
+    const size_t block = (size_t) 1 << class;
+    /* blocks are aligned to their own size up to a page, so any block of
+     * the class will do unless more than that was asked for */
+    const size_t natural = block < page ? block : page;
+    const size_t align = alignment > natural ? alignment : natural;
+    const size_t header = sizeof(struct octopus_arena_region);
+    unsigned char *result;
+    seagrass_required_true(!pthread_mutex_lock(&object->lock));
+    if (align == natural && object->blocks[class]) {
+        struct octopus_arena_block *const released = object->blocks[class];
+        object->blocks[class] = released->next;
+        result = (unsigned char *) released;
+    } else if (block + align + header > object->region) {
+        /* too large to share a region, give it one of its own */
+        const size_t length = round_up(header + align + block,
+                                       granule_of(object));
+        struct octopus_arena_region *const region
+                = add_region(object, length);
+        result = !region
+                 ? NULL
+                 : (unsigned char *) round_up(
+                        (uintptr_t) region + header, align);
+    } else {
+        result = (unsigned char *) round_up((uintptr_t) object->cursor,
+                                            align);
+        if (result + block > object->end) {
+            /* the rest of the current region is left unused */
+            struct octopus_arena_region *const region
+                    = add_region(object, object->region);
+            if (region) {
+                object->end = (unsigned char *) region + region->size;
+                result = (unsigned char *) round_up(
+                        (uintptr_t) region + header, align);
+                object->cursor = result + block;
+            } else {
+                result = NULL;
+            }
+        } else {
+            object->cursor = result + block;
+        }
+    }
+    seagrass_required_true(!pthread_mutex_unlock(&object->lock));
+    return result;
+}
+
+static void arena_free(void *const context,
+                       void *const pointer,
+                       const size_t size) {
+    struct octopus_arena *const object = context;
+    assert(object);
+    assert(pointer);
+    const unsigned class = class_of(
+            size < sizeof(struct octopus_arena_block)
+            ? sizeof(struct octopus_arena_block)
+            : size);
+    struct octopus_arena_block *const block = pointer;
+    seagrass_required_true(!pthread_mutex_lock(&object->lock));
+    block->next = object->blocks[class];
+    object->blocks[class] = block;
+    seagrass_required_true(!pthread_mutex_unlock(&object->lock));
+}
+
+bool octopus_arena_init(struct octopus_arena *const object,
+                        const size_t region,
+                        const int pages) {
+    if (!object) {
+        octopus_error = OCTOPUS_ARENA_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!region) {
+        octopus_error = OCTOPUS_ARENA_ERROR_SIZE_IS_ZERO;
+        return false;
+    }
+    if (OCTOPUS_ARENA_PAGES_DEFAULT != pages
+        && OCTOPUS_ARENA_PAGES_HUGE != pages
+        && OCTOPUS_ARENA_PAGES_TRANSPARENT_HUGE != pages) {
+        octopus_error = OCTOPUS_ARENA_ERROR_PAGES_IS_INVALID;
+        return false;
+    }
+    *object = (struct octopus_arena) {
+            .pages = pages
+    };
+    const size_t granule = granule_of(object);
+    if (region > SIZE_MAX / 4 - granule) {
+        octopus_error = OCTOPUS_ARENA_ERROR_SIZE_IS_TOO_LARGE;
+        return false;
+    }
+    object->region = round_up(region, granule);
+    int error;
+    if ((error = pthread_mutex_init(&object->lock, NULL))) {
+        seagrass_required_true(ENOMEM == error);
+        octopus_error = OCTOPUS_ARENA_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    /* map the first region now so that missing huge pages are reported
+     * here rather than by the first allocation */
+    struct octopus_arena_region *const first
+            = add_region(object, object->region);
+    if (!first) {
+        seagrass_required_true(!pthread_mutex_destroy(&object->lock));
+        octopus_error = OCTOPUS_ARENA_PAGES_HUGE == pages
+                        ? OCTOPUS_ARENA_ERROR_HUGE_PAGES_ARE_UNAVAILABLE
+                        : OCTOPUS_ARENA_ERROR_MEMORY_ALLOCATION_FAILED;
+        *object = (struct octopus_arena) {0};
+        return false;
+    }
+    object->cursor = (unsigned char *) first
+                     + sizeof(struct octopus_arena_region);
+    object->end = (unsigned char *) first + first->size;
+    return true;
+}
+
+bool octopus_arena_invalidate(struct octopus_arena *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_ARENA_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (object->regions) {
+        struct octopus_arena_region *region = object->regions;
+        while (region) {
+            struct octopus_arena_region *const next = region->next;
+            seagrass_required_true(!munmap(region, region->size));
+            region = next;
+        }
+        seagrass_required_true(!pthread_mutex_destroy(&object->lock));
+    }
+    *object = (struct octopus_arena) {0};
+    return true;
+}
+
+bool octopus_arena_allocator(struct octopus_arena *const object,
+                             struct octopus_allocator *const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_ARENA_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_ARENA_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    *out = (struct octopus_allocator) {
+            .alloc = arena_alloc,
+            .free = arena_free,
+            .context = object
+    };
+    return true;
+}
+
+bool octopus_arena_mapped(struct octopus_arena *const object,
+                          uintmax_t *const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_ARENA_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_ARENA_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    uintmax_t mapped = 0;
+    seagrass_required_true(!pthread_mutex_lock(&object->lock));
+    for (struct octopus_arena_region *region = object->regions; region;
+         region = region->next) {
+        mapped += region->size;
+    }
+    seagrass_required_true(!pthread_mutex_unlock(&object->lock));
+    *out = mapped;
+    return true;
+}
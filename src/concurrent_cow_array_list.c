@@ -0,0 +1,413 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <seagrass.h>
+#include <octopus.h>
+
+#include "private/concurrent_cow_array_list.h"
+#include "private/epoch.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+static void release(struct octopus_epoch_entry *const entry) {
+    assert(entry);
+    struct octopus_concurrent_cow_array_list_snapshot *const snapshot =
+            (struct octopus_concurrent_cow_array_list_snapshot *) entry;
+    seagrass_required_true(coral_array_list_invalidate(
+            &snapshot->list, NULL));
+    free(snapshot);
+}
+
+static struct octopus_concurrent_cow_array_list_snapshot *allocate(
+        const size_t size, const uintmax_t length) {
+    struct octopus_concurrent_cow_array_list_snapshot *const result =
+            malloc(sizeof(*result));
+    if (!result) {
+        return NULL;
+    }
+    /* an empty list still gets room for one item */
+    if (!coral_array_list_init(&result->list, size, length ? length : 1)) {
+        seagrass_required_true(CORAL_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED
+                               == coral_error);
+        free(result);
+        return NULL;
+    }
+    seagrass_required_true(coral_array_list_set_length(
+            &result->list, length));
+    result->items = NULL;
+    result->length = length;
+    result->size = size;
+    if (length) {
+        seagrass_required_true(coral_array_list_get(
+                &result->list, 0, (void **) &result->items));
+    }
+    return result;
+}
+
+static void *item_of(
+        const struct octopus_concurrent_cow_array_list_snapshot *const snapshot,
+        const uintmax_t at) {
+    assert(snapshot);
+    assert(at < snapshot->length);
+    return snapshot->items + at * snapshot->size;
+}
+
+/* copy count items starting at from in source to to onwards in destination */
+static void copy(
+        const struct octopus_concurrent_cow_array_list *const object,
+        struct octopus_concurrent_cow_array_list_snapshot *const destination,
+        const uintmax_t to,
+        const struct octopus_concurrent_cow_array_list_snapshot *const source,
+        const uintmax_t from,
+        const uintmax_t count) {
+    assert(object);
+    assert(destination);
+    assert(source);
+    if (!count) {
+        return;
+    }
+    memcpy(item_of(destination, to), item_of(source, from),
+           count * object->size);
+}
+
+/*
+ * Writers are serialized by the lock, the current snapshot is therefore only
+ * ever replaced by the caller. A replaced snapshot is retired through the
+ * epoch so that readers still iterating it may carry on.
+ */
+static bool begin(
+        struct octopus_concurrent_cow_array_list *const object,
+        const struct octopus_concurrent_cow_array_list_snapshot **const out) {
+    assert(object);
+    assert(out);
+    if (!octopus_epoch_enter()) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    seagrass_required_true(!pthread_mutex_lock(&object->lock));
+    *out = atomic_load_explicit(&object->snapshot, memory_order_relaxed);
+    return true;
+}
+
+static void end(
+        struct octopus_concurrent_cow_array_list *const object,
+        struct octopus_concurrent_cow_array_list_snapshot *const snapshot) {
+    assert(object);
+    if (snapshot) {
+        struct octopus_concurrent_cow_array_list_snapshot *const previous =
+                atomic_exchange_explicit(&object->snapshot, snapshot,
+                                         memory_order_release);
+        octopus_epoch_retire(&previous->entry, release);
+    }
+    seagrass_required_true(!pthread_mutex_unlock(&object->lock));
+    octopus_epoch_exit();
+}
+
+bool octopus_concurrent_cow_array_list_init(
+        struct octopus_concurrent_cow_array_list *const object,
+        const size_t size) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!size) {
+        octopus_error = OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_SIZE_IS_ZERO;
+        return false;
+    }
+    *object = (struct octopus_concurrent_cow_array_list) {
+            .size = size
+    };
+    struct octopus_concurrent_cow_array_list_snapshot *const snapshot =
+            allocate(size, 0);
+    if (!snapshot) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    int error;
+    if ((error = pthread_mutex_init(&object->lock, NULL))) {
+        seagrass_required_true(ENOMEM == error);
+        release(&snapshot->entry);
+        *object = (struct octopus_concurrent_cow_array_list) {0};
+        octopus_error =
+                OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    atomic_init(&object->snapshot, snapshot);
+    return true;
+}
+
+bool octopus_concurrent_cow_array_list_invalidate(
+        struct octopus_concurrent_cow_array_list *const object,
+        void (*const on_destroy)(void *)) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    struct octopus_concurrent_cow_array_list_snapshot *const snapshot =
+            atomic_load(&object->snapshot);
+    if (snapshot) {
+        /* release the snapshots this thread has replaced */
+        octopus_epoch_synchronize();
+        seagrass_required_true(coral_array_list_invalidate(
+                &snapshot->list, on_destroy));
+        free(snapshot);
+        seagrass_required_true(!pthread_mutex_destroy(&object->lock));
+    }
+    *object = (struct octopus_concurrent_cow_array_list) {0};
+    return true;
+}
+
+bool octopus_concurrent_cow_array_list_size(
+        const struct octopus_concurrent_cow_array_list *const object,
+        size_t *const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    *out = object->size;
+    return true;
+}
+
+bool octopus_concurrent_cow_array_list_length(
+        struct octopus_concurrent_cow_array_list *const object,
+        uintmax_t *const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    const struct octopus_concurrent_cow_array_list_snapshot *snapshot;
+    if (!octopus_concurrent_cow_array_list_acquire(object, &snapshot)) {
+        return false;
+    }
+    *out = snapshot->length;
+    seagrass_required_true(octopus_concurrent_cow_array_list_release(
+            snapshot));
+    return true;
+}
+
+bool octopus_concurrent_cow_array_list_add(
+        struct octopus_concurrent_cow_array_list *const object,
+        const void *const item) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!item) {
+        octopus_error = OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_ITEM_IS_NULL;
+        return false;
+    }
+    const struct octopus_concurrent_cow_array_list_snapshot *current;
+    if (!begin(object, &current)) {
+        return false;
+    }
+    const uintmax_t length = current->length;
+    struct octopus_concurrent_cow_array_list_snapshot *const snapshot =
+            allocate(object->size, 1 + length);
+    if (!snapshot) {
+        end(object, NULL);
+        octopus_error =
+                OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    copy(object, snapshot, 0, current, 0, length);
+    memcpy(item_of(snapshot, length), item, object->size);
+    end(object, snapshot);
+    return true;
+}
+
+bool octopus_concurrent_cow_array_list_insert(
+        struct octopus_concurrent_cow_array_list *const object,
+        const uintmax_t at,
+        const void *const item) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!item) {
+        octopus_error = OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_ITEM_IS_NULL;
+        return false;
+    }
+    const struct octopus_concurrent_cow_array_list_snapshot *current;
+    if (!begin(object, &current)) {
+        return false;
+    }
+    const uintmax_t length = current->length;
+    if (at > length) {
+        end(object, NULL);
+        octopus_error =
+                OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_INDEX_IS_OUT_OF_BOUNDS;
+        return false;
+    }
+    struct octopus_concurrent_cow_array_list_snapshot *const snapshot =
+            allocate(object->size, 1 + length);
+    if (!snapshot) {
+        end(object, NULL);
+        octopus_error =
+                OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    copy(object, snapshot, 0, current, 0, at);
+    memcpy(item_of(snapshot, at), item, object->size);
+    copy(object, snapshot, 1 + at, current, at, length - at);
+    end(object, snapshot);
+    return true;
+}
+
+bool octopus_concurrent_cow_array_list_set(
+        struct octopus_concurrent_cow_array_list *const object,
+        const uintmax_t at,
+        const void *const item) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!item) {
+        octopus_error = OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_ITEM_IS_NULL;
+        return false;
+    }
+    const struct octopus_concurrent_cow_array_list_snapshot *current;
+    if (!begin(object, &current)) {
+        return false;
+    }
+    const uintmax_t length = current->length;
+    if (at >= length) {
+        end(object, NULL);
+        octopus_error =
+                OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_INDEX_IS_OUT_OF_BOUNDS;
+        return false;
+    }
+    struct octopus_concurrent_cow_array_list_snapshot *const snapshot =
+            allocate(object->size, length);
+    if (!snapshot) {
+        end(object, NULL);
+        octopus_error =
+                OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    copy(object, snapshot, 0, current, 0, length);
+    memcpy(item_of(snapshot, at), item, object->size);
+    end(object, snapshot);
+    return true;
+}
+
+bool octopus_concurrent_cow_array_list_remove(
+        struct octopus_concurrent_cow_array_list *const object,
+        const uintmax_t at,
+        void *const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    const struct octopus_concurrent_cow_array_list_snapshot *current;
+    if (!begin(object, &current)) {
+        return false;
+    }
+    const uintmax_t length = current->length;
+    if (at >= length) {
+        end(object, NULL);
+        octopus_error =
+                OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_INDEX_IS_OUT_OF_BOUNDS;
+        return false;
+    }
+    struct octopus_concurrent_cow_array_list_snapshot *const snapshot =
+            allocate(object->size, length - 1);
+    if (!snapshot) {
+        end(object, NULL);
+        octopus_error =
+                OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    if (out) {
+        memcpy(out, item_of(current, at), object->size);
+    }
+    copy(object, snapshot, 0, current, 0, at);
+    copy(object, snapshot, at, current, 1 + at, length - at - 1);
+    end(object, snapshot);
+    return true;
+}
+
+bool octopus_concurrent_cow_array_list_acquire(
+        struct octopus_concurrent_cow_array_list *const object,
+        const struct octopus_concurrent_cow_array_list_snapshot **const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    if (!octopus_epoch_enter()) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    /* pairs with the exchange in end() so the items copied are visible */
+    *out = atomic_load_explicit(&object->snapshot, memory_order_acquire);
+    return true;
+}
+
+bool octopus_concurrent_cow_array_list_release(
+        const struct octopus_concurrent_cow_array_list_snapshot *const
+        snapshot) {
+    if (!snapshot) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_SNAPSHOT_IS_NULL;
+        return false;
+    }
+    octopus_epoch_exit();
+    return true;
+}
+
+bool octopus_concurrent_cow_array_list_snapshot_length(
+        const struct octopus_concurrent_cow_array_list_snapshot *const
+        snapshot,
+        uintmax_t *const out) {
+    if (!snapshot) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_SNAPSHOT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    *out = snapshot->length;
+    return true;
+}
+
+bool octopus_concurrent_cow_array_list_snapshot_get(
+        const struct octopus_concurrent_cow_array_list_snapshot *const
+        snapshot,
+        const uintmax_t at,
+        const void **const out) {
+    if (!snapshot) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_SNAPSHOT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    if (at >= snapshot->length) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_INDEX_IS_OUT_OF_BOUNDS;
+        return false;
+    }
+    *out = item_of(snapshot, at);
+    return true;
+}
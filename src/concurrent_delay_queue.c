@@ -0,0 +1,455 @@
+#include <stdlib.h>
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <seagrass.h>
+#include <octopus.h>
+
+#include "private/concurrent_delay_queue.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+#define BITS                                OCTOPUS_CONCURRENT_DELAY_QUEUE_BITS
+#define SLOTS                               (UINTMAX_C(1) << BITS)
+#define MASK                                (SLOTS - 1)
+#define LEVELS                              OCTOPUS_CONCURRENT_DELAY_QUEUE_LEVELS
+#define OVERFLOW                            (LEVELS * SLOTS)
+#define EXPIRED                             (OVERFLOW + 1)
+#define LISTS                               OCTOPUS_CONCURRENT_DELAY_QUEUE_LISTS
+#define FREE                                LISTS
+#define NONE                                UINTMAX_MAX
+
+static uint64_t now(void) {
+    struct timespec ts;
+    seagrass_required_true(!clock_gettime(CLOCK_MONOTONIC, &ts));
+    return (uint64_t) ts.tv_sec * UINT64_C(1000000000) + ts.tv_nsec;
+}
+
+static uintmax_t ticks(
+        const struct octopus_concurrent_delay_queue *const object) {
+    assert(object);
+    return (now() - object->epoch) / object->tick;
+}
+
+static void push(struct octopus_concurrent_delay_queue_shard *const shard,
+                 const uintmax_t list,
+                 const uintmax_t index) {
+    assert(shard);
+    assert(list < LISTS);
+    struct octopus_concurrent_delay_queue_entry *const entry
+            = &shard->entries[index];
+    struct octopus_concurrent_delay_queue_list *const at = &shard->lists[list];
+    entry->list = list;
+    entry->next = NONE;
+    entry->prev = at->tail;
+    if (NONE == at->tail) {
+        at->head = index;
+    } else {
+        shard->entries[at->tail].next = index;
+    }
+    at->tail = index;
+    if (list < OVERFLOW) {
+        shard->occupied[list / SLOTS] |= UINT64_C(1) << (list & MASK);
+    }
+    if (list < EXPIRED) {
+        shard->pending++;
+    }
+}
+
+static void pop(struct octopus_concurrent_delay_queue_shard *const shard,
+                const uintmax_t index) {
+    assert(shard);
+    struct octopus_concurrent_delay_queue_entry *const entry
+            = &shard->entries[index];
+    const uintmax_t list = entry->list;
+    assert(list < LISTS);
+    struct octopus_concurrent_delay_queue_list *const at = &shard->lists[list];
+    if (NONE == entry->prev) {
+        at->head = entry->next;
+    } else {
+        shard->entries[entry->prev].next = entry->next;
+    }
+    if (NONE == entry->next) {
+        at->tail = entry->prev;
+    } else {
+        shard->entries[entry->next].prev = entry->prev;
+    }
+    if (list < OVERFLOW && NONE == at->head) {
+        shard->occupied[list / SLOTS] &= ~(UINT64_C(1) << (list & MASK));
+    }
+    if (list < EXPIRED) {
+        shard->pending--;
+    }
+}
+
+static void place(struct octopus_concurrent_delay_queue_shard *const shard,
+                  const uintmax_t index) {
+    assert(shard);
+    const uintmax_t deadline = shard->entries[index].deadline;
+    const uintmax_t current = shard->current;
+    uintmax_t list = OVERFLOW;
+    if (deadline < current) {
+        list = EXPIRED;
+    } else {
+        /* lowest level above which the deadline and the current tick agree,
+         * the slot is then cascaded down once the current tick reaches it */
+        for (uintmax_t level = 0; level < LEVELS; level++) {
+            const uintmax_t shift = BITS * (level + 1);
+            if ((deadline >> shift) == (current >> shift)) {
+                list = level * SLOTS
+                       + ((deadline >> (BITS * level)) & MASK);
+                break;
+            }
+        }
+    }
+    push(shard, list, index);
+}
+
+static void cascade(struct octopus_concurrent_delay_queue_shard *const shard,
+                    const uintmax_t list) {
+    assert(shard);
+    assert(list < EXPIRED);
+    /* detached first, an entry still beyond the next block of the wheel is
+     * placed back onto the overflow list that is being walked */
+    struct octopus_concurrent_delay_queue_list *const at = &shard->lists[list];
+    uintmax_t index = at->head;
+    at->head = NONE;
+    at->tail = NONE;
+    if (list < OVERFLOW) {
+        shard->occupied[list / SLOTS] &= ~(UINT64_C(1) << (list & MASK));
+    }
+    while (NONE != index) {
+        const uintmax_t next = shard->entries[index].next;
+        shard->pending--;
+        place(shard, index);
+        index = next;
+    }
+}
+
+static void advance(struct octopus_concurrent_delay_queue_shard *const shard,
+                    const uintmax_t tick) {
+    assert(shard);
+    while (shard->current <= tick) {
+        if (!shard->pending) {
+            shard->current = tick + 1;
+            return;
+        }
+        const uintmax_t current = shard->current;
+        if (!(current & ((UINTMAX_C(1) << (BITS * LEVELS)) - 1))) {
+            cascade(shard, OVERFLOW);
+        }
+        for (uintmax_t level = LEVELS - 1; level; level--) {
+            if (!(current & ((UINTMAX_C(1) << (BITS * level)) - 1))) {
+                cascade(shard, level * SLOTS
+                               + ((current >> (BITS * level)) & MASK));
+            }
+        }
+        /* the whole slot becomes due at once */
+        const uintmax_t list = current & MASK;
+        for (uintmax_t index = shard->lists[list].head; NONE != index;) {
+            const uintmax_t next = shard->entries[index].next;
+            pop(shard, index);
+            push(shard, EXPIRED, index);
+            index = next;
+        }
+        /* skip ahead to the next occupied slot, a slot on a lower level is
+         * always reached before any slot on a higher level */
+        uintmax_t next = ((current >> (BITS * LEVELS)) + 1)
+                << (BITS * LEVELS);
+        for (uintmax_t level = 0; level < LEVELS; level++) {
+            const uintmax_t shift = BITS * level;
+            const uint64_t ahead = shard->occupied[level]
+                    & ~((UINT64_C(2) << ((current >> shift) & MASK)) - 1);
+            if (ahead) {
+                next = ((current >> (shift + BITS)) << (shift + BITS))
+                       + ((uintmax_t) __builtin_ctzll(ahead) << shift);
+                break;
+            }
+        }
+        if (next > tick + 1) {
+            next = tick + 1;
+        }
+        shard->current = next;
+    }
+}
+
+static bool grow(struct octopus_concurrent_delay_queue_shard *const shard,
+                 const size_t size) {
+    assert(shard);
+    assert(NONE == shard->free);
+    const uintmax_t capacity = shard->capacity ? 2 * shard->capacity : 16;
+    uintmax_t bytes;
+    if (!seagrass_uintmax_t_multiply(
+            capacity, sizeof(*shard->entries), &bytes)
+        || bytes > SIZE_MAX) {
+        return false;
+    }
+    void *entries = realloc(shard->entries, bytes);
+    if (!entries) {
+        return false;
+    }
+    shard->entries = entries;
+    if (!seagrass_uintmax_t_multiply(capacity, size, &bytes)
+        || bytes > SIZE_MAX) {
+        return false;
+    }
+    void *items = realloc(shard->items, bytes);
+    if (!items) {
+        return false;
+    }
+    shard->items = items;
+    for (uintmax_t i = capacity; i > shard->capacity; i--) {
+        struct octopus_concurrent_delay_queue_entry *const entry
+                = &shard->entries[i - 1];
+        *entry = (struct octopus_concurrent_delay_queue_entry) {
+                .list = FREE,
+                .next = shard->free
+        };
+        shard->free = i - 1;
+    }
+    shard->capacity = capacity;
+    return true;
+}
+
+static void release(struct octopus_concurrent_delay_queue_shard *const shard,
+                    const uintmax_t index) {
+    assert(shard);
+    struct octopus_concurrent_delay_queue_entry *const entry
+            = &shard->entries[index];
+    pop(shard, index);
+    entry->generation++;
+    entry->list = FREE;
+    entry->next = shard->free;
+    shard->free = index;
+}
+
+static void shard_invalidate(
+        struct octopus_concurrent_delay_queue_shard *const shard,
+        const size_t size,
+        void (*const on_destroy)(void *)) {
+    assert(shard);
+    for (uintmax_t i = 0; on_destroy && i < shard->capacity; i++) {
+        if (FREE != shard->entries[i].list) {
+            on_destroy(&shard->items[i * size]);
+        }
+    }
+    free(shard->entries);
+    free(shard->items);
+    seagrass_required_true(!pthread_mutex_destroy(&shard->lock));
+}
+
+bool octopus_concurrent_delay_queue_init(
+        struct octopus_concurrent_delay_queue *const object,
+        const size_t size,
+        const uintmax_t concurrency,
+        const uint64_t tick) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!size) {
+        octopus_error = OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_SIZE_IS_ZERO;
+        return false;
+    }
+    if (!concurrency) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_CONCURRENCY_IS_ZERO;
+        return false;
+    }
+    if (!tick) {
+        octopus_error = OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_TICK_IS_ZERO;
+        return false;
+    }
+    if (size > SIZE_MAX / 16) {
+        octopus_error = OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_SIZE_IS_TOO_LARGE;
+        return false;
+    }
+    *object = (struct octopus_concurrent_delay_queue) {0};
+    uintmax_t count;
+    uintmax_t bytes;
+    if (!octopus_concurrent_queue_shards(concurrency, &count)
+        || !seagrass_uintmax_t_multiply(
+                count, sizeof(struct octopus_concurrent_delay_queue_shard),
+                &bytes)
+        || bytes > SIZE_MAX
+        || posix_memalign((void **) &object->shards,
+                          OCTOPUS_CACHE_LINE_SIZE, bytes)) {
+        *object = (struct octopus_concurrent_delay_queue) {0};
+        octopus_error =
+                OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    for (uintmax_t i = 0; i < count; i++) {
+        struct octopus_concurrent_delay_queue_shard *const shard
+                = &object->shards[i];
+        *shard = (struct octopus_concurrent_delay_queue_shard) {
+                .free = NONE
+        };
+        for (uintmax_t o = 0; o < LISTS; o++) {
+            shard->lists[o] = (struct octopus_concurrent_delay_queue_list) {
+                    .head = NONE,
+                    .tail = NONE
+            };
+        }
+        int error;
+        if ((error = pthread_mutex_init(&shard->lock, NULL))) {
+            seagrass_required_true(ENOMEM == error);
+            for (uintmax_t o = 0; o < i; o++) {
+                shard_invalidate(&object->shards[o], size, NULL);
+            }
+            free(object->shards);
+            *object = (struct octopus_concurrent_delay_queue) {0};
+            octopus_error =
+                    OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+            return false;
+        }
+    }
+    object->size = size;
+    object->mask = count - 1;
+    object->tick = tick;
+    object->epoch = now();
+    return true;
+}
+
+bool octopus_concurrent_delay_queue_invalidate(
+        struct octopus_concurrent_delay_queue *const object,
+        void (*const on_destroy)(void *)) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (object->shards) {
+        for (uintmax_t i = 0; i <= object->mask; i++) {
+            shard_invalidate(&object->shards[i], object->size, on_destroy);
+        }
+        free(object->shards);
+    }
+    *object = (struct octopus_concurrent_delay_queue) {0};
+    return true;
+}
+
+bool octopus_concurrent_delay_queue_schedule(
+        struct octopus_concurrent_delay_queue *const object,
+        const void *const item,
+        const uint64_t delay,
+        struct octopus_concurrent_delay_queue_timer *const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!item) {
+        octopus_error = OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_ITEM_IS_NULL;
+        return false;
+    }
+    const uint64_t elapsed = now() - object->epoch;
+    const uint64_t at = delay > UINT64_MAX - elapsed - object->tick
+                        ? UINT64_MAX - object->tick
+                        : elapsed + delay;
+    /* round up so that an item is never due early, unless there is no delay
+     * in which case it is due at once */
+    const uintmax_t deadline = delay
+                               ? (at + object->tick - 1) / object->tick
+                               : at / object->tick;
+    const uintmax_t s = atomic_fetch_add_explicit(
+            &object->schedule, 1, memory_order_relaxed) & object->mask;
+    struct octopus_concurrent_delay_queue_shard *const shard
+            = &object->shards[s];
+    seagrass_required_true(!pthread_mutex_lock(&shard->lock));
+    if (NONE == shard->free && !grow(shard, object->size)) {
+        seagrass_required_true(!pthread_mutex_unlock(&shard->lock));
+        octopus_error =
+                OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    /* keep the wheel close to now so that placement is as low as possible */
+    advance(shard, elapsed / object->tick);
+    const uintmax_t index = shard->free;
+    struct octopus_concurrent_delay_queue_entry *const entry
+            = &shard->entries[index];
+    shard->free = entry->next;
+    entry->deadline = deadline;
+    memcpy(&shard->items[index * object->size], item, object->size);
+    place(shard, index);
+    if (out) {
+        *out = (struct octopus_concurrent_delay_queue_timer) {
+                .shard = s,
+                .index = index,
+                .generation = entry->generation
+        };
+    }
+    seagrass_required_true(!pthread_mutex_unlock(&shard->lock));
+    return true;
+}
+
+bool octopus_concurrent_delay_queue_cancel(
+        struct octopus_concurrent_delay_queue *const object,
+        const struct octopus_concurrent_delay_queue_timer *const timer,
+        void **const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!timer) {
+        octopus_error = OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_TIMER_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    if (timer->shard > object->mask) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_TIMER_IS_NOT_PENDING;
+        return false;
+    }
+    struct octopus_concurrent_delay_queue_shard *const shard
+            = &object->shards[timer->shard];
+    seagrass_required_true(!pthread_mutex_lock(&shard->lock));
+    if (timer->index >= shard->capacity
+        || FREE == shard->entries[timer->index].list
+        || timer->generation != shard->entries[timer->index].generation) {
+        seagrass_required_true(!pthread_mutex_unlock(&shard->lock));
+        octopus_error =
+                OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_TIMER_IS_NOT_PENDING;
+        return false;
+    }
+    memcpy(out, &shard->items[timer->index * object->size], object->size);
+    release(shard, timer->index);
+    seagrass_required_true(!pthread_mutex_unlock(&shard->lock));
+    return true;
+}
+
+bool octopus_concurrent_delay_queue_take(
+        struct octopus_concurrent_delay_queue *const object,
+        void **const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    const uintmax_t tick = ticks(object);
+    const uintmax_t begin = atomic_fetch_add_explicit(
+            &object->take, 1, memory_order_relaxed);
+    for (uintmax_t i = 0; i <= object->mask; i++) {
+        struct octopus_concurrent_delay_queue_shard *const shard
+                = &object->shards[(begin + i) & object->mask];
+        seagrass_required_true(!pthread_mutex_lock(&shard->lock));
+        advance(shard, tick);
+        const uintmax_t index = shard->lists[EXPIRED].head;
+        if (NONE != index) {
+            memcpy(out, &shard->items[index * object->size], object->size);
+            release(shard, index);
+            seagrass_required_true(!pthread_mutex_unlock(&shard->lock));
+            return true;
+        }
+        seagrass_required_true(!pthread_mutex_unlock(&shard->lock));
+    }
+    octopus_error = OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_NOTHING_IS_DUE;
+    return false;
+}
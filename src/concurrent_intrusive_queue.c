@@ -0,0 +1,233 @@
+#include <stdlib.h>
+#include <assert.h>
+#include <errno.h>
+#include <seagrass.h>
+#include <octopus.h>
+
+#include "private/concurrent_intrusive_queue.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+static bool shard_init(
+        struct octopus_concurrent_intrusive_queue_shard *const shard) {
+    assert(shard);
+    *shard = (struct octopus_concurrent_intrusive_queue_shard) {0};
+    atomic_init(&shard->stub.next, NULL);
+    shard->first = shard->last = &shard->stub;
+    int error;
+    if ((error = pthread_mutex_init(&shard->dequeue, NULL))) {
+        seagrass_required_true(ENOMEM == error);
+        return false;
+    }
+    if ((error = pthread_mutex_init(&shard->enqueue, NULL))) {
+        seagrass_required_true(ENOMEM == error);
+        seagrass_required_true(!pthread_mutex_destroy(&shard->dequeue));
+        return false;
+    }
+    return true;
+}
+
+/* must hold the enqueue lock */
+static void shard_push(
+        struct octopus_concurrent_intrusive_queue_shard *const shard,
+        struct octopus_queue_link *const link) {
+    assert(shard);
+    assert(link);
+    atomic_store_explicit(&link->next, NULL, memory_order_relaxed);
+    struct octopus_queue_link *const previous = shard->last;
+    shard->last = link;
+    /* pairs with the acquire in shard_pop so that the consumer sees the
+     * item's contents once it sees the link */
+    atomic_store_explicit(&previous->next, link, memory_order_release);
+}
+
+/* must hold the dequeue lock */
+static struct octopus_queue_link *shard_pop(
+        struct octopus_concurrent_intrusive_queue_shard *const shard) {
+    assert(shard);
+    struct octopus_queue_link *link = shard->first;
+    struct octopus_queue_link *next = atomic_load_explicit(
+            &link->next, memory_order_acquire);
+    if (&shard->stub == link) {
+        if (!next) {
+            return NULL;
+        }
+        shard->first = link = next;
+        next = atomic_load_explicit(&link->next, memory_order_acquire);
+    }
+    if (!next) {
+        /* the link may be the last one, in which case the stub has to take
+         * its place before it can be handed back to the caller */
+        seagrass_required_true(!pthread_mutex_lock(&shard->enqueue));
+        next = atomic_load_explicit(&link->next, memory_order_acquire);
+        if (!next) {
+            shard_push(shard, &shard->stub);
+            next = &shard->stub;
+        }
+        seagrass_required_true(!pthread_mutex_unlock(&shard->enqueue));
+    }
+    shard->first = next;
+    return link;
+}
+
+static void shard_invalidate(
+        struct octopus_concurrent_intrusive_queue_shard *const shard,
+        void (*const on_destroy)(struct octopus_queue_link *)) {
+    assert(shard);
+    struct octopus_queue_link *link;
+    while ((link = shard_pop(shard))) {
+        if (on_destroy) {
+            on_destroy(link);
+        }
+    }
+    seagrass_required_true(!pthread_mutex_destroy(&shard->enqueue));
+    seagrass_required_true(!pthread_mutex_destroy(&shard->dequeue));
+}
+
+static void destroy(struct octopus_concurrent_intrusive_queue *const object,
+                    const uintmax_t count,
+                    void (*const on_destroy)(struct octopus_queue_link *)) {
+    assert(object);
+    for (uintmax_t i = 0; i < count; i++) {
+        shard_invalidate(&object->shards[i], on_destroy);
+    }
+    free(object->shards);
+    *object = (struct octopus_concurrent_intrusive_queue) {0};
+}
+
+bool octopus_concurrent_intrusive_queue_init(
+        struct octopus_concurrent_intrusive_queue *const object,
+        const uintmax_t concurrency) {
+    if (!object) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!concurrency) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_CONCURRENCY_IS_ZERO;
+        return false;
+    }
+    *object = (struct octopus_concurrent_intrusive_queue) {0};
+    uintmax_t count;
+    uintmax_t bytes;
+    if (!octopus_concurrent_queue_shards(concurrency, &count)
+        || !seagrass_uintmax_t_multiply(
+                count, sizeof(struct octopus_concurrent_intrusive_queue_shard),
+                &bytes)
+        || bytes > SIZE_MAX
+        || posix_memalign((void **) &object->shards,
+                          OCTOPUS_CACHE_LINE_SIZE, bytes)) {
+        *object = (struct octopus_concurrent_intrusive_queue) {0};
+        octopus_error =
+                OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    for (uintmax_t i = 0; i < count; i++) {
+        if (!shard_init(&object->shards[i])) {
+            destroy(object, i, NULL);
+            octopus_error =
+                    OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+            return false;
+        }
+    }
+    object->mask = count - 1;
+    return true;
+}
+
+bool octopus_concurrent_intrusive_queue_invalidate(
+        struct octopus_concurrent_intrusive_queue *const object,
+        void (*const on_destroy)(struct octopus_queue_link *)) {
+    if (!object) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (object->shards) {
+        destroy(object, 1 + object->mask, on_destroy);
+    }
+    return true;
+}
+
+bool octopus_concurrent_intrusive_queue_concurrency(
+        const struct octopus_concurrent_intrusive_queue *const object,
+        uintmax_t *const out) {
+    if (!object) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    *out = 1 + object->mask;
+    return true;
+}
+
+bool octopus_concurrent_intrusive_queue_add(
+        struct octopus_concurrent_intrusive_queue *const object,
+        struct octopus_queue_link *const link) {
+    if (!object) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!link) {
+        octopus_error = OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_LINK_IS_NULL;
+        return false;
+    }
+    const uintmax_t at = atomic_fetch_add(&object->enqueue, 1);
+    struct octopus_concurrent_intrusive_queue_shard *const shard
+            = &object->shards[at & object->mask];
+    seagrass_required_true(!pthread_mutex_lock(&shard->enqueue));
+    shard_push(shard, link);
+    seagrass_required_true(!pthread_mutex_unlock(&shard->enqueue));
+    return true;
+}
+
+static struct octopus_queue_link *retrieve(
+        struct octopus_concurrent_intrusive_queue *const object,
+        const uintmax_t at) {
+    assert(object);
+    struct octopus_concurrent_intrusive_queue_shard *const shard
+            = &object->shards[at & object->mask];
+    seagrass_required_true(!pthread_mutex_lock(&shard->dequeue));
+    struct octopus_queue_link *const link = shard_pop(shard);
+    seagrass_required_true(!pthread_mutex_unlock(&shard->dequeue));
+    return link;
+}
+
+bool octopus_concurrent_intrusive_queue_remove(
+        struct octopus_concurrent_intrusive_queue *const object,
+        struct octopus_queue_link **const out) {
+    if (!object) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    const uintmax_t c = 1 + object->mask;
+    const uintmax_t begin = atomic_fetch_add(&object->dequeue, 1);
+    const uintmax_t end = begin + c; /* allow integer overflow */
+    uintmax_t at = begin;
+    struct octopus_queue_link *link;
+    while (octopus_concurrent_queue_in_window(begin, end, at)) {
+        if ((link = retrieve(object, at))) {
+            *out = link;
+            return true;
+        }
+        at = atomic_fetch_add(&object->dequeue, 1);
+    }
+    if ((link = retrieve(object, at))) {
+        *out = link;
+        return true;
+    }
+    octopus_error = OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_QUEUE_IS_EMPTY;
+    return false;
+}
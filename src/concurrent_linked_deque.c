@@ -0,0 +1,345 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <seagrass.h>
+#include <octopus.h>
+
+#include "private/concurrent_linked_deque.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+/* most released nodes each shard keeps for reuse */
+#define SPARES 64
+
+/*
+ * The items are laid out over the shards as if they were in one array whose
+ * first and last positions are the cursors of the two ends, so the item at
+ * position at lives in the shard at & mask. Adding at the front and removing
+ * from the end step a cursor down, the other two step it up. If the shard an
+ * end points at has been emptied by an overlapping operation the shards
+ * further along are looked at instead, which only loosens the order the same
+ * way overlapping operations do, and a remove that finds the deque empty
+ * steps its cursor back.
+ */
+
+static void destroy(struct octopus_concurrent_linked_deque *const object,
+                    const uintmax_t count,
+                    void (*const on_destroy)(void *)) {
+    assert(object);
+    for (uintmax_t i = 0; i < count; i++) {
+        struct octopus_concurrent_linked_deque_shard *const shard =
+                &object->shards[i];
+        seagrass_required_true(!pthread_mutex_destroy(&shard->lock));
+        struct octopus_concurrent_linked_deque_node *node = shard->head;
+        while (node) {
+            struct octopus_concurrent_linked_deque_node *const next =
+                    node->next;
+            if (on_destroy) {
+                on_destroy(node->item);
+            }
+            free(node);
+            node = next;
+        }
+        node = shard->spare;
+        while (node) {
+            struct octopus_concurrent_linked_deque_node *const next =
+                    node->next;
+            free(node);
+            node = next;
+        }
+    }
+    free(object->shards);
+    *object = (struct octopus_concurrent_linked_deque) {0};
+}
+
+bool octopus_concurrent_linked_deque_init(
+        struct octopus_concurrent_linked_deque *const object,
+        const size_t size,
+        const uintmax_t concurrency) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!size) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_SIZE_IS_ZERO;
+        return false;
+    }
+    if (size > SIZE_MAX - sizeof(struct octopus_concurrent_linked_deque_node)) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_SIZE_IS_TOO_LARGE;
+        return false;
+    }
+    if (!concurrency) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_CONCURRENCY_IS_ZERO;
+        return false;
+    }
+    *object = (struct octopus_concurrent_linked_deque) {
+            .size = size
+    };
+    uintmax_t count;
+    uintmax_t bytes;
+    if (!octopus_concurrent_queue_shards(concurrency, &count)
+        || !seagrass_uintmax_t_multiply(
+                count, sizeof(struct octopus_concurrent_linked_deque_shard),
+                &bytes)
+        || bytes > SIZE_MAX
+        || posix_memalign((void **) &object->shards,
+                          OCTOPUS_CACHE_LINE_SIZE, bytes)) {
+        *object = (struct octopus_concurrent_linked_deque) {0};
+        octopus_error =
+                OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    object->mask = count - 1;
+    for (uintmax_t i = 0; i < count; i++) {
+        object->shards[i] = (struct octopus_concurrent_linked_deque_shard) {0};
+        int error;
+        if ((error = pthread_mutex_init(&object->shards[i].lock, NULL))) {
+            seagrass_required_true(ENOMEM == error);
+            destroy(object, i, NULL);
+            octopus_error =
+                    OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED;
+            return false;
+        }
+    }
+    atomic_init(&object->first, 0);
+    atomic_init(&object->last, 0);
+    return true;
+}
+
+bool octopus_concurrent_linked_deque_invalidate(
+        struct octopus_concurrent_linked_deque *const object,
+        void (*const on_destroy)(void *)) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    destroy(object, object->shards ? 1 + object->mask : 0, on_destroy);
+    return true;
+}
+
+bool octopus_concurrent_linked_deque_size(
+        const struct octopus_concurrent_linked_deque *const object,
+        size_t *const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    *out = object->size;
+    return true;
+}
+
+/* must hold the shard's lock */
+static struct octopus_concurrent_linked_deque_node *node_of(
+        const struct octopus_concurrent_linked_deque *const object,
+        struct octopus_concurrent_linked_deque_shard *const shard) {
+    assert(object);
+    assert(shard);
+    struct octopus_concurrent_linked_deque_node *const node = shard->spare;
+    if (node) {
+        shard->spare = node->next;
+        shard->spares--;
+        return node;
+    }
+    return malloc(sizeof(*node) + object->size);
+}
+
+static bool push(struct octopus_concurrent_linked_deque *const object,
+                 const uintmax_t at,
+                 const void *const item,
+                 const bool front) {
+    assert(object);
+    assert(item);
+    struct octopus_concurrent_linked_deque_shard *const shard =
+            &object->shards[at & object->mask];
+    seagrass_required_true(!pthread_mutex_lock(&shard->lock));
+    struct octopus_concurrent_linked_deque_node *const node =
+            node_of(object, shard);
+    if (!node) {
+        seagrass_required_true(!pthread_mutex_unlock(&shard->lock));
+        octopus_error =
+                OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    memcpy(node->item, item, object->size);
+    if (front) {
+        node->prev = NULL;
+        node->next = shard->head;
+        *(shard->head ? &shard->head->prev : &shard->tail) = node;
+        shard->head = node;
+    } else {
+        node->next = NULL;
+        node->prev = shard->tail;
+        *(shard->tail ? &shard->tail->next : &shard->head) = node;
+        shard->tail = node;
+    }
+    seagrass_required_true(!pthread_mutex_unlock(&shard->lock));
+    return true;
+}
+
+static bool pop(struct octopus_concurrent_linked_deque *const object,
+                const uintmax_t at,
+                void **const out,
+                const bool front,
+                const bool remove) {
+    assert(object);
+    assert(out);
+    struct octopus_concurrent_linked_deque_shard *const shard =
+            &object->shards[at & object->mask];
+    seagrass_required_true(!pthread_mutex_lock(&shard->lock));
+    struct octopus_concurrent_linked_deque_node *const node =
+            front ? shard->head : shard->tail;
+    if (!node) {
+        seagrass_required_true(!pthread_mutex_unlock(&shard->lock));
+        return false;
+    }
+    memcpy(out, node->item, object->size);
+    if (remove) {
+        if (front) {
+            shard->head = node->next;
+            *(shard->head ? &shard->head->prev : &shard->tail) = NULL;
+        } else {
+            shard->tail = node->prev;
+            *(shard->tail ? &shard->tail->next : &shard->head) = NULL;
+        }
+        if (shard->spares < SPARES) {
+            node->next = shard->spare;
+            shard->spare = node;
+            shard->spares++;
+        } else {
+            free(node);
+        }
+    }
+    seagrass_required_true(!pthread_mutex_unlock(&shard->lock));
+    return true;
+}
+
+/* look from at onwards in the direction the end moves when items are taken
+ * from it, since that is where the following items are */
+static bool take(struct octopus_concurrent_linked_deque *const object,
+                 const uintmax_t at,
+                 void **const out,
+                 const bool front,
+                 const bool remove) {
+    assert(object);
+    assert(out);
+    for (uintmax_t i = 0; i <= object->mask; i++) {
+        if (pop(object, front ? at + i : at - i, out, front, remove)) {
+            return true;
+        }
+    }
+    octopus_error = OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_DEQUE_IS_EMPTY;
+    return false;
+}
+
+bool octopus_concurrent_linked_deque_add_first(
+        struct octopus_concurrent_linked_deque *const object,
+        const void *const item) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!item) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_ITEM_IS_NULL;
+        return false;
+    }
+    const uintmax_t at = atomic_fetch_sub(&object->first, 1) - 1;
+    if (!push(object, at, item, true)) {
+        atomic_fetch_add(&object->first, 1);
+        return false;
+    }
+    return true;
+}
+
+bool octopus_concurrent_linked_deque_add_last(
+        struct octopus_concurrent_linked_deque *const object,
+        const void *const item) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!item) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_ITEM_IS_NULL;
+        return false;
+    }
+    const uintmax_t at = atomic_fetch_add(&object->last, 1);
+    if (!push(object, at, item, false)) {
+        atomic_fetch_sub(&object->last, 1);
+        return false;
+    }
+    return true;
+}
+
+bool octopus_concurrent_linked_deque_remove_first(
+        struct octopus_concurrent_linked_deque *const object,
+        void **const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    const uintmax_t at = atomic_fetch_add(&object->first, 1);
+    if (!take(object, at, out, true, true)) {
+        atomic_fetch_sub(&object->first, 1);
+        return false;
+    }
+    return true;
+}
+
+bool octopus_concurrent_linked_deque_remove_last(
+        struct octopus_concurrent_linked_deque *const object,
+        void **const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    const uintmax_t at = atomic_fetch_sub(&object->last, 1) - 1;
+    if (!take(object, at, out, false, true)) {
+        atomic_fetch_add(&object->last, 1);
+        return false;
+    }
+    return true;
+}
+
+bool octopus_concurrent_linked_deque_peek_first(
+        struct octopus_concurrent_linked_deque *const object,
+        void **const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    return take(object, atomic_load(&object->first), out, true, false);
+}
+
+bool octopus_concurrent_linked_deque_peek_last(
+        struct octopus_concurrent_linked_deque *const object,
+        void **const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    return take(object, atomic_load(&object->last) - 1, out, false, false);
+}
@@ -1,73 +1,469 @@
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sched.h>
 #include <seagrass.h>
 #include <octopus.h>
 
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+#include "private/allocator.h"
+#include "private/deadline.h"
 #include "private/linked_queue.h"
+#include "private/membarrier.h"
+#include "private/probe.h"
+#include "private/select.h"
 
 #ifdef TEST
 #include <test/cmocka.h>
 #endif
 
+/* most passes a combiner makes over the records before it hands over */
+#define PASSES 4
+/* times a waiting thread checks its record before it starts yielding */
+#define SPINS 64
+
+struct octopus_concurrent_linked_queue_counter {
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) atomic_uintmax_t value;
+};
+
+/* a producer's staging buffer, handed on to another thread once the one it
+ * belonged to has exited, its items are only touched while holding busy so
+ * that a consumer may add them once their deadline has passed */
+struct octopus_concurrent_linked_queue_stage {
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) struct octopus_concurrent_linked_queue
+            *queue;
+    struct octopus_concurrent_linked_queue_stage *next;
+    uintmax_t count;
+    atomic_uintmax_t deadline;
+    atomic_bool busy;
+    atomic_bool used;
+    _Alignas(max_align_t) unsigned char items[];
+};
+
+struct octopus_concurrent_linked_queue_combiner {
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) atomic_bool busy;
+};
+
+/* an operation published by a thread, pending holds one more than the index
+ * of the shard it is for until the operation has been carried out */
+struct octopus_concurrent_linked_queue_record {
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) struct octopus_concurrent_linked_queue_record
+            *next;
+    atomic_bool used;
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) atomic_uintmax_t pending;
+    const void *item;
+    void **out;
+    bool result;
+    uintmax_t error;
+};
+
 static bool retrieve(struct octopus_concurrent_linked_queue *const object,
-                     const uintmax_t concurrency,
                      const uintmax_t at,
                      void **const out,
                      bool (*func)(struct octopus_linked_queue *, void **)) {
     assert(object);
-    assert(concurrency);
     assert(out);
     assert(func);
-    uintmax_t qr[2];
-    seagrass_required_true(seagrass_uintmax_t_divide(
-            at, concurrency, &qr[0], &qr[1]));
-    struct octopus_linked_queue *queue;
-    seagrass_required_true(coral_array_list_get(
-            &object->queues, qr[1], (void **) &queue));
-    const bool result = func(queue, out);
-    if (!result) {
-        seagrass_required_true(OCTOPUS_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY
-                               == octopus_error);
-    }
+    const bool result = func(&object->queues[at & object->mask], out);
+    assert(result || OCTOPUS_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY
+                     == octopus_error);
     return result;
 }
 
-static void
-concurrency(const struct octopus_concurrent_linked_queue *const object,
-            uintmax_t *const out) {
+/* read the eventfd once for every debit left by a consumer which found it
+ * empty, a single thread settles at a time on behalf of every request */
+static void settle(struct octopus_concurrent_linked_queue *const object) {
+    assert(object);
+    uintmax_t requests = 1;
+    if (atomic_fetch_add(&object->settling, requests)) {
+        return;
+    }
+    do {
+        while (atomic_load(&object->debits)) {
+            uint64_t value;
+            ssize_t result;
+            do {
+                result = read(object->event_fd, &value, sizeof(value));
+            } while (-1 == result && EINTR == errno);
+            if (-1 == result && EAGAIN == errno) {
+                /* the write owed has not happened yet, it settles itself */
+                break;
+            }
+            seagrass_required_true(sizeof(value) == result);
+            atomic_fetch_sub(&object->debits, 1);
+        }
+    } while ((requests = atomic_fetch_sub(&object->settling, requests)
+                         - requests));
+}
+
+static void added(struct octopus_concurrent_linked_queue *const object,
+                  const uintmax_t count) {
+    assert(object);
+    assert(count);
+    if (object->event_fd < 0
+        || 0 != atomic_fetch_add(&object->count, (intmax_t) count)) {
+        return;
+    }
+    /* queue went from empty to not empty */
+    const uint64_t value = 1;
+    ssize_t result;
+    do {
+        result = write(object->event_fd, &value, sizeof(value));
+    } while (-1 == result && EINTR == errno);
+    seagrass_required_true(sizeof(value) == result);
+    /* a consumer may have found the eventfd empty before this write */
+    if (atomic_load(&object->debits)) {
+        settle(object);
+    }
+}
+
+static uintmax_t limit_of(
+        const struct octopus_concurrent_linked_queue *const object,
+        const uintmax_t at) {
+    assert(object);
+    const uintmax_t c = 1 + object->mask;
+    return object->capacity / c + (at < object->capacity % c);
+}
+
+/* reserve space for up to count items on the first shard from at onwards
+ * with any space, count receives how many were reserved */
+static bool reserve_some(
+        struct octopus_concurrent_linked_queue *const object,
+        const uintmax_t at,
+        uintmax_t *const count,
+        uintmax_t *const out) {
     assert(object);
+    assert(count && *count);
     assert(out);
-    seagrass_required_true(coral_array_list_get_length(
-            &object->queues, out));
+    if (!object->counters) {
+        *out = at & object->mask;
+        return true;
+    }
+    for (uintmax_t i = 0; i <= object->mask; i++) {
+        const uintmax_t index = (at + i) & object->mask;
+        const uintmax_t limit = limit_of(object, index);
+        atomic_uintmax_t *const value = &object->counters[index].value;
+        uintmax_t used = atomic_load_explicit(value, memory_order_relaxed);
+        while (used < limit) {
+            const uintmax_t wanted = limit - used < *count
+                                     ? limit - used
+                                     : *count;
+            if (atomic_compare_exchange_weak_explicit(
+                    value, &used, used + wanted,
+                    memory_order_relaxed, memory_order_relaxed)) {
+                *count = wanted;
+                *out = index;
+                return true;
+            }
+        }
+    }
+    return false;
 }
 
-static bool remove(struct octopus_concurrent_linked_queue *const object,
-                   void **const out) {
+static bool reserve(struct octopus_concurrent_linked_queue *const object,
+                    const uintmax_t at,
+                    uintmax_t *const out) {
+    uintmax_t count = 1;
+    return reserve_some(object, at, &count, out);
+}
+
+static bool has_space(
+        const struct octopus_concurrent_linked_queue *const object) {
+    assert(object);
+    for (uintmax_t i = 0; i <= object->mask; i++) {
+        if (atomic_load_explicit(&object->counters[i].value,
+                                 memory_order_relaxed)
+            < limit_of(object, i)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* move a reservation made for the shard at onto the next shard with space */
+static uintmax_t move(struct octopus_concurrent_linked_queue *const object,
+                      const uintmax_t at) {
+    assert(object);
+    uintmax_t next;
+    if (!reserve(object, at + 1, &next)) {
+        return at;
+    }
+    if (object->counters) {
+        /* the space is taken up again by the new reservation so nobody
+         * blocked on a full queue needs to be woken up */
+        atomic_fetch_sub_explicit(&object->counters[at].value, 1,
+                                  memory_order_relaxed);
+    }
+    return next;
+}
+
+static void release_some(
+        struct octopus_concurrent_linked_queue *const object,
+        const uintmax_t at,
+        const uintmax_t count) {
+    assert(object);
+    if (!object->counters) {
+        return;
+    }
+    atomic_fetch_sub_explicit(&object->counters[at & object->mask].value,
+                              count, memory_order_relaxed);
+    /* pairs with the fence in octopus_concurrent_linked_queue_put so that
+     * either a blocked producer sees the space or we see the producer */
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&object->blocked, memory_order_relaxed)) {
+        seagrass_required_true(!pthread_mutex_lock(&object->lock));
+        seagrass_required_true(!pthread_cond_broadcast(&object->space));
+        seagrass_required_true(!pthread_mutex_unlock(&object->lock));
+    }
+}
+
+static void release(struct octopus_concurrent_linked_queue *const object,
+                    const uintmax_t at) {
+    release_some(object, at, 1);
+}
+
+static void removed(struct octopus_concurrent_linked_queue *const object,
+                    const uintmax_t at) {
+    assert(object);
+    release(object, at);
+    if (object->event_fd < 0
+        || 1 != atomic_fetch_sub(&object->count, 1)) {
+        return;
+    }
+    /* queue went from not empty to empty, the eventfd is in semaphore mode
+     * so this read undoes the write made by the matching transition from
+     * empty to not empty, if that write has not happened yet a debit is left
+     * for it to settle rather than waiting */
+    uint64_t value;
+    ssize_t result;
+    do {
+        result = read(object->event_fd, &value, sizeof(value));
+    } while (-1 == result && EINTR == errno);
+    if (-1 == result && EAGAIN == errno) {
+        atomic_fetch_add(&object->debits, 1);
+        settle(object);
+        return;
+    }
+    seagrass_required_true(sizeof(value) == result);
+}
+
+/* take over a stage or record left behind by a thread that has exited */
+static bool adopt(atomic_bool *const used) {
+    assert(used);
+    bool expected = false;
+    return !atomic_load_explicit(used, memory_order_relaxed)
+           && atomic_compare_exchange_strong(used, &expected, true);
+}
+
+static void on_record_exit(void *const arg) {
+    struct octopus_concurrent_linked_queue_record *const record = arg;
+    atomic_store_explicit(&record->used, false, memory_order_release);
+}
+
+static struct octopus_concurrent_linked_queue_record *record_of(
+        struct octopus_concurrent_linked_queue *const object) {
+    assert(object);
+    struct octopus_concurrent_linked_queue_record *record =
+            pthread_getspecific(object->record);
+    if (record) {
+        return record;
+    }
+    for (record = atomic_load(&object->records);
+         record && !adopt(&record->used);
+         record = record->next);
+    if (!record) {
+        if (!(record = octopus_allocate(&object->allocator, sizeof(*record),
+                                        OCTOPUS_CACHE_LINE_SIZE))) {
+            return NULL;
+        }
+        *record = (struct octopus_concurrent_linked_queue_record) {0};
+        atomic_init(&record->used, true);
+        atomic_init(&record->pending, 0);
+        struct octopus_concurrent_linked_queue_record *head = atomic_load(
+                &object->records);
+        do {
+            record->next = head;
+        } while (!atomic_compare_exchange_weak(&object->records, &head,
+                                               record));
+    }
+    if (pthread_setspecific(object->record, record)) {
+        atomic_store_explicit(&record->used, false, memory_order_release);
+        return NULL;
+    }
+    return record;
+}
+
+/* must be the combiner of the shard at */
+static void apply(struct octopus_concurrent_linked_queue *const object,
+                  const uintmax_t at) {
+    assert(object);
+    struct octopus_linked_queue *const queue = &object->queues[at];
+    uintmax_t count;
+    uintmax_t passes = 0;
+    do {
+        count = 0;
+        for (struct octopus_concurrent_linked_queue_record *record
+                = atomic_load_explicit(&object->records, memory_order_acquire);
+             record; record = record->next) {
+            /* only we mark operations on this shard as done, so once we have
+             * seen one its record stays as it is until we do */
+            if (1 + at != atomic_load_explicit(&record->pending,
+                                               memory_order_acquire)) {
+                continue;
+            }
+            record->result = record->out
+                             ? octopus_linked_queue_remove(queue, record->out)
+                             : octopus_linked_queue_add(queue, record->item);
+            if (!record->result) {
+                record->error = octopus_error;
+            }
+            atomic_store_explicit(&record->pending, 0, memory_order_release);
+            count++;
+        }
+        OCTOPUS_PROBE2(shard__combine, queue, count);
+    } while (count && ++passes < PASSES);
+}
+
+/* add item to, or if out is given remove an item from, the shard at */
+static bool combine(struct octopus_concurrent_linked_queue *const object,
+                    const uintmax_t at,
+                    const void *const item,
+                    void **const out) {
+    assert(object);
+    assert(item || out);
+    struct octopus_linked_queue *const queue = &object->queues[at];
+    struct octopus_concurrent_linked_queue_record *const record = record_of(
+            object);
+    if (!record) {
+        /* the combiner takes the shard's locks too, so we may just as well
+         * wait for them ourselves */
+        return out
+               ? octopus_linked_queue_remove(queue, out)
+               : octopus_linked_queue_add(queue, item);
+    }
+    record->item = item;
+    record->out = out;
+    atomic_store_explicit(&record->pending, 1 + at, memory_order_release);
+    atomic_bool *const busy = &object->combiners[at].busy;
+    for (uintmax_t i = 0; atomic_load_explicit(&record->pending,
+                                               memory_order_acquire); i++) {
+        if (!atomic_load_explicit(busy, memory_order_relaxed)
+            && !atomic_exchange_explicit(busy, true, memory_order_acquire)) {
+            apply(object, at);
+            atomic_store_explicit(busy, false, memory_order_release);
+        } else if (i >= SPINS) {
+            sched_yield();
+        }
+    }
+    if (!record->result) {
+        octopus_error = record->error;
+    }
+    return record->result;
+}
+
+static bool take(struct octopus_concurrent_linked_queue *const object,
+                 const uintmax_t at,
+                 void **const out,
+                 uintmax_t *const index) {
+    assert(object);
+    assert(out);
+    assert(index);
+    if (object->combiners) {
+        *index = at & object->mask;
+        const bool result = combine(object, *index, NULL, out);
+        assert(result || OCTOPUS_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY
+                         == octopus_error);
+        return result;
+    }
+    for (uintmax_t i = 0; i < object->probes && i <= object->mask; i++) {
+        const uintmax_t shard = (at + i) & object->mask;
+        if (octopus_linked_queue_remove_unless_busy(
+                &object->queues[shard], out)) {
+            *index = shard;
+            return true;
+        }
+        if (OCTOPUS_LINKED_QUEUE_ERROR_LOCK_IS_BUSY != octopus_error) {
+            assert(OCTOPUS_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY == octopus_error);
+            break;
+        }
+    }
+    *index = at & object->mask;
+    return retrieve(object, at, out, octopus_linked_queue_remove);
+}
+
+static bool dequeue(struct octopus_concurrent_linked_queue *const object,
+                    void **const out) {
     assert(object);
     assert(out);
-    uintmax_t c;
-    concurrency(object, &c);
+    const uintmax_t c = 1 + object->mask;
     const uintmax_t begin = atomic_fetch_add(&object->dequeue, 1);
     const uintmax_t end = begin + c; /* allow integer overflow */
     uintmax_t at = begin;
-    while ((begin < end && at < end)
-           || ((begin > end && at >= begin) || at < end)) {
-        if (retrieve(object, c, at, out, octopus_linked_queue_remove)) {
+    uintmax_t index;
+    while (octopus_concurrent_queue_in_window(begin, end, at)) {
+        OCTOPUS_PROBE3(queue__select, object, at, at & object->mask);
+        if (take(object, at, out, &index)) {
+            removed(object, index);
+            OCTOPUS_PROBE2(queue__remove, object, index);
             return true;
         }
         at = atomic_fetch_add(&object->dequeue, 1);
     }
-    if (retrieve(object, c, at, out, octopus_linked_queue_remove)) {
+    OCTOPUS_PROBE3(queue__select, object, at, at & object->mask);
+    if (take(object, at, out, &index)) {
+        removed(object, index);
+        OCTOPUS_PROBE2(queue__remove, object, index);
         return true;
     }
+    OCTOPUS_PROBE1(queue__empty, object);
     octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY;
     return false;
 }
 
+static void destroy(struct octopus_concurrent_linked_queue *const object,
+                    const uintmax_t count) {
+    assert(object);
+    for (uintmax_t i = 0; i < count; i++) {
+        seagrass_required_true(octopus_linked_queue_invalidate(
+                &object->queues[i], NULL));
+    }
+    const uintmax_t shards = 1 + object->mask;
+    octopus_deallocate(
+            &object->allocator, object->counters,
+            shards * sizeof(struct octopus_concurrent_linked_queue_counter));
+    octopus_deallocate(&object->allocator, object->queues,
+                       shards * sizeof(struct octopus_linked_queue));
+    *object = (struct octopus_concurrent_linked_queue) {0};
+}
+
 bool octopus_concurrent_linked_queue_init(
         struct octopus_concurrent_linked_queue *const object,
         const size_t size,
         const uintmax_t concurrency) {
+    return octopus_concurrent_linked_queue_init_with_capacity(
+            object, size, concurrency, 0);
+}
+
+bool octopus_concurrent_linked_queue_init_with_capacity(
+        struct octopus_concurrent_linked_queue *const object,
+        const size_t size,
+        const uintmax_t concurrency,
+        const uintmax_t capacity) {
+    return octopus_concurrent_linked_queue_init_with_allocator(
+            object, size, concurrency, capacity, NULL);
+}
+
+bool octopus_concurrent_linked_queue_init_with_allocator(
+        struct octopus_concurrent_linked_queue *const object,
+        const size_t size,
+        const uintmax_t concurrency,
+        const uintmax_t capacity,
+        const struct octopus_allocator *const allocator) {
     if (!object) {
         octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
         return false;
@@ -81,23 +477,50 @@ bool octopus_concurrent_linked_queue_init(
                 OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_CONCURRENCY_IS_ZERO;
         return false;
     }
-    *object = (struct octopus_concurrent_linked_queue) {0};
-    if (!coral_array_list_init(&object->queues,
-                               sizeof(struct octopus_linked_queue),
-                               concurrency)) {
-        seagrass_required_true(CORAL_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED
-                               == coral_error);
+    if (allocator && (!allocator->alloc || !allocator->free)) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_ALLOCATOR_IS_INVALID;
+        return false;
+    }
+    *object = (struct octopus_concurrent_linked_queue) {
+            .event_fd = -1
+    };
+    if (allocator) {
+        object->allocator = *allocator;
+    }
+    uintmax_t count;
+    uintmax_t bytes;
+    if (!octopus_concurrent_queue_shards(concurrency, &count)
+        || !seagrass_uintmax_t_multiply(
+                count, sizeof(struct octopus_linked_queue), &bytes)
+        || bytes > SIZE_MAX
+        || !(object->queues = octopus_allocate(
+                &object->allocator, bytes, OCTOPUS_CACHE_LINE_SIZE))) {
+        *object = (struct octopus_concurrent_linked_queue) {0};
         octopus_error =
                 OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
         return false;
     }
-    seagrass_required_true(coral_array_list_set_length(
-            &object->queues, concurrency));
-    for (uintmax_t i = 0; i < concurrency; i++) {
-        struct octopus_linked_queue *item;
-        seagrass_required_true(coral_array_list_get(
-                &object->queues, i, (void **) &item));
-        if (!octopus_linked_queue_init(item, size)) {
+    object->mask = count - 1;
+    if (capacity) {
+        if (!seagrass_uintmax_t_multiply(
+                count, sizeof(struct octopus_concurrent_linked_queue_counter),
+                &bytes)
+            || bytes > SIZE_MAX
+            || !(object->counters = octopus_allocate(
+                    &object->allocator, bytes, OCTOPUS_CACHE_LINE_SIZE))) {
+            destroy(object, 0);
+            octopus_error =
+                    OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+            return false;
+        }
+        for (uintmax_t i = 0; i < count; i++) {
+            atomic_init(&object->counters[i].value, 0);
+        }
+    }
+    for (uintmax_t i = 0; i < count; i++) {
+        if (!octopus_linked_queue_init_with_allocator(
+                &object->queues[i], size, &object->allocator)) {
             uintmax_t error;
             switch (octopus_error) {
                 default: {
@@ -114,20 +537,28 @@ bool octopus_concurrent_linked_queue_init(
                     break;
                 }
             }
-            for (uintmax_t o = 0; o < i; o++) {
-                struct octopus_linked_queue *queue;
-                seagrass_required_true(coral_array_list_get(
-                        &object->queues, o, (void **) &queue));
-                seagrass_required_true(octopus_linked_queue_invalidate(
-                        queue, NULL));
-            }
-            seagrass_required_true(coral_array_list_invalidate(
-                    &object->queues, NULL));
-            *object = (struct octopus_concurrent_linked_queue) {0};
+            destroy(object, i);
             octopus_error = error;
             return false;
         }
     }
+    int error;
+    if ((error = pthread_mutex_init(&object->lock, NULL))) {
+        seagrass_required_true(ENOMEM == error);
+        destroy(object, count);
+        octopus_error =
+                OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    if ((error = octopus_deadline_condition_init(&object->space))) {
+        seagrass_required_true(ENOMEM == error || EAGAIN == error);
+        seagrass_required_true(!pthread_mutex_destroy(&object->lock));
+        destroy(object, count);
+        octopus_error =
+                OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    object->capacity = capacity;
     return true;
 }
 
@@ -138,12 +569,26 @@ bool octopus_concurrent_linked_queue_invalidate(
         octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
         return false;
     }
-    uintmax_t count;
-    seagrass_required_true(coral_array_list_get_length(
-            &object->queues, &count));
-    if (count) {
+    if (object->queues) {
+        if (object->combiners) {
+            seagrass_required_true(!pthread_key_delete(object->record));
+            struct octopus_concurrent_linked_queue_record *record
+                    = atomic_load(&object->records);
+            while (record) {
+                struct octopus_concurrent_linked_queue_record *const next
+                        = record->next;
+                octopus_deallocate(&object->allocator, record,
+                                   sizeof(*record));
+                record = next;
+            }
+            octopus_deallocate(
+                    &object->allocator, object->combiners,
+                    (1 + object->mask)
+                    * sizeof(struct octopus_concurrent_linked_queue_combiner));
+            object->combiners = NULL;
+        }
         void *out;
-        while (remove(object, &out)) {
+        while (dequeue(object, &out)) {
             if (on_destroy) {
                 on_destroy(out);
             }
@@ -151,9 +596,33 @@ bool octopus_concurrent_linked_queue_invalidate(
         seagrass_required_true(
                 OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY
                 == octopus_error);
+        if (object->staging) {
+            seagrass_required_true(!pthread_key_delete(object->key));
+            const size_t size = object->queues[0].size;
+            struct octopus_concurrent_linked_queue_stage *stage
+                    = atomic_load(&object->stages);
+            while (stage) {
+                struct octopus_concurrent_linked_queue_stage *const next
+                        = stage->next;
+                /* handed over the same way as the items removed above */
+                for (uintmax_t i = 0; on_destroy && i < stage->count; i++) {
+                    void *item = NULL;
+                    memcpy(&item, stage->items + i * size,
+                           size < sizeof(item) ? size : sizeof(item));
+                    on_destroy(item);
+                }
+                octopus_deallocate(&object->allocator, stage,
+                                   sizeof(*stage) + object->staging * size);
+                stage = next;
+            }
+        }
+        if (object->event_fd >= 0) {
+            seagrass_required_true(!close(object->event_fd));
+        }
+        seagrass_required_true(!pthread_cond_destroy(&object->space));
+        seagrass_required_true(!pthread_mutex_destroy(&object->lock));
+        destroy(object, 1 + object->mask);
     }
-    seagrass_required_true(coral_array_list_invalidate(
-            &object->queues, NULL));
     *object = (struct octopus_concurrent_linked_queue) {0};
     return true;
 }
@@ -169,10 +638,8 @@ bool octopus_concurrent_linked_queue_size(
         octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OUT_IS_NULL;
         return false;
     }
-    const struct octopus_linked_queue *queue;
-    seagrass_required_true(coral_array_list_get(
-            &object->queues, 0, (void **) &queue));
-    seagrass_required_true(octopus_linked_queue_size(queue, out));
+    seagrass_required_true(octopus_linked_queue_size(
+            &object->queues[0], out));
     return true;
 }
 
@@ -187,7 +654,86 @@ bool octopus_concurrent_linked_queue_concurrency(
         octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OUT_IS_NULL;
         return false;
     }
-    concurrency(object, out);
+    *out = 1 + object->mask;
+    return true;
+}
+
+bool octopus_concurrent_linked_queue_capacity(
+        const struct octopus_concurrent_linked_queue *const object,
+        uintmax_t *const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    *out = object->capacity;
+    return true;
+}
+
+/* count items have been added to the shard at */
+static void notify(struct octopus_concurrent_linked_queue *const object,
+                   const uintmax_t at,
+                   const uintmax_t count) {
+    assert(object);
+    added(object, count);
+    OCTOPUS_PROBE2(queue__add, object, at);
+    /* pairs with the fence in octopus_select_remove so that either a waiter
+     * finds the item or we find the waiter, once a select registered for
+     * membarriers the full fence is issued by the select instead */
+    octopus_membarrier_light(atomic_load_explicit(
+            &octopus_select_expedited, memory_order_relaxed));
+    if (atomic_load_explicit(&object->waiters, memory_order_relaxed)) {
+        octopus_select_wake(object);
+    }
+}
+
+static bool insert(struct octopus_concurrent_linked_queue *const object,
+                   const void *const item) {
+    assert(object);
+    assert(item);
+    const uintmax_t ticket = atomic_fetch_add(&object->enqueue, 1);
+    uintmax_t at;
+    if (!reserve(object, ticket, &at)) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_FULL;
+        return false;
+    }
+    OCTOPUS_PROBE3(queue__select, object, ticket, at);
+    bool result = false;
+    bool busy = true;
+    for (uintmax_t i = 0; !object->combiners && i < object->probes
+                          && i <= object->mask; i++) {
+        if (i) {
+            at = move(object, at);
+        }
+        if ((result = octopus_linked_queue_add_unless_busy(
+                &object->queues[at], item))) {
+            break;
+        }
+        if (OCTOPUS_LINKED_QUEUE_ERROR_LOCK_IS_BUSY != octopus_error) {
+            busy = false;
+            break;
+        }
+    }
+    if (!result && busy) {
+        result = object->combiners
+                 ? combine(object, at, item, NULL)
+                 : octopus_linked_queue_add(&object->queues[at], item);
+    }
+    if (!result) {
+        assert(OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED
+               == octopus_error
+               || OCTOPUS_LINKED_QUEUE_ERROR_SPILL_FAILED == octopus_error);
+        release(object, at);
+        octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_SPILL_FAILED
+                        == octopus_error
+                        ? OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_SPILL_FAILED
+                        : OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    notify(object, at, 1);
     return true;
 }
 
@@ -202,26 +748,206 @@ bool octopus_concurrent_linked_queue_add(
         octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_ITEM_IS_NULL;
         return false;
     }
-    uintmax_t c;
-    concurrency(object, &c);
-    const uintmax_t begin = atomic_fetch_add(&object->enqueue, 1);
-    uintmax_t at;
-    seagrass_required_true(seagrass_uintmax_t_divide(
-            begin, c, &at, NULL));
-    struct octopus_linked_queue *queue;
-    seagrass_required_true(coral_array_list_get(
-            &object->queues, at, (void **) &queue));
-    const bool result = octopus_linked_queue_add(queue, item);
-    if (!result) {
-        seagrass_required_true(
-                OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED
-                == octopus_error);
+    return insert(object, item);
+}
+
+bool octopus_concurrent_linked_queue_put(
+        struct octopus_concurrent_linked_queue *const object,
+        const void *const item,
+        const struct timespec *const timeout) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!item) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_ITEM_IS_NULL;
+        return false;
+    }
+    if (timeout && !octopus_deadline_is_valid(timeout)) {
         octopus_error =
-                OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+                OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_TIMEOUT_IS_INVALID;
+        return false;
+    }
+    struct timespec deadline;
+    if (timeout) {
+        octopus_deadline_of(timeout, &deadline);
+    }
+    bool timed_out = false;
+    while (!insert(object, item)) {
+        if (OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_FULL
+            != octopus_error) {
+            return false;
+        }
+        if (timed_out) {
+            octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_TIMED_OUT;
+            return false;
+        }
+        seagrass_required_true(!pthread_mutex_lock(&object->lock));
+        atomic_fetch_add_explicit(&object->blocked, 1, memory_order_relaxed);
+        /* pairs with the fence in release() so that either we see the space
+         * or the consumer sees us blocked */
+        atomic_thread_fence(memory_order_seq_cst);
+        while (!has_space(object) && !timed_out) {
+            if (!timeout) {
+                seagrass_required_true(!pthread_cond_wait(
+                        &object->space, &object->lock));
+                continue;
+            }
+            const int error = pthread_cond_timedwait(
+                    &object->space, &object->lock, &deadline);
+            seagrass_required_true(!error || ETIMEDOUT == error);
+            timed_out = ETIMEDOUT == error;
+        }
+        atomic_fetch_sub_explicit(&object->blocked, 1, memory_order_relaxed);
+        seagrass_required_true(!pthread_mutex_unlock(&object->lock));
+    }
+    return true;
+}
+
+static uintmax_t nanoseconds_of(const struct timespec *const time) {
+    assert(time);
+    return (uintmax_t) time->tv_sec * UINTMAX_C(1000000000)
+           + (uintmax_t) time->tv_nsec;
+}
+
+static uintmax_t now(const struct octopus_concurrent_linked_queue *const object) {
+    assert(object);
+    struct timespec time;
+    seagrass_required_true(!clock_gettime(object->clock, &time));
+    return nanoseconds_of(&time);
+}
+
+/* add the staged items to the queue, those that could not be added are
+ * moved to the front of the buffer */
+static bool drain(struct octopus_concurrent_linked_queue *const object,
+                  struct octopus_concurrent_linked_queue_stage *const stage) {
+    assert(object);
+    assert(stage);
+    const size_t size = object->queues[0].size;
+    bool result = true;
+    uintmax_t done = 0;
+    while (done < stage->count) {
+        const uintmax_t ticket = atomic_fetch_add(&object->enqueue, 1);
+        uintmax_t count = stage->count - done;
+        uintmax_t at;
+        if (!reserve_some(object, ticket, &count, &at)) {
+            octopus_error =
+                    OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_FULL;
+            result = false;
+            break;
+        }
+        OCTOPUS_PROBE3(queue__select, object, ticket, at);
+        uintmax_t added;
+        result = octopus_linked_queue_add_all(
+                &object->queues[at], stage->items + done * size, count,
+                &added);
+        if (added < count) {
+            release_some(object, at, count - added);
+        }
+        if (added) {
+            done += added;
+            notify(object, at, added);
+        }
+        if (!result) {
+            assert(OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED
+                   == octopus_error
+                   || OCTOPUS_LINKED_QUEUE_ERROR_SPILL_FAILED
+                      == octopus_error);
+            octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_SPILL_FAILED
+                            == octopus_error
+                            ? OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_SPILL_FAILED
+                            : OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+            break;
+        }
+    }
+    if (done && done < stage->count) {
+        memmove(stage->items, stage->items + done * size,
+                (stage->count - done) * size);
+    }
+    if (!(stage->count -= done)) {
+        atomic_store_explicit(&stage->deadline, UINTMAX_MAX,
+                              memory_order_relaxed);
     }
     return result;
 }
 
+/* wait for a consumer to finish adding the items of a stage past its
+ * deadline */
+static void claim(struct octopus_concurrent_linked_queue_stage *const stage) {
+    assert(stage);
+    bool expected = false;
+    for (uintmax_t spins = 0;
+         !atomic_compare_exchange_weak_explicit(
+                 &stage->busy, &expected, true,
+                 memory_order_acquire, memory_order_relaxed);
+         expected = false) {
+        if (++spins > SPINS) {
+            sched_yield();
+        }
+    }
+}
+
+static void unclaim(struct octopus_concurrent_linked_queue_stage *const stage) {
+    assert(stage);
+    atomic_store_explicit(&stage->busy, false, memory_order_release);
+}
+
+static void on_thread_exit(void *const arg) {
+    struct octopus_concurrent_linked_queue_stage *const stage = arg;
+    /* whatever cannot be added now stays staged for the thread that adopts
+     * the buffer next or is destroyed when the queue is invalidated */
+    claim(stage);
+    (void) drain(stage->queue, stage);
+    unclaim(stage);
+    atomic_store_explicit(&stage->used, false, memory_order_release);
+}
+
+/* add the items of every stage whose deadline has passed, skipping those
+ * another thread is busy with, returns whether any items were added */
+static bool expire(struct octopus_concurrent_linked_queue *const object) {
+    assert(object);
+    if (UINTMAX_MAX == object->latency) {
+        return false;
+    }
+    struct octopus_concurrent_linked_queue_stage *stage = atomic_load(
+            &object->stages);
+    if (!stage) {
+        return false;
+    }
+    const uintmax_t error = octopus_error;
+    const uintmax_t time = now(object);
+    bool result = false;
+    for (; stage; stage = stage->next) {
+        bool expected = false;
+        if (atomic_load_explicit(&stage->deadline, memory_order_relaxed) > time
+            || atomic_load_explicit(&stage->busy, memory_order_relaxed)
+            || !atomic_compare_exchange_strong_explicit(
+                    &stage->busy, &expected, true,
+                    memory_order_acquire, memory_order_relaxed)) {
+            continue;
+        }
+        const uintmax_t count = stage->count;
+        if (count && atomic_load_explicit(&stage->deadline,
+                                          memory_order_relaxed) <= time) {
+            (void) drain(object, stage);
+            result |= stage->count < count;
+        }
+        unclaim(stage);
+    }
+    octopus_error = error;
+    return result;
+}
+
+/* a consumer finding the queue empty adds the items staged for too long
+ * before looking again, so that a producer gone quiet does not hold them */
+static bool remove(struct octopus_concurrent_linked_queue *const object,
+                   void **const out) {
+    assert(object);
+    assert(out);
+    return dequeue(object, out)
+           || (object->staging && expire(object) && dequeue(object, out));
+}
+
 bool octopus_concurrent_linked_queue_remove(
         struct octopus_concurrent_linked_queue *const object,
         void **const out) {
@@ -247,20 +973,383 @@ bool octopus_concurrent_linked_queue_peek(
         octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OUT_IS_NULL;
         return false;
     }
-    uintmax_t c;
-    concurrency(object, &c);
+    const uintmax_t c = 1 + object->mask;
     const uintmax_t begin = atomic_load(&object->dequeue);
     const uintmax_t end = begin + c; /* allow integer overflow */
     uintmax_t at = begin;
-    for (; (begin < end && at < end)
-           || ((begin > end && at >= begin) || at < end); at++) {
-        if (retrieve(object, c, at, out, octopus_linked_queue_peek)) {
+    for (; octopus_concurrent_queue_in_window(begin, end, at); at++) {
+        if (retrieve(object, at, out, octopus_linked_queue_peek)) {
             return true;
         }
     }
-    if (retrieve(object, c, at, out, octopus_linked_queue_peek)) {
+    if (retrieve(object, at, out, octopus_linked_queue_peek)) {
         return true;
     }
     octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY;
     return false;
 }
+
+bool octopus_concurrent_linked_queue_memory_usage(
+        const struct octopus_concurrent_linked_queue *const object,
+        uintmax_t *const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    uintmax_t result = 0;
+    if (object->queues) {
+        result = (1 + object->mask) * sizeof(struct octopus_linked_queue);
+        if (object->counters) {
+            result += (1 + object->mask)
+                      * sizeof(struct octopus_concurrent_linked_queue_counter);
+        }
+        for (uintmax_t i = 0; i <= object->mask; i++) {
+            uintmax_t bytes;
+            seagrass_required_true(octopus_linked_queue_memory_usage(
+                    &object->queues[i], &bytes));
+            result += bytes;
+        }
+        const size_t size = object->queues[0].size;
+        for (struct octopus_concurrent_linked_queue_stage *stage
+                = atomic_load(&object->stages); stage; stage = stage->next) {
+            result += sizeof(*stage) + object->staging * size;
+        }
+        if (object->combiners) {
+            result += (1 + object->mask)
+                      * sizeof(struct octopus_concurrent_linked_queue_combiner);
+        }
+        for (struct octopus_concurrent_linked_queue_record *record
+                = atomic_load(&object->records); record;
+             record = record->next) {
+            result += sizeof(*record);
+        }
+    }
+    *out = result;
+    return true;
+}
+
+bool octopus_concurrent_linked_queue_trim(
+        struct octopus_concurrent_linked_queue *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (object->queues) {
+        for (uintmax_t i = 0; i <= object->mask; i++) {
+            seagrass_required_true(octopus_linked_queue_trim(
+                    &object->queues[i]));
+        }
+    }
+    return true;
+}
+
+bool octopus_concurrent_linked_queue_attach_event_fd(
+        struct octopus_concurrent_linked_queue *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (object->event_fd >= 0) {
+        return true;
+    }
+#ifdef __linux__
+    const int fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK | EFD_SEMAPHORE);
+    if (fd < 0) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_EVENT_FD_FAILED;
+        return false;
+    }
+    uintmax_t count = 0;
+    for (uintmax_t i = 0; i <= object->mask; i++) {
+        uintmax_t items;
+        seagrass_required_true(octopus_linked_queue_count(
+                &object->queues[i], &items));
+        count += items;
+    }
+    object->event_fd = fd;
+    atomic_store(&object->count, 0);
+    if (count) {
+        added(object, 1);
+        atomic_store(&object->count, (intmax_t) count);
+    }
+    return true;
+#else
+    octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_EVENT_FD_FAILED;
+    return false;
+#endif
+}
+
+bool octopus_concurrent_linked_queue_event_fd(
+        const struct octopus_concurrent_linked_queue *const object,
+        int *const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    if (object->event_fd < 0) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_EVENT_FD_IS_NOT_ATTACHED;
+        return false;
+    }
+    *out = object->event_fd;
+    return true;
+}
+
+bool octopus_concurrent_linked_queue_attach_spill(
+        struct octopus_concurrent_linked_queue *const object,
+        const char *const directory,
+        const uintmax_t threshold) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!directory) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_DIRECTORY_IS_NULL;
+        return false;
+    }
+    const uintmax_t c = 1 + object->mask;
+    for (uintmax_t i = 0; i < c; i++) {
+        if (!octopus_linked_queue_attach_spill(
+                &object->queues[i], directory,
+                threshold / c + (i < threshold % c),
+                OCTOPUS_CONCURRENT_LINKED_QUEUE_SPILL_SEGMENT_SIZE)) {
+            uintmax_t error;
+            switch (octopus_error) {
+                default: {
+                    seagrass_required_true(false);
+                }
+                case OCTOPUS_LINKED_QUEUE_ERROR_SIZE_IS_TOO_LARGE: {
+                    error =
+                            OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_SIZE_IS_TOO_LARGE;
+                    break;
+                }
+                case OCTOPUS_LINKED_QUEUE_ERROR_SPILL_FAILED: {
+                    error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_SPILL_FAILED;
+                    break;
+                }
+                case OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED: {
+                    error =
+                            OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+                    break;
+                }
+            }
+            while (i--) {
+                seagrass_required_true(octopus_linked_queue_detach_spill(
+                        &object->queues[i]));
+            }
+            octopus_error = error;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool octopus_concurrent_linked_queue_set_probes(
+        struct octopus_concurrent_linked_queue *const object,
+        const uintmax_t probes) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    object->probes = probes;
+    return true;
+}
+
+bool octopus_concurrent_linked_queue_attach_staging(
+        struct octopus_concurrent_linked_queue *const object,
+        const uintmax_t count,
+        const struct timespec *const latency) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!count) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_COUNT_IS_ZERO;
+        return false;
+    }
+    if (object->staging) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_STAGING_IS_ATTACHED;
+        return false;
+    }
+    const size_t size = object->queues[0].size;
+    uintmax_t bytes;
+    if (!seagrass_uintmax_t_multiply(count, size, &bytes)
+        || bytes > SIZE_MAX - sizeof(struct octopus_concurrent_linked_queue_stage)) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_SIZE_IS_TOO_LARGE;
+        return false;
+    }
+    if (pthread_key_create(&object->key, on_thread_exit)) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    object->staging = count;
+    object->latency = latency ? nanoseconds_of(latency) : UINTMAX_MAX;
+    object->clock = CLOCK_MONOTONIC;
+#ifdef CLOCK_MONOTONIC_COARSE
+    /* the precise clock costs as much to read as adding an item does */
+    struct timespec resolution;
+    if (latency && !clock_getres(CLOCK_MONOTONIC_COARSE, &resolution)
+        && nanoseconds_of(&resolution) <= object->latency) {
+        object->clock = CLOCK_MONOTONIC_COARSE;
+    }
+#endif
+    atomic_init(&object->stages, NULL);
+    return true;
+}
+
+static struct octopus_concurrent_linked_queue_stage *stage_of(
+        struct octopus_concurrent_linked_queue *const object) {
+    assert(object);
+    struct octopus_concurrent_linked_queue_stage *stage = pthread_getspecific(
+            object->key);
+    if (stage) {
+        return stage;
+    }
+    /* reuse the buffer of a thread that has exited */
+    for (stage = atomic_load(&object->stages);
+         stage && !adopt(&stage->used);
+         stage = stage->next);
+    if (!stage) {
+        const size_t size = object->queues[0].size;
+        if (!(stage = octopus_allocate(
+                &object->allocator, sizeof(*stage) + object->staging * size,
+                OCTOPUS_CACHE_LINE_SIZE))) {
+            octopus_error =
+                    OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+            return NULL;
+        }
+        *stage = (struct octopus_concurrent_linked_queue_stage) {
+                .queue = object
+        };
+        atomic_init(&stage->deadline, UINTMAX_MAX);
+        atomic_init(&stage->busy, false);
+        atomic_init(&stage->used, true);
+        struct octopus_concurrent_linked_queue_stage *head = atomic_load(
+                &object->stages);
+        do {
+            stage->next = head;
+        } while (!atomic_compare_exchange_weak(&object->stages, &head,
+                                               stage));
+    }
+    if (pthread_setspecific(object->key, stage)) {
+        atomic_store_explicit(&stage->used, false, memory_order_release);
+        octopus_error =
+                OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+        return NULL;
+    }
+    return stage;
+}
+
+bool octopus_concurrent_linked_queue_stage(
+        struct octopus_concurrent_linked_queue *const object,
+        const void *const item) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!item) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_ITEM_IS_NULL;
+        return false;
+    }
+    if (!object->staging) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_STAGING_IS_NOT_ATTACHED;
+        return false;
+    }
+    struct octopus_concurrent_linked_queue_stage *const stage = stage_of(
+            object);
+    if (!stage) {
+        return false;
+    }
+    const bool timed = UINTMAX_MAX != object->latency;
+    claim(stage);
+    if (stage->count
+        && (stage->count == object->staging
+            || (timed && now(object) >= atomic_load_explicit(
+                    &stage->deadline, memory_order_relaxed)))
+        && !drain(object, stage)) {
+        unclaim(stage);
+        return false;
+    }
+    const size_t size = object->queues[0].size;
+    memcpy(stage->items + stage->count * size, item, size);
+    if (!stage->count++ && timed) {
+        atomic_store_explicit(&stage->deadline, now(object) + object->latency,
+                              memory_order_relaxed);
+    }
+    if (stage->count == object->staging) {
+        /* should this fail the items are added on the next call instead,
+         * which reports the error should it persist */
+        (void) drain(object, stage);
+    }
+    unclaim(stage);
+    return true;
+}
+
+bool octopus_concurrent_linked_queue_flush(
+        struct octopus_concurrent_linked_queue *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!object->staging) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_STAGING_IS_NOT_ATTACHED;
+        return false;
+    }
+    struct octopus_concurrent_linked_queue_stage *const stage =
+            pthread_getspecific(object->key);
+    if (!stage) {
+        return true;
+    }
+    claim(stage);
+    const bool result = drain(object, stage);
+    unclaim(stage);
+    return result;
+}
+
+bool octopus_concurrent_linked_queue_attach_combining(
+        struct octopus_concurrent_linked_queue *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (object->combiners) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_COMBINING_IS_ATTACHED;
+        return false;
+    }
+    const uintmax_t count = 1 + object->mask;
+    const size_t bytes = count
+            * sizeof(struct octopus_concurrent_linked_queue_combiner);
+    struct octopus_concurrent_linked_queue_combiner *const combiners
+            = octopus_allocate(&object->allocator, bytes,
+                               OCTOPUS_CACHE_LINE_SIZE);
+    if (!combiners) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    if (pthread_key_create(&object->record, on_record_exit)) {
+        octopus_deallocate(&object->allocator, combiners, bytes);
+        octopus_error =
+                OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    for (uintmax_t i = 0; i < count; i++) {
+        atomic_init(&combiners[i].busy, false);
+    }
+    atomic_init(&object->records, NULL);
+    object->combiners = combiners;
+    return true;
+}
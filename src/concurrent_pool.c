@@ -0,0 +1,444 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <seagrass.h>
+#include <octopus.h>
+
+#include "private/concurrent_pool.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+#define INDEX_MASK                              UINT64_C(0xffffffff)
+#define TABLE_CAPACITY                          8
+
+static size_t round_up(const size_t value, const size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+static struct octopus_concurrent_pool_slab *slab_of(
+        const struct octopus_concurrent_pool *const object,
+        const void *const item) {
+    assert(object);
+    assert(item);
+    return (struct octopus_concurrent_pool_slab *)
+            ((uintptr_t) item & ~(uintptr_t) (object->slab - 1));
+}
+
+static uintmax_t index_of(const struct octopus_concurrent_pool *const object,
+                          const void *const item) {
+    assert(object);
+    assert(item);
+    const struct octopus_concurrent_pool_slab *const slab
+            = slab_of(object, item);
+    const uintmax_t offset = ((const unsigned char *) item
+                              - (const unsigned char *) slab
+                              - object->header) / object->stride;
+    return slab->index * object->objects + offset;
+}
+
+static struct octopus_concurrent_pool_free *item_of(
+        const struct octopus_concurrent_pool *const object,
+        struct octopus_concurrent_pool_slab *const slab,
+        const uintmax_t offset) {
+    assert(object);
+    assert(slab);
+    return (struct octopus_concurrent_pool_free *)
+            ((unsigned char *) slab + object->header
+             + offset * object->stride);
+}
+
+static void push(struct octopus_concurrent_pool *const object,
+                 struct octopus_concurrent_pool_free *const first,
+                 const uintmax_t count) {
+    assert(object);
+    assert(first);
+    assert(count);
+    first->count = count;
+    const uintmax_t index = index_of(object, first);
+    atomic_uint_least32_t *const link = &slab_of(object, first)
+            ->links[index % object->objects];
+    uint_least64_t head = atomic_load_explicit(&object->depot,
+                                               memory_order_relaxed);
+    uint_least64_t next;
+    do {
+        atomic_store_explicit(link, (uint_least32_t) (head & INDEX_MASK),
+                              memory_order_relaxed);
+        /* the tag in the upper half changes on every update so that a pop
+         * holding on to a stale link fails */
+        next = (((head >> 32) + 1) << 32) | (uint_least64_t) (1 + index);
+    } while (!atomic_compare_exchange_weak_explicit(
+            &object->depot, &head, next,
+            memory_order_release, memory_order_relaxed));
+}
+
+static struct octopus_concurrent_pool_free *pop(
+        struct octopus_concurrent_pool *const object) {
+    assert(object);
+    uint_least64_t head = atomic_load_explicit(&object->depot,
+                                               memory_order_acquire);
+    struct octopus_concurrent_pool_slab *slab;
+    uintmax_t offset;
+    uint_least64_t next;
+    do {
+        if (!(head & INDEX_MASK)) {
+            return NULL;
+        }
+        const uintmax_t index = (head & INDEX_MASK) - 1;
+        /* the slab was added to the table before any of its objects could
+         * be pushed and tables are never released while in use */
+        const struct octopus_concurrent_pool_table *const table
+                = atomic_load_explicit(&object->table, memory_order_acquire);
+        slab = table->slabs[index / object->objects];
+        offset = index % object->objects;
+        next = (((head >> 32) + 1) << 32)
+               | atomic_load_explicit(&slab->links[offset],
+                                      memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(
+            &object->depot, &head, next,
+            memory_order_acquire, memory_order_acquire));
+    return item_of(object, slab, offset);
+}
+
+/* detach up to count objects from the front of the cache */
+static struct octopus_concurrent_pool_free *take(
+        struct octopus_concurrent_pool_cache *const cache,
+        uintmax_t *const count) {
+    assert(cache);
+    assert(count);
+    assert(cache->count);
+    if (*count > cache->count) {
+        *count = cache->count;
+    }
+    struct octopus_concurrent_pool_free *const first = cache->head;
+    struct octopus_concurrent_pool_free *last = first;
+    for (uintmax_t i = 1; i < *count; i++) {
+        last = last->next;
+    }
+    cache->head = last->next;
+    cache->count -= *count;
+    last->next = NULL;
+    return first;
+}
+
+static void flush(struct octopus_concurrent_pool *const object,
+                  struct octopus_concurrent_pool_cache *const cache) {
+    assert(object);
+    assert(cache);
+    while (cache->count) {
+        uintmax_t count = object->batch;
+        struct octopus_concurrent_pool_free *const first = take(cache, &count);
+        push(object, first, count);
+    }
+}
+
+static void on_thread_exit(void *const arg) {
+    struct octopus_concurrent_pool_cache *const cache = arg;
+    flush(cache->pool, cache);
+    atomic_store_explicit(&cache->used, false, memory_order_release);
+}
+
+bool octopus_concurrent_pool_init(struct octopus_concurrent_pool *const object,
+                                  const size_t size,
+                                  const uintmax_t batch) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_POOL_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!size) {
+        octopus_error = OCTOPUS_CONCURRENT_POOL_ERROR_SIZE_IS_ZERO;
+        return false;
+    }
+    if (!batch) {
+        octopus_error = OCTOPUS_CONCURRENT_POOL_ERROR_BATCH_IS_ZERO;
+        return false;
+    }
+    if (size > (SIZE_MAX >> 2) || batch > UINT32_MAX) {
+        octopus_error = OCTOPUS_CONCURRENT_POOL_ERROR_SIZE_IS_TOO_LARGE;
+        return false;
+    }
+    *object = (struct octopus_concurrent_pool) {
+            .size = size,
+            .batch = batch,
+            .stride = round_up(
+                    size > sizeof(struct octopus_concurrent_pool_free)
+                    ? size
+                    : sizeof(struct octopus_concurrent_pool_free),
+                    OCTOPUS_CACHE_LINE_SIZE)
+    };
+    /* find the smallest slab that holds at least a whole batch */
+    uintmax_t slab = OCTOPUS_CONCURRENT_POOL_SLAB_SIZE;
+    for (;; slab <<= 1) {
+        if (slab > (SIZE_MAX >> 2)) {
+            *object = (struct octopus_concurrent_pool) {0};
+            octopus_error = OCTOPUS_CONCURRENT_POOL_ERROR_SIZE_IS_TOO_LARGE;
+            return false;
+        }
+        const uintmax_t estimate = slab / (object->stride
+                                           + sizeof(atomic_uint_least32_t));
+        object->header = round_up(
+                sizeof(struct octopus_concurrent_pool_slab)
+                + estimate * sizeof(atomic_uint_least32_t),
+                OCTOPUS_CACHE_LINE_SIZE);
+        if (object->header >= slab) {
+            continue;
+        }
+        object->objects = (slab - object->header) / object->stride;
+        if (object->objects > estimate) {
+            object->objects = estimate;
+        }
+        if (object->objects >= batch) {
+            /* only whole batches so that a refill is never left short */
+            object->objects -= object->objects % batch;
+            break;
+        }
+    }
+    object->slab = slab;
+    if (pthread_key_create(&object->key, on_thread_exit)) {
+        *object = (struct octopus_concurrent_pool) {0};
+        octopus_error = OCTOPUS_CONCURRENT_POOL_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    if (pthread_mutex_init(&object->lock, NULL)) {
+        seagrass_required_true(!pthread_key_delete(object->key));
+        *object = (struct octopus_concurrent_pool) {0};
+        octopus_error = OCTOPUS_CONCURRENT_POOL_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    return true;
+}
+
+bool octopus_concurrent_pool_invalidate(
+        struct octopus_concurrent_pool *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_POOL_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (object->stride) {
+        seagrass_required_true(!pthread_key_delete(object->key));
+        seagrass_required_true(!pthread_mutex_destroy(&object->lock));
+        struct octopus_concurrent_pool_table *table = atomic_load(
+                &object->table);
+        for (uintmax_t i = 0; table && i < table->count; i++) {
+            free(table->slabs[i]);
+        }
+        while (table) {
+            struct octopus_concurrent_pool_table *const previous
+                    = table->previous;
+            free(table);
+            table = previous;
+        }
+        struct octopus_concurrent_pool_cache *cache = atomic_load(
+                &object->caches);
+        while (cache) {
+            struct octopus_concurrent_pool_cache *const next = cache->next;
+            free(cache);
+            cache = next;
+        }
+    }
+    *object = (struct octopus_concurrent_pool) {0};
+    return true;
+}
+
+static bool adopt(struct octopus_concurrent_pool_cache *const cache) {
+    assert(cache);
+    bool expected = false;
+    return !atomic_load_explicit(&cache->used, memory_order_relaxed)
+           && atomic_compare_exchange_strong(&cache->used, &expected, true);
+}
+
+static struct octopus_concurrent_pool_cache *cache_of(
+        struct octopus_concurrent_pool *const object) {
+    assert(object);
+    struct octopus_concurrent_pool_cache *cache = pthread_getspecific(
+            object->key);
+    if (cache) {
+        return cache;
+    }
+    /* reuse the cache of a thread that has exited */
+    for (cache = atomic_load(&object->caches);
+         cache && !adopt(cache);
+         cache = cache->next);
+    if (!cache) {
+        if (posix_memalign((void **) &cache, OCTOPUS_CACHE_LINE_SIZE,
+                           sizeof(*cache))) {
+            octopus_error =
+                    OCTOPUS_CONCURRENT_POOL_ERROR_MEMORY_ALLOCATION_FAILED;
+            return NULL;
+        }
+        *cache = (struct octopus_concurrent_pool_cache) {
+                .pool = object
+        };
+        atomic_init(&cache->used, true);
+        struct octopus_concurrent_pool_cache *head = atomic_load(
+                &object->caches);
+        do {
+            cache->next = head;
+        } while (!atomic_compare_exchange_weak(&object->caches, &head,
+                                               cache));
+    }
+    if (pthread_setspecific(object->key, cache)) {
+        atomic_store_explicit(&cache->used, false, memory_order_release);
+        octopus_error = OCTOPUS_CONCURRENT_POOL_ERROR_MEMORY_ALLOCATION_FAILED;
+        return NULL;
+    }
+    return cache;
+}
+
+/* must be called with the lock held */
+static bool add_slab(struct octopus_concurrent_pool *const object,
+                     struct octopus_concurrent_pool_slab **const out) {
+    assert(object);
+    assert(out);
+    struct octopus_concurrent_pool_table *table = atomic_load_explicit(
+            &object->table, memory_order_relaxed);
+    const uintmax_t count = table ? table->count : 0;
+    /* indexes, plus one for the empty list, have to fit in 32 bits */
+    if ((1 + count) * object->objects >= UINT32_MAX) {
+        octopus_error = OCTOPUS_CONCURRENT_POOL_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    if (!table || table->count == table->capacity) {
+        const uintmax_t capacity = table ? 2 * table->capacity : TABLE_CAPACITY;
+        struct octopus_concurrent_pool_table *const larger = malloc(
+                sizeof(*larger) + capacity * sizeof(larger->slabs[0]));
+        if (!larger) {
+            octopus_error =
+                    OCTOPUS_CONCURRENT_POOL_ERROR_MEMORY_ALLOCATION_FAILED;
+            return false;
+        }
+        *larger = (struct octopus_concurrent_pool_table) {
+                .previous = table,
+                .count = count,
+                .capacity = capacity
+        };
+        if (table) {
+            memcpy(larger->slabs, table->slabs,
+                   count * sizeof(table->slabs[0]));
+        }
+        atomic_store_explicit(&object->table, larger, memory_order_release);
+        table = larger;
+    }
+    struct octopus_concurrent_pool_slab *slab;
+    if (posix_memalign((void **) &slab, object->slab, object->slab)) {
+        octopus_error = OCTOPUS_CONCURRENT_POOL_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    slab->index = count;
+    for (uintmax_t i = 0; i < object->objects; i++) {
+        atomic_init(&slab->links[i], 0);
+    }
+    table->slabs[count] = slab;
+    table->count++;
+    *out = slab;
+    return true;
+}
+
+static bool refill(struct octopus_concurrent_pool *const object,
+                   struct octopus_concurrent_pool_cache *const cache) {
+    assert(object);
+    assert(cache);
+    assert(!cache->count);
+    struct octopus_concurrent_pool_free *first = pop(object);
+    if (!first) {
+        seagrass_required_true(!pthread_mutex_lock(&object->lock));
+        /* another thread may have added a slab while we were waiting */
+        struct octopus_concurrent_pool_slab *slab;
+        if (!(first = pop(object)) && add_slab(object, &slab)) {
+            /* carve the slab into batches, keeping the first for ourselves */
+            for (uintmax_t i = 0; i < object->objects; i += object->batch) {
+                const uintmax_t count = object->objects - i < object->batch
+                                        ? object->objects - i
+                                        : object->batch;
+                for (uintmax_t j = 0; j < count; j++) {
+                    item_of(object, slab, i + j)->next = j + 1 < count
+                            ? item_of(object, slab, i + j + 1)
+                            : NULL;
+                }
+                if (i) {
+                    push(object, item_of(object, slab, i), count);
+                } else {
+                    first = item_of(object, slab, 0);
+                    first->count = count;
+                }
+            }
+        }
+        seagrass_required_true(!pthread_mutex_unlock(&object->lock));
+        if (!first) {
+            return false;
+        }
+    }
+    cache->head = first;
+    cache->count = first->count;
+    return true;
+}
+
+bool octopus_concurrent_pool_allocate(
+        struct octopus_concurrent_pool *const object,
+        void **const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_POOL_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_POOL_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    struct octopus_concurrent_pool_cache *const cache = cache_of(object);
+    if (!cache || (!cache->count && !refill(object, cache))) {
+        return false;
+    }
+    struct octopus_concurrent_pool_free *const item = cache->head;
+    cache->head = item->next;
+    cache->count--;
+    *out = item;
+    return true;
+}
+
+bool octopus_concurrent_pool_release(
+        struct octopus_concurrent_pool *const object,
+        void *const item) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_POOL_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!item) {
+        octopus_error = OCTOPUS_CONCURRENT_POOL_ERROR_ITEM_IS_NULL;
+        return false;
+    }
+    struct octopus_concurrent_pool_cache *const cache = cache_of(object);
+    if (!cache) {
+        return false;
+    }
+    struct octopus_concurrent_pool_free *const node = item;
+    node->next = cache->head;
+    cache->head = node;
+    if (++cache->count == 2 * object->batch) {
+        /* keep the objects released most recently as they are the most
+         * likely to still be in our cache and hand over the others */
+        struct octopus_concurrent_pool_free *last = cache->head;
+        for (uintmax_t i = 1; i < object->batch; i++) {
+            last = last->next;
+        }
+        struct octopus_concurrent_pool_free *const first = last->next;
+        last->next = NULL;
+        cache->count = object->batch;
+        push(object, first, object->batch);
+    }
+    return true;
+}
+
+bool octopus_concurrent_pool_flush(
+        struct octopus_concurrent_pool *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_POOL_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    struct octopus_concurrent_pool_cache *const cache = pthread_getspecific(
+            object->key);
+    if (cache) {
+        flush(object, cache);
+    }
+    return true;
+}
@@ -0,0 +1,435 @@
+#include <stdlib.h>
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <sched.h>
+#include <seagrass.h>
+#include <octopus.h>
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+static void *slot_of(const struct octopus_concurrent_ring *const object,
+                     const uintmax_t sequence) {
+    assert(object);
+    return object->items + (sequence & object->mask) * object->size;
+}
+
+static void backoff(const struct octopus_concurrent_ring *const object) {
+    assert(object);
+    if (OCTOPUS_CONCURRENT_RING_WAIT_YIELD == object->wait) {
+        sched_yield();
+    }
+}
+
+static void wake(struct octopus_concurrent_ring *const object) {
+    assert(object);
+    if (OCTOPUS_CONCURRENT_RING_WAIT_BLOCK != object->wait) {
+        return;
+    }
+    /* pairs with the fence in the waits below so that either the waiter
+     * sees what we did or we see the waiter */
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&object->waiters, memory_order_relaxed)) {
+        seagrass_required_true(!pthread_mutex_lock(&object->lock));
+        seagrass_required_true(!pthread_cond_broadcast(&object->condition));
+        seagrass_required_true(!pthread_mutex_unlock(&object->lock));
+    }
+}
+
+/* must be called with the lock held */
+static uintmax_t gate_of(struct octopus_concurrent_ring *const object) {
+    assert(object);
+    /* without consumers nothing holds the producers back */
+    uintmax_t gate = atomic_load_explicit(&object->claim,
+                                          memory_order_relaxed);
+    for (struct octopus_concurrent_ring_consumer *consumer = object->consumers;
+         consumer;
+         consumer = consumer->next) {
+        const uintmax_t cursor = atomic_load_explicit(
+                &consumer->cursor, memory_order_acquire);
+        if (cursor < gate) {
+            gate = cursor;
+        }
+    }
+    /* a consumer that registers later starts at the claim so that the gate
+     * never moves backwards */
+    if (gate > atomic_load_explicit(&object->gate, memory_order_relaxed)) {
+        atomic_store_explicit(&object->gate, gate, memory_order_release);
+    }
+    return atomic_load_explicit(&object->gate, memory_order_relaxed);
+}
+
+static bool has_space(struct octopus_concurrent_ring *const object,
+                      const uintmax_t sequence,
+                      const bool locked) {
+    assert(object);
+    uintmax_t gate = atomic_load_explicit(&object->gate, memory_order_acquire);
+    if (sequence > gate + object->mask) {
+        if (!locked) {
+            seagrass_required_true(!pthread_mutex_lock(&object->lock));
+        }
+        gate = gate_of(object);
+        if (!locked) {
+            seagrass_required_true(!pthread_mutex_unlock(&object->lock));
+        }
+    }
+    return sequence <= gate + object->mask;
+}
+
+static bool is_writable(struct octopus_concurrent_ring *const object,
+                        const uintmax_t sequence,
+                        const bool locked) {
+    assert(object);
+    /* the producer of the previous lap must be done with the slot, this only
+     * matters when no consumer is holding us back */
+    const uintmax_t previous = sequence > object->mask
+                               ? sequence - object->mask : 0;
+    return previous == atomic_load_explicit(
+            &object->published[sequence & object->mask],
+            memory_order_acquire)
+           && has_space(object, sequence, locked);
+}
+
+static void store(struct octopus_concurrent_ring *const object,
+                  const uintmax_t sequence,
+                  const void *const item) {
+    assert(object);
+    assert(item);
+    if (!is_writable(object, sequence, false)) {
+        if (OCTOPUS_CONCURRENT_RING_WAIT_BLOCK != object->wait) {
+            do {
+                backoff(object);
+            } while (!is_writable(object, sequence, false));
+        } else {
+            seagrass_required_true(!pthread_mutex_lock(&object->lock));
+            atomic_fetch_add_explicit(&object->waiters, 1,
+                                      memory_order_relaxed);
+            atomic_thread_fence(memory_order_seq_cst);
+            while (!is_writable(object, sequence, true)) {
+                seagrass_required_true(!pthread_cond_wait(
+                        &object->condition, &object->lock));
+            }
+            atomic_fetch_sub_explicit(&object->waiters, 1,
+                                      memory_order_relaxed);
+            seagrass_required_true(!pthread_mutex_unlock(&object->lock));
+        }
+    }
+    memcpy(slot_of(object, sequence), item, object->size);
+    atomic_store_explicit(&object->published[sequence & object->mask],
+                          sequence + 1, memory_order_release);
+    wake(object);
+}
+
+bool octopus_concurrent_ring_init(struct octopus_concurrent_ring *const object,
+                                  const size_t size,
+                                  const uintmax_t capacity,
+                                  const int wait) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!size) {
+        octopus_error = OCTOPUS_CONCURRENT_RING_ERROR_SIZE_IS_ZERO;
+        return false;
+    }
+    if (!capacity) {
+        octopus_error = OCTOPUS_CONCURRENT_RING_ERROR_CAPACITY_IS_ZERO;
+        return false;
+    }
+    if (OCTOPUS_CONCURRENT_RING_WAIT_BUSY_SPIN != wait
+        && OCTOPUS_CONCURRENT_RING_WAIT_YIELD != wait
+        && OCTOPUS_CONCURRENT_RING_WAIT_BLOCK != wait) {
+        octopus_error = OCTOPUS_CONCURRENT_RING_ERROR_WAIT_IS_INVALID;
+        return false;
+    }
+    uintmax_t count;
+    uintmax_t bytes;
+    uintmax_t flags;
+    if (!octopus_concurrent_queue_shards(capacity, &count)
+        || !seagrass_uintmax_t_multiply(count, size, &bytes)
+        || bytes > SIZE_MAX
+        || !seagrass_uintmax_t_multiply(
+                count, sizeof(atomic_uintmax_t), &flags)
+        || flags > SIZE_MAX) {
+        octopus_error = OCTOPUS_CONCURRENT_RING_ERROR_SIZE_IS_TOO_LARGE;
+        return false;
+    }
+    *object = (struct octopus_concurrent_ring) {
+            .size = size,
+            .mask = count - 1,
+            .wait = wait
+    };
+    if (posix_memalign((void **) &object->items, OCTOPUS_CACHE_LINE_SIZE,
+                       bytes)) {
+        *object = (struct octopus_concurrent_ring) {0};
+        octopus_error =
+                OCTOPUS_CONCURRENT_RING_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    if (posix_memalign((void **) &object->published, OCTOPUS_CACHE_LINE_SIZE,
+                       flags)) {
+        free(object->items);
+        *object = (struct octopus_concurrent_ring) {0};
+        octopus_error =
+                OCTOPUS_CONCURRENT_RING_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    for (uintmax_t i = 0; i < count; i++) {
+        atomic_init(&object->published[i], 0);
+    }
+    int error;
+    if ((error = pthread_mutex_init(&object->lock, NULL))) {
+        seagrass_required_true(ENOMEM == error);
+        free(object->published);
+        free(object->items);
+        *object = (struct octopus_concurrent_ring) {0};
+        octopus_error =
+                OCTOPUS_CONCURRENT_RING_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    if ((error = pthread_cond_init(&object->condition, NULL))) {
+        seagrass_required_true(ENOMEM == error || EAGAIN == error);
+        seagrass_required_true(!pthread_mutex_destroy(&object->lock));
+        free(object->published);
+        free(object->items);
+        *object = (struct octopus_concurrent_ring) {0};
+        octopus_error =
+                OCTOPUS_CONCURRENT_RING_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    return true;
+}
+
+bool octopus_concurrent_ring_invalidate(
+        struct octopus_concurrent_ring *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (object->items) {
+        assert(!object->consumers);
+        seagrass_required_true(!pthread_cond_destroy(&object->condition));
+        seagrass_required_true(!pthread_mutex_destroy(&object->lock));
+        free(object->published);
+        free(object->items);
+    }
+    *object = (struct octopus_concurrent_ring) {0};
+    return true;
+}
+
+bool octopus_concurrent_ring_publish(
+        struct octopus_concurrent_ring *const object,
+        const void *const item) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!item) {
+        octopus_error = OCTOPUS_CONCURRENT_RING_ERROR_ITEM_IS_NULL;
+        return false;
+    }
+    const uintmax_t sequence = atomic_fetch_add_explicit(
+            &object->claim, 1, memory_order_relaxed);
+    store(object, sequence, item);
+    return true;
+}
+
+bool octopus_concurrent_ring_try_publish(
+        struct octopus_concurrent_ring *const object,
+        const void *const item) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!item) {
+        octopus_error = OCTOPUS_CONCURRENT_RING_ERROR_ITEM_IS_NULL;
+        return false;
+    }
+    uintmax_t sequence = atomic_load_explicit(&object->claim,
+                                              memory_order_relaxed);
+    do {
+        if (!has_space(object, sequence, false)) {
+            octopus_error = OCTOPUS_CONCURRENT_RING_ERROR_RING_IS_FULL;
+            return false;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(
+            &object->claim, &sequence, 1 + sequence,
+            memory_order_relaxed, memory_order_relaxed));
+    store(object, sequence, item);
+    return true;
+}
+
+bool octopus_concurrent_ring_consumer_init(
+        struct octopus_concurrent_ring_consumer *const object,
+        struct octopus_concurrent_ring *const ring,
+        struct octopus_concurrent_ring_consumer *const *const dependencies,
+        const uintmax_t count) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!ring) {
+        octopus_error = OCTOPUS_CONCURRENT_RING_ERROR_RING_IS_NULL;
+        return false;
+    }
+    if (count && !dependencies) {
+        octopus_error = OCTOPUS_CONCURRENT_RING_ERROR_DEPENDENCIES_IS_NULL;
+        return false;
+    }
+    for (uintmax_t i = 0; i < count; i++) {
+        if (!dependencies[i] || ring != dependencies[i]->ring) {
+            octopus_error =
+                    OCTOPUS_CONCURRENT_RING_ERROR_DEPENDENCY_IS_INVALID;
+            return false;
+        }
+    }
+    *object = (struct octopus_concurrent_ring_consumer) {
+            .ring = ring,
+            .count = count
+    };
+    if (count) {
+        uintmax_t bytes;
+        if (!seagrass_uintmax_t_multiply(
+                count, sizeof(*dependencies), &bytes)
+            || bytes > SIZE_MAX
+            || !(object->dependencies = malloc(bytes))) {
+            *object = (struct octopus_concurrent_ring_consumer) {0};
+            octopus_error =
+                    OCTOPUS_CONCURRENT_RING_ERROR_MEMORY_ALLOCATION_FAILED;
+            return false;
+        }
+        memcpy(object->dependencies, dependencies, bytes);
+    }
+    seagrass_required_true(!pthread_mutex_lock(&ring->lock));
+    const uintmax_t cursor = atomic_load_explicit(&ring->claim,
+                                                  memory_order_relaxed);
+    atomic_init(&object->cursor, cursor);
+    object->available = cursor;
+    object->next = ring->consumers;
+    ring->consumers = object;
+    seagrass_required_true(!pthread_mutex_unlock(&ring->lock));
+    return true;
+}
+
+bool octopus_concurrent_ring_consumer_invalidate(
+        struct octopus_concurrent_ring_consumer *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    struct octopus_concurrent_ring *const ring = object->ring;
+    if (ring) {
+        seagrass_required_true(!pthread_mutex_lock(&ring->lock));
+        struct octopus_concurrent_ring_consumer **at = &ring->consumers;
+        for (; *at != object; at = &(*at)->next) {
+            assert(*at);
+        }
+        *at = object->next;
+        /* producers waiting on us may now move on */
+        seagrass_required_true(!pthread_cond_broadcast(&ring->condition));
+        seagrass_required_true(!pthread_mutex_unlock(&ring->lock));
+        free(object->dependencies);
+    }
+    *object = (struct octopus_concurrent_ring_consumer) {0};
+    return true;
+}
+
+static bool is_available(
+        struct octopus_concurrent_ring_consumer *const object) {
+    assert(object);
+    const uintmax_t cursor = atomic_load_explicit(&object->cursor,
+                                                  memory_order_relaxed);
+    if (cursor != object->available) {
+        return true;
+    }
+    uintmax_t available;
+    if (object->count) {
+        /* an item consumed by all of our dependencies has been published */
+        available = atomic_load_explicit(&object->dependencies[0]->cursor,
+                                         memory_order_acquire);
+        for (uintmax_t i = 1; i < object->count; i++) {
+            const uintmax_t at = atomic_load_explicit(
+                    &object->dependencies[i]->cursor, memory_order_acquire);
+            if (at < available) {
+                available = at;
+            }
+        }
+        /* we may have registered after our dependencies had moved on */
+        if (available < cursor) {
+            available = cursor;
+        }
+    } else {
+        const struct octopus_concurrent_ring *const ring = object->ring;
+        available = cursor;
+        while (available <= cursor + ring->mask
+               && 1 + available == atomic_load_explicit(
+                &ring->published[available & ring->mask],
+                memory_order_acquire)) {
+            available++;
+        }
+    }
+    object->available = available;
+    return cursor != available;
+}
+
+bool octopus_concurrent_ring_consumer_poll(
+        struct octopus_concurrent_ring_consumer *const object,
+        void **const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_RING_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    if (!is_available(object)) {
+        octopus_error = OCTOPUS_CONCURRENT_RING_ERROR_NOTHING_IS_AVAILABLE;
+        return false;
+    }
+    struct octopus_concurrent_ring *const ring = object->ring;
+    const uintmax_t cursor = atomic_load_explicit(&object->cursor,
+                                                  memory_order_relaxed);
+    memcpy(out, slot_of(ring, cursor), ring->size);
+    atomic_store_explicit(&object->cursor, 1 + cursor, memory_order_release);
+    wake(ring);
+    return true;
+}
+
+bool octopus_concurrent_ring_consumer_take(
+        struct octopus_concurrent_ring_consumer *const object,
+        void **const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_RING_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    struct octopus_concurrent_ring *const ring = object->ring;
+    if (!is_available(object)) {
+        if (OCTOPUS_CONCURRENT_RING_WAIT_BLOCK != ring->wait) {
+            do {
+                backoff(ring);
+            } while (!is_available(object));
+        } else {
+            seagrass_required_true(!pthread_mutex_lock(&ring->lock));
+            atomic_fetch_add_explicit(&ring->waiters, 1,
+                                      memory_order_relaxed);
+            atomic_thread_fence(memory_order_seq_cst);
+            while (!is_available(object)) {
+                seagrass_required_true(!pthread_cond_wait(
+                        &ring->condition, &ring->lock));
+            }
+            atomic_fetch_sub_explicit(&ring->waiters, 1,
+                                      memory_order_relaxed);
+            seagrass_required_true(!pthread_mutex_unlock(&ring->lock));
+        }
+    }
+    seagrass_required_true(octopus_concurrent_ring_consumer_poll(
+            object, out));
+    return true;
+}
@@ -0,0 +1,456 @@
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <time.h>
+#include <seagrass.h>
+#include <octopus.h>
+
+#include "private/concurrent_skip_list.h"
+#include "private/epoch.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+#define MAX_HEIGHT                      OCTOPUS_CONCURRENT_SKIP_LIST_MAX_HEIGHT
+#define MARK                            ((uintptr_t) 1)
+
+static size_t align_up(const size_t size, const size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+static atomic_uintptr_t *next_of(
+        const struct octopus_concurrent_skip_list *const object,
+        struct octopus_concurrent_skip_list_node *const node) {
+    assert(object);
+    assert(node);
+    return (atomic_uintptr_t *) (node->data + object->next);
+}
+
+static void *value_of(const struct octopus_concurrent_skip_list *const object,
+                      struct octopus_concurrent_skip_list_node *const node) {
+    assert(object);
+    assert(node);
+    return node->data + align_up(object->next
+                                 + node->height * sizeof(atomic_uintptr_t),
+                                 _Alignof(max_align_t));
+}
+
+static struct octopus_concurrent_skip_list_node *pointer_of(
+        const uintptr_t value) {
+    return (struct octopus_concurrent_skip_list_node *) (value & ~MARK);
+}
+
+static struct octopus_concurrent_skip_list_node *allocate(
+        const struct octopus_concurrent_skip_list *const object,
+        const uintmax_t height) {
+    assert(object);
+    assert(height && height <= MAX_HEIGHT);
+    const size_t size = sizeof(struct octopus_concurrent_skip_list_node)
+                        + align_up(object->next
+                                   + height * sizeof(atomic_uintptr_t),
+                                   _Alignof(max_align_t))
+                        + object->value;
+    struct octopus_concurrent_skip_list_node *const node = malloc(size);
+    if (node) {
+        node->height = height;
+        atomic_init(&node->holders, 2);
+        for (uintmax_t i = 0; i < height; i++) {
+            atomic_init(&next_of(object, node)[i], 0);
+        }
+    }
+    return node;
+}
+
+static void release(struct octopus_epoch_entry *const entry) {
+    free(entry);
+}
+
+#ifdef TEST
+uintmax_t octopus_concurrent_skip_list_height;
+#endif
+
+static uintmax_t height_of(void) {
+#ifdef TEST
+    if (octopus_concurrent_skip_list_height) {
+        return octopus_concurrent_skip_list_height;
+    }
+#endif
+    static _Thread_local uint64_t seed;
+    if (!seed) {
+        seed = ((uint64_t) (uintptr_t) &seed) ^ (uint64_t) time(NULL)
+               ^ UINT64_C(0x9e3779b97f4a7c15);
+    }
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    /* each level is a quarter as likely as the one below it */
+    uintmax_t height = 1;
+    for (uint64_t bits = seed; height < MAX_HEIGHT && !(bits & 3);
+         bits >>= 2) {
+        height++;
+    }
+    return height;
+}
+
+/*
+ * Locate the predecessors and successors of key on every level, unlinking
+ * any marked nodes found on the way. Returns true if the level 0 successor
+ * holds key.
+ */
+static bool find(struct octopus_concurrent_skip_list *const object,
+                 const void *const key,
+                 struct octopus_concurrent_skip_list_node **const preds,
+                 struct octopus_concurrent_skip_list_node **const succs) {
+    assert(object);
+    assert(key);
+    assert(preds);
+    assert(succs);
+    retry:;
+    struct octopus_concurrent_skip_list_node *pred = object->head;
+    for (uintmax_t i = atomic_load_explicit(&object->height,
+                                            memory_order_acquire); i--;) {
+        struct octopus_concurrent_skip_list_node *curr = pointer_of(
+                atomic_load_explicit(&next_of(object, pred)[i],
+                                     memory_order_acquire));
+        while (curr) {
+            uintptr_t succ = atomic_load_explicit(
+                    &next_of(object, curr)[i], memory_order_acquire);
+            if (succ & MARK) {
+                uintptr_t expected = (uintptr_t) curr;
+                if (!atomic_compare_exchange_strong_explicit(
+                        &next_of(object, pred)[i], &expected, succ & ~MARK,
+                        memory_order_acq_rel, memory_order_acquire)) {
+                    goto retry;
+                }
+                curr = pointer_of(succ);
+                continue;
+            }
+            if (object->compare(curr->data, key) >= 0) {
+                break;
+            }
+            pred = curr;
+            curr = pointer_of(succ);
+        }
+        preds[i] = pred;
+        succs[i] = curr;
+    }
+    return succs[0] && !object->compare(succs[0]->data, key);
+}
+
+/*
+ * Called by the inserter once it stopped linking the node and by the remover
+ * once it marked it. The one to let go last has seen every level the other
+ * linked, unlinks whatever is still reachable and then retires the node.
+ */
+static void let_go(struct octopus_concurrent_skip_list *const object,
+                   struct octopus_concurrent_skip_list_node *const node,
+                   struct octopus_concurrent_skip_list_node **const preds,
+                   struct octopus_concurrent_skip_list_node **const succs) {
+    assert(object);
+    assert(node);
+    if (1 != atomic_fetch_sub_explicit(&node->holders, 1,
+                                       memory_order_acq_rel)) {
+        return;
+    }
+    find(object, node->data, preds, succs);
+    octopus_epoch_retire(&node->entry, release);
+}
+
+bool octopus_concurrent_skip_list_init(
+        struct octopus_concurrent_skip_list *const object,
+        const size_t key,
+        const size_t value,
+        int (*const compare)(const void *, const void *)) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!key) {
+        octopus_error = OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_SIZE_IS_ZERO;
+        return false;
+    }
+    if (!compare) {
+        octopus_error = OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_COMPARE_IS_NULL;
+        return false;
+    }
+    const size_t limit = SIZE_MAX / 4;
+    if (key > limit || value > limit) {
+        octopus_error = OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_SIZE_IS_TOO_LARGE;
+        return false;
+    }
+    *object = (struct octopus_concurrent_skip_list) {
+            .compare = compare,
+            .key = key,
+            .value = value,
+            .next = align_up(key, _Alignof(atomic_uintptr_t))
+    };
+    atomic_init(&object->height, 1);
+    if (!(object->head = allocate(object, MAX_HEIGHT))) {
+        *object = (struct octopus_concurrent_skip_list) {0};
+        octopus_error =
+                OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    return true;
+}
+
+bool octopus_concurrent_skip_list_invalidate(
+        struct octopus_concurrent_skip_list *const object,
+        void (*const on_destroy)(void *, void *)) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (object->head) {
+        /* release the nodes this thread has removed */
+        octopus_epoch_synchronize();
+        struct octopus_concurrent_skip_list_node *node = object->head;
+        while (node) {
+            struct octopus_concurrent_skip_list_node *const next = pointer_of(
+                    atomic_load(&next_of(object, node)[0]));
+            if (on_destroy && node != object->head) {
+                on_destroy(node->data, value_of(object, node));
+            }
+            free(node);
+            node = next;
+        }
+    }
+    *object = (struct octopus_concurrent_skip_list) {0};
+    return true;
+}
+
+bool octopus_concurrent_skip_list_insert(
+        struct octopus_concurrent_skip_list *const object,
+        const void *const key,
+        const void *const value) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!key) {
+        octopus_error = OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_IS_NULL;
+        return false;
+    }
+    if (!value && object->value) {
+        octopus_error = OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_VALUE_IS_NULL;
+        return false;
+    }
+    const uintmax_t height = height_of();
+    struct octopus_concurrent_skip_list_node *const node =
+            allocate(object, height);
+    if (!node || !octopus_epoch_enter()) {
+        free(node);
+        octopus_error =
+                OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    memcpy(node->data, key, object->key);
+    if (object->value) {
+        memcpy(value_of(object, node), value, object->value);
+    }
+    uintmax_t current = atomic_load(&object->height);
+    while (current < height
+           && !atomic_compare_exchange_weak(&object->height, &current,
+                                            height));
+    atomic_uintptr_t *const next = next_of(object, node);
+    struct octopus_concurrent_skip_list_node *preds[MAX_HEIGHT];
+    struct octopus_concurrent_skip_list_node *succs[MAX_HEIGHT];
+    for (;;) {
+        if (find(object, key, preds, succs)) {
+            octopus_epoch_exit();
+            free(node);
+            octopus_error =
+                    OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_ALREADY_EXISTS;
+            return false;
+        }
+        for (uintmax_t i = 0; i < height; i++) {
+            atomic_store_explicit(&next[i], (uintptr_t) succs[i],
+                                  memory_order_relaxed);
+        }
+        uintptr_t expected = (uintptr_t) succs[0];
+        if (atomic_compare_exchange_strong_explicit(
+                &next_of(object, preds[0])[0], &expected, (uintptr_t) node,
+                memory_order_release, memory_order_relaxed)) {
+            break;
+        }
+    }
+    /* the entry is now present, link the rest of its tower */
+    for (uintmax_t i = 1; i < height; i++) {
+        for (;;) {
+            if (atomic_load(&next[0]) & MARK) {
+                /* removed concurrently, stop building the tower */
+                goto done;
+            }
+            uintptr_t expected = (uintptr_t) succs[i];
+            if (atomic_compare_exchange_strong_explicit(
+                    &next_of(object, preds[i])[i], &expected,
+                    (uintptr_t) node,
+                    memory_order_release, memory_order_relaxed)) {
+                break;
+            }
+            find(object, key, preds, succs);
+            uintptr_t succ = atomic_load(&next[i]);
+            if ((succ & MARK)
+                || !atomic_compare_exchange_strong(&next[i], &succ,
+                                                   (uintptr_t) succs[i])) {
+                /* removed concurrently, stop building the tower */
+                goto done;
+            }
+        }
+    }
+    done:
+    let_go(object, node, preds, succs);
+    octopus_epoch_exit();
+    return true;
+}
+
+bool octopus_concurrent_skip_list_remove(
+        struct octopus_concurrent_skip_list *const object,
+        const void *const key,
+        void **const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!key) {
+        octopus_error = OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_IS_NULL;
+        return false;
+    }
+    if (!octopus_epoch_enter()) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    struct octopus_concurrent_skip_list_node *preds[MAX_HEIGHT];
+    struct octopus_concurrent_skip_list_node *succs[MAX_HEIGHT];
+    if (!find(object, key, preds, succs)) {
+        octopus_epoch_exit();
+        octopus_error = OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_NOT_FOUND;
+        return false;
+    }
+    struct octopus_concurrent_skip_list_node *const node = succs[0];
+    atomic_uintptr_t *const next = next_of(object, node);
+    for (uintmax_t i = node->height; --i;) {
+        uintptr_t succ = atomic_load(&next[i]);
+        while (!(succ & MARK)
+               && !atomic_compare_exchange_weak(&next[i], &succ,
+                                                succ | MARK));
+    }
+    /* whoever marks level 0 has removed the entry */
+    uintptr_t succ = atomic_load(&next[0]);
+    do {
+        if (succ & MARK) {
+            octopus_epoch_exit();
+            octopus_error = OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_NOT_FOUND;
+            return false;
+        }
+    } while (!atomic_compare_exchange_weak(&next[0], &succ, succ | MARK));
+    if (out && object->value) {
+        memcpy(out, value_of(object, node), object->value);
+    }
+    let_go(object, node, preds, succs);
+    octopus_epoch_exit();
+    return true;
+}
+
+/*
+ * Locate the first node whose key is not less than key without modifying the
+ * skip list, must be called from inside a critical section.
+ */
+static struct octopus_concurrent_skip_list_node *ceiling(
+        struct octopus_concurrent_skip_list *const object,
+        const void *const key) {
+    assert(object);
+    struct octopus_concurrent_skip_list_node *pred = object->head;
+    struct octopus_concurrent_skip_list_node *curr = NULL;
+    for (uintmax_t i = atomic_load_explicit(&object->height,
+                                            memory_order_acquire); i--;) {
+        curr = pointer_of(atomic_load_explicit(
+                &next_of(object, pred)[i], memory_order_acquire));
+        while (curr) {
+            const uintptr_t succ = atomic_load_explicit(
+                    &next_of(object, curr)[i], memory_order_acquire);
+            if (!(succ & MARK)) {
+                if (!key || object->compare(curr->data, key) >= 0) {
+                    break;
+                }
+                pred = curr;
+            }
+            curr = pointer_of(succ);
+        }
+    }
+    return curr;
+}
+
+bool octopus_concurrent_skip_list_get(
+        struct octopus_concurrent_skip_list *const object,
+        const void *const key,
+        void **const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!key) {
+        octopus_error = OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    if (!octopus_epoch_enter()) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    struct octopus_concurrent_skip_list_node *const node = ceiling(object, key);
+    const bool result = node && !object->compare(node->data, key);
+    if (result && object->value) {
+        memcpy(out, value_of(object, node), object->value);
+    }
+    octopus_epoch_exit();
+    if (!result) {
+        octopus_error = OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_NOT_FOUND;
+    }
+    return result;
+}
+
+bool octopus_concurrent_skip_list_range(
+        struct octopus_concurrent_skip_list *const object,
+        const void *const first,
+        const void *const last,
+        bool (*const func)(const void *, const void *, void *),
+        void *const arg) {
+    if (!object) {
+        octopus_error = OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!func) {
+        octopus_error = OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_FUNC_IS_NULL;
+        return false;
+    }
+    if (!octopus_epoch_enter()) {
+        octopus_error =
+                OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    /* removed nodes keep pointing forward so walking level 0 while inside
+     * the critical section never loses our place */
+    struct octopus_concurrent_skip_list_node *node = ceiling(object, first);
+    while (node) {
+        const uintptr_t succ = atomic_load_explicit(
+                &next_of(object, node)[0], memory_order_acquire);
+        if (!(succ & MARK)) {
+            if (last && object->compare(node->data, last) >= 0) {
+                break;
+            }
+            if (!func(node->data, value_of(object, node), arg)) {
+                break;
+            }
+        }
+        node = pointer_of(succ);
+    }
+    octopus_epoch_exit();
+    return true;
+}
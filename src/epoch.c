@@ -0,0 +1,199 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <assert.h>
+#include <sched.h>
+#include <pthread.h>
+#include <seagrass.h>
+#include <octopus/cache_line.h>
+
+#include "private/epoch.h"
+
+#define RETIRED_BEFORE_ADVANCE                  64
+
+struct bag {
+    struct octopus_epoch_entry *head;
+    uintmax_t epoch;
+};
+
+struct record {
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) atomic_uintmax_t state;
+    atomic_bool used;
+    struct record *next;
+    uintmax_t depth;
+    uintmax_t retired;
+    struct bag bags[3];
+};
+
+static _Atomic(struct record *) records;
+static atomic_uintmax_t global;
+static _Thread_local struct record *self;
+static pthread_once_t once = PTHREAD_ONCE_INIT;
+static pthread_key_t key;
+
+static void on_thread_exit(void *const arg) {
+    struct record *const record = arg;
+    assert(!record->depth);
+    /* any memory still waiting to be released is handed over to the next
+     * thread to use this record */
+    atomic_store_explicit(&record->state, 0, memory_order_release);
+    atomic_store_explicit(&record->used, false, memory_order_release);
+}
+
+static void on_once(void) {
+    seagrass_required_true(!pthread_key_create(&key, on_thread_exit));
+}
+
+static bool adopt(struct record *const record) {
+    assert(record);
+    bool expected = false;
+    return !atomic_load_explicit(&record->used, memory_order_relaxed)
+           && atomic_compare_exchange_strong(&record->used, &expected, true);
+}
+
+static struct record *acquire(void) {
+    if (self) {
+        return self;
+    }
+    seagrass_required_true(!pthread_once(&once, on_once));
+    struct record *record = atomic_load(&records);
+    for (; record && !adopt(record); record = record->next);
+    if (!record) {
+        if (posix_memalign((void **) &record, OCTOPUS_CACHE_LINE_SIZE,
+                           sizeof(*record))) {
+            return NULL;
+        }
+        *record = (struct record) {0};
+        atomic_init(&record->used, true);
+        struct record *head = atomic_load(&records);
+        do {
+            record->next = head;
+        } while (!atomic_compare_exchange_weak(&records, &head, record));
+    }
+    if (pthread_setspecific(key, record)) {
+        atomic_store_explicit(&record->used, false, memory_order_release);
+        return NULL;
+    }
+    self = record;
+    return record;
+}
+
+static void collect(struct record *const record) {
+    assert(record);
+    const uintmax_t epoch = atomic_load(&global);
+    for (uintmax_t i = 0; i < 3; i++) {
+        struct bag *const bag = &record->bags[i];
+        if (!bag->head || bag->epoch + 2 > epoch) {
+            continue;
+        }
+        struct octopus_epoch_entry *entry = bag->head;
+        bag->head = NULL;
+        while (entry) {
+            struct octopus_epoch_entry *const next = entry->next;
+            entry->on_free(entry);
+            entry = next;
+        }
+    }
+}
+
+static bool is_empty(const struct record *const record) {
+    assert(record);
+    return !record->bags[0].head
+           && !record->bags[1].head
+           && !record->bags[2].head;
+}
+
+static void advance(void) {
+    uintmax_t epoch = atomic_load(&global);
+    for (struct record *record = atomic_load(&records);
+         record;
+         record = record->next) {
+        const uintmax_t state = atomic_load(&record->state);
+        if ((state & 1) && (state >> 1) != epoch) {
+            return;
+        }
+    }
+    if (!atomic_compare_exchange_strong(&global, &epoch, epoch + 1)) {
+        return;
+    }
+    /* release what the threads that have since exited left behind */
+    for (struct record *record = atomic_load(&records);
+         record;
+         record = record->next) {
+        if (record != self && adopt(record)) {
+            collect(record);
+            atomic_store_explicit(&record->used, false, memory_order_release);
+        }
+    }
+}
+
+bool octopus_epoch_enter(void) {
+    struct record *const record = acquire();
+    if (!record) {
+        return false;
+    }
+    if (record->depth++) {
+        return true;
+    }
+    uintmax_t epoch;
+    do {
+        epoch = atomic_load(&global);
+        atomic_store(&record->state, (epoch << 1) | 1);
+    } while (epoch != atomic_load(&global));
+    atomic_thread_fence(memory_order_seq_cst);
+    return true;
+}
+
+void octopus_epoch_exit(void) {
+    struct record *const record = self;
+    assert(record && record->depth);
+    if (!--record->depth) {
+        atomic_store_explicit(&record->state, 0, memory_order_release);
+    }
+}
+
+void octopus_epoch_retire(
+        struct octopus_epoch_entry *const entry,
+        void (*const on_free)(struct octopus_epoch_entry *)) {
+    struct record *const record = self;
+    assert(record && record->depth);
+    assert(entry);
+    assert(on_free);
+    entry->on_free = on_free;
+    atomic_thread_fence(memory_order_seq_cst);
+    const uintmax_t epoch = atomic_load(&global);
+    struct bag *const bag = &record->bags[epoch % 3];
+    if (bag->head && bag->epoch != epoch) {
+        /* the bag holds what was retired three or more epochs ago */
+        struct octopus_epoch_entry *item = bag->head;
+        bag->head = NULL;
+        while (item) {
+            struct octopus_epoch_entry *const next = item->next;
+            item->on_free(item);
+            item = next;
+        }
+    }
+    entry->next = bag->head;
+    bag->head = entry;
+    bag->epoch = epoch;
+    if (++record->retired >= RETIRED_BEFORE_ADVANCE) {
+        record->retired = 0;
+        advance();
+        collect(record);
+    }
+}
+
+void octopus_epoch_synchronize(void) {
+    struct record *const record = self;
+    if (!record) {
+        return;
+    }
+    assert(!record->depth);
+    while (collect(record), !is_empty(record)) {
+        advance();
+        if (!is_empty(record)) {
+            sched_yield();
+        }
+    }
+    record->retired = 0;
+}
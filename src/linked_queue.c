@@ -1,18 +1,36 @@
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include <seagrass.h>
 #include <errno.h>
 #include <octopus.h>
 
+#include "private/allocator.h"
 #include "private/linked_queue.h"
+#include "private/probe.h"
+#include "private/spill.h"
 
 #ifdef TEST
 #include <test/cmocka.h>
 #endif
 
+static void free_node(struct octopus_linked_queue *const object,
+                      struct octopus_linked_queue_node *const node) {
+    assert(object);
+    octopus_deallocate(&object->allocator, node,
+                       sizeof(*node) + object->size);
+}
+
 bool octopus_linked_queue_init(
         struct octopus_linked_queue *const object,
         const size_t size) {
+    return octopus_linked_queue_init_with_allocator(object, size, NULL);
+}
+
+bool octopus_linked_queue_init_with_allocator(
+        struct octopus_linked_queue *const object,
+        const size_t size,
+        const struct octopus_allocator *const allocator) {
     if (!object) {
         octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
         return false;
@@ -21,18 +39,18 @@ bool octopus_linked_queue_init(
         octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_SIZE_IS_ZERO;
         return false;
     }
-    *object = (struct octopus_linked_queue) {0};
-    if (!coral_linked_queue_init(&object->queue, size)) {
-        seagrass_required_true(CORAL_LINKED_QUEUE_ERROR_SIZE_IS_TOO_LARGE
-                               == coral_error);
+    if (size > SIZE_MAX - sizeof(struct octopus_linked_queue_node)) {
         octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_SIZE_IS_TOO_LARGE;
         return false;
     }
+    *object = (struct octopus_linked_queue) {0};
+    object->size = size;
+    if (allocator) {
+        object->allocator = *allocator;
+    }
     int error;
     if ((error = pthread_mutex_init(&object->dequeue, NULL))) {
         seagrass_required_true(ENOMEM == error);
-        seagrass_required_true(coral_linked_queue_invalidate(
-                &object->queue, NULL));
         octopus_error =
                 OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
         return false;
@@ -40,8 +58,6 @@ bool octopus_linked_queue_init(
     if ((error = pthread_mutex_init(&object->enqueue, NULL))) {
         seagrass_required_true(ENOMEM == error);
         seagrass_required_true(!pthread_mutex_destroy(&object->dequeue));
-        seagrass_required_true(coral_linked_queue_invalidate(
-                &object->queue, NULL));
         octopus_error =
                 OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
         return false;
@@ -63,8 +79,25 @@ bool octopus_linked_queue_invalidate(
     for (uintmax_t i = 0; i < limit; i++) {
         seagrass_required_true(!pthread_mutex_destroy(locks[i]));
     }
-    seagrass_required_true(coral_linked_queue_invalidate(
-            &object->queue, on_destroy));
+    struct octopus_linked_queue_node *const head = atomic_load(&object->head);
+    struct octopus_linked_queue_node *node = object->first;
+    bool item = false;
+    while (node) {
+        struct octopus_linked_queue_node *const next = atomic_load(&node->next);
+        if (item && on_destroy) {
+            on_destroy(node->item);
+        }
+        item = item || node == head;
+        free_node(object, node);
+        node = next;
+    }
+    if (object->spill) {
+        seagrass_required_true(octopus_spill_invalidate(
+                object->spill, on_destroy));
+        seagrass_required_true(!pthread_mutex_destroy(&object->spilling));
+        octopus_deallocate(&object->allocator, object->spill,
+                           sizeof(*object->spill));
+    }
     *object = (struct octopus_linked_queue) {0};
     return true;
 }
@@ -80,12 +113,10 @@ bool octopus_linked_queue_size(
         octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_OUT_IS_NULL;
         return false;
     }
-    seagrass_required_true(coral_linked_queue_size(
-            &object->queue, out));
+    *out = object->size;
     return true;
 }
 
-#ifdef TEST
 bool octopus_linked_queue_count(
         struct octopus_linked_queue *const object,
         uintmax_t *const out) {
@@ -99,41 +130,258 @@ bool octopus_linked_queue_count(
     }
     seagrass_required_true(!pthread_mutex_lock(&object->dequeue));
     seagrass_required_true(!pthread_mutex_lock(&object->enqueue));
-    seagrass_required_true(coral_linked_queue_count(
-            &object->queue, out));
+    uintmax_t count = 0;
+    struct octopus_linked_queue_node *node = atomic_load(&object->head);
+    while (node && (node = atomic_load(&node->next))) {
+        count++;
+    }
+    if (object->spill) {
+        count += atomic_load(&object->spill->count);
+    }
+    *out = count;
     seagrass_required_true(!pthread_mutex_unlock(&object->enqueue));
     seagrass_required_true(!pthread_mutex_unlock(&object->dequeue));
     return true;
 }
-#endif /* TEST */
+
+static struct octopus_linked_queue_node *node_of(
+        struct octopus_linked_queue *const object) {
+    assert(object);
+    struct octopus_linked_queue_node *node = object->first;
+    if (node && node != atomic_load_explicit(&object->head,
+                                             memory_order_acquire)) {
+        object->first = atomic_load_explicit(&node->next,
+                                             memory_order_relaxed);
+    } else if ((node = octopus_allocate(
+            &object->allocator, sizeof(*node) + object->size,
+            _Alignof(struct octopus_linked_queue_node)))) {
+        atomic_store_explicit(&object->nodes,
+                              1 + atomic_load_explicit(
+                                      &object->nodes, memory_order_relaxed),
+                              memory_order_relaxed);
+    } else {
+        return NULL;
+    }
+    atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+    return node;
+}
+
+static bool lock(struct octopus_linked_queue *const object,
+                 pthread_mutex_t *const mutex,
+                 const bool wait) {
+    assert(object);
+    assert(mutex);
+    if (!wait) {
+        const int error = pthread_mutex_trylock(mutex);
+        if (!error) {
+            OCTOPUS_PROBE2(shard__lock__acquire, object, mutex);
+            return true;
+        }
+        seagrass_required_true(EBUSY == error);
+        OCTOPUS_PROBE2(shard__lock__busy, object, mutex);
+        octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_LOCK_IS_BUSY;
+        return false;
+    }
+    /* the time between these two is how long we waited for the lock */
+    OCTOPUS_PROBE2(shard__lock__wait, object, mutex);
+    seagrass_required_true(!pthread_mutex_lock(mutex));
+    OCTOPUS_PROBE2(shard__lock__acquire, object, mutex);
+    return true;
+}
+
+/* must hold the enqueue lock, allocates the dummy on the first add */
+static bool prepare(struct octopus_linked_queue *const object) {
+    assert(object);
+    if (object->tail) {
+        return true;
+    }
+    struct octopus_linked_queue_node *const dummy = node_of(object);
+    if (!dummy) {
+        octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    object->first = object->tail = dummy;
+    atomic_store_explicit(&object->head, dummy, memory_order_release);
+    return true;
+}
+
+/* must hold the enqueue lock */
+static bool append(struct octopus_linked_queue *const object,
+                   const void *const item) {
+    assert(object);
+    assert(item);
+    if (object->spill
+        && (atomic_load_explicit(&object->spill->count, memory_order_relaxed)
+            || object->threshold <= atomic_load_explicit(
+                &object->resident, memory_order_relaxed))) {
+        seagrass_required_true(!pthread_mutex_lock(&object->spilling));
+        const bool result = octopus_spill_add(object->spill, item);
+        seagrass_required_true(!pthread_mutex_unlock(&object->spilling));
+        if (!result) {
+            octopus_error = OCTOPUS_SPILL_ERROR_FILE_FAILED == octopus_error
+                            ? OCTOPUS_LINKED_QUEUE_ERROR_SPILL_FAILED
+                            : OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+        } else {
+            OCTOPUS_PROBE2(shard__add, object, 1);
+        }
+        return result;
+    }
+    if (!prepare(object)) {
+        return false;
+    }
+    struct octopus_linked_queue_node *const node = node_of(object);
+    if (!node) {
+        octopus_error =
+                OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    memcpy(node->item, item, object->size);
+    if (object->spill) {
+        atomic_fetch_add_explicit(&object->resident, 1, memory_order_relaxed);
+    }
+    atomic_store_explicit(&object->tail->next, node, memory_order_release);
+    object->tail = node;
+    OCTOPUS_PROBE2(shard__add, object, 0);
+    return true;
+}
+
+static bool insert(struct octopus_linked_queue *const object,
+                   const void *const item,
+                   const bool wait) {
+    if (!object) {
+        octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!item) {
+        octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_ITEM_IS_NULL;
+        return false;
+    }
+    if (!lock(object, &object->enqueue, wait)) {
+        return false;
+    }
+    const bool result = append(object, item);
+    seagrass_required_true(!pthread_mutex_unlock(&object->enqueue));
+    return result;
+}
 
 bool octopus_linked_queue_add(
         struct octopus_linked_queue *const object,
         const void *const item) {
+    return insert(object, item, true);
+}
+
+bool octopus_linked_queue_add_unless_busy(
+        struct octopus_linked_queue *const object,
+        const void *const item) {
+    return insert(object, item, false);
+}
+
+bool octopus_linked_queue_add_all(
+        struct octopus_linked_queue *const object,
+        const void *const items,
+        const uintmax_t count,
+        uintmax_t *const out) {
     if (!object) {
         octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
         return false;
     }
-    if (!item) {
+    if (!items) {
         octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_ITEM_IS_NULL;
         return false;
     }
-    seagrass_required_true(!pthread_mutex_lock(&object->enqueue));
-    const bool result = coral_linked_queue_add(&object->queue, item);
-    if (!result) {
-        seagrass_required_true(CORAL_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED
-                               == coral_error);
-        octopus_error =
-                OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+    if (!out) {
+        octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    if (!count) {
+        *out = 0;
+        return true;
+    }
+    const unsigned char *const bytes = items;
+    seagrass_required_true(lock(object, &object->enqueue, true));
+    if (object->spill) {
+        /* the items may have to go to the spill part way through */
+        uintmax_t i = 0;
+        for (; i < count && append(object, bytes + i * object->size); i++);
+        seagrass_required_true(!pthread_mutex_unlock(&object->enqueue));
+        *out = i;
+        return i == count;
+    }
+    if (!prepare(object)) {
+        seagrass_required_true(!pthread_mutex_unlock(&object->enqueue));
+        *out = 0;
+        return false;
     }
+    /* link the nodes up on their own and splice them in with one store so
+     * that consumers only ever see the whole chain */
+    struct octopus_linked_queue_node *first = NULL;
+    struct octopus_linked_queue_node *last = NULL;
+    for (uintmax_t i = 0; i < count; i++) {
+        struct octopus_linked_queue_node *const node = node_of(object);
+        if (!node) {
+            /* hand the nodes back for reuse, they sit in front of head */
+            if (last) {
+                atomic_store_explicit(&last->next, object->first,
+                                      memory_order_relaxed);
+                object->first = first;
+            }
+            seagrass_required_true(!pthread_mutex_unlock(&object->enqueue));
+            *out = 0;
+            octopus_error =
+                    OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+            return false;
+        }
+        memcpy(node->item, bytes + i * object->size, object->size);
+        if (last) {
+            atomic_store_explicit(&last->next, node, memory_order_relaxed);
+        } else {
+            first = node;
+        }
+        last = node;
+    }
+    atomic_store_explicit(&object->tail->next, first, memory_order_release);
+    object->tail = last;
     seagrass_required_true(!pthread_mutex_unlock(&object->enqueue));
+    for (uintmax_t i = 0; i < count; i++) {
+        OCTOPUS_PROBE2(shard__add, object, 0);
+    }
+    *out = count;
+    return true;
+}
+
+static struct octopus_linked_queue_node *next_of(
+        struct octopus_linked_queue *const object) {
+    assert(object);
+    struct octopus_linked_queue_node *const head = atomic_load_explicit(
+            &object->head, memory_order_acquire);
+    return head
+           ? atomic_load_explicit(&head->next, memory_order_acquire)
+           : NULL;
+}
+
+static bool retrieve_spilled(struct octopus_linked_queue *const object,
+                             void **const out,
+                             const bool remove) {
+    assert(object);
+    assert(out);
+    bool result = false;
+    seagrass_required_true(!pthread_mutex_lock(&object->spilling));
+    /* an item that made it into memory before the spilled one we are about
+     * to take is older, so look again now that the producers are held */
+    if (!next_of(object)) {
+        result = remove
+                 ? octopus_spill_remove(object->spill, out)
+                 : octopus_spill_peek(object->spill, out);
+        assert(result || OCTOPUS_SPILL_ERROR_SPILL_IS_EMPTY == octopus_error);
+    }
+    seagrass_required_true(!pthread_mutex_unlock(&object->spilling));
     return result;
 }
 
 static bool retrieve(struct octopus_linked_queue *const object,
                      void **const out,
-                     bool (*func)(struct coral_linked_queue *, void **)) {
-    assert(func);
+                     const bool remove,
+                     const bool wait) {
     if (!object) {
         octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
         return false;
@@ -142,37 +390,201 @@ static bool retrieve(struct octopus_linked_queue *const object,
         octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_OUT_IS_NULL;
         return false;
     }
-    seagrass_required_true(!pthread_mutex_lock(&object->dequeue));
-    uintmax_t count;
-    seagrass_required_true(coral_linked_queue_count(
-            &object->queue, &count));
-    bool result = true;
-    if (1 >= count) {
-        seagrass_required_true(!pthread_mutex_lock(&object->enqueue));
-        if (!(result = func(&object->queue, out))) {
-            seagrass_required_true(CORAL_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY
-                                   == coral_error);
-            octopus_error =
-                    OCTOPUS_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY;
+    if (!lock(object, &object->dequeue, wait)) {
+        return false;
+    }
+    struct octopus_linked_queue_node *next;
+    while (!(next = next_of(object))) {
+        if (object->spill
+            && atomic_load_explicit(&object->spill->count,
+                                    memory_order_acquire)) {
+            if (retrieve_spilled(object, out, remove)) {
+                seagrass_required_true(
+                        !pthread_mutex_unlock(&object->dequeue));
+                if (remove) {
+                    OCTOPUS_PROBE2(shard__remove, object, 1);
+                }
+                return true;
+            }
+            continue;
+        }
+        seagrass_required_true(!pthread_mutex_unlock(&object->dequeue));
+        OCTOPUS_PROBE1(shard__empty, object);
+        octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY;
+        return false;
+    }
+    memcpy(out, next->item, object->size);
+    if (remove) {
+        atomic_store_explicit(&object->head, next, memory_order_release);
+        if (object->spill) {
+            atomic_fetch_sub_explicit(&object->resident, 1,
+                                      memory_order_relaxed);
         }
-        seagrass_required_true(!pthread_mutex_unlock(&object->enqueue));
-    } else {
-        seagrass_required_true(func(&object->queue, out));
     }
     seagrass_required_true(!pthread_mutex_unlock(&object->dequeue));
-    return result;
+    if (remove) {
+        OCTOPUS_PROBE2(shard__remove, object, 0);
+    }
+    return true;
 }
 
 bool octopus_linked_queue_remove(
         struct octopus_linked_queue *const object,
         void **const out) {
-    return retrieve(object, out, coral_linked_queue_remove);
+    return retrieve(object, out, true, true);
+}
+
+bool octopus_linked_queue_remove_unless_busy(
+        struct octopus_linked_queue *const object,
+        void **const out) {
+    return retrieve(object, out, true, false);
 }
 
 bool octopus_linked_queue_peek(
         struct octopus_linked_queue *const object,
         void **const out) {
-    return retrieve(object, out,
-                    (bool (*)(struct coral_linked_queue *, void **))
-                            coral_linked_queue_peek);
+    return retrieve(object, out, false, true);
+}
+
+bool octopus_linked_queue_is_empty(
+        struct octopus_linked_queue *const object,
+        bool *const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    seagrass_required_true(!pthread_mutex_lock(&object->dequeue));
+    *out = !next_of(object)
+           && (!object->spill || !atomic_load(&object->spill->count));
+    seagrass_required_true(!pthread_mutex_unlock(&object->dequeue));
+    return true;
+}
+
+bool octopus_linked_queue_memory_usage(
+        const struct octopus_linked_queue *const object,
+        uintmax_t *const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    *out = atomic_load_explicit(&object->nodes, memory_order_relaxed)
+           * (sizeof(struct octopus_linked_queue_node) + object->size);
+    return true;
+}
+
+bool octopus_linked_queue_trim(struct octopus_linked_queue *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    seagrass_required_true(!pthread_mutex_lock(&object->dequeue));
+    seagrass_required_true(!pthread_mutex_lock(&object->enqueue));
+    struct octopus_linked_queue_node *const head = atomic_load(&object->head);
+    uintmax_t nodes = atomic_load(&object->nodes);
+    while (object->first != head) {
+        struct octopus_linked_queue_node *const node = object->first;
+        object->first = atomic_load(&node->next);
+        free_node(object, node);
+        nodes--;
+    }
+    if (head && !atomic_load(&head->next)) {
+        free_node(object, head);
+        object->first = object->tail = NULL;
+        atomic_store(&object->head, NULL);
+        nodes--;
+    }
+    atomic_store(&object->nodes, nodes);
+    seagrass_required_true(!pthread_mutex_unlock(&object->enqueue));
+    seagrass_required_true(!pthread_mutex_unlock(&object->dequeue));
+    return true;
+}
+
+bool octopus_linked_queue_attach_spill(
+        struct octopus_linked_queue *const object,
+        const char *const directory,
+        const uintmax_t threshold,
+        const uintmax_t segment) {
+    if (!object) {
+        octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!directory) {
+        octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_DIRECTORY_IS_NULL;
+        return false;
+    }
+    if (object->spill) {
+        return true;
+    }
+    struct octopus_spill *const spill = octopus_allocate(
+            &object->allocator, sizeof(*spill), _Alignof(struct octopus_spill));
+    if (!spill) {
+        octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    if (!octopus_spill_init(spill, directory, object->size, segment)) {
+        switch (octopus_error) {
+            default: {
+                seagrass_required_true(false);
+            }
+            case OCTOPUS_SPILL_ERROR_SIZE_IS_TOO_LARGE: {
+                octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_SIZE_IS_TOO_LARGE;
+                break;
+            }
+            case OCTOPUS_SPILL_ERROR_FILE_FAILED: {
+                octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_SPILL_FAILED;
+                break;
+            }
+            case OCTOPUS_SPILL_ERROR_MEMORY_ALLOCATION_FAILED: {
+                octopus_error =
+                        OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+                break;
+            }
+        }
+        octopus_deallocate(&object->allocator, spill, sizeof(*spill));
+        return false;
+    }
+    int error;
+    if ((error = pthread_mutex_init(&object->spilling, NULL))) {
+        seagrass_required_true(ENOMEM == error);
+        seagrass_required_true(octopus_spill_invalidate(spill, NULL));
+        octopus_deallocate(&object->allocator, spill, sizeof(*spill));
+        octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    uintmax_t count = 0;
+    struct octopus_linked_queue_node *node = atomic_load(&object->head);
+    while (node && (node = atomic_load(&node->next))) {
+        count++;
+    }
+    atomic_store(&object->resident, count);
+    object->threshold = threshold;
+    object->spill = spill;
+    return true;
+}
+
+bool octopus_linked_queue_detach_spill(
+        struct octopus_linked_queue *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (object->spill) {
+        assert(!atomic_load(&object->spill->count));
+        seagrass_required_true(octopus_spill_invalidate(object->spill, NULL));
+        seagrass_required_true(!pthread_mutex_destroy(&object->spilling));
+        octopus_deallocate(&object->allocator, object->spill,
+                           sizeof(*object->spill));
+        object->spill = NULL;
+        object->threshold = 0;
+        atomic_store(&object->resident, 0);
+    }
+    return true;
 }
@@ -0,0 +1,165 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <seagrass.h>
+#include <octopus.h>
+
+#include "private/mpsc_queue.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+bool octopus_mpsc_queue_init(struct octopus_mpsc_queue *const object,
+                             const size_t size) {
+    if (!object) {
+        octopus_error = OCTOPUS_MPSC_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!size) {
+        octopus_error = OCTOPUS_MPSC_QUEUE_ERROR_SIZE_IS_ZERO;
+        return false;
+    }
+    if (size > SIZE_MAX - sizeof(struct octopus_mpsc_queue_node)) {
+        octopus_error = OCTOPUS_MPSC_QUEUE_ERROR_SIZE_IS_TOO_LARGE;
+        return false;
+    }
+    struct octopus_mpsc_queue_node *const stub
+            = malloc(sizeof(*stub) + size);
+    if (!stub) {
+        octopus_error = OCTOPUS_MPSC_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    atomic_init(&stub->next, NULL);
+    *object = (struct octopus_mpsc_queue) {0};
+    object->size = size;
+    atomic_init(&object->head, stub);
+    object->tail = stub;
+    return true;
+}
+
+bool octopus_mpsc_queue_invalidate(struct octopus_mpsc_queue *const object,
+                                   void (*const on_destroy)(void *)) {
+    if (!object) {
+        octopus_error = OCTOPUS_MPSC_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    struct octopus_mpsc_queue_node *node = object->tail;
+    bool item = false;
+    while (node) {
+        struct octopus_mpsc_queue_node *const next
+                = atomic_load_explicit(&node->next, memory_order_acquire);
+        if (item && on_destroy) {
+            on_destroy(node->item);
+        }
+        item = true;
+        free(node);
+        node = next;
+    }
+    *object = (struct octopus_mpsc_queue) {0};
+    return true;
+}
+
+bool octopus_mpsc_queue_add(struct octopus_mpsc_queue *const object,
+                            const void *const item) {
+    if (!object) {
+        octopus_error = OCTOPUS_MPSC_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!item) {
+        octopus_error = OCTOPUS_MPSC_QUEUE_ERROR_ITEM_IS_NULL;
+        return false;
+    }
+    struct octopus_mpsc_queue_node *const node
+            = malloc(sizeof(*node) + object->size);
+    if (!node) {
+        octopus_error = OCTOPUS_MPSC_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    memcpy(node->item, item, object->size);
+    atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+    struct octopus_mpsc_queue_node *const previous = atomic_exchange_explicit(
+            &object->head, node, memory_order_acq_rel);
+    /* until this store the consumer cannot reach the node nor any that are
+     * added after it */
+    atomic_store_explicit(&previous->next, node, memory_order_release);
+    return true;
+}
+
+/* oldest node still holding an item or NULL, consumer side only */
+static struct octopus_mpsc_queue_node *first(
+        const struct octopus_mpsc_queue *const object) {
+    assert(object);
+    /* an acquire load and no read-modify-write, which on most architectures
+     * is an ordinary load */
+    return atomic_load_explicit(&object->tail->next, memory_order_acquire);
+}
+
+bool octopus_mpsc_queue_remove(struct octopus_mpsc_queue *const object,
+                               void **const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_MPSC_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_MPSC_QUEUE_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    struct octopus_mpsc_queue_node *const next = first(object);
+    if (!next) {
+        octopus_error = OCTOPUS_MPSC_QUEUE_ERROR_QUEUE_IS_EMPTY;
+        return false;
+    }
+    memcpy(out, next->item, object->size);
+    free(object->tail);
+    object->tail = next;
+    return true;
+}
+
+bool octopus_mpsc_queue_remove_batch(struct octopus_mpsc_queue *const object,
+                                     void *const out,
+                                     const uintmax_t count,
+                                     uintmax_t *const removed) {
+    if (!object) {
+        octopus_error = OCTOPUS_MPSC_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out || !removed) {
+        octopus_error = OCTOPUS_MPSC_QUEUE_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    unsigned char *item = out;
+    uintmax_t i = 0;
+    struct octopus_mpsc_queue_node *next;
+    for (; i < count && (next = first(object)); i++) {
+        memcpy(item, next->item, object->size);
+        item += object->size;
+        free(object->tail);
+        object->tail = next;
+    }
+    if (!i) {
+        octopus_error = OCTOPUS_MPSC_QUEUE_ERROR_QUEUE_IS_EMPTY;
+        return false;
+    }
+    *removed = i;
+    return true;
+}
+
+bool octopus_mpsc_queue_peek(struct octopus_mpsc_queue *const object,
+                             void **const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_MPSC_QUEUE_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_MPSC_QUEUE_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    struct octopus_mpsc_queue_node *const next = first(object);
+    if (!next) {
+        octopus_error = OCTOPUS_MPSC_QUEUE_ERROR_QUEUE_IS_EMPTY;
+        return false;
+    }
+    memcpy(out, next->item, object->size);
+    return true;
+}
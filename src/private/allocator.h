@@ -0,0 +1,29 @@
+#ifndef _OCTOPUS_PRIVATE_ALLOCATOR_H_
+#define _OCTOPUS_PRIVATE_ALLOCATOR_H_
+
+#include <stddef.h>
+#include <octopus/allocator.h>
+
+/**
+ * @brief Allocate memory from the given allocator.
+ * <p>An allocator without any functions stands for the C library.</p>
+ * @param [in] allocator memory source.
+ * @param [in] size in bytes to allocate.
+ * @param [in] alignment power of two the memory is to be aligned to.
+ * @return allocated memory or <i>NULL</i> if there is not enough memory.
+ */
+void *octopus_allocate(const struct octopus_allocator *allocator,
+                       size_t size,
+                       size_t alignment);
+
+/**
+ * @brief Return memory to the allocator it was taken from.
+ * @param [in] allocator memory source.
+ * @param [in] pointer to the memory or <i>NULL</i>.
+ * @param [in] size in bytes that was allocated.
+ */
+void octopus_deallocate(const struct octopus_allocator *allocator,
+                        void *pointer,
+                        size_t size);
+
+#endif /* _OCTOPUS_PRIVATE_ALLOCATOR_H_ */
@@ -0,0 +1,17 @@
+#ifndef _OCTOPUS_PRIVATE_ARENA_H_
+#define _OCTOPUS_PRIVATE_ARENA_H_
+
+#include <stddef.h>
+
+/* placed at the start of every mapped region */
+struct octopus_arena_region {
+    struct octopus_arena_region *next;
+    size_t size;
+};
+
+/* released block waiting on the free list of its size class */
+struct octopus_arena_block {
+    struct octopus_arena_block *next;
+};
+
+#endif /* _OCTOPUS_PRIVATE_ARENA_H_ */
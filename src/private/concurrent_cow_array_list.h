@@ -0,0 +1,19 @@
+#ifndef _OCTOPUS_PRIVATE_CONCURRENT_COW_ARRAY_LIST_H_
+#define _OCTOPUS_PRIVATE_CONCURRENT_COW_ARRAY_LIST_H_
+
+#include <coral.h>
+
+#include "epoch.h"
+
+/* never changed once published, retired through the epoch when replaced,
+ * the items and length of the list are kept alongside it so that readers
+ * need not go through the list */
+struct octopus_concurrent_cow_array_list_snapshot {
+    struct octopus_epoch_entry entry;
+    unsigned char *items;
+    uintmax_t length;
+    size_t size;
+    struct coral_array_list list;
+};
+
+#endif /* _OCTOPUS_PRIVATE_CONCURRENT_COW_ARRAY_LIST_H_ */
@@ -0,0 +1,41 @@
+#ifndef _OCTOPUS_PRIVATE_CONCURRENT_DELAY_QUEUE_H_
+#define _OCTOPUS_PRIVATE_CONCURRENT_DELAY_QUEUE_H_
+
+#include <stdint.h>
+#include <pthread.h>
+#include <octopus/cache_line.h>
+
+/* each level of the wheel has 2^BITS slots, followed by the overflow and the
+ * expired lists */
+#define OCTOPUS_CONCURRENT_DELAY_QUEUE_BITS     6
+#define OCTOPUS_CONCURRENT_DELAY_QUEUE_LEVELS   4
+#define OCTOPUS_CONCURRENT_DELAY_QUEUE_LISTS \
+    ((OCTOPUS_CONCURRENT_DELAY_QUEUE_LEVELS \
+      << OCTOPUS_CONCURRENT_DELAY_QUEUE_BITS) + 2)
+
+struct octopus_concurrent_delay_queue_entry {
+    uintmax_t generation;
+    uintmax_t deadline;
+    uintmax_t list;
+    uintmax_t prev;
+    uintmax_t next;
+};
+
+struct octopus_concurrent_delay_queue_list {
+    uintmax_t head;
+    uintmax_t tail;
+};
+
+struct octopus_concurrent_delay_queue_shard {
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) pthread_mutex_t lock;
+    uintmax_t current;
+    uintmax_t pending;
+    uint64_t occupied[OCTOPUS_CONCURRENT_DELAY_QUEUE_LEVELS];
+    struct octopus_concurrent_delay_queue_entry *entries;
+    unsigned char *items;
+    uintmax_t capacity;
+    uintmax_t free;
+    struct octopus_concurrent_delay_queue_list lists[OCTOPUS_CONCURRENT_DELAY_QUEUE_LISTS];
+};
+
+#endif /* _OCTOPUS_PRIVATE_CONCURRENT_DELAY_QUEUE_H_ */
@@ -0,0 +1,22 @@
+#ifndef _OCTOPUS_PRIVATE_CONCURRENT_INTRUSIVE_QUEUE_H_
+#define _OCTOPUS_PRIVATE_CONCURRENT_INTRUSIVE_QUEUE_H_
+
+#include <pthread.h>
+#include <octopus/cache_line.h>
+#include <octopus/concurrent_intrusive_queue.h>
+
+/*
+ * Two-lock queue of caller owned links. Links from first up to last are
+ * chained through next and the shard's own stub link sits among them
+ * whenever the queue would otherwise be left without a link, so that
+ * producers and consumers only ever meet on the last item.
+ */
+struct octopus_concurrent_intrusive_queue_shard {
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) pthread_mutex_t dequeue;
+    struct octopus_queue_link *first;
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) pthread_mutex_t enqueue;
+    struct octopus_queue_link *last;
+    struct octopus_queue_link stub;
+};
+
+#endif /* _OCTOPUS_PRIVATE_CONCURRENT_INTRUSIVE_QUEUE_H_ */
@@ -0,0 +1,25 @@
+#ifndef _OCTOPUS_PRIVATE_CONCURRENT_LINKED_DEQUE_H_
+#define _OCTOPUS_PRIVATE_CONCURRENT_LINKED_DEQUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <octopus/cache_line.h>
+
+struct octopus_concurrent_linked_deque_node {
+    struct octopus_concurrent_linked_deque_node *prev;
+    struct octopus_concurrent_linked_deque_node *next;
+    _Alignas(max_align_t) unsigned char item[];
+};
+
+/* a doubly linked deque behind a single lock, released nodes are kept on
+ * the spare list for reuse */
+struct octopus_concurrent_linked_deque_shard {
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) pthread_mutex_t lock;
+    struct octopus_concurrent_linked_deque_node *head;
+    struct octopus_concurrent_linked_deque_node *tail;
+    struct octopus_concurrent_linked_deque_node *spare;
+    uintmax_t spares;
+};
+
+#endif /* _OCTOPUS_PRIVATE_CONCURRENT_LINKED_DEQUE_H_ */
@@ -0,0 +1,46 @@
+#ifndef _OCTOPUS_PRIVATE_CONCURRENT_POOL_H_
+#define _OCTOPUS_PRIVATE_CONCURRENT_POOL_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <octopus/cache_line.h>
+
+/* smallest slab, slabs are a power of two in size and aligned to it so that
+ * the slab an object belongs to is found by masking its address */
+#define OCTOPUS_CONCURRENT_POOL_SLAB_SIZE       (UINTMAX_C(1) << 16)
+
+/* overlaid on an object while it is free, count is only meaningful in the
+ * first object of a batch */
+struct octopus_concurrent_pool_free {
+    struct octopus_concurrent_pool_free *next;
+    uintmax_t count;
+};
+
+/* sits at the start of each slab, the links chain the first objects of the
+ * batches held by the global list by index so that a stale link is caught by
+ * the tag next to the index in the list's head */
+struct octopus_concurrent_pool_slab {
+    uintmax_t index;
+    atomic_uint_least32_t links[];
+};
+
+/* replaced by a larger copy as slabs are added, the previous tables are kept
+ * around until the pool is invalidated as they may still be read from */
+struct octopus_concurrent_pool_table {
+    struct octopus_concurrent_pool_table *previous;
+    uintmax_t count;
+    uintmax_t capacity;
+    struct octopus_concurrent_pool_slab *slabs[];
+};
+
+struct octopus_concurrent_pool_cache {
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) struct octopus_concurrent_pool *pool;
+    struct octopus_concurrent_pool_free *head;
+    uintmax_t count;
+    struct octopus_concurrent_pool_cache *next;
+    atomic_bool used;
+};
+
+#endif /* _OCTOPUS_PRIVATE_CONCURRENT_POOL_H_ */
@@ -0,0 +1,29 @@
+#ifndef _OCTOPUS_PRIVATE_CONCURRENT_SKIP_LIST_H_
+#define _OCTOPUS_PRIVATE_CONCURRENT_SKIP_LIST_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#include "epoch.h"
+
+#define OCTOPUS_CONCURRENT_SKIP_LIST_MAX_HEIGHT 32
+
+/* the key is followed by the tower of marked next pointers and then the
+ * value, so that a search reads the key and the pointer it follows from the
+ * same cache line */
+struct octopus_concurrent_skip_list_node {
+    struct octopus_epoch_entry entry;
+    uintmax_t height;
+    /* the inserter and the remover each hold the node until they are done
+     * linking and unlinking it, whoever lets go last reclaims it */
+    atomic_uint holders;
+    _Alignas(max_align_t) unsigned char data[];
+};
+
+#ifdef TEST
+/* when not zero, the height of every node inserted */
+extern uintmax_t octopus_concurrent_skip_list_height;
+#endif
+
+#endif /* _OCTOPUS_PRIVATE_CONCURRENT_SKIP_LIST_H_ */
@@ -0,0 +1,79 @@
+#ifndef _OCTOPUS_PRIVATE_DEADLINE_H_
+#define _OCTOPUS_PRIVATE_DEADLINE_H_
+
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <seagrass.h>
+
+/* largest value of the signed time_t */
+#define OCTOPUS_DEADLINE_SECONDS_MAX \
+    ((time_t) (((uintmax_t) 1 << (sizeof(time_t) * CHAR_BIT - 1)) - 1))
+
+/**
+ * @brief Check that a relative timeout is usable.
+ * @param [in] timeout relative time to wait for.
+ * @return true if neither part is negative and there are fewer than a
+ * second's worth of nanoseconds, otherwise false.
+ */
+static inline bool octopus_deadline_is_valid(
+        const struct timespec *const timeout) {
+    assert(timeout);
+    return timeout->tv_sec >= 0
+           && timeout->tv_nsec >= 0
+           && timeout->tv_nsec < 1000000000L;
+}
+
+/**
+ * @brief Initialize a condition variable whose timed waits are measured
+ * against <i>CLOCK_MONOTONIC</i>, so that changes to the wall clock neither
+ * stretch nor cut short a wait.
+ * @param [in] condition to be initialized.
+ * @return 0 on success, otherwise the error reported by pthread.
+ */
+static inline int octopus_deadline_condition_init(
+        pthread_cond_t *const condition) {
+    assert(condition);
+    pthread_condattr_t attributes;
+    int error;
+    if ((error = pthread_condattr_init(&attributes))) {
+        return error;
+    }
+    seagrass_required_true(!pthread_condattr_setclock(&attributes,
+                                                      CLOCK_MONOTONIC));
+    error = pthread_cond_init(condition, &attributes);
+    seagrass_required_true(!pthread_condattr_destroy(&attributes));
+    return error;
+}
+
+/**
+ * @brief Convert a relative timeout into an absolute deadline.
+ * <p>The deadline is measured against <i>CLOCK_MONOTONIC</i>, for condition
+ * variables initialized by @ref octopus_deadline_condition_init. A timeout
+ * too long to be represented waits for as long as it can.</p>
+ * @param [in] timeout valid relative time to wait for.
+ * @param [out] out receive the deadline.
+ */
+static inline void octopus_deadline_of(const struct timespec *const timeout,
+                                       struct timespec *const out) {
+    assert(timeout);
+    assert(octopus_deadline_is_valid(timeout));
+    assert(out);
+    seagrass_required_true(!clock_gettime(CLOCK_MONOTONIC, out));
+    if (timeout->tv_sec >= OCTOPUS_DEADLINE_SECONDS_MAX - out->tv_sec) {
+        out->tv_sec = OCTOPUS_DEADLINE_SECONDS_MAX;
+        out->tv_nsec = 999999999L;
+        return;
+    }
+    out->tv_sec += timeout->tv_sec;
+    out->tv_nsec += timeout->tv_nsec;
+    if (out->tv_nsec >= 1000000000L) {
+        out->tv_sec += 1;
+        out->tv_nsec -= 1000000000L;
+    }
+}
+
+#endif /* _OCTOPUS_PRIVATE_DEADLINE_H_ */
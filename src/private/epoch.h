@@ -0,0 +1,44 @@
+#ifndef _OCTOPUS_PRIVATE_EPOCH_H_
+#define _OCTOPUS_PRIVATE_EPOCH_H_
+
+#include <stdbool.h>
+
+struct octopus_epoch_entry {
+    struct octopus_epoch_entry *next;
+    void (*on_free)(struct octopus_epoch_entry *);
+};
+
+/**
+ * @brief Enter a read-side critical section.
+ * <p>Memory retired by any thread while the calling thread is inside the
+ * critical section is not released until it leaves. Critical sections may be
+ * nested.</p>
+ * @return On success true, otherwise false if the calling thread could not be
+ * registered due to insufficient memory.
+ */
+bool octopus_epoch_enter(void);
+
+/**
+ * @brief Leave a read-side critical section.
+ */
+void octopus_epoch_exit(void);
+
+/**
+ * @brief Retire memory that has been made unreachable.
+ * <p>Must be called from inside a critical section. The <i>on free</i>
+ * callback is invoked once no thread can still be holding a reference to it,
+ * it must not access the structure the entry was removed from.</p>
+ * @param [in] entry embedded in the memory to release.
+ * @param [in] on_free called to release the memory.
+ */
+void octopus_epoch_retire(struct octopus_epoch_entry *entry,
+                          void (*on_free)(struct octopus_epoch_entry *));
+
+/**
+ * @brief Wait until all the memory retired by the calling thread has been
+ * released.
+ * <p>Must not be called from inside a critical section.</p>
+ */
+void octopus_epoch_synchronize(void);
+
+#endif /* _OCTOPUS_PRIVATE_EPOCH_H_ */
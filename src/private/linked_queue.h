@@ -4,8 +4,10 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdatomic.h>
 #include <pthread.h>
-#include <coral.h>
+#include <octopus/allocator.h>
+#include <octopus/cache_line.h>
 
 #define OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL                1
 #define OCTOPUS_LINKED_QUEUE_ERROR_SIZE_IS_ZERO                  2
@@ -14,11 +16,40 @@
 #define OCTOPUS_LINKED_QUEUE_ERROR_OUT_IS_NULL                   5
 #define OCTOPUS_LINKED_QUEUE_ERROR_ITEM_IS_NULL                  6
 #define OCTOPUS_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY                7
+#define OCTOPUS_LINKED_QUEUE_ERROR_SPILL_FAILED                  8
+#define OCTOPUS_LINKED_QUEUE_ERROR_DIRECTORY_IS_NULL             9
+#define OCTOPUS_LINKED_QUEUE_ERROR_LOCK_IS_BUSY                  10
 
+struct octopus_spill;
+
+struct octopus_linked_queue_node {
+    _Atomic(struct octopus_linked_queue_node *) next;
+    _Alignas(max_align_t) unsigned char item[];
+};
+
+/*
+ * Two-lock queue whose nodes are recycled. Nodes from first up to, but
+ * excluding, head have been consumed and are reused by add before any new
+ * memory is allocated. The head node is a dummy, it is allocated on the
+ * first add so that an idle queue holds no nodes.
+ *
+ * With a spill attached, items are appended to the spill instead once
+ * threshold items are resident in memory, or while the spill still holds
+ * any, so that the items in memory are always older than those spilled.
+ */
 struct octopus_linked_queue {
-    struct coral_linked_queue queue;
-    pthread_mutex_t enqueue;
-    pthread_mutex_t dequeue;
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) pthread_mutex_t dequeue;
+    _Atomic(struct octopus_linked_queue_node *) head;
+    size_t size;
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) pthread_mutex_t enqueue;
+    struct octopus_linked_queue_node *tail;
+    struct octopus_linked_queue_node *first;
+    atomic_uintmax_t nodes;
+    struct octopus_spill *spill;
+    uintmax_t threshold;
+    atomic_uintmax_t resident;
+    pthread_mutex_t spilling;
+    struct octopus_allocator allocator;
 };
 
 /**
@@ -37,6 +68,26 @@ bool octopus_linked_queue_init(
         struct octopus_linked_queue *object,
         size_t size);
 
+/**
+ * @brief Initialize linked queue with an allocator.
+ * <p>The nodes and the spill, if one is attached, are allocated from the
+ * given allocator.</p>
+ * @param [in] object instance to be initialized.
+ * @param [in] size of item to be contained within the queue.
+ * @param [in] allocator memory source or <i>NULL</i> for the C library.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_SIZE_IS_ZERO if size is zero.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_SIZE_IS_TOO_LARGE if size is too
+ * large.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to initialize instance.
+ */
+bool octopus_linked_queue_init_with_allocator(
+        struct octopus_linked_queue *object,
+        size_t size,
+        const struct octopus_allocator *allocator);
+
 /**
  * @brief Invalidate linked queue.
  * <p>All the items contained within the queue will have the given <i>on
@@ -64,6 +115,17 @@ bool octopus_linked_queue_size(
         const struct octopus_linked_queue *object,
         size_t *out);
 
+/**
+ * @brief Retrieve the count of items.
+ * @param [in] object instance whose count we are to retrieve.
+ * @param [out] out receive the count.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ */
+bool octopus_linked_queue_count(struct octopus_linked_queue *object,
+                                uintmax_t *out);
+
 /**
  * @brief Add item to the end of the queue.
  * @param [in] object queue instance.
@@ -77,6 +139,46 @@ bool octopus_linked_queue_size(
 bool octopus_linked_queue_add(struct octopus_linked_queue *object,
                               const void *item);
 
+/**
+ * @brief Add item to the end of the queue unless another thread is adding.
+ * @param [in] object queue instance.
+ * @param [in] item to add to the end of the queue.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_ITEM_IS_NULL if item is <i>NULL</i>.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_LOCK_IS_BUSY if another thread holds
+ * the lock for adding.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to add item.
+ */
+bool octopus_linked_queue_add_unless_busy(struct octopus_linked_queue *object,
+                                          const void *item);
+
+/**
+ * @brief Add items to the end of the queue in one go.
+ * <p>The nodes are linked up with the enqueue lock held once and spliced in
+ * as a whole, so that a consumer sees either none or all of them. Either
+ * all the items are added or, should there be insufficient memory, none of
+ * them. With a spill attached the items are added one after another and
+ * those before the failing one stay added.</p>
+ * @param [in] object queue instance.
+ * @param [in] items array of count items to add to the end of the queue.
+ * @param [in] count number of items.
+ * @param [out] out receive the number of items that were added.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_ITEM_IS_NULL if items is <i>NULL</i>.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to add the items.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_SPILL_FAILED if a spill is attached and
+ * a segment file could not be created.
+ */
+bool octopus_linked_queue_add_all(struct octopus_linked_queue *object,
+                                  const void *items,
+                                  uintmax_t count,
+                                  uintmax_t *out);
+
 /**
  * @brief Remove item from the front of the queue.
  * @param [in] object queue instance.
@@ -89,6 +191,22 @@ bool octopus_linked_queue_add(struct octopus_linked_queue *object,
 bool octopus_linked_queue_remove(struct octopus_linked_queue *object,
                                  void **out);
 
+/**
+ * @brief Remove item from the front of the queue unless another thread is
+ * removing.
+ * @param [in] object queue instance.
+ * @param [in] out receive the item in the front of the queue.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_LOCK_IS_BUSY if another thread holds
+ * the lock for removing.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY if queue is empty.
+ */
+bool octopus_linked_queue_remove_unless_busy(
+        struct octopus_linked_queue *object,
+        void **out);
+
 /**
  * @brief Retrieve the item from the front of the queue without removing it.
  * @param [in] object queue instance.
@@ -102,4 +220,71 @@ bool octopus_linked_queue_remove(struct octopus_linked_queue *object,
 bool octopus_linked_queue_peek(struct octopus_linked_queue *object,
                                void **out);
 
+/**
+ * @brief Check if the queue is empty.
+ * @param [in] object queue instance.
+ * @param [out] out receive true if the queue is empty, otherwise false.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ */
+bool octopus_linked_queue_is_empty(struct octopus_linked_queue *object,
+                                   bool *out);
+
+/**
+ * @brief Retrieve the number of bytes held by the queue's nodes.
+ * <p>This includes the nodes holding items, the dummy node and nodes kept
+ * for reuse.</p>
+ * @param [in] object queue instance.
+ * @param [out] out receive the number of bytes.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ */
+bool octopus_linked_queue_memory_usage(
+        const struct octopus_linked_queue *object,
+        uintmax_t *out);
+
+/**
+ * @brief Release the nodes kept for reuse.
+ * <p>If the queue is empty the dummy node is released as well.</p>
+ * @param [in] object queue instance.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ */
+bool octopus_linked_queue_trim(struct octopus_linked_queue *object);
+
+/**
+ * @brief Attach a spill to the queue.
+ * <p>Must be done before the queue is shared with other threads. If a spill
+ * is already attached then nothing is done.</p>
+ * @param [in] object queue instance.
+ * @param [in] directory in which the segment files are created.
+ * @param [in] threshold number of items kept in memory before further items
+ * are spilled.
+ * @param [in] segment size in bytes of each segment file.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_DIRECTORY_IS_NULL if directory is
+ * <i>NULL</i>.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_SIZE_IS_TOO_LARGE if segment is too
+ * large.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_SPILL_FAILED if directory is not a
+ * writable directory.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to attach the spill.
+ */
+bool octopus_linked_queue_attach_spill(struct octopus_linked_queue *object,
+                                       const char *directory,
+                                       uintmax_t threshold,
+                                       uintmax_t segment);
+
+/**
+ * @brief Detach the spill from an empty queue.
+ * @param [in] object queue instance.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ */
+bool octopus_linked_queue_detach_spill(struct octopus_linked_queue *object);
+
 #endif /* _OCTOPUS_PRIVATE_LINKED_QUEUE_H_ */
@@ -0,0 +1,70 @@
+#ifndef _OCTOPUS_PRIVATE_MEMBARRIER_H_
+#define _OCTOPUS_PRIVATE_MEMBARRIER_H_
+
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <seagrass.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/membarrier.h>
+#endif
+
+/* the membarrier commands are enumerators, only the syscall is a macro */
+#if defined(__linux__) && defined(__NR_membarrier)
+#define OCTOPUS_HAS_MEMBARRIER
+#endif
+
+/*
+ * A thread on a rarely taken path may issue a full fence on every running
+ * thread of the process at once, so that the threads on the frequently taken
+ * path only need to stop the compiler from reordering.
+ */
+
+/**
+ * @brief Register the process for expedited membarriers.
+ * @return true if the kernel supports them and the process is registered,
+ * otherwise false in which case both sides have to issue their own fence.
+ */
+static inline bool octopus_membarrier_register(void) {
+#ifdef OCTOPUS_HAS_MEMBARRIER
+    const long commands = syscall(__NR_membarrier, MEMBARRIER_CMD_QUERY, 0);
+    return commands > 0
+           && (commands & MEMBARRIER_CMD_PRIVATE_EXPEDITED)
+           && (commands & MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED)
+           && !syscall(__NR_membarrier,
+                       MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0);
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Fence on the rarely taken path.
+ * @param [in] expedited whether the process is registered.
+ */
+static inline void octopus_membarrier_heavy(const bool expedited) {
+#ifdef OCTOPUS_HAS_MEMBARRIER
+    if (expedited) {
+        seagrass_required_true(!syscall(
+                __NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0));
+        return;
+    }
+#endif
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+/**
+ * @brief Fence on the frequently taken path.
+ * @param [in] expedited whether the process is registered.
+ */
+static inline void octopus_membarrier_light(const bool expedited) {
+    if (expedited) {
+        atomic_signal_fence(memory_order_seq_cst);
+    } else {
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+}
+
+#endif /* _OCTOPUS_PRIVATE_MEMBARRIER_H_ */
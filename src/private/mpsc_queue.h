@@ -0,0 +1,14 @@
+#ifndef _OCTOPUS_PRIVATE_MPSC_QUEUE_H_
+#define _OCTOPUS_PRIVATE_MPSC_QUEUE_H_
+
+#include <stddef.h>
+#include <stdatomic.h>
+
+/* the consumer's tail is always a node whose item has already been taken,
+ * the oldest item is in the node after it */
+struct octopus_mpsc_queue_node {
+    _Atomic(struct octopus_mpsc_queue_node *) next;
+    _Alignas(max_align_t) unsigned char item[];
+};
+
+#endif /* _OCTOPUS_PRIVATE_MPSC_QUEUE_H_ */
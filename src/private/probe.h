@@ -0,0 +1,33 @@
+#ifndef _OCTOPUS_PRIVATE_PROBE_H_
+#define _OCTOPUS_PRIVATE_PROBE_H_
+
+/*
+ * Statically defined tracing points under the "octopus" provider which may
+ * be attached to by bpftrace, perf or SystemTap without a rebuild. They are
+ * only compiled in when OCTOPUS_PROBES is defined, in which case each one is
+ * a single nop until something attaches to it. Otherwise they disappear and
+ * their arguments are not evaluated.
+ */
+#ifdef OCTOPUS_PROBES
+
+#include <sys/sdt.h>
+
+#define OCTOPUS_PROBE1(name, a) \
+    DTRACE_PROBE1(octopus, name, a)
+#define OCTOPUS_PROBE2(name, a, b) \
+    DTRACE_PROBE2(octopus, name, a, b)
+#define OCTOPUS_PROBE3(name, a, b, c) \
+    DTRACE_PROBE3(octopus, name, a, b, c)
+
+#else
+
+#define OCTOPUS_PROBE1(name, a) \
+    ((void) sizeof(a))
+#define OCTOPUS_PROBE2(name, a, b) \
+    ((void) sizeof(a), (void) sizeof(b))
+#define OCTOPUS_PROBE3(name, a, b, c) \
+    ((void) sizeof(a), (void) sizeof(b), (void) sizeof(c))
+
+#endif /* OCTOPUS_PROBES */
+
+#endif /* _OCTOPUS_PRIVATE_PROBE_H_ */
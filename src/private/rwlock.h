@@ -0,0 +1,13 @@
+#ifndef _OCTOPUS_PRIVATE_RWLOCK_H_
+#define _OCTOPUS_PRIVATE_RWLOCK_H_
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include <octopus/cache_line.h>
+
+/* number of readers holding the lock among the threads counted here */
+struct octopus_rwlock_slot {
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) atomic_uintmax_t readers;
+};
+
+#endif /* _OCTOPUS_PRIVATE_RWLOCK_H_ */
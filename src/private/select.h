@@ -0,0 +1,18 @@
+#ifndef _OCTOPUS_PRIVATE_SELECT_H_
+#define _OCTOPUS_PRIVATE_SELECT_H_
+
+#include <stdatomic.h>
+
+struct octopus_concurrent_linked_queue;
+
+/* set once a select has registered the process for expedited membarriers,
+ * producers then leave the full fence to the selects about to wait */
+extern atomic_bool octopus_select_expedited;
+
+/**
+ * @brief Wake up all the selects waiting on the queue.
+ * @param [in] object queue instance which has had an item added.
+ */
+void octopus_select_wake(struct octopus_concurrent_linked_queue *object);
+
+#endif /* _OCTOPUS_PRIVATE_SELECT_H_ */
@@ -0,0 +1,114 @@
+#ifndef _OCTOPUS_PRIVATE_SPILL_H_
+#define _OCTOPUS_PRIVATE_SPILL_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#define OCTOPUS_SPILL_ERROR_OBJECT_IS_NULL                      1
+#define OCTOPUS_SPILL_ERROR_DIRECTORY_IS_NULL                   2
+#define OCTOPUS_SPILL_ERROR_SIZE_IS_ZERO                        3
+#define OCTOPUS_SPILL_ERROR_SIZE_IS_TOO_LARGE                   4
+#define OCTOPUS_SPILL_ERROR_MEMORY_ALLOCATION_FAILED            5
+#define OCTOPUS_SPILL_ERROR_ITEM_IS_NULL                        6
+#define OCTOPUS_SPILL_ERROR_OUT_IS_NULL                         7
+#define OCTOPUS_SPILL_ERROR_SPILL_IS_EMPTY                      8
+#define OCTOPUS_SPILL_ERROR_FILE_FAILED                         9
+
+struct octopus_spill_segment {
+    struct octopus_spill_segment *next;
+    unsigned char *map;
+    int fd;
+    uintmax_t read;
+    uintmax_t write;
+};
+
+/*
+ * First in first out sequence of fixed size items kept in memory mapped
+ * segment files. Segments are unlinked as soon as they are created so that
+ * their disk space is returned once they have been drained and unmapped,
+ * even if the process goes away. Callers provide their own locking, only
+ * count may be read without it.
+ */
+struct octopus_spill {
+    char *directory;
+    size_t size;
+    uintmax_t items;
+    struct octopus_spill_segment *head;
+    struct octopus_spill_segment *tail;
+    atomic_uintmax_t count;
+};
+
+/**
+ * @brief Initialize spill.
+ * @param [in] object instance to be initialized.
+ * @param [in] directory in which the segment files are created.
+ * @param [in] size of item to be contained within the spill.
+ * @param [in] segment size in bytes of each segment file, this is rounded
+ * down to a whole number of items but holds at least one.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_SPILL_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_SPILL_ERROR_DIRECTORY_IS_NULL if directory is <i>NULL</i>.
+ * @throws OCTOPUS_SPILL_ERROR_SIZE_IS_ZERO if size is zero.
+ * @throws OCTOPUS_SPILL_ERROR_SIZE_IS_TOO_LARGE if size is too large.
+ * @throws OCTOPUS_SPILL_ERROR_FILE_FAILED if directory is not a writable
+ * directory.
+ * @throws OCTOPUS_SPILL_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to initialize instance.
+ */
+bool octopus_spill_init(struct octopus_spill *object,
+                        const char *directory,
+                        size_t size,
+                        uintmax_t segment);
+
+/**
+ * @brief Invalidate spill.
+ * <p>All the items contained within the spill will have the given <i>on
+ * destroy</i> callback invoked upon itself and the segments are released.</p>
+ * @param [in] object instance to be invalidated.
+ * @param [in] on_destroy called just before the item is to be destroyed.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_SPILL_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ */
+bool octopus_spill_invalidate(struct octopus_spill *object,
+                              void (*on_destroy)(void *));
+
+/**
+ * @brief Append item to the spill.
+ * @param [in] object spill instance.
+ * @param [in] item to append.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_SPILL_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_SPILL_ERROR_ITEM_IS_NULL if item is <i>NULL</i>.
+ * @throws OCTOPUS_SPILL_ERROR_FILE_FAILED if a segment file could not be
+ * created, for example if the disk is full.
+ * @throws OCTOPUS_SPILL_ERROR_MEMORY_ALLOCATION_FAILED if there is
+ * insufficient memory to append item.
+ */
+bool octopus_spill_add(struct octopus_spill *object, const void *item);
+
+/**
+ * @brief Remove the oldest item from the spill.
+ * <p>Segments are released as soon as they have been drained.</p>
+ * @param [in] object spill instance.
+ * @param [out] out receive the oldest item.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_SPILL_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_SPILL_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws OCTOPUS_SPILL_ERROR_SPILL_IS_EMPTY if spill is empty.
+ */
+bool octopus_spill_remove(struct octopus_spill *object, void **out);
+
+/**
+ * @brief Retrieve the oldest item from the spill without removing it.
+ * @param [in] object spill instance.
+ * @param [out] out receive the oldest item.
+ * @return On success true, otherwise false if an error has occurred.
+ * @throws OCTOPUS_SPILL_ERROR_OBJECT_IS_NULL if object is <i>NULL</i>.
+ * @throws OCTOPUS_SPILL_ERROR_OUT_IS_NULL if out is <i>NULL</i>.
+ * @throws OCTOPUS_SPILL_ERROR_SPILL_IS_EMPTY if spill is empty.
+ */
+bool octopus_spill_peek(const struct octopus_spill *object, void **out);
+
+#endif /* _OCTOPUS_PRIVATE_SPILL_H_ */
@@ -0,0 +1,28 @@
+#ifndef _OCTOPUS_PRIVATE_STRIPED_COUNTER_H_
+#define _OCTOPUS_PRIVATE_STRIPED_COUNTER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <octopus/cache_line.h>
+
+struct octopus_striped_counter;
+
+/* allocated together at initialization, the first count of which are in
+ * use */
+struct octopus_striped_counter_cell {
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) atomic_uintmax_t value;
+};
+
+/**
+ * @brief Double the number of cells in use.
+ * <p>Nothing is done if another thread has grown the counter since
+ * <i>count</i> cells were seen or if it is already at its limit.</p>
+ * @param [in] object counter instance.
+ * @param [in] count number of cells seen by the caller.
+ * @return true if the number of cells was doubled, otherwise false.
+ */
+bool octopus_striped_counter_grow(struct octopus_striped_counter *object,
+                                  uintmax_t count);
+
+#endif /* _OCTOPUS_PRIVATE_STRIPED_COUNTER_H_ */
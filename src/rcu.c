@@ -0,0 +1,323 @@
+#include <stdlib.h>
+#include <assert.h>
+#include <errno.h>
+#include <sched.h>
+#include <seagrass.h>
+#include <octopus.h>
+
+#include "private/membarrier.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+/*
+ * Readers record the grace period they entered in, zero while outside of a
+ * critical section. A grace period ends once no reader is left that entered
+ * before it began.
+ *
+ * Either every reader issues a full fence after recording its grace period
+ * and before reading the pointer, or when the kernel supports it, the writer
+ * issues one on every running thread of the process at once through
+ * membarrier and readers only need to stop the compiler reordering.
+ */
+
+/* pairs with the fence in octopus_rcu_read_lock() */
+static void writer_fence(const struct octopus_rcu *const object) {
+    assert(object);
+    octopus_membarrier_heavy(object->expedited);
+}
+
+/* smallest grace period a reader entered in and is still inside of,
+ * UINTMAX_MAX if none */
+static uintmax_t oldest(const struct octopus_rcu *const object) {
+    assert(object);
+    uintmax_t result = UINTMAX_MAX;
+    for (struct octopus_rcu_reader *reader = atomic_load_explicit(
+            &object->readers, memory_order_acquire);
+         reader;
+         reader = reader->next) {
+        const uintmax_t state = atomic_load_explicit(&reader->state,
+                                                     memory_order_acquire);
+        if (state && state < result) {
+            result = state;
+        }
+    }
+    return result;
+}
+
+/* begin a new grace period and return it, a reader which enters in it is
+ * therefore sure to see whatever was published before */
+static uintmax_t begin(struct octopus_rcu *const object) {
+    assert(object);
+    const uintmax_t grace = 1 + atomic_fetch_add_explicit(
+            &object->grace, 1, memory_order_release);
+    writer_fence(object);
+    return grace;
+}
+
+static void wait_for(const struct octopus_rcu *const object,
+                     const uintmax_t grace) {
+    assert(object);
+    while (oldest(object) < grace) {
+        sched_yield();
+    }
+}
+
+/* must hold the lock, detach the deferred releases from before grace */
+static struct octopus_rcu_head *detach(struct octopus_rcu *const object,
+                                       const uintmax_t grace) {
+    assert(object);
+    struct octopus_rcu_head *const result = object->first;
+    struct octopus_rcu_head *last = NULL;
+    for (struct octopus_rcu_head *head = object->first;
+         head && head->grace <= grace;
+         head = head->next) {
+        last = head;
+    }
+    if (!last) {
+        return NULL;
+    }
+    object->first = last->next;
+    if (!object->first) {
+        object->last = NULL;
+    }
+    last->next = NULL;
+    return result;
+}
+
+static void release(struct octopus_rcu_head *head) {
+    while (head) {
+        struct octopus_rcu_head *const next = head->next;
+        head->func(head);
+        head = next;
+    }
+}
+
+bool octopus_rcu_init(struct octopus_rcu *const object, void *const pointer) {
+    if (!object) {
+        octopus_error = OCTOPUS_RCU_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    *object = (struct octopus_rcu) {0};
+    int error;
+    if ((error = pthread_mutex_init(&object->lock, NULL))) {
+        seagrass_required_true(ENOMEM == error);
+        octopus_error = OCTOPUS_RCU_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    atomic_init(&object->pointer, pointer);
+    atomic_init(&object->grace, 1);
+    atomic_init(&object->readers, NULL);
+    object->expedited = octopus_membarrier_register();
+    return true;
+}
+
+bool octopus_rcu_invalidate(struct octopus_rcu *const object,
+                            void (*const on_destroy)(void *)) {
+    if (!object) {
+        octopus_error = OCTOPUS_RCU_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (atomic_load(&object->grace)) {
+        struct octopus_rcu_reader *reader = atomic_load(&object->readers);
+        while (reader) {
+            assert(!reader->depth);
+            struct octopus_rcu_reader *const next = reader->next;
+            free(reader);
+            reader = next;
+        }
+        release(object->first);
+        void *const pointer = atomic_load(&object->pointer);
+        if (on_destroy && pointer) {
+            on_destroy(pointer);
+        }
+        seagrass_required_true(!pthread_mutex_destroy(&object->lock));
+    }
+    *object = (struct octopus_rcu) {0};
+    return true;
+}
+
+static bool adopt(struct octopus_rcu_reader *const reader) {
+    assert(reader);
+    bool expected = false;
+    return !atomic_load_explicit(&reader->used, memory_order_relaxed)
+           && atomic_compare_exchange_strong(&reader->used, &expected, true);
+}
+
+bool octopus_rcu_register(struct octopus_rcu *const object,
+                          struct octopus_rcu_reader **const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_RCU_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_RCU_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    struct octopus_rcu_reader *reader = atomic_load(&object->readers);
+    for (; reader && !adopt(reader); reader = reader->next);
+    if (!reader) {
+        if (posix_memalign((void **) &reader, OCTOPUS_CACHE_LINE_SIZE,
+                           sizeof(*reader))) {
+            octopus_error = OCTOPUS_RCU_ERROR_MEMORY_ALLOCATION_FAILED;
+            return false;
+        }
+        *reader = (struct octopus_rcu_reader) {
+                .rcu = object
+        };
+        atomic_init(&reader->state, 0);
+        atomic_init(&reader->used, true);
+        struct octopus_rcu_reader *head = atomic_load(&object->readers);
+        do {
+            reader->next = head;
+        } while (!atomic_compare_exchange_weak(&object->readers, &head,
+                                               reader));
+    }
+    *out = reader;
+    return true;
+}
+
+bool octopus_rcu_unregister(struct octopus_rcu *const object,
+                            struct octopus_rcu_reader *const reader) {
+    if (!object) {
+        octopus_error = OCTOPUS_RCU_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!reader) {
+        octopus_error = OCTOPUS_RCU_ERROR_READER_IS_NULL;
+        return false;
+    }
+    if (reader->depth) {
+        octopus_error = OCTOPUS_RCU_ERROR_READER_IS_ACTIVE;
+        return false;
+    }
+    /* kept on the list for the next thread to register */
+    atomic_store_explicit(&reader->used, false, memory_order_release);
+    return true;
+}
+
+bool octopus_rcu_read_lock(struct octopus_rcu_reader *const reader) {
+    if (!reader) {
+        octopus_error = OCTOPUS_RCU_ERROR_READER_IS_NULL;
+        return false;
+    }
+    if (reader->depth++) {
+        return true;
+    }
+    const struct octopus_rcu *const object = reader->rcu;
+    atomic_store_explicit(&reader->state,
+                          atomic_load_explicit(&object->grace,
+                                               memory_order_acquire),
+                          memory_order_relaxed);
+    /* pairs with writer_fence() so that either the writer sees us inside or
+     * we see what it published */
+    octopus_membarrier_light(object->expedited);
+    return true;
+}
+
+bool octopus_rcu_read_unlock(struct octopus_rcu_reader *const reader) {
+    if (!reader) {
+        octopus_error = OCTOPUS_RCU_ERROR_READER_IS_NULL;
+        return false;
+    }
+    if (!reader->depth) {
+        octopus_error = OCTOPUS_RCU_ERROR_READER_IS_NOT_ACTIVE;
+        return false;
+    }
+    if (!--reader->depth) {
+        /* our reads of the version are done before a writer sees us leave */
+        atomic_store_explicit(&reader->state, 0, memory_order_release);
+    }
+    return true;
+}
+
+bool octopus_rcu_dereference(struct octopus_rcu_reader *const reader,
+                             void **const out) {
+    if (!reader) {
+        octopus_error = OCTOPUS_RCU_ERROR_READER_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_RCU_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    if (!reader->depth) {
+        octopus_error = OCTOPUS_RCU_ERROR_READER_IS_NOT_ACTIVE;
+        return false;
+    }
+    *out = atomic_load_explicit(&reader->rcu->pointer, memory_order_acquire);
+    return true;
+}
+
+bool octopus_rcu_publish(struct octopus_rcu *const object,
+                         void *const pointer,
+                         void **const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_RCU_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_RCU_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    *out = atomic_exchange_explicit(&object->pointer, pointer,
+                                    memory_order_acq_rel);
+    return true;
+}
+
+bool octopus_rcu_synchronize(struct octopus_rcu *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_RCU_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    wait_for(object, begin(object));
+    return true;
+}
+
+bool octopus_rcu_defer(struct octopus_rcu *const object,
+                       struct octopus_rcu_head *const head,
+                       void (*const func)(struct octopus_rcu_head *)) {
+    if (!object) {
+        octopus_error = OCTOPUS_RCU_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!head) {
+        octopus_error = OCTOPUS_RCU_ERROR_HEAD_IS_NULL;
+        return false;
+    }
+    if (!func) {
+        octopus_error = OCTOPUS_RCU_ERROR_FUNC_IS_NULL;
+        return false;
+    }
+    head->func = func;
+    head->next = NULL;
+    seagrass_required_true(!pthread_mutex_lock(&object->lock));
+    /* taken under the lock so that the list stays in grace period order */
+    head->grace = begin(object);
+    if (object->last) {
+        object->last->next = head;
+    } else {
+        object->first = head;
+    }
+    object->last = head;
+    /* a release is due once every reader still inside entered after it */
+    struct octopus_rcu_head *const due = detach(object, oldest(object));
+    seagrass_required_true(!pthread_mutex_unlock(&object->lock));
+    release(due);
+    return true;
+}
+
+bool octopus_rcu_barrier(struct octopus_rcu *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_RCU_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    const uintmax_t grace = begin(object);
+    wait_for(object, grace);
+    seagrass_required_true(!pthread_mutex_lock(&object->lock));
+    struct octopus_rcu_head *const due = detach(object, grace);
+    seagrass_required_true(!pthread_mutex_unlock(&object->lock));
+    release(due);
+    return true;
+}
@@ -0,0 +1,217 @@
+#include <stdlib.h>
+#include <assert.h>
+#include <errno.h>
+#include <seagrass.h>
+#include <octopus.h>
+
+#include "private/rwlock.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+/* times a reader checks for the writer to be done before it blocks */
+#define SPINS 64
+
+/*
+ * A reader counts itself in its slot and then checks for a writer, while a
+ * writer announces itself and then checks the slots. Both sides use
+ * sequentially consistent operations so that either the writer sees the
+ * reader counted or the reader sees the writer, in which case it takes
+ * itself out of the count again and waits. A reader which leaves while a
+ * writer is about wakes the writer up, so the writer only ever waits for
+ * readers that are still inside.
+ */
+
+static atomic_uintmax_t threads;
+static _Thread_local uintmax_t thread;
+
+/* each thread keeps to the same slot so that it counts itself out of the
+ * slot it counted itself into */
+static struct octopus_rwlock_slot *slot_of(
+        struct octopus_rwlock *const object) {
+    assert(object);
+    if (!thread) {
+        thread = 1 + atomic_fetch_add_explicit(&threads, 1,
+                                               memory_order_relaxed);
+    }
+    return &object->slots[(thread - 1) & object->mask];
+}
+
+bool octopus_rwlock_init(struct octopus_rwlock *const object,
+                         const uintmax_t concurrency) {
+    if (!object) {
+        octopus_error = OCTOPUS_RWLOCK_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!concurrency) {
+        octopus_error = OCTOPUS_RWLOCK_ERROR_CONCURRENCY_IS_ZERO;
+        return false;
+    }
+    *object = (struct octopus_rwlock) {0};
+    uintmax_t count;
+    if (!octopus_concurrent_queue_shards(concurrency, &count)
+        || count > SIZE_MAX / sizeof(struct octopus_rwlock_slot)
+        || posix_memalign((void **) &object->slots, OCTOPUS_CACHE_LINE_SIZE,
+                          count * sizeof(struct octopus_rwlock_slot))) {
+        *object = (struct octopus_rwlock) {0};
+        octopus_error = OCTOPUS_RWLOCK_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    object->mask = count - 1;
+    for (uintmax_t i = 0; i < count; i++) {
+        atomic_init(&object->slots[i].readers, 0);
+    }
+    atomic_init(&object->writer, false);
+    int error;
+    if ((error = pthread_mutex_init(&object->lock, NULL))) {
+        seagrass_required_true(ENOMEM == error);
+        goto fail_lock;
+    }
+    if ((error = pthread_cond_init(&object->readable, NULL))) {
+        seagrass_required_true(ENOMEM == error || EAGAIN == error);
+        goto fail_readable;
+    }
+    if ((error = pthread_cond_init(&object->writable, NULL))) {
+        seagrass_required_true(ENOMEM == error || EAGAIN == error);
+        goto fail_writable;
+    }
+    return true;
+fail_writable:
+    seagrass_required_true(!pthread_cond_destroy(&object->readable));
+fail_readable:
+    seagrass_required_true(!pthread_mutex_destroy(&object->lock));
+fail_lock:
+    free(object->slots);
+    *object = (struct octopus_rwlock) {0};
+    octopus_error = OCTOPUS_RWLOCK_ERROR_MEMORY_ALLOCATION_FAILED;
+    return false;
+}
+
+bool octopus_rwlock_invalidate(struct octopus_rwlock *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_RWLOCK_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (object->slots) {
+        seagrass_required_true(!pthread_cond_destroy(&object->writable));
+        seagrass_required_true(!pthread_cond_destroy(&object->readable));
+        seagrass_required_true(!pthread_mutex_destroy(&object->lock));
+        free(object->slots);
+    }
+    *object = (struct octopus_rwlock) {0};
+    return true;
+}
+
+/* the reader has just been counted out of its slot */
+static void left(struct octopus_rwlock *const object) {
+    assert(object);
+    if (!atomic_load_explicit(&object->writer, memory_order_seq_cst)) {
+        return;
+    }
+    seagrass_required_true(!pthread_mutex_lock(&object->lock));
+    seagrass_required_true(!pthread_cond_broadcast(&object->writable));
+    seagrass_required_true(!pthread_mutex_unlock(&object->lock));
+}
+
+bool octopus_rwlock_read_lock(struct octopus_rwlock *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_RWLOCK_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    struct octopus_rwlock_slot *const slot = slot_of(object);
+    for (;;) {
+        atomic_fetch_add_explicit(&slot->readers, 1, memory_order_seq_cst);
+        if (!atomic_load_explicit(&object->writer, memory_order_seq_cst)) {
+            return true;
+        }
+        /* make way for the writer */
+        atomic_fetch_sub_explicit(&slot->readers, 1, memory_order_seq_cst);
+        left(object);
+        for (uintmax_t i = 0; i < SPINS && atomic_load_explicit(
+                &object->writer, memory_order_relaxed); i++);
+        seagrass_required_true(!pthread_mutex_lock(&object->lock));
+        while (atomic_load_explicit(&object->writer, memory_order_relaxed)) {
+            seagrass_required_true(!pthread_cond_wait(&object->readable,
+                                                      &object->lock));
+        }
+        seagrass_required_true(!pthread_mutex_unlock(&object->lock));
+    }
+}
+
+bool octopus_rwlock_read_unlock(struct octopus_rwlock *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_RWLOCK_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    struct octopus_rwlock_slot *const slot = slot_of(object);
+    uintmax_t readers = atomic_load_explicit(&slot->readers,
+                                             memory_order_relaxed);
+    do {
+        if (!readers) {
+            octopus_error = OCTOPUS_RWLOCK_ERROR_LOCK_IS_NOT_HELD;
+            return false;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(
+            &slot->readers, &readers, readers - 1,
+            memory_order_seq_cst, memory_order_relaxed));
+    left(object);
+    return true;
+}
+
+/* must hold the lock */
+static bool is_read(const struct octopus_rwlock *const object) {
+    assert(object);
+    for (uintmax_t i = 0; i <= object->mask; i++) {
+        if (atomic_load_explicit(&object->slots[i].readers,
+                                 memory_order_seq_cst)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool octopus_rwlock_write_lock(struct octopus_rwlock *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_RWLOCK_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    seagrass_required_true(!pthread_mutex_lock(&object->lock));
+    object->waiting++;
+    while (object->held) {
+        seagrass_required_true(!pthread_cond_wait(&object->writable,
+                                                  &object->lock));
+    }
+    object->waiting--;
+    object->held = true;
+    atomic_store_explicit(&object->writer, true, memory_order_seq_cst);
+    while (is_read(object)) {
+        seagrass_required_true(!pthread_cond_wait(&object->writable,
+                                                  &object->lock));
+    }
+    seagrass_required_true(!pthread_mutex_unlock(&object->lock));
+    return true;
+}
+
+bool octopus_rwlock_write_unlock(struct octopus_rwlock *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_RWLOCK_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    seagrass_required_true(!pthread_mutex_lock(&object->lock));
+    if (!object->held) {
+        seagrass_required_true(!pthread_mutex_unlock(&object->lock));
+        octopus_error = OCTOPUS_RWLOCK_ERROR_LOCK_IS_NOT_HELD;
+        return false;
+    }
+    object->held = false;
+    if (object->waiting) {
+        /* readers stay out until the waiting writers are done */
+        seagrass_required_true(!pthread_cond_broadcast(&object->writable));
+    } else {
+        atomic_store_explicit(&object->writer, false, memory_order_seq_cst);
+        seagrass_required_true(!pthread_cond_broadcast(&object->readable));
+    }
+    seagrass_required_true(!pthread_mutex_unlock(&object->lock));
+    return true;
+}
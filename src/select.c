@@ -0,0 +1,244 @@
+#include <stdlib.h>
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <seagrass.h>
+#include <octopus.h>
+
+#include "private/deadline.h"
+#include "private/linked_queue.h"
+#include "private/membarrier.h"
+#include "private/select.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+atomic_bool octopus_select_expedited;
+
+bool octopus_select_init(struct octopus_select *const object,
+                         struct octopus_concurrent_linked_queue *const *queues,
+                         const uintmax_t count,
+                         const bool priority) {
+    if (!object) {
+        octopus_error = OCTOPUS_SELECT_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!queues) {
+        octopus_error = OCTOPUS_SELECT_ERROR_QUEUES_IS_NULL;
+        return false;
+    }
+    if (!count) {
+        octopus_error = OCTOPUS_SELECT_ERROR_COUNT_IS_ZERO;
+        return false;
+    }
+    *object = (struct octopus_select) {0};
+    if (count > SIZE_MAX / sizeof(struct octopus_select_entry)
+        || !(object->queues = malloc(count * sizeof(*object->queues)))) {
+        octopus_error = OCTOPUS_SELECT_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    if (!(object->entries = calloc(count, sizeof(*object->entries)))) {
+        free(object->queues);
+        octopus_error = OCTOPUS_SELECT_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    int error;
+    if ((error = pthread_mutex_init(&object->lock, NULL))) {
+        seagrass_required_true(ENOMEM == error);
+        free(object->entries);
+        free(object->queues);
+        octopus_error = OCTOPUS_SELECT_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    if ((error = octopus_deadline_condition_init(&object->condition))) {
+        seagrass_required_true(ENOMEM == error || EAGAIN == error);
+        seagrass_required_true(!pthread_mutex_destroy(&object->lock));
+        free(object->entries);
+        free(object->queues);
+        octopus_error = OCTOPUS_SELECT_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    if (!atomic_load_explicit(&octopus_select_expedited, memory_order_relaxed)
+        && octopus_membarrier_register()) {
+        atomic_store_explicit(&octopus_select_expedited, true,
+                              memory_order_relaxed);
+    }
+    memcpy(object->queues, queues, count * sizeof(*object->queues));
+    for (uintmax_t i = 0; i < count; i++) {
+        object->entries[i].select = object;
+    }
+    object->count = count;
+    object->priority = priority;
+    return true;
+}
+
+bool octopus_select_invalidate(struct octopus_select *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_SELECT_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (object->queues) {
+        seagrass_required_true(!pthread_cond_destroy(&object->condition));
+        seagrass_required_true(!pthread_mutex_destroy(&object->lock));
+    }
+    free(object->entries);
+    free(object->queues);
+    *object = (struct octopus_select) {0};
+    return true;
+}
+
+static bool retrieve(struct octopus_select *const object,
+                     uintmax_t *const at,
+                     void **const out) {
+    assert(object);
+    assert(at);
+    assert(out);
+    for (uintmax_t i = 0; i < object->count; i++) {
+        const uintmax_t index = object->priority
+                                ? i
+                                : (object->next + i) % object->count;
+        if (octopus_concurrent_linked_queue_remove(object->queues[index],
+                                                   out)) {
+            if (!object->priority) {
+                object->next = (index + 1) % object->count;
+            }
+            *at = index;
+            return true;
+        }
+        seagrass_required_true(
+                OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY
+                == octopus_error);
+    }
+    return false;
+}
+
+static bool is_empty(const struct octopus_select *const object) {
+    assert(object);
+    for (uintmax_t i = 0; i < object->count; i++) {
+        struct octopus_concurrent_linked_queue *const queue
+                = object->queues[i];
+        for (uintmax_t j = 0; j <= queue->mask; j++) {
+            bool empty;
+            seagrass_required_true(octopus_linked_queue_is_empty(
+                    &queue->queues[j], &empty));
+            if (!empty) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void attach(struct octopus_select *const object) {
+    assert(object);
+    for (uintmax_t i = 0; i < object->count; i++) {
+        struct octopus_concurrent_linked_queue *const queue
+                = object->queues[i];
+        struct octopus_select_entry *const entry = &object->entries[i];
+        seagrass_required_true(!pthread_mutex_lock(&queue->lock));
+        entry->prev = NULL;
+        entry->next = queue->waiting;
+        if (queue->waiting) {
+            queue->waiting->prev = entry;
+        }
+        queue->waiting = entry;
+        atomic_fetch_add_explicit(&queue->waiters, 1, memory_order_relaxed);
+        seagrass_required_true(!pthread_mutex_unlock(&queue->lock));
+    }
+}
+
+static void detach(struct octopus_select *const object) {
+    assert(object);
+    for (uintmax_t i = 0; i < object->count; i++) {
+        struct octopus_concurrent_linked_queue *const queue
+                = object->queues[i];
+        struct octopus_select_entry *const entry = &object->entries[i];
+        seagrass_required_true(!pthread_mutex_lock(&queue->lock));
+        if (entry->prev) {
+            entry->prev->next = entry->next;
+        } else {
+            queue->waiting = entry->next;
+        }
+        if (entry->next) {
+            entry->next->prev = entry->prev;
+        }
+        entry->prev = entry->next = NULL;
+        atomic_fetch_sub_explicit(&queue->waiters, 1, memory_order_relaxed);
+        seagrass_required_true(!pthread_mutex_unlock(&queue->lock));
+    }
+}
+
+bool octopus_select_remove(struct octopus_select *const object,
+                           const struct timespec *const timeout,
+                           uintmax_t *const at,
+                           void **const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_SELECT_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!at) {
+        octopus_error = OCTOPUS_SELECT_ERROR_AT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_SELECT_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    if (timeout && !octopus_deadline_is_valid(timeout)) {
+        octopus_error = OCTOPUS_SELECT_ERROR_TIMEOUT_IS_INVALID;
+        return false;
+    }
+    struct timespec deadline;
+    if (timeout) {
+        octopus_deadline_of(timeout, &deadline);
+    }
+    bool timed_out = false;
+    while (!retrieve(object, at, out)) {
+        if (timed_out) {
+            octopus_error = OCTOPUS_SELECT_ERROR_TIMED_OUT;
+            return false;
+        }
+        seagrass_required_true(!pthread_mutex_lock(&object->lock));
+        object->signalled = false;
+        seagrass_required_true(!pthread_mutex_unlock(&object->lock));
+        attach(object);
+        /* pairs with the fence in octopus_concurrent_linked_queue_add so
+         * that either the producer sees us waiting or we see its item, our
+         * own init registered for membarriers if the kernel supports them */
+        octopus_membarrier_heavy(atomic_load_explicit(
+                &octopus_select_expedited, memory_order_relaxed));
+        if (is_empty(object)) {
+            seagrass_required_true(!pthread_mutex_lock(&object->lock));
+            while (!object->signalled && !timed_out) {
+                if (!timeout) {
+                    seagrass_required_true(!pthread_cond_wait(
+                            &object->condition, &object->lock));
+                    continue;
+                }
+                const int error = pthread_cond_timedwait(
+                        &object->condition, &object->lock, &deadline);
+                seagrass_required_true(!error || ETIMEDOUT == error);
+                timed_out = ETIMEDOUT == error;
+            }
+            seagrass_required_true(!pthread_mutex_unlock(&object->lock));
+        }
+        detach(object);
+    }
+    return true;
+}
+
+void octopus_select_wake(struct octopus_concurrent_linked_queue *const object) {
+    assert(object);
+    seagrass_required_true(!pthread_mutex_lock(&object->lock));
+    for (struct octopus_select_entry *entry = object->waiting;
+         entry;
+         entry = entry->next) {
+        struct octopus_select *const select = entry->select;
+        seagrass_required_true(!pthread_mutex_lock(&select->lock));
+        select->signalled = true;
+        seagrass_required_true(!pthread_cond_signal(&select->condition));
+        seagrass_required_true(!pthread_mutex_unlock(&select->lock));
+    }
+    seagrass_required_true(!pthread_mutex_unlock(&object->lock));
+}
@@ -0,0 +1,155 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <sched.h>
+#include <seagrass.h>
+#include <octopus.h>
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+/* attempts a reader makes before it starts yielding */
+#define SPINS 64
+
+#define WORD sizeof(atomic_uintmax_t)
+
+/*
+ * The value is kept in words which are only ever accessed atomically, so
+ * that a reader copying it while it is being written is not a data race,
+ * and the relaxed loads and stores cost no more than plain ones. What makes
+ * a copy consistent is the sequence. The writer's release fence after making
+ * it odd pairs with the reader's acquire fence before looking at it again,
+ * so a reader which saw any word of a new value sees at least the odd
+ * sequence and retries.
+ */
+
+static uintmax_t words_of(const struct octopus_seqlock *const object) {
+    assert(object);
+    return (object->size + WORD - 1) / WORD;
+}
+
+bool octopus_seqlock_init(struct octopus_seqlock *const object,
+                          const size_t size) {
+    if (!object) {
+        octopus_error = OCTOPUS_SEQLOCK_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!size) {
+        octopus_error = OCTOPUS_SEQLOCK_ERROR_SIZE_IS_ZERO;
+        return false;
+    }
+    if (size > SIZE_MAX - (WORD - 1)) {
+        octopus_error = OCTOPUS_SEQLOCK_ERROR_SIZE_IS_TOO_LARGE;
+        return false;
+    }
+    *object = (struct octopus_seqlock) {
+            .size = size
+    };
+    const uintmax_t count = words_of(object);
+    if (posix_memalign((void **) &object->words, OCTOPUS_CACHE_LINE_SIZE,
+                       count * WORD)) {
+        *object = (struct octopus_seqlock) {0};
+        octopus_error = OCTOPUS_SEQLOCK_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    for (uintmax_t i = 0; i < count; i++) {
+        atomic_init(&object->words[i], 0);
+    }
+    atomic_init(&object->sequence, 0);
+    return true;
+}
+
+bool octopus_seqlock_invalidate(struct octopus_seqlock *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_SEQLOCK_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    free(object->words);
+    *object = (struct octopus_seqlock) {0};
+    return true;
+}
+
+bool octopus_seqlock_size(const struct octopus_seqlock *const object,
+                          size_t *const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_SEQLOCK_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_SEQLOCK_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    *out = object->size;
+    return true;
+}
+
+bool octopus_seqlock_write(struct octopus_seqlock *const object,
+                           const void *const value) {
+    if (!object) {
+        octopus_error = OCTOPUS_SEQLOCK_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!value) {
+        octopus_error = OCTOPUS_SEQLOCK_ERROR_VALUE_IS_NULL;
+        return false;
+    }
+    /* we are the only writer so nobody else changes the sequence */
+    const uintmax_t sequence = atomic_load_explicit(&object->sequence,
+                                                    memory_order_relaxed);
+    assert(!(sequence & 1));
+    atomic_store_explicit(&object->sequence, sequence + 1,
+                          memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    const unsigned char *const bytes = value;
+    const uintmax_t count = words_of(object);
+    for (uintmax_t i = 0; i < count; i++) {
+        const size_t offset = i * WORD;
+        const size_t length = object->size - offset < WORD
+                              ? object->size - offset
+                              : WORD;
+        uintmax_t word = 0;
+        memcpy(&word, bytes + offset, length);
+        atomic_store_explicit(&object->words[i], word, memory_order_relaxed);
+    }
+    atomic_store_explicit(&object->sequence, sequence + 2,
+                          memory_order_release);
+    return true;
+}
+
+bool octopus_seqlock_read(const struct octopus_seqlock *const object,
+                          void *const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_SEQLOCK_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_SEQLOCK_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    unsigned char *const bytes = out;
+    const uintmax_t count = words_of(object);
+    for (uintmax_t attempt = 0;; attempt++) {
+        const uintmax_t sequence = atomic_load_explicit(
+                &object->sequence, memory_order_acquire);
+        if (!(sequence & 1)) {
+            for (uintmax_t i = 0; i < count; i++) {
+                const size_t offset = i * WORD;
+                const size_t length = object->size - offset < WORD
+                                      ? object->size - offset
+                                      : WORD;
+                const uintmax_t word = atomic_load_explicit(
+                        &object->words[i], memory_order_relaxed);
+                memcpy(bytes + offset, &word, length);
+            }
+            atomic_thread_fence(memory_order_acquire);
+            if (sequence == atomic_load_explicit(&object->sequence,
+                                                 memory_order_relaxed)) {
+                return true;
+            }
+        }
+        if (attempt >= SPINS) {
+            sched_yield();
+        }
+    }
+}
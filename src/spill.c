@@ -0,0 +1,204 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <seagrass.h>
+#include <octopus.h>
+
+#include "private/spill.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+#define TEMPLATE                                "/octopus-spill-XXXXXX"
+
+bool octopus_spill_init(struct octopus_spill *const object,
+                        const char *const directory,
+                        const size_t size,
+                        const uintmax_t segment) {
+    if (!object) {
+        octopus_error = OCTOPUS_SPILL_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!directory) {
+        octopus_error = OCTOPUS_SPILL_ERROR_DIRECTORY_IS_NULL;
+        return false;
+    }
+    if (!size) {
+        octopus_error = OCTOPUS_SPILL_ERROR_SIZE_IS_ZERO;
+        return false;
+    }
+    const uintmax_t items = segment > size ? segment / size : 1;
+    uintmax_t bytes;
+    if (!seagrass_uintmax_t_multiply(items, size, &bytes)
+        || bytes > (SIZE_MAX >> 1)) {
+        octopus_error = OCTOPUS_SPILL_ERROR_SIZE_IS_TOO_LARGE;
+        return false;
+    }
+    if (access(directory, W_OK | X_OK)) {
+        octopus_error = OCTOPUS_SPILL_ERROR_FILE_FAILED;
+        return false;
+    }
+    const size_t length = strlen(directory);
+    *object = (struct octopus_spill) {
+            .size = size,
+            .items = items
+    };
+    if (!(object->directory = malloc(length + sizeof(TEMPLATE)))) {
+        *object = (struct octopus_spill) {0};
+        octopus_error = OCTOPUS_SPILL_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    memcpy(object->directory, directory, 1 + length);
+    return true;
+}
+
+static void release(struct octopus_spill_segment *const segment,
+                    const uintmax_t bytes) {
+    assert(segment);
+    seagrass_required_true(!munmap(segment->map, bytes));
+    seagrass_required_true(!close(segment->fd));
+    free(segment);
+}
+
+bool octopus_spill_invalidate(struct octopus_spill *const object,
+                              void (*const on_destroy)(void *)) {
+    if (!object) {
+        octopus_error = OCTOPUS_SPILL_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    const uintmax_t bytes = object->items * object->size;
+    struct octopus_spill_segment *segment = object->head;
+    while (segment) {
+        struct octopus_spill_segment *const next = segment->next;
+        for (uintmax_t i = segment->read; on_destroy && i < segment->write;
+             i++) {
+            on_destroy(segment->map + i * object->size);
+        }
+        release(segment, bytes);
+        segment = next;
+    }
+    free(object->directory);
+    *object = (struct octopus_spill) {0};
+    return true;
+}
+
+static struct octopus_spill_segment *segment_of(
+        struct octopus_spill *const object) {
+    assert(object);
+    struct octopus_spill_segment *const segment = malloc(sizeof(*segment));
+    if (!segment) {
+        octopus_error = OCTOPUS_SPILL_ERROR_MEMORY_ALLOCATION_FAILED;
+        return NULL;
+    }
+    const size_t length = strlen(object->directory);
+    char path[length + sizeof(TEMPLATE)];
+    memcpy(path, object->directory, length);
+    memcpy(path + length, TEMPLATE, sizeof(TEMPLATE));
+    const uintmax_t bytes = object->items * object->size;
+    *segment = (struct octopus_spill_segment) {
+            .fd = mkstemp(path)
+    };
+    if (segment->fd < 0) {
+        free(segment);
+        octopus_error = OCTOPUS_SPILL_ERROR_FILE_FAILED;
+        return NULL;
+    }
+    /* the file only lives on for as long as it is open and mapped */
+    seagrass_required_true(!unlink(path));
+    /* reserve the blocks up front so that a full disk is reported here
+     * rather than by a SIGBUS when the mapping is written to */
+    if (posix_fallocate(segment->fd, 0, (off_t) bytes)
+        || MAP_FAILED == (segment->map = mmap(
+            NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, segment->fd,
+            0))) {
+        seagrass_required_true(!close(segment->fd));
+        free(segment);
+        octopus_error = OCTOPUS_SPILL_ERROR_FILE_FAILED;
+        return NULL;
+    }
+    (void) madvise(segment->map, bytes, MADV_SEQUENTIAL);
+    return segment;
+}
+
+bool octopus_spill_add(struct octopus_spill *const object,
+                       const void *const item) {
+    if (!object) {
+        octopus_error = OCTOPUS_SPILL_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!item) {
+        octopus_error = OCTOPUS_SPILL_ERROR_ITEM_IS_NULL;
+        return false;
+    }
+    struct octopus_spill_segment *segment = object->tail;
+    if (!segment || object->items == segment->write) {
+        if (!(segment = segment_of(object))) {
+            return false;
+        }
+        if (object->tail) {
+            object->tail->next = segment;
+        } else {
+            object->head = segment;
+        }
+        object->tail = segment;
+    }
+    memcpy(segment->map + segment->write * object->size, item,
+           object->size);
+    segment->write++;
+    atomic_store_explicit(&object->count,
+                          1 + atomic_load_explicit(&object->count,
+                                                   memory_order_relaxed),
+                          memory_order_release);
+    return true;
+}
+
+static bool retrieve(const struct octopus_spill *const object,
+                     void **const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_SPILL_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_SPILL_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    const struct octopus_spill_segment *const segment = object->head;
+    if (!segment || segment->read == segment->write) {
+        octopus_error = OCTOPUS_SPILL_ERROR_SPILL_IS_EMPTY;
+        return false;
+    }
+    memcpy(out, segment->map + segment->read * object->size, object->size);
+    return true;
+}
+
+bool octopus_spill_remove(struct octopus_spill *const object,
+                          void **const out) {
+    if (!retrieve(object, out)) {
+        return false;
+    }
+    struct octopus_spill_segment *const segment = object->head;
+    segment->read++;
+    atomic_store_explicit(&object->count,
+                          atomic_load_explicit(&object->count,
+                                               memory_order_relaxed) - 1,
+                          memory_order_release);
+    if (object->items == segment->read) {
+        /* drained, nothing more will be written to it either */
+        object->head = segment->next;
+        if (object->tail == segment) {
+            object->tail = NULL;
+        }
+        release(segment, object->items * object->size);
+    }
+    return true;
+}
+
+bool octopus_spill_peek(const struct octopus_spill *const object,
+                        void **const out) {
+    return retrieve(object, out);
+}
@@ -0,0 +1,158 @@
+#include <stdlib.h>
+#include <assert.h>
+#include <seagrass.h>
+#include <octopus.h>
+
+#include "private/striped_counter.h"
+
+#ifdef TEST
+#include <test/cmocka.h>
+#endif
+
+/* odd constant from the golden ratio, spreads consecutive seeds apart */
+#define GOLDEN_RATIO                    UINTMAX_C(0x9e3779b97f4a7c15)
+
+static atomic_uintmax_t seed;
+static _Thread_local uintmax_t probe;
+static _Thread_local bool collided;
+
+static uintmax_t probe_of(void) {
+    if (!probe) {
+        probe = GOLDEN_RATIO + atomic_fetch_add_explicit(
+                &seed, GOLDEN_RATIO, memory_order_relaxed);
+        probe |= 1; /* xorshift never leaves zero */
+    }
+    return probe;
+}
+
+/* move the calling thread on to another cell */
+static void rehash(void) {
+    assert(probe);
+    probe ^= probe << 13;
+    probe ^= probe >> 7;
+    probe ^= probe << 17;
+}
+
+bool octopus_striped_counter_init(struct octopus_striped_counter *const object,
+                                  const uintmax_t concurrency) {
+    if (!object) {
+        octopus_error = OCTOPUS_STRIPED_COUNTER_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!concurrency) {
+        octopus_error = OCTOPUS_STRIPED_COUNTER_ERROR_CONCURRENCY_IS_ZERO;
+        return false;
+    }
+    *object = (struct octopus_striped_counter) {0};
+    uintmax_t limit;
+    /* every cell is allocated up front so that adding never allocates */
+    if (!octopus_concurrent_queue_shards(concurrency, &limit)
+        || limit > SIZE_MAX / sizeof(struct octopus_striped_counter_cell)
+        || posix_memalign(
+            (void **) &object->cells, OCTOPUS_CACHE_LINE_SIZE,
+            limit * sizeof(struct octopus_striped_counter_cell))) {
+        *object = (struct octopus_striped_counter) {0};
+        octopus_error =
+                OCTOPUS_STRIPED_COUNTER_ERROR_MEMORY_ALLOCATION_FAILED;
+        return false;
+    }
+    for (uintmax_t i = 0; i < limit; i++) {
+        atomic_init(&object->cells[i].value, 0);
+    }
+    object->limit = limit;
+    atomic_init(&object->count, 0);
+    atomic_init(&object->base, 0);
+    return true;
+}
+
+bool octopus_striped_counter_invalidate(
+        struct octopus_striped_counter *const object) {
+    if (!object) {
+        octopus_error = OCTOPUS_STRIPED_COUNTER_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    free(object->cells);
+    *object = (struct octopus_striped_counter) {0};
+    return true;
+}
+
+bool octopus_striped_counter_grow(struct octopus_striped_counter *const object,
+                                  uintmax_t count) {
+    assert(object);
+    const uintmax_t next = count ? count << 1 : 2;
+    if (next > object->limit) {
+        return false;
+    }
+    /* pairs with the acquire in add() and sum(), failing means that another
+     * thread has already grown the counter since count cells were seen */
+    return atomic_compare_exchange_strong_explicit(
+            &object->count, &count, next,
+            memory_order_release, memory_order_relaxed);
+}
+
+bool octopus_striped_counter_add(struct octopus_striped_counter *const object,
+                                 const uintmax_t delta) {
+    if (!object) {
+        octopus_error = OCTOPUS_STRIPED_COUNTER_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    const uintmax_t count = atomic_load_explicit(&object->count,
+                                                 memory_order_acquire);
+    atomic_uintmax_t *const value = count
+            ? &object->cells[probe_of() & (count - 1)].value
+            : &object->base;
+    uintmax_t expected = atomic_load_explicit(value, memory_order_relaxed);
+    if (atomic_compare_exchange_strong_explicit(
+            value, &expected, expected + delta,
+            memory_order_relaxed, memory_order_relaxed)) {
+        collided = false;
+        return true;
+    }
+    /* another thread got in first, count it anyway and spread out so that
+     * the next addition is less likely to collide */
+    atomic_fetch_add_explicit(value, delta, memory_order_relaxed);
+    if (!count || collided) {
+        octopus_striped_counter_grow(object, count);
+    }
+    if (count) {
+        rehash();
+    }
+    collided = true;
+    return true;
+}
+
+bool octopus_striped_counter_sum(struct octopus_striped_counter *const object,
+                                 uintmax_t *const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_STRIPED_COUNTER_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_STRIPED_COUNTER_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    const uintmax_t count = atomic_load_explicit(&object->count,
+                                                 memory_order_acquire);
+    uintmax_t sum = atomic_load_explicit(&object->base,
+                                         memory_order_relaxed);
+    for (uintmax_t i = 0; i < count; i++) {
+        sum += atomic_load_explicit(&object->cells[i].value,
+                                    memory_order_relaxed);
+    }
+    *out = sum;
+    return true;
+}
+
+bool octopus_striped_counter_cells(struct octopus_striped_counter *const object,
+                                   uintmax_t *const out) {
+    if (!object) {
+        octopus_error = OCTOPUS_STRIPED_COUNTER_ERROR_OBJECT_IS_NULL;
+        return false;
+    }
+    if (!out) {
+        octopus_error = OCTOPUS_STRIPED_COUNTER_ERROR_OUT_IS_NULL;
+        return false;
+    }
+    *out = atomic_load_explicit(&object->count, memory_order_relaxed);
+    return true;
+}
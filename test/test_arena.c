@@ -0,0 +1,264 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <octopus.h>
+
+#include "private/arena.h"
+
+#include <test/cmocka.h>
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_arena_invalidate(NULL));
+    assert_int_equal(OCTOPUS_ARENA_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_arena_init(NULL, 1, OCTOPUS_ARENA_PAGES_DEFAULT));
+    assert_int_equal(OCTOPUS_ARENA_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_size_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_arena_init((void *) 1, 0,
+                                    OCTOPUS_ARENA_PAGES_DEFAULT));
+    assert_int_equal(OCTOPUS_ARENA_ERROR_SIZE_IS_ZERO, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_size_is_too_large(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_arena object;
+    assert_false(octopus_arena_init(&object, SIZE_MAX,
+                                    OCTOPUS_ARENA_PAGES_DEFAULT));
+    assert_int_equal(OCTOPUS_ARENA_ERROR_SIZE_IS_TOO_LARGE, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_pages_is_invalid(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_arena_init((void *) 1, 1, -1));
+    assert_int_equal(OCTOPUS_ARENA_ERROR_PAGES_IS_INVALID, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_arena object;
+    pthread_mutex_init_is_overridden = true;
+    will_return(cmocka_test_pthread_mutex_init, ENOMEM);
+    assert_false(octopus_arena_init(&object, 1, OCTOPUS_ARENA_PAGES_DEFAULT));
+    pthread_mutex_init_is_overridden = false;
+    assert_int_equal(OCTOPUS_ARENA_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_arena object;
+    assert_true(octopus_arena_init(&object, 1, OCTOPUS_ARENA_PAGES_DEFAULT));
+    const size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    assert_int_equal(object.region, page);
+    assert_non_null(object.regions);
+    assert_null(object.regions->next);
+    assert_int_equal(object.regions->size, page);
+    assert_ptr_equal(object.cursor, (unsigned char *) object.regions
+                                    + sizeof(struct octopus_arena_region));
+    assert_ptr_equal(object.end, (unsigned char *) object.regions + page);
+    uintmax_t mapped;
+    assert_true(octopus_arena_mapped(&object, &mapped));
+    assert_int_equal(mapped, page);
+    assert_true(octopus_arena_invalidate(&object));
+    assert_null(object.regions);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_huge(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_arena object;
+    /* there may not be any huge pages reserved on this machine */
+    if (!octopus_arena_init(&object, 1, OCTOPUS_ARENA_PAGES_HUGE)) {
+        assert_int_equal(OCTOPUS_ARENA_ERROR_HUGE_PAGES_ARE_UNAVAILABLE,
+                         octopus_error);
+        octopus_error = OCTOPUS_ERROR_NONE;
+        return;
+    }
+    assert_int_equal(object.region, OCTOPUS_ARENA_HUGE_PAGE_SIZE);
+    assert_true(octopus_arena_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_transparent_huge(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_arena object;
+    assert_true(octopus_arena_init(&object, 1,
+                                   OCTOPUS_ARENA_PAGES_TRANSPARENT_HUGE));
+    assert_int_equal(object.region, OCTOPUS_ARENA_HUGE_PAGE_SIZE);
+    assert_int_equal((uintptr_t) object.regions
+                     % OCTOPUS_ARENA_HUGE_PAGE_SIZE, 0);
+    assert_true(octopus_arena_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_allocator_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_arena_allocator(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_ARENA_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_allocator_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_arena_allocator((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_ARENA_ERROR_OUT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_mapped_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_arena_mapped(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_ARENA_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_mapped_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_arena_mapped((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_ARENA_ERROR_OUT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_alloc(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_arena object;
+    assert_true(octopus_arena_init(&object, 1, OCTOPUS_ARENA_PAGES_DEFAULT));
+    struct octopus_allocator allocator;
+    assert_true(octopus_arena_allocator(&object, &allocator));
+    assert_ptr_equal(allocator.context, &object);
+    /* blocks are bumped out of the region, aligned to their size class */
+    unsigned char *const a = allocator.alloc(allocator.context, 24, 8);
+    assert_non_null(a);
+    assert_int_equal((uintptr_t) a % 32, 0);
+    unsigned char *const b = allocator.alloc(allocator.context, 24, 8);
+    assert_ptr_equal(b, a + 32);
+    memset(a, 0xff, 24);
+    memset(b, 0xff, 24);
+    /* more alignment than the size class gives */
+    unsigned char *const c = allocator.alloc(
+            allocator.context, 24, OCTOPUS_CACHE_LINE_SIZE);
+    assert_int_equal((uintptr_t) c % OCTOPUS_CACHE_LINE_SIZE, 0);
+    assert_null(allocator.alloc(allocator.context, 0, 8));
+    assert_null(allocator.alloc(allocator.context, 8,
+                                2 * (size_t) sysconf(_SC_PAGESIZE)));
+    assert_true(octopus_arena_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_free(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_arena object;
+    assert_true(octopus_arena_init(&object, 1, OCTOPUS_ARENA_PAGES_DEFAULT));
+    struct octopus_allocator allocator;
+    assert_true(octopus_arena_allocator(&object, &allocator));
+    void *const a = allocator.alloc(allocator.context, 24, 8);
+    void *const b = allocator.alloc(allocator.context, 24, 8);
+    allocator.free(allocator.context, a, 24);
+    allocator.free(allocator.context, b, 24);
+    /* released blocks are reused most recent first, by any size in the
+     * same class */
+    assert_ptr_equal(allocator.alloc(allocator.context, 17, 8), b);
+    assert_ptr_equal(allocator.alloc(allocator.context, 32, 8), a);
+    assert_true(octopus_arena_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_alloc_new_region(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_arena object;
+    assert_true(octopus_arena_init(&object, 1, OCTOPUS_ARENA_PAGES_DEFAULT));
+    struct octopus_allocator allocator;
+    assert_true(octopus_arena_allocator(&object, &allocator));
+    const size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    struct octopus_arena_region *const first = object.regions;
+    /* a quarter of a page at a time fills the first region after three
+     * allocations due to the region header */
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_non_null(allocator.alloc(allocator.context, page / 4, 8));
+        assert_ptr_equal(object.regions, first);
+    }
+    assert_non_null(allocator.alloc(allocator.context, page / 4, 8));
+    assert_ptr_not_equal(object.regions, first);
+    assert_ptr_equal(object.regions->next, first);
+    uintmax_t mapped;
+    assert_true(octopus_arena_mapped(&object, &mapped));
+    assert_int_equal(mapped, 2 * page);
+    /* larger than a region */
+    unsigned char *const large = allocator.alloc(allocator.context,
+                                                 3 * page, 8);
+    assert_non_null(large);
+    memset(large, 0xff, 3 * page);
+    assert_true(octopus_arena_mapped(&object, &mapped));
+    assert_true(mapped >= 2 * page + 4 * page);
+    allocator.free(allocator.context, large, 3 * page);
+    assert_ptr_equal(allocator.alloc(allocator.context, 3 * page, 8), large);
+    assert_true(octopus_arena_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_concurrent_linked_queue(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_arena arena;
+    assert_true(octopus_arena_init(&arena, 1 << 16,
+                                   OCTOPUS_ARENA_PAGES_TRANSPARENT_HUGE));
+    struct octopus_allocator allocator;
+    assert_true(octopus_arena_allocator(&arena, &allocator));
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init_with_allocator(
+            &object, sizeof(uintmax_t), 4, 0, &allocator));
+    for (uintmax_t i = 0; i < 1000; i++) {
+        assert_true(octopus_concurrent_linked_queue_add(&object, &i));
+    }
+    uintmax_t sum = 0;
+    for (uintmax_t i = 0; i < 1000; i++) {
+        uintmax_t out;
+        assert_true(octopus_concurrent_linked_queue_remove(
+                &object, (void **) &out));
+        sum += out;
+    }
+    assert_int_equal(sum, 999 * 1000 / 2);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    assert_true(octopus_arena_invalidate(&arena));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_size_is_zero),
+            cmocka_unit_test(check_init_error_on_size_is_too_large),
+            cmocka_unit_test(check_init_error_on_pages_is_invalid),
+            cmocka_unit_test(check_init_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_init_huge),
+            cmocka_unit_test(check_init_transparent_huge),
+            cmocka_unit_test(check_allocator_error_on_object_is_null),
+            cmocka_unit_test(check_allocator_error_on_out_is_null),
+            cmocka_unit_test(check_mapped_error_on_object_is_null),
+            cmocka_unit_test(check_mapped_error_on_out_is_null),
+            cmocka_unit_test(check_alloc),
+            cmocka_unit_test(check_free),
+            cmocka_unit_test(check_alloc_new_region),
+            cmocka_unit_test(check_concurrent_linked_queue),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
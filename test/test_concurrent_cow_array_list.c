@@ -0,0 +1,560 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <errno.h>
+#include <pthread.h>
+#include <octopus.h>
+
+#include <test/cmocka.h>
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_cow_array_list_invalidate(NULL, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static uintmax_t destroyed;
+
+static void on_destroy(void *item) {
+    destroyed += *(uintmax_t *) item;
+}
+
+static void check_invalidate(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_cow_array_list object;
+    assert_true(octopus_concurrent_cow_array_list_init(
+            &object, sizeof(uintmax_t)));
+    for (uintmax_t i = 1; i <= 3; i++) {
+        assert_true(octopus_concurrent_cow_array_list_add(&object, &i));
+    }
+    destroyed = 0;
+    assert_true(octopus_concurrent_cow_array_list_invalidate(
+            &object, on_destroy));
+    assert_int_equal(destroyed, 6);
+    assert_null(object.snapshot);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_cow_array_list_init(NULL, 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_size_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_cow_array_list object;
+    assert_false(octopus_concurrent_cow_array_list_init(&object, 0));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_SIZE_IS_ZERO,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_cow_array_list object;
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_false(octopus_concurrent_cow_array_list_init(
+            &object, sizeof(uintmax_t)));
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    pthread_mutex_init_is_overridden = true;
+    will_return(cmocka_test_pthread_mutex_init, ENOMEM);
+    assert_false(octopus_concurrent_cow_array_list_init(
+            &object, sizeof(uintmax_t)));
+    pthread_mutex_init_is_overridden = false;
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_cow_array_list object;
+    assert_true(octopus_concurrent_cow_array_list_init(
+            &object, sizeof(uintmax_t)));
+    assert_int_equal(object.size, sizeof(uintmax_t));
+    assert_non_null(object.snapshot);
+    uintmax_t length;
+    assert_true(octopus_concurrent_cow_array_list_length(&object, &length));
+    assert_int_equal(length, 0);
+    assert_true(octopus_concurrent_cow_array_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_size_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_cow_array_list_size(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_size_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_cow_array_list_size((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_size(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_cow_array_list object;
+    assert_true(octopus_concurrent_cow_array_list_init(&object, 3));
+    size_t size;
+    assert_true(octopus_concurrent_cow_array_list_size(&object, &size));
+    assert_int_equal(size, 3);
+    assert_true(octopus_concurrent_cow_array_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_length_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_cow_array_list_length(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_length_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_cow_array_list_length((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_cow_array_list_add(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_error_on_item_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_cow_array_list_add((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_ITEM_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_cow_array_list object;
+    assert_true(octopus_concurrent_cow_array_list_init(
+            &object, sizeof(uintmax_t)));
+    const uintmax_t item = 1;
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_false(octopus_concurrent_cow_array_list_add(&object, &item));
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    uintmax_t length;
+    assert_true(octopus_concurrent_cow_array_list_length(&object, &length));
+    assert_int_equal(length, 0);
+    assert_true(octopus_concurrent_cow_array_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_contents(struct octopus_concurrent_cow_array_list *object,
+                           const uintmax_t *items,
+                           const uintmax_t count) {
+    const struct octopus_concurrent_cow_array_list_snapshot *snapshot;
+    assert_true(octopus_concurrent_cow_array_list_acquire(object, &snapshot));
+    uintmax_t length;
+    assert_true(octopus_concurrent_cow_array_list_snapshot_length(
+            snapshot, &length));
+    assert_int_equal(length, count);
+    for (uintmax_t i = 0; i < count; i++) {
+        const uintmax_t *item;
+        assert_true(octopus_concurrent_cow_array_list_snapshot_get(
+                snapshot, i, (const void **) &item));
+        assert_int_equal(*item, items[i]);
+    }
+    assert_true(octopus_concurrent_cow_array_list_release(snapshot));
+}
+
+static void check_add(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_cow_array_list object;
+    assert_true(octopus_concurrent_cow_array_list_init(
+            &object, sizeof(uintmax_t)));
+    for (uintmax_t i = 10; i < 13; i++) {
+        assert_true(octopus_concurrent_cow_array_list_add(&object, &i));
+    }
+    check_contents(&object, (uintmax_t[]) {10, 11, 12}, 3);
+    assert_true(octopus_concurrent_cow_array_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_insert_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_cow_array_list_insert(
+            NULL, 0, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_insert_error_on_item_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_cow_array_list_insert(
+            (void *) 1, 0, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_ITEM_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_insert_error_on_index_is_out_of_bounds(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_cow_array_list object;
+    assert_true(octopus_concurrent_cow_array_list_init(
+            &object, sizeof(uintmax_t)));
+    const uintmax_t item = 1;
+    assert_false(octopus_concurrent_cow_array_list_insert(
+            &object, 1, &item));
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_INDEX_IS_OUT_OF_BOUNDS,
+            octopus_error);
+    assert_true(octopus_concurrent_cow_array_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_insert(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_cow_array_list object;
+    assert_true(octopus_concurrent_cow_array_list_init(
+            &object, sizeof(uintmax_t)));
+    uintmax_t item = 2;
+    assert_true(octopus_concurrent_cow_array_list_insert(&object, 0, &item));
+    item = 0;
+    assert_true(octopus_concurrent_cow_array_list_insert(&object, 0, &item));
+    item = 1;
+    assert_true(octopus_concurrent_cow_array_list_insert(&object, 1, &item));
+    item = 3;
+    assert_true(octopus_concurrent_cow_array_list_insert(&object, 3, &item));
+    check_contents(&object, (uintmax_t[]) {0, 1, 2, 3}, 4);
+    assert_true(octopus_concurrent_cow_array_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_set_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_cow_array_list_set(NULL, 0, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_set_error_on_item_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_cow_array_list_set((void *) 1, 0, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_ITEM_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_set_error_on_index_is_out_of_bounds(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_cow_array_list object;
+    assert_true(octopus_concurrent_cow_array_list_init(
+            &object, sizeof(uintmax_t)));
+    const uintmax_t item = 1;
+    assert_false(octopus_concurrent_cow_array_list_set(&object, 0, &item));
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_INDEX_IS_OUT_OF_BOUNDS,
+            octopus_error);
+    assert_true(octopus_concurrent_cow_array_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_set(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_cow_array_list object;
+    assert_true(octopus_concurrent_cow_array_list_init(
+            &object, sizeof(uintmax_t)));
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_concurrent_cow_array_list_add(&object, &i));
+    }
+    const uintmax_t item = 7;
+    assert_true(octopus_concurrent_cow_array_list_set(&object, 1, &item));
+    check_contents(&object, (uintmax_t[]) {0, 7, 2}, 3);
+    assert_true(octopus_concurrent_cow_array_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_cow_array_list_remove(NULL, 0, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_index_is_out_of_bounds(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_cow_array_list object;
+    assert_true(octopus_concurrent_cow_array_list_init(
+            &object, sizeof(uintmax_t)));
+    assert_false(octopus_concurrent_cow_array_list_remove(&object, 0, NULL));
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_INDEX_IS_OUT_OF_BOUNDS,
+            octopus_error);
+    assert_true(octopus_concurrent_cow_array_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_cow_array_list object;
+    assert_true(octopus_concurrent_cow_array_list_init(
+            &object, sizeof(uintmax_t)));
+    for (uintmax_t i = 0; i < 4; i++) {
+        assert_true(octopus_concurrent_cow_array_list_add(&object, &i));
+    }
+    uintmax_t item;
+    assert_true(octopus_concurrent_cow_array_list_remove(&object, 1, &item));
+    assert_int_equal(item, 1);
+    check_contents(&object, (uintmax_t[]) {0, 2, 3}, 3);
+    assert_true(octopus_concurrent_cow_array_list_remove(&object, 2, NULL));
+    assert_true(octopus_concurrent_cow_array_list_remove(&object, 0, &item));
+    assert_int_equal(item, 0);
+    check_contents(&object, (uintmax_t[]) {2}, 1);
+    assert_true(octopus_concurrent_cow_array_list_remove(&object, 0, NULL));
+    check_contents(&object, NULL, 0);
+    assert_true(octopus_concurrent_cow_array_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_acquire_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_cow_array_list_acquire(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_acquire_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_cow_array_list_acquire((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_release_error_on_snapshot_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_cow_array_list_release(NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_SNAPSHOT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_snapshot_is_unchanged_by_writers(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_cow_array_list object;
+    assert_true(octopus_concurrent_cow_array_list_init(
+            &object, sizeof(uintmax_t)));
+    for (uintmax_t i = 0; i < 2; i++) {
+        assert_true(octopus_concurrent_cow_array_list_add(&object, &i));
+    }
+    const struct octopus_concurrent_cow_array_list_snapshot *snapshot;
+    assert_true(octopus_concurrent_cow_array_list_acquire(&object, &snapshot));
+    const uintmax_t item = 9;
+    assert_true(octopus_concurrent_cow_array_list_set(&object, 0, &item));
+    assert_true(octopus_concurrent_cow_array_list_add(&object, &item));
+    assert_true(octopus_concurrent_cow_array_list_remove(&object, 1, NULL));
+    assert_ptr_not_equal(snapshot, object.snapshot);
+    uintmax_t length;
+    assert_true(octopus_concurrent_cow_array_list_snapshot_length(
+            snapshot, &length));
+    assert_int_equal(length, 2);
+    const uintmax_t *first;
+    assert_true(octopus_concurrent_cow_array_list_snapshot_get(
+            snapshot, 0, (const void **) &first));
+    assert_int_equal(*first, 0);
+    assert_true(octopus_concurrent_cow_array_list_release(snapshot));
+    check_contents(&object, (uintmax_t[]) {9, 9}, 2);
+    assert_true(octopus_concurrent_cow_array_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_snapshot_length_error_on_snapshot_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_cow_array_list_snapshot_length(
+            NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_SNAPSHOT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_snapshot_length_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_cow_array_list_snapshot_length(
+            (void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_snapshot_get_error_on_snapshot_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_cow_array_list_snapshot_get(
+            NULL, 0, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_SNAPSHOT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_snapshot_get_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_cow_array_list_snapshot_get(
+            (void *) 1, 0, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_snapshot_get_error_on_index_is_out_of_bounds(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_cow_array_list object;
+    assert_true(octopus_concurrent_cow_array_list_init(
+            &object, sizeof(uintmax_t)));
+    const struct octopus_concurrent_cow_array_list_snapshot *snapshot;
+    assert_true(octopus_concurrent_cow_array_list_acquire(&object, &snapshot));
+    const void *item;
+    assert_false(octopus_concurrent_cow_array_list_snapshot_get(
+            snapshot, 0, &item));
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_COW_ARRAY_LIST_ERROR_INDEX_IS_OUT_OF_BOUNDS,
+            octopus_error);
+    assert_true(octopus_concurrent_cow_array_list_release(snapshot));
+    assert_true(octopus_concurrent_cow_array_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+#define ROUNDS 2000
+#define ITEMS 8
+
+struct shared {
+    struct octopus_concurrent_cow_array_list object;
+    atomic_bool stop;
+};
+
+static void *check_concurrently_reader(void *arg) {
+    struct shared *const shared = arg;
+    while (!atomic_load_explicit(&shared->stop, memory_order_relaxed)) {
+        const struct octopus_concurrent_cow_array_list_snapshot *snapshot;
+        assert_true(octopus_concurrent_cow_array_list_acquire(
+                &shared->object, &snapshot));
+        uintmax_t length;
+        assert_true(octopus_concurrent_cow_array_list_snapshot_length(
+                snapshot, &length));
+        assert_in_range(length, ITEMS, ITEMS + 1);
+        /* the writer keeps the items consecutive in every snapshot */
+        const uintmax_t *first;
+        assert_true(octopus_concurrent_cow_array_list_snapshot_get(
+                snapshot, 0, (const void **) &first));
+        for (uintmax_t i = 1; i < length; i++) {
+            const uintmax_t *item;
+            assert_true(octopus_concurrent_cow_array_list_snapshot_get(
+                    snapshot, i, (const void **) &item));
+            assert_int_equal(*item, *first + i);
+        }
+        assert_true(octopus_concurrent_cow_array_list_release(snapshot));
+    }
+    return NULL;
+}
+
+static void check_concurrently(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct shared shared;
+    assert_true(octopus_concurrent_cow_array_list_init(
+            &shared.object, sizeof(uintmax_t)));
+    for (uintmax_t i = 0; i < ITEMS; i++) {
+        assert_true(octopus_concurrent_cow_array_list_add(
+                &shared.object, &i));
+    }
+    atomic_init(&shared.stop, false);
+    pthread_t threads[3];
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_int_equal(0, pthread_create(
+                &threads[i], NULL, check_concurrently_reader, &shared));
+    }
+    for (uintmax_t i = ITEMS; i < ITEMS + ROUNDS; i++) {
+        assert_true(octopus_concurrent_cow_array_list_add(
+                &shared.object, &i));
+        assert_true(octopus_concurrent_cow_array_list_remove(
+                &shared.object, 0, NULL));
+    }
+    atomic_store(&shared.stop, true);
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_int_equal(0, pthread_join(threads[i], NULL));
+    }
+    check_contents(&shared.object, (uintmax_t[]) {
+            ROUNDS, ROUNDS + 1, ROUNDS + 2, ROUNDS + 3,
+            ROUNDS + 4, ROUNDS + 5, ROUNDS + 6, ROUNDS + 7
+    }, ITEMS);
+    assert_true(octopus_concurrent_cow_array_list_invalidate(
+            &shared.object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_invalidate),
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_size_is_zero),
+            cmocka_unit_test(check_init_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_size_error_on_object_is_null),
+            cmocka_unit_test(check_size_error_on_out_is_null),
+            cmocka_unit_test(check_size),
+            cmocka_unit_test(check_length_error_on_object_is_null),
+            cmocka_unit_test(check_length_error_on_out_is_null),
+            cmocka_unit_test(check_add_error_on_object_is_null),
+            cmocka_unit_test(check_add_error_on_item_is_null),
+            cmocka_unit_test(check_add_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_add),
+            cmocka_unit_test(check_insert_error_on_object_is_null),
+            cmocka_unit_test(check_insert_error_on_item_is_null),
+            cmocka_unit_test(check_insert_error_on_index_is_out_of_bounds),
+            cmocka_unit_test(check_insert),
+            cmocka_unit_test(check_set_error_on_object_is_null),
+            cmocka_unit_test(check_set_error_on_item_is_null),
+            cmocka_unit_test(check_set_error_on_index_is_out_of_bounds),
+            cmocka_unit_test(check_set),
+            cmocka_unit_test(check_remove_error_on_object_is_null),
+            cmocka_unit_test(check_remove_error_on_index_is_out_of_bounds),
+            cmocka_unit_test(check_remove),
+            cmocka_unit_test(check_acquire_error_on_object_is_null),
+            cmocka_unit_test(check_acquire_error_on_out_is_null),
+            cmocka_unit_test(check_release_error_on_snapshot_is_null),
+            cmocka_unit_test(check_snapshot_is_unchanged_by_writers),
+            cmocka_unit_test(check_snapshot_length_error_on_snapshot_is_null),
+            cmocka_unit_test(check_snapshot_length_error_on_out_is_null),
+            cmocka_unit_test(check_snapshot_get_error_on_snapshot_is_null),
+            cmocka_unit_test(check_snapshot_get_error_on_out_is_null),
+            cmocka_unit_test(check_snapshot_get_error_on_index_is_out_of_bounds),
+            cmocka_unit_test(check_concurrently),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,417 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <octopus.h>
+
+#include "private/concurrent_delay_queue.h"
+
+#include <test/cmocka.h>
+
+#define TICK                                    UINT64_C(1000000)
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_delay_queue_invalidate(NULL, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_invalidate(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_delay_queue object = {};
+    assert_true(octopus_concurrent_delay_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_delay_queue_init(
+            NULL, sizeof(uintmax_t), 2, TICK));
+    assert_int_equal(OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_size_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_delay_queue_init(
+            (void *) 1, 0, 2, TICK));
+    assert_int_equal(OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_SIZE_IS_ZERO,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_size_is_too_large(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_delay_queue_init(
+            (void *) 1, SIZE_MAX, 2, TICK));
+    assert_int_equal(OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_SIZE_IS_TOO_LARGE,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_concurrency_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_delay_queue_init(
+            (void *) 1, sizeof(uintmax_t), 0, TICK));
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_CONCURRENCY_IS_ZERO,
+            octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_tick_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_delay_queue_init(
+            (void *) 1, sizeof(uintmax_t), 2, 0));
+    assert_int_equal(OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_TICK_IS_ZERO,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_delay_queue object;
+    posix_memalign_is_overridden = true;
+    assert_false(octopus_concurrent_delay_queue_init(
+            &object, sizeof(uintmax_t), 2, TICK));
+    posix_memalign_is_overridden = false;
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_delay_queue object;
+    assert_true(octopus_concurrent_delay_queue_init(
+            &object, sizeof(uintmax_t), 3, TICK));
+    assert_int_equal(object.size, sizeof(uintmax_t));
+    assert_int_equal(object.mask, 3);
+    assert_int_equal(object.tick, TICK);
+    assert_true(octopus_concurrent_delay_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_schedule_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_delay_queue_schedule(
+            NULL, (void *) 1, 0, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_schedule_error_on_item_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_delay_queue_schedule(
+            (void *) 1, NULL, 0, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_ITEM_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_schedule_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_delay_queue object;
+    assert_true(octopus_concurrent_delay_queue_init(
+            &object, sizeof(uintmax_t), 1, TICK));
+    const uintmax_t check = 1;
+    realloc_is_overridden = true;
+    assert_false(octopus_concurrent_delay_queue_schedule(
+            &object, &check, 0, NULL));
+    realloc_is_overridden = false;
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    assert_true(octopus_concurrent_delay_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_take_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_delay_queue_take(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_take_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_delay_queue_take((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_take_error_on_nothing_is_due(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_delay_queue object;
+    assert_true(octopus_concurrent_delay_queue_init(
+            &object, sizeof(uintmax_t), 2, TICK));
+    uintmax_t out;
+    assert_false(octopus_concurrent_delay_queue_take(
+            &object, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_NOTHING_IS_DUE,
+                     octopus_error);
+    const uintmax_t check = 1;
+    assert_true(octopus_concurrent_delay_queue_schedule(
+            &object, &check, 1000 * TICK, NULL));
+    assert_false(octopus_concurrent_delay_queue_take(
+            &object, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_NOTHING_IS_DUE,
+                     octopus_error);
+    assert_true(octopus_concurrent_delay_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_take(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_delay_queue object;
+    assert_true(octopus_concurrent_delay_queue_init(
+            &object, sizeof(uintmax_t), 1, TICK));
+    const uintmax_t delays[] = {
+            1, 70, 5000, 300000, 20000000, 40000000
+    };
+    const uintmax_t count = sizeof(delays) / sizeof(delays[0]);
+    for (uintmax_t i = count; i; i--) {
+        assert_true(octopus_concurrent_delay_queue_schedule(
+                &object, &i, delays[i - 1] * TICK, NULL));
+    }
+    uintmax_t out;
+    uintmax_t elapsed = 0;
+    for (uintmax_t i = 0; i < count; i++) {
+        /* move time forward to just before the item is due */
+        object.epoch -= (delays[i] - 1 - elapsed) * TICK;
+        elapsed = delays[i] - 1;
+        assert_false(octopus_concurrent_delay_queue_take(
+                &object, (void **) &out));
+        assert_int_equal(OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_NOTHING_IS_DUE,
+                         octopus_error);
+        object.epoch -= 2 * TICK;
+        elapsed += 2;
+        assert_true(octopus_concurrent_delay_queue_take(
+                &object, (void **) &out));
+        assert_int_equal(out, i + 1);
+    }
+    assert_false(octopus_concurrent_delay_queue_take(
+            &object, (void **) &out));
+    assert_int_equal(object.shards[0].pending, 0);
+    assert_true(octopus_concurrent_delay_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_take_with_no_delay(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_delay_queue object;
+    assert_true(octopus_concurrent_delay_queue_init(
+            &object, sizeof(uintmax_t), 2, TICK));
+    const uintmax_t check = 42;
+    assert_true(octopus_concurrent_delay_queue_schedule(
+            &object, &check, 0, NULL));
+    uintmax_t out;
+    assert_true(octopus_concurrent_delay_queue_take(
+            &object, (void **) &out));
+    assert_int_equal(out, check);
+    assert_true(octopus_concurrent_delay_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_take_expires_slot_at_once(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_delay_queue object;
+    assert_true(octopus_concurrent_delay_queue_init(
+            &object, sizeof(uintmax_t), 1, TICK));
+    for (uintmax_t i = 0; i < 100; i++) {
+        assert_true(octopus_concurrent_delay_queue_schedule(
+                &object, &i, 100 * TICK, NULL));
+    }
+    object.epoch -= 200 * TICK;
+    uintmax_t out;
+    assert_true(octopus_concurrent_delay_queue_take(
+            &object, (void **) &out));
+    assert_int_equal(out, 0);
+    assert_int_equal(object.shards[0].pending, 0);
+    for (uintmax_t i = 1; i < 100; i++) {
+        assert_true(octopus_concurrent_delay_queue_take(
+                &object, (void **) &out));
+        assert_int_equal(out, i);
+    }
+    assert_true(octopus_concurrent_delay_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_take_cascades_overflow(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_delay_queue object;
+    assert_true(octopus_concurrent_delay_queue_init(
+            &object, sizeof(uintmax_t), 1, TICK));
+    /* well beyond the block after the current one of the whole wheel */
+    const uintmax_t block = UINTMAX_C(1)
+            << (OCTOPUS_CONCURRENT_DELAY_QUEUE_BITS
+                * OCTOPUS_CONCURRENT_DELAY_QUEUE_LEVELS);
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_concurrent_delay_queue_schedule(
+                &object, &i, 3 * block * TICK, NULL));
+    }
+    /* the overflow list is cascaded with every entry going back onto it */
+    object.epoch -= (block + 1) * TICK;
+    uintmax_t out;
+    assert_false(octopus_concurrent_delay_queue_take(
+            &object, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_NOTHING_IS_DUE,
+                     octopus_error);
+    assert_int_equal(object.shards[0].pending, 3);
+    object.epoch -= 2 * block * TICK;
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_concurrent_delay_queue_take(
+                &object, (void **) &out));
+        assert_int_equal(out, i);
+    }
+    assert_int_equal(object.shards[0].pending, 0);
+    assert_true(octopus_concurrent_delay_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_cancel_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_delay_queue_cancel(
+            NULL, (void *) 1, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_cancel_error_on_timer_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_delay_queue_cancel(
+            (void *) 1, NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_TIMER_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_cancel_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_delay_queue_cancel(
+            (void *) 1, (void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_cancel_error_on_timer_is_not_pending(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_delay_queue object;
+    assert_true(octopus_concurrent_delay_queue_init(
+            &object, sizeof(uintmax_t), 2, TICK));
+    const uintmax_t check = 1;
+    struct octopus_concurrent_delay_queue_timer timer;
+    assert_true(octopus_concurrent_delay_queue_schedule(
+            &object, &check, TICK, &timer));
+    object.epoch -= 2 * TICK;
+    uintmax_t out;
+    assert_true(octopus_concurrent_delay_queue_take(
+            &object, (void **) &out));
+    assert_false(octopus_concurrent_delay_queue_cancel(
+            &object, &timer, (void **) &out));
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_TIMER_IS_NOT_PENDING,
+            octopus_error);
+    /* the entry is reused but the timer is stale */
+    assert_true(octopus_concurrent_delay_queue_schedule(
+            &object, &check, TICK, NULL));
+    assert_true(octopus_concurrent_delay_queue_schedule(
+            &object, &check, TICK, NULL));
+    assert_false(octopus_concurrent_delay_queue_cancel(
+            &object, &timer, (void **) &out));
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_DELAY_QUEUE_ERROR_TIMER_IS_NOT_PENDING,
+            octopus_error);
+    assert_true(octopus_concurrent_delay_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_cancel(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_delay_queue object;
+    assert_true(octopus_concurrent_delay_queue_init(
+            &object, sizeof(uintmax_t), 1, TICK));
+    struct octopus_concurrent_delay_queue_timer timers[3];
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_concurrent_delay_queue_schedule(
+                &object, &i, 10 * TICK, &timers[i]));
+    }
+    uintmax_t out;
+    assert_true(octopus_concurrent_delay_queue_cancel(
+            &object, &timers[1], (void **) &out));
+    assert_int_equal(out, 1);
+    object.epoch -= 20 * TICK;
+    assert_true(octopus_concurrent_delay_queue_take(
+            &object, (void **) &out));
+    assert_int_equal(out, 0);
+    assert_true(octopus_concurrent_delay_queue_take(
+            &object, (void **) &out));
+    assert_int_equal(out, 2);
+    assert_false(octopus_concurrent_delay_queue_take(
+            &object, (void **) &out));
+    assert_true(octopus_concurrent_delay_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static uintmax_t destroyed;
+
+static void on_destroy(void *item) {
+    destroyed += *(uintmax_t *) item;
+}
+
+static void check_invalidate_with_on_destroy(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_delay_queue object;
+    assert_true(octopus_concurrent_delay_queue_init(
+            &object, sizeof(uintmax_t), 2, TICK));
+    for (uintmax_t i = 1; i <= 40; i++) {
+        assert_true(octopus_concurrent_delay_queue_schedule(
+                &object, &i, i * TICK, NULL));
+    }
+    destroyed = 0;
+    assert_true(octopus_concurrent_delay_queue_invalidate(
+            &object, on_destroy));
+    assert_int_equal(destroyed, 40 * 41 / 2);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_invalidate),
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_size_is_zero),
+            cmocka_unit_test(check_init_error_on_size_is_too_large),
+            cmocka_unit_test(check_init_error_on_concurrency_is_zero),
+            cmocka_unit_test(check_init_error_on_tick_is_zero),
+            cmocka_unit_test(check_init_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_schedule_error_on_object_is_null),
+            cmocka_unit_test(check_schedule_error_on_item_is_null),
+            cmocka_unit_test(check_schedule_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_take_error_on_object_is_null),
+            cmocka_unit_test(check_take_error_on_out_is_null),
+            cmocka_unit_test(check_take_error_on_nothing_is_due),
+            cmocka_unit_test(check_take),
+            cmocka_unit_test(check_take_with_no_delay),
+            cmocka_unit_test(check_take_expires_slot_at_once),
+            cmocka_unit_test(check_take_cascades_overflow),
+            cmocka_unit_test(check_cancel_error_on_object_is_null),
+            cmocka_unit_test(check_cancel_error_on_timer_is_null),
+            cmocka_unit_test(check_cancel_error_on_out_is_null),
+            cmocka_unit_test(check_cancel_error_on_timer_is_not_pending),
+            cmocka_unit_test(check_cancel),
+            cmocka_unit_test(check_invalidate_with_on_destroy),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
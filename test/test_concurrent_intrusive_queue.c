@@ -0,0 +1,317 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <pthread.h>
+#include <octopus.h>
+
+#include "private/concurrent_intrusive_queue.h"
+
+#include <test/cmocka.h>
+
+struct item {
+    uintmax_t value;
+    struct octopus_queue_link link;
+};
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_intrusive_queue_invalidate(NULL, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_intrusive_queue_init(NULL, 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_concurrency_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_intrusive_queue_init((void *) 1, 0));
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_CONCURRENCY_IS_ZERO,
+            octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_intrusive_queue object;
+    posix_memalign_is_overridden = true;
+    assert_false(octopus_concurrent_intrusive_queue_init(&object, 1));
+    posix_memalign_is_overridden = false;
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    assert_false(octopus_concurrent_intrusive_queue_init(
+            &object, UINTMAX_MAX));
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_intrusive_queue object;
+    assert_true(octopus_concurrent_intrusive_queue_init(&object, 3));
+    assert_int_equal(object.mask, 3);
+    for (uintmax_t i = 0; i <= object.mask; i++) {
+        struct octopus_concurrent_intrusive_queue_shard *const shard
+                = &object.shards[i];
+        assert_int_equal((uintptr_t) shard % OCTOPUS_CACHE_LINE_SIZE, 0);
+        assert_ptr_equal(shard->first, &shard->stub);
+        assert_ptr_equal(shard->last, &shard->stub);
+        assert_null(atomic_load(&shard->stub.next));
+    }
+    uintmax_t concurrency;
+    assert_true(octopus_concurrent_intrusive_queue_concurrency(
+            &object, &concurrency));
+    assert_int_equal(concurrency, 4);
+    assert_true(octopus_concurrent_intrusive_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_concurrency_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_intrusive_queue_concurrency(
+            NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_concurrency_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_intrusive_queue_concurrency(
+            (void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_intrusive_queue_add(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_error_on_link_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_intrusive_queue_add((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_LINK_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_intrusive_queue object;
+    assert_true(octopus_concurrent_intrusive_queue_init(&object, 1));
+    struct item items[2];
+    /* no allocation is needed to add an item */
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    for (uintmax_t i = 0; i < 2; i++) {
+        assert_true(octopus_concurrent_intrusive_queue_add(
+                &object, &items[i].link));
+    }
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+    struct octopus_concurrent_intrusive_queue_shard *const shard
+            = &object.shards[0];
+    assert_ptr_equal(shard->first, &shard->stub);
+    assert_ptr_equal(atomic_load(&shard->stub.next), &items[0].link);
+    assert_ptr_equal(atomic_load(&items[0].link.next), &items[1].link);
+    assert_null(atomic_load(&items[1].link.next));
+    assert_ptr_equal(shard->last, &items[1].link);
+    assert_true(octopus_concurrent_intrusive_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_intrusive_queue_remove(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_intrusive_queue_remove((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_queue_is_empty(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_intrusive_queue object;
+    assert_true(octopus_concurrent_intrusive_queue_init(&object, 4));
+    struct octopus_queue_link *out;
+    assert_false(octopus_concurrent_intrusive_queue_remove(&object, &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                     octopus_error);
+    assert_true(octopus_concurrent_intrusive_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_intrusive_queue object;
+    assert_true(octopus_concurrent_intrusive_queue_init(&object, 1));
+    struct item items[3];
+    for (uintmax_t i = 0; i < 3; i++) {
+        items[i].value = i;
+        assert_true(octopus_concurrent_intrusive_queue_add(
+                &object, &items[i].link));
+    }
+    struct octopus_concurrent_intrusive_queue_shard *const shard
+            = &object.shards[0];
+    for (uintmax_t i = 0; i < 3; i++) {
+        struct octopus_queue_link *out;
+        assert_true(octopus_concurrent_intrusive_queue_remove(&object, &out));
+        struct item *const item = OCTOPUS_QUEUE_LINK_ENTRY(
+                out, struct item, link);
+        assert_ptr_equal(item, &items[i]);
+        assert_int_equal(item->value, i);
+        /* the removed link is no longer referenced by the shard */
+        assert_ptr_not_equal(shard->first, out);
+    }
+    /* the stub took the place of the last item */
+    assert_ptr_equal(shard->first, &shard->stub);
+    assert_ptr_equal(shard->last, &shard->stub);
+    struct octopus_queue_link *out;
+    assert_false(octopus_concurrent_intrusive_queue_remove(&object, &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_INTRUSIVE_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                     octopus_error);
+    /* an item may be added again once it has been removed */
+    assert_true(octopus_concurrent_intrusive_queue_add(
+            &object, &items[1].link));
+    assert_true(octopus_concurrent_intrusive_queue_remove(&object, &out));
+    assert_ptr_equal(out, &items[1].link);
+    assert_true(octopus_concurrent_intrusive_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static uintmax_t destroyed;
+
+static void on_destroy(struct octopus_queue_link *link) {
+    destroyed += OCTOPUS_QUEUE_LINK_ENTRY(link, struct item, link)->value;
+}
+
+static void check_invalidate(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_intrusive_queue object;
+    assert_true(octopus_concurrent_intrusive_queue_init(&object, 2));
+    struct item items[4];
+    for (uintmax_t i = 0; i < 4; i++) {
+        items[i].value = 1 + i;
+        assert_true(octopus_concurrent_intrusive_queue_add(
+                &object, &items[i].link));
+    }
+    destroyed = 0;
+    assert_true(octopus_concurrent_intrusive_queue_invalidate(
+            &object, on_destroy));
+    assert_int_equal(destroyed, 1 + 2 + 3 + 4);
+    assert_null(object.shards);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+#define THREADS                                     4
+#define ITEMS                                       10000
+
+struct context {
+    struct octopus_concurrent_intrusive_queue queue;
+    struct item items[THREADS][ITEMS];
+    atomic_uint seen[THREADS][ITEMS];
+    atomic_uintmax_t removed;
+    atomic_uintmax_t id;
+};
+
+static void *check_threads_producer(void *arg) {
+    struct context *const context = arg;
+    const uintmax_t id = atomic_fetch_add(&context->id, 1);
+    for (uintmax_t i = 0; i < ITEMS; i++) {
+        struct item *const item = &context->items[id][i];
+        item->value = id * ITEMS + i;
+        assert_true(octopus_concurrent_intrusive_queue_add(
+                &context->queue, &item->link));
+    }
+    return NULL;
+}
+
+static void *check_threads_consumer(void *arg) {
+    struct context *const context = arg;
+    while (atomic_load(&context->removed) < THREADS * ITEMS) {
+        struct octopus_queue_link *out;
+        if (!octopus_concurrent_intrusive_queue_remove(
+                &context->queue, &out)) {
+            continue;
+        }
+        const uintmax_t value = OCTOPUS_QUEUE_LINK_ENTRY(
+                out, struct item, link)->value;
+        atomic_fetch_add(&context->seen[value / ITEMS][value % ITEMS], 1);
+        atomic_fetch_add(&context->removed, 1);
+    }
+    return NULL;
+}
+
+static void check_threads(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct context *const context = calloc(1, sizeof(*context));
+    assert_non_null(context);
+    assert_true(octopus_concurrent_intrusive_queue_init(
+            &context->queue, THREADS));
+    pthread_t threads[2 * THREADS];
+    for (uintmax_t i = 0; i < THREADS; i++) {
+        assert_int_equal(0, pthread_create(&threads[i], NULL,
+                                           check_threads_producer, context));
+        assert_int_equal(0, pthread_create(&threads[THREADS + i], NULL,
+                                           check_threads_consumer, context));
+    }
+    for (uintmax_t i = 0; i < 2 * THREADS; i++) {
+        assert_int_equal(0, pthread_join(threads[i], NULL));
+    }
+    /* every item was removed exactly once */
+    for (uintmax_t i = 0; i < THREADS; i++) {
+        for (uintmax_t j = 0; j < ITEMS; j++) {
+            assert_int_equal(atomic_load(&context->seen[i][j]), 1);
+        }
+    }
+    assert_true(octopus_concurrent_intrusive_queue_invalidate(
+            &context->queue, NULL));
+    free(context);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_concurrency_is_zero),
+            cmocka_unit_test(check_init_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_concurrency_error_on_object_is_null),
+            cmocka_unit_test(check_concurrency_error_on_out_is_null),
+            cmocka_unit_test(check_add_error_on_object_is_null),
+            cmocka_unit_test(check_add_error_on_link_is_null),
+            cmocka_unit_test(check_add),
+            cmocka_unit_test(check_remove_error_on_object_is_null),
+            cmocka_unit_test(check_remove_error_on_out_is_null),
+            cmocka_unit_test(check_remove_error_on_queue_is_empty),
+            cmocka_unit_test(check_remove),
+            cmocka_unit_test(check_invalidate),
+            cmocka_unit_test(check_threads),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
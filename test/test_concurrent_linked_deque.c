@@ -0,0 +1,585 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <errno.h>
+#include <pthread.h>
+#include <octopus.h>
+
+#include "private/concurrent_linked_deque.h"
+
+#include <test/cmocka.h>
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_deque_invalidate(NULL, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static uintmax_t destroyed;
+
+static void on_destroy(void *item) {
+    destroyed += *(uintmax_t *) item;
+}
+
+static void check_invalidate(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_deque object;
+    assert_true(octopus_concurrent_linked_deque_init(
+            &object, sizeof(uintmax_t), 4));
+    for (uintmax_t i = 1; i <= 3; i++) {
+        assert_true(octopus_concurrent_linked_deque_add_first(&object, &i));
+        assert_true(octopus_concurrent_linked_deque_add_last(&object, &i));
+    }
+    destroyed = 0;
+    assert_true(octopus_concurrent_linked_deque_invalidate(
+            &object, on_destroy));
+    assert_int_equal(destroyed, 12);
+    assert_null(object.shards);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_deque_init(NULL, 1, 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_size_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_deque object;
+    assert_false(octopus_concurrent_linked_deque_init(&object, 0, 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_SIZE_IS_ZERO,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_size_is_too_large(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_deque object;
+    assert_false(octopus_concurrent_linked_deque_init(&object, SIZE_MAX, 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_SIZE_IS_TOO_LARGE,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_concurrency_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_deque object;
+    assert_false(octopus_concurrent_linked_deque_init(&object, 1, 0));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_CONCURRENCY_IS_ZERO,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_deque object;
+    posix_memalign_is_overridden = true;
+    assert_false(octopus_concurrent_linked_deque_init(&object, 1, 4));
+    posix_memalign_is_overridden = false;
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    assert_false(octopus_concurrent_linked_deque_init(&object, 1, UINTMAX_MAX));
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    pthread_mutex_init_is_overridden = true;
+    will_return(cmocka_test_pthread_mutex_init, ENOMEM);
+    assert_false(octopus_concurrent_linked_deque_init(&object, 1, 4));
+    pthread_mutex_init_is_overridden = false;
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_deque object;
+    assert_true(octopus_concurrent_linked_deque_init(
+            &object, sizeof(uintmax_t), 3));
+    assert_non_null(object.shards);
+    assert_int_equal(object.mask, 3);
+    assert_int_equal(object.size, sizeof(uintmax_t));
+    assert_true(octopus_concurrent_linked_deque_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_size_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_deque_size(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_size_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_deque_size((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_size(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_deque object;
+    assert_true(octopus_concurrent_linked_deque_init(&object, 3, 1));
+    size_t size;
+    assert_true(octopus_concurrent_linked_deque_size(&object, &size));
+    assert_int_equal(size, 3);
+    assert_true(octopus_concurrent_linked_deque_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_first_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_deque_add_first(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_first_error_on_item_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_deque_add_first((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_ITEM_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_first_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_deque object;
+    assert_true(octopus_concurrent_linked_deque_init(
+            &object, sizeof(uintmax_t), 4));
+    const uintmax_t item = 1;
+    malloc_is_overridden = true;
+    assert_false(octopus_concurrent_linked_deque_add_first(&object, &item));
+    malloc_is_overridden = false;
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    assert_int_equal(atomic_load(&object.first), 0);
+    assert_true(octopus_concurrent_linked_deque_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_first(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_deque object;
+    assert_true(octopus_concurrent_linked_deque_init(
+            &object, sizeof(uintmax_t), 4));
+    for (uintmax_t i = 0; i < 6; i++) {
+        assert_true(octopus_concurrent_linked_deque_add_first(&object, &i));
+    }
+    assert_int_equal(atomic_load(&object.first), -6);
+    for (uintmax_t i = 6; i; i--) {
+        uintmax_t out;
+        assert_true(octopus_concurrent_linked_deque_remove_first(
+                &object, (void **) &out));
+        assert_int_equal(out, i - 1);
+    }
+    assert_true(octopus_concurrent_linked_deque_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_last_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_deque_add_last(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_last_error_on_item_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_deque_add_last((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_ITEM_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_last_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_deque object;
+    assert_true(octopus_concurrent_linked_deque_init(
+            &object, sizeof(uintmax_t), 4));
+    const uintmax_t item = 1;
+    malloc_is_overridden = true;
+    assert_false(octopus_concurrent_linked_deque_add_last(&object, &item));
+    malloc_is_overridden = false;
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    assert_int_equal(atomic_load(&object.last), 0);
+    assert_true(octopus_concurrent_linked_deque_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_last(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_deque object;
+    assert_true(octopus_concurrent_linked_deque_init(
+            &object, sizeof(uintmax_t), 4));
+    for (uintmax_t i = 0; i < 6; i++) {
+        assert_true(octopus_concurrent_linked_deque_add_last(&object, &i));
+    }
+    assert_int_equal(atomic_load(&object.last), 6);
+    for (uintmax_t i = 0; i < 6; i++) {
+        uintmax_t out;
+        assert_true(octopus_concurrent_linked_deque_remove_first(
+                &object, (void **) &out));
+        assert_int_equal(out, i);
+    }
+    assert_true(octopus_concurrent_linked_deque_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_first_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_deque_remove_first(
+            NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_first_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_deque_remove_first(
+            (void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_first_error_on_deque_is_empty(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_deque object;
+    assert_true(octopus_concurrent_linked_deque_init(
+            &object, sizeof(uintmax_t), 4));
+    uintmax_t out;
+    assert_false(octopus_concurrent_linked_deque_remove_first(
+            &object, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_DEQUE_IS_EMPTY,
+                     octopus_error);
+    assert_int_equal(atomic_load(&object.first), 0);
+    assert_true(octopus_concurrent_linked_deque_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_first(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_deque object;
+    assert_true(octopus_concurrent_linked_deque_init(
+            &object, sizeof(uintmax_t), 4));
+    uintmax_t item = 1;
+    assert_true(octopus_concurrent_linked_deque_add_last(&object, &item));
+    item = 0;
+    assert_true(octopus_concurrent_linked_deque_add_first(&object, &item));
+    uintmax_t out;
+    assert_true(octopus_concurrent_linked_deque_remove_first(
+            &object, (void **) &out));
+    assert_int_equal(out, 0);
+    assert_true(octopus_concurrent_linked_deque_remove_first(
+            &object, (void **) &out));
+    assert_int_equal(out, 1);
+    assert_false(octopus_concurrent_linked_deque_remove_first(
+            &object, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_DEQUE_IS_EMPTY,
+                     octopus_error);
+    assert_true(octopus_concurrent_linked_deque_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_last_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_deque_remove_last(
+            NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_last_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_deque_remove_last(
+            (void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_last_error_on_deque_is_empty(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_deque object;
+    assert_true(octopus_concurrent_linked_deque_init(
+            &object, sizeof(uintmax_t), 4));
+    uintmax_t out;
+    assert_false(octopus_concurrent_linked_deque_remove_last(
+            &object, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_DEQUE_IS_EMPTY,
+                     octopus_error);
+    assert_int_equal(atomic_load(&object.last), 0);
+    assert_true(octopus_concurrent_linked_deque_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_last(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_deque object;
+    assert_true(octopus_concurrent_linked_deque_init(
+            &object, sizeof(uintmax_t), 4));
+    for (uintmax_t i = 0; i < 6; i++) {
+        assert_true(octopus_concurrent_linked_deque_add_last(&object, &i));
+    }
+    const uintmax_t item = 9;
+    assert_true(octopus_concurrent_linked_deque_add_first(&object, &item));
+    for (uintmax_t i = 6; i; i--) {
+        uintmax_t out;
+        assert_true(octopus_concurrent_linked_deque_remove_last(
+                &object, (void **) &out));
+        assert_int_equal(out, i - 1);
+    }
+    uintmax_t out;
+    assert_true(octopus_concurrent_linked_deque_remove_last(
+            &object, (void **) &out));
+    assert_int_equal(out, 9);
+    assert_false(octopus_concurrent_linked_deque_remove_last(
+            &object, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_DEQUE_IS_EMPTY,
+                     octopus_error);
+    assert_true(octopus_concurrent_linked_deque_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_peek_first_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_deque_peek_first(
+            NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_peek_first_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_deque_peek_first(
+            (void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_peek_first(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_deque object;
+    assert_true(octopus_concurrent_linked_deque_init(
+            &object, sizeof(uintmax_t), 4));
+    uintmax_t out;
+    assert_false(octopus_concurrent_linked_deque_peek_first(
+            &object, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_DEQUE_IS_EMPTY,
+                     octopus_error);
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_concurrent_linked_deque_add_last(&object, &i));
+    }
+    assert_true(octopus_concurrent_linked_deque_peek_first(
+            &object, (void **) &out));
+    assert_int_equal(out, 0);
+    assert_true(octopus_concurrent_linked_deque_peek_first(
+            &object, (void **) &out));
+    assert_int_equal(out, 0);
+    assert_int_equal(atomic_load(&object.first), 0);
+    assert_true(octopus_concurrent_linked_deque_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_peek_last_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_deque_peek_last(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_peek_last_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_deque_peek_last((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_peek_last(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_deque object;
+    assert_true(octopus_concurrent_linked_deque_init(
+            &object, sizeof(uintmax_t), 4));
+    uintmax_t out;
+    assert_false(octopus_concurrent_linked_deque_peek_last(
+            &object, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_DEQUE_IS_EMPTY,
+                     octopus_error);
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_concurrent_linked_deque_add_first(&object, &i));
+    }
+    assert_true(octopus_concurrent_linked_deque_peek_last(
+            &object, (void **) &out));
+    assert_int_equal(out, 0);
+    assert_int_equal(atomic_load(&object.last), 0);
+    assert_true(octopus_concurrent_linked_deque_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_ends_use_different_shards(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_deque object;
+    assert_true(octopus_concurrent_linked_deque_init(
+            &object, sizeof(uintmax_t), 4));
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_concurrent_linked_deque_add_last(&object, &i));
+    }
+    /* hold the lock of the shard at the front, the end is elsewhere */
+    assert_int_equal(0, pthread_mutex_lock(
+            &object.shards[0].lock));
+    uintmax_t out;
+    assert_true(octopus_concurrent_linked_deque_remove_last(
+            &object, (void **) &out));
+    assert_int_equal(out, 2);
+    assert_int_equal(0, pthread_mutex_unlock(
+            &object.shards[0].lock));
+    assert_true(octopus_concurrent_linked_deque_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_spare_nodes_are_reused(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_deque object;
+    assert_true(octopus_concurrent_linked_deque_init(
+            &object, sizeof(uintmax_t), 1));
+    const uintmax_t item = 1;
+    assert_true(octopus_concurrent_linked_deque_add_last(&object, &item));
+    uintmax_t out;
+    assert_true(octopus_concurrent_linked_deque_remove_first(
+            &object, (void **) &out));
+    malloc_is_overridden = true;
+    assert_true(octopus_concurrent_linked_deque_add_first(&object, &item));
+    assert_false(octopus_concurrent_linked_deque_add_first(&object, &item));
+    malloc_is_overridden = false;
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    assert_true(octopus_concurrent_linked_deque_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+#define ITEMS 20000
+
+struct shared {
+    struct octopus_concurrent_linked_deque object;
+    atomic_uintmax_t sum;
+    atomic_uintmax_t taken;
+};
+
+static void *check_concurrently_worker(void *arg) {
+    struct shared *const shared = arg;
+    while (atomic_load(&shared->taken) < ITEMS) {
+        uintmax_t out;
+        const bool front = atomic_load(&shared->taken) % 2;
+        if (front
+            ? octopus_concurrent_linked_deque_remove_first(
+                    &shared->object, (void **) &out)
+            : octopus_concurrent_linked_deque_remove_last(
+                    &shared->object, (void **) &out)) {
+            atomic_fetch_add(&shared->sum, out);
+            atomic_fetch_add(&shared->taken, 1);
+        } else {
+            assert_int_equal(
+                    OCTOPUS_CONCURRENT_LINKED_DEQUE_ERROR_DEQUE_IS_EMPTY,
+                    octopus_error);
+        }
+    }
+    return NULL;
+}
+
+static void check_concurrently(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct shared shared;
+    assert_true(octopus_concurrent_linked_deque_init(
+            &shared.object, sizeof(uintmax_t), 4));
+    atomic_init(&shared.sum, 0);
+    atomic_init(&shared.taken, 0);
+    pthread_t threads[3];
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_int_equal(0, pthread_create(
+                &threads[i], NULL, check_concurrently_worker, &shared));
+    }
+    for (uintmax_t i = 1; i <= ITEMS; i++) {
+        assert_true(i % 2
+                    ? octopus_concurrent_linked_deque_add_first(
+                            &shared.object, &i)
+                    : octopus_concurrent_linked_deque_add_last(
+                            &shared.object, &i));
+    }
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_int_equal(0, pthread_join(threads[i], NULL));
+    }
+    assert_int_equal(atomic_load(&shared.sum), ITEMS * (ITEMS + 1) / 2);
+    uintmax_t out;
+    assert_false(octopus_concurrent_linked_deque_remove_first(
+            &shared.object, (void **) &out));
+    assert_true(octopus_concurrent_linked_deque_invalidate(
+            &shared.object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_invalidate),
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_size_is_zero),
+            cmocka_unit_test(check_init_error_on_size_is_too_large),
+            cmocka_unit_test(check_init_error_on_concurrency_is_zero),
+            cmocka_unit_test(check_init_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_size_error_on_object_is_null),
+            cmocka_unit_test(check_size_error_on_out_is_null),
+            cmocka_unit_test(check_size),
+            cmocka_unit_test(check_add_first_error_on_object_is_null),
+            cmocka_unit_test(check_add_first_error_on_item_is_null),
+            cmocka_unit_test(check_add_first_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_add_first),
+            cmocka_unit_test(check_add_last_error_on_object_is_null),
+            cmocka_unit_test(check_add_last_error_on_item_is_null),
+            cmocka_unit_test(check_add_last_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_add_last),
+            cmocka_unit_test(check_remove_first_error_on_object_is_null),
+            cmocka_unit_test(check_remove_first_error_on_out_is_null),
+            cmocka_unit_test(check_remove_first_error_on_deque_is_empty),
+            cmocka_unit_test(check_remove_first),
+            cmocka_unit_test(check_remove_last_error_on_object_is_null),
+            cmocka_unit_test(check_remove_last_error_on_out_is_null),
+            cmocka_unit_test(check_remove_last_error_on_deque_is_empty),
+            cmocka_unit_test(check_remove_last),
+            cmocka_unit_test(check_peek_first_error_on_object_is_null),
+            cmocka_unit_test(check_peek_first_error_on_out_is_null),
+            cmocka_unit_test(check_peek_first),
+            cmocka_unit_test(check_peek_last_error_on_object_is_null),
+            cmocka_unit_test(check_peek_last_error_on_out_is_null),
+            cmocka_unit_test(check_peek_last),
+            cmocka_unit_test(check_ends_use_different_shards),
+            cmocka_unit_test(check_spare_nodes_are_reused),
+            cmocka_unit_test(check_concurrently),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -3,11 +3,17 @@
 #include <setjmp.h>
 #include <cmocka.h>
 #include <octopus.h>
+#include <poll.h>
+#include <sched.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <unistd.h>
 
+#include "private/deadline.h"
 #include "private/linked_queue.h"
+#include "private/spill.h"
 
 #include <test/cmocka.h>
-#include "test/linked_queue.h"
 
 static void check_invalidate_error_on_object_is_null(void **state) {
     octopus_error = OCTOPUS_ERROR_NONE;
@@ -140,9 +146,30 @@ static void check_concurrency(void **state) {
     struct octopus_concurrent_linked_queue object;
     assert_true(octopus_concurrent_linked_queue_init(
             &object, sizeof(uintmax_t), check));
-    size_t out;
+    uintmax_t out;
     assert_true(octopus_concurrent_linked_queue_concurrency(&object, &out));
-    assert_int_equal(out, check);
+    assert_true(out >= check);
+    assert_true(out < 2 * check);
+    assert_int_equal(out & (out - 1), 0);
+    assert_int_equal(object.mask, out - 1);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_concurrency_is_rounded_up(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 5));
+    uintmax_t out;
+    assert_true(octopus_concurrent_linked_queue_concurrency(&object, &out));
+    assert_int_equal(out, 8);
+    assert_int_equal((uintptr_t) object.queues % OCTOPUS_CACHE_LINE_SIZE, 0);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 1));
+    assert_true(octopus_concurrent_linked_queue_concurrency(&object, &out));
+    assert_int_equal(out, 1);
     assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
     octopus_error = OCTOPUS_ERROR_NONE;
 }
@@ -176,17 +203,38 @@ static void check_add(void **state) {
     }
     assert_int_equal(atomic_load(&object.enqueue), check);
     for (uintmax_t i = 0; i < 8; i++) {
-        struct octopus_linked_queue *queue;
-        assert_true(coral_array_list_get(
-                &object.queues, i, (void **) &queue));
         uintmax_t count;
-        assert_true(octopus_linked_queue_count(queue, &count));
+        assert_true(octopus_linked_queue_count(&object.queues[i], &count));
         assert_int_equal(count, 8);
     }
     assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
     octopus_error = OCTOPUS_ERROR_NONE;
 }
 
+static void check_add_wraps_around_shards(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 8));
+    const uintmax_t check = 3 * 64; /* beyond concurrency ^ 2 */
+    for (uintmax_t i = 0; i < check; i++) {
+        assert_true(octopus_concurrent_linked_queue_add(&object, &i));
+    }
+    for (uintmax_t i = 0; i < 8; i++) {
+        uintmax_t count;
+        assert_true(octopus_linked_queue_count(&object.queues[i], &count));
+        assert_int_equal(count, check / 8);
+    }
+    for (uintmax_t i = 0; i < check; i++) {
+        uintmax_t out;
+        assert_true(octopus_concurrent_linked_queue_remove(
+                &object, (void **) &out));
+        assert_int_equal(out, i);
+    }
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
 static void check_add_error_on_memory_allocation_failed(void **state) {
     srand(time(NULL));
     octopus_error = OCTOPUS_ERROR_NONE;
@@ -287,7 +335,7 @@ static void check_remove_case_enqueue_dequeue_integer_overflow(void **state) {
     atomic_store(&object.dequeue, UINTMAX_MAX);
     uintmax_t out;
     assert_true(octopus_concurrent_linked_queue_remove(&object, (void **) &out));
-    assert_int_equal(atomic_load(&object.dequeue), 1);
+    assert_int_equal(atomic_load(&object.dequeue), 3);
     assert_int_equal(out, check);
     assert_false(octopus_concurrent_linked_queue_remove(
             &object, (void **) &out));
@@ -349,7 +397,7 @@ static void check_peek_case_enqueue_dequeue_aligned(void **state) {
     assert_int_equal(atomic_load(&object.dequeue), 1);
     assert_int_equal(out, check);
     assert_true(octopus_concurrent_linked_queue_remove(&object, (void **) &out));
-    assert_int_equal(atomic_load(&object.dequeue), 9);
+    assert_int_equal(atomic_load(&object.dequeue), 2);
     assert_false(octopus_concurrent_linked_queue_remove(
             &object, (void **) &out));
     assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY,
@@ -401,7 +449,7 @@ static void check_peek_case_enqueue_dequeue_integer_overflow(void **state) {
     assert_int_equal(out, check);
     out = ~out;
     assert_true(octopus_concurrent_linked_queue_remove(&object, (void **) &out));
-    assert_int_equal(atomic_load(&object.dequeue), 1);
+    assert_int_equal(atomic_load(&object.dequeue), 3);
     assert_int_equal(out, check);
     assert_false(octopus_concurrent_linked_queue_remove(
             &object, (void **) &out));
@@ -411,6 +459,1408 @@ static void check_peek_case_enqueue_dequeue_integer_overflow(void **state) {
     octopus_error = OCTOPUS_ERROR_NONE;
 }
 
+static void check_init_with_capacity_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_queue_init_with_capacity(
+            NULL, sizeof(uintmax_t), 8, 8));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_with_capacity_error_on_memory_allocation_failed(
+        void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    posix_memalign_is_overridden = true;
+    assert_false(octopus_concurrent_linked_queue_init_with_capacity(
+            &object, sizeof(uintmax_t), 8, 8));
+    posix_memalign_is_overridden = false;
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_with_allocator_error_on_allocator_is_invalid(
+        void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    const struct octopus_allocator allocator = {0};
+    assert_false(octopus_concurrent_linked_queue_init_with_allocator(
+            &object, sizeof(uintmax_t), 8, 0, &allocator));
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_ALLOCATOR_IS_INVALID,
+            octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+/* hands out memory from a fixed buffer so as not to depend on the C library
+ * allocation functions that the tests override */
+struct counting_allocator {
+    _Alignas(OCTOPUS_CACHE_LINE_SIZE) unsigned char buffer[1 << 14];
+    size_t used;
+    uintmax_t allocated;
+    uintmax_t released;
+    uintmax_t bytes;
+    bool fail;
+};
+
+static void *counting_alloc(void *context, size_t size, size_t alignment) {
+    struct counting_allocator *const counting = context;
+    const size_t at = (counting->used + alignment - 1) & ~(alignment - 1);
+    if (counting->fail || at + size > sizeof(counting->buffer)) {
+        return NULL;
+    }
+    counting->used = at + size;
+    counting->allocated++;
+    counting->bytes += size;
+    return counting->buffer + at;
+}
+
+static void counting_free(void *context, void *pointer, size_t size) {
+    struct counting_allocator *const counting = context;
+    assert_true((unsigned char *) pointer >= counting->buffer);
+    assert_true((unsigned char *) pointer + size
+                <= counting->buffer + counting->used);
+    counting->released++;
+    counting->bytes -= size;
+}
+
+static void check_init_with_allocator_error_on_memory_allocation_failed(
+        void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    static struct counting_allocator counting;
+    counting = (struct counting_allocator) {
+            .fail = true
+    };
+    const struct octopus_allocator allocator = {
+            .alloc = counting_alloc,
+            .free = counting_free,
+            .context = &counting
+    };
+    assert_false(octopus_concurrent_linked_queue_init_with_allocator(
+            &object, sizeof(uintmax_t), 8, 8, &allocator));
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    counting.fail = false;
+    assert_true(octopus_concurrent_linked_queue_init_with_allocator(
+            &object, sizeof(uintmax_t), 8, 8, &allocator));
+    const uintmax_t item = rand();
+    counting.fail = true;
+    assert_false(octopus_concurrent_linked_queue_add(&object, &item));
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    counting.fail = false;
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    assert_int_equal(counting.allocated, counting.released);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_with_allocator(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    static struct counting_allocator counting;
+    counting = (struct counting_allocator) {0};
+    const struct octopus_allocator allocator = {
+            .alloc = counting_alloc,
+            .free = counting_free,
+            .context = &counting
+    };
+    /* no allocation may bypass the allocator */
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_true(octopus_concurrent_linked_queue_init_with_allocator(
+            &object, sizeof(uintmax_t), 2, 8, &allocator));
+    /* shards and their counters */
+    assert_int_equal(counting.allocated, 2);
+    for (uintmax_t i = 0; i < 4; i++) {
+        assert_true(octopus_concurrent_linked_queue_add(&object, &i));
+    }
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+    /* a dummy and two item nodes for each shard */
+    assert_int_equal(counting.allocated, 2 + 2 * 3);
+    assert_true(octopus_concurrent_linked_queue_trim(&object));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    assert_int_equal(counting.allocated, counting.released);
+    assert_int_equal(counting.bytes, 0);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_capacity_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_queue_capacity(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_capacity_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_queue_capacity((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_capacity(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 8));
+    uintmax_t out;
+    assert_true(octopus_concurrent_linked_queue_capacity(&object, &out));
+    assert_int_equal(out, 0);
+    assert_null(object.counters);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    assert_true(octopus_concurrent_linked_queue_init_with_capacity(
+            &object, sizeof(uintmax_t), 8, 100));
+    assert_true(octopus_concurrent_linked_queue_capacity(&object, &out));
+    assert_int_equal(out, 100);
+    assert_non_null(object.counters);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_error_on_queue_is_full(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init_with_capacity(
+            &object, sizeof(uintmax_t), 2, 3));
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_concurrent_linked_queue_add(&object, &i));
+    }
+    const uintmax_t check = 3;
+    assert_false(octopus_concurrent_linked_queue_add(&object, &check));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_FULL,
+                     octopus_error);
+    uintmax_t out;
+    assert_true(octopus_concurrent_linked_queue_remove(
+            &object, (void **) &out));
+    assert_true(octopus_concurrent_linked_queue_add(&object, &check));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_moves_on_from_full_shard(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init_with_capacity(
+            &object, sizeof(uintmax_t), 2, 3));
+    /* shard 0 holds 2 items and shard 1 holds 1 item */
+    uintmax_t check = 0;
+    assert_true(octopus_concurrent_linked_queue_add(&object, &check));
+    assert_true(octopus_concurrent_linked_queue_add(&object, &check));
+    atomic_store(&object.enqueue, 1);
+    assert_true(octopus_concurrent_linked_queue_add(&object, &check));
+    uintmax_t out;
+    assert_true(octopus_linked_queue_count(&object.queues[0], &out));
+    assert_int_equal(out, 2);
+    assert_true(octopus_linked_queue_count(&object.queues[1], &out));
+    assert_int_equal(out, 1);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_put_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_queue_put(NULL, (void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_put_error_on_item_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_queue_put((void *) 1, NULL, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_ITEM_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_put_error_on_timeout_is_invalid(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    const struct timespec timeouts[] = {
+            {.tv_sec = -1},
+            {.tv_nsec = -1},
+            {.tv_nsec = 1000000000L}
+    };
+    for (uintmax_t i = 0; i < sizeof(timeouts) / sizeof(timeouts[0]); i++) {
+        assert_false(octopus_concurrent_linked_queue_put(
+                (void *) 1, (void *) 1, &timeouts[i]));
+        assert_int_equal(
+                OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_TIMEOUT_IS_INVALID,
+                octopus_error);
+    }
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_put_with_longest_timeout(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init_with_capacity(
+            &object, sizeof(uintmax_t), 2, 1));
+    const uintmax_t check = 1;
+    const struct timespec timeout = {
+            .tv_sec = OCTOPUS_DEADLINE_SECONDS_MAX,
+            .tv_nsec = 999999999L
+    };
+    assert_true(octopus_concurrent_linked_queue_put(
+            &object, &check, &timeout));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_put_error_on_timed_out(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init_with_capacity(
+            &object, sizeof(uintmax_t), 2, 1));
+    const uintmax_t check = 1;
+    const struct timespec timeout = {.tv_nsec = 10000000};
+    assert_true(octopus_concurrent_linked_queue_put(
+            &object, &check, &timeout));
+    assert_false(octopus_concurrent_linked_queue_put(
+            &object, &check, &timeout));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_TIMED_OUT,
+                     octopus_error);
+    assert_int_equal(atomic_load(&object.blocked), 0);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void *check_put_waits_for_space_consumer(void *arg) {
+    usleep(10000);
+    uintmax_t out;
+    assert_true(octopus_concurrent_linked_queue_remove(arg, (void **) &out));
+    assert_int_equal(out, 1);
+    return NULL;
+}
+
+static void check_put_waits_for_space(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init_with_capacity(
+            &object, sizeof(uintmax_t), 1, 1));
+    uintmax_t check = 1;
+    assert_true(octopus_concurrent_linked_queue_put(&object, &check, NULL));
+    pthread_t thread;
+    assert_int_equal(0, pthread_create(
+            &thread, NULL, check_put_waits_for_space_consumer, &object));
+    check = 2;
+    assert_true(octopus_concurrent_linked_queue_put(&object, &check, NULL));
+    assert_int_equal(0, pthread_join(thread, NULL));
+    uintmax_t out;
+    assert_true(octopus_concurrent_linked_queue_remove(
+            &object, (void **) &out));
+    assert_int_equal(out, 2);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_memory_usage_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_queue_memory_usage(
+            NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_memory_usage_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_queue_memory_usage(
+            (void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_memory_usage(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object = {};
+    uintmax_t out;
+    assert_true(octopus_concurrent_linked_queue_memory_usage(&object, &out));
+    assert_int_equal(out, 0);
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 8));
+    const uintmax_t fixed = 8 * sizeof(struct octopus_linked_queue);
+    assert_true(octopus_concurrent_linked_queue_memory_usage(&object, &out));
+    assert_int_equal(out, fixed);
+    const uintmax_t item = 42;
+    assert_true(octopus_concurrent_linked_queue_add(&object, &item));
+    assert_true(octopus_concurrent_linked_queue_memory_usage(&object, &out));
+    assert_int_equal(out, fixed + 2 * (sizeof(struct octopus_linked_queue_node)
+                                       + sizeof(uintmax_t)));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_trim_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_queue_trim(NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_trim(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 4));
+    uintmax_t fixed;
+    assert_true(octopus_concurrent_linked_queue_memory_usage(
+            &object, &fixed));
+    for (uintmax_t i = 0; i < 1024; i++) {
+        assert_true(octopus_concurrent_linked_queue_add(&object, &i));
+    }
+    uintmax_t out;
+    for (uintmax_t i = 0; i < 1024; i++) {
+        assert_true(octopus_concurrent_linked_queue_remove(
+                &object, (void **) &out));
+    }
+    assert_true(octopus_concurrent_linked_queue_memory_usage(&object, &out));
+    assert_true(out > fixed);
+    assert_true(octopus_concurrent_linked_queue_trim(&object));
+    assert_true(octopus_concurrent_linked_queue_memory_usage(&object, &out));
+    assert_int_equal(out, fixed);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_attach_event_fd_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_queue_attach_event_fd(NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_event_fd_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_queue_event_fd(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_event_fd_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_queue_event_fd((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_event_fd_error_on_event_fd_is_not_attached(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 8));
+    int fd;
+    assert_false(octopus_concurrent_linked_queue_event_fd(&object, &fd));
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_EVENT_FD_IS_NOT_ATTACHED,
+            octopus_error);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+#ifdef __linux__
+static bool is_readable(const int fd) {
+    struct pollfd item = {
+            .fd = fd,
+            .events = POLLIN
+    };
+    const int result = poll(&item, 1, 0);
+    assert_true(result >= 0);
+    return result && (item.revents & POLLIN);
+}
+
+static void check_event_fd(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 8));
+    assert_true(octopus_concurrent_linked_queue_attach_event_fd(&object));
+    int fd;
+    assert_true(octopus_concurrent_linked_queue_event_fd(&object, &fd));
+    assert_false(is_readable(fd));
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_concurrent_linked_queue_add(&object, &i));
+        assert_true(is_readable(fd));
+    }
+    uintmax_t out;
+    for (uintmax_t i = 0; i < 2; i++) {
+        assert_true(octopus_concurrent_linked_queue_remove(
+                &object, (void **) &out));
+        assert_true(is_readable(fd));
+    }
+    assert_true(octopus_concurrent_linked_queue_remove(
+            &object, (void **) &out));
+    assert_false(is_readable(fd));
+    assert_false(octopus_concurrent_linked_queue_remove(
+            &object, (void **) &out));
+    assert_false(is_readable(fd));
+    assert_true(octopus_concurrent_linked_queue_add(&object, &out));
+    assert_true(is_readable(fd));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_attach_event_fd_when_not_empty(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 8));
+    for (uintmax_t i = 0; i < 2; i++) {
+        assert_true(octopus_concurrent_linked_queue_add(&object, &i));
+    }
+    assert_true(octopus_concurrent_linked_queue_attach_event_fd(&object));
+    int fd;
+    assert_true(octopus_concurrent_linked_queue_event_fd(&object, &fd));
+    assert_true(is_readable(fd));
+    uintmax_t out;
+    for (uintmax_t i = 0; i < 2; i++) {
+        assert_true(is_readable(fd));
+        assert_true(octopus_concurrent_linked_queue_remove(
+                &object, (void **) &out));
+    }
+    assert_false(is_readable(fd));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_event_fd_settles_late_write(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 8));
+    assert_true(octopus_concurrent_linked_queue_attach_event_fd(&object));
+    int fd;
+    assert_true(octopus_concurrent_linked_queue_event_fd(&object, &fd));
+    uintmax_t out = 0;
+    assert_true(octopus_concurrent_linked_queue_add(&object, &out));
+    /* take the write back out, as if it had not been made yet */
+    uint64_t value;
+    assert_int_equal(sizeof(value), read(fd, &value, sizeof(value)));
+    assert_true(octopus_concurrent_linked_queue_remove(
+            &object, (void **) &out));
+    assert_int_equal(1, atomic_load(&object.debits));
+    assert_false(is_readable(fd));
+    /* the late write */
+    assert_int_equal(sizeof(value), write(fd, &value, sizeof(value)));
+    assert_true(octopus_concurrent_linked_queue_add(&object, &out));
+    assert_int_equal(0, atomic_load(&object.debits));
+    assert_true(is_readable(fd));
+    assert_true(octopus_concurrent_linked_queue_remove(
+            &object, (void **) &out));
+    assert_false(is_readable(fd));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+#define EVENT_FD_ITEMS 10000
+
+static void *event_fd_produce(void *arg) {
+    struct octopus_concurrent_linked_queue *const object = arg;
+    for (uintmax_t i = 0; i < EVENT_FD_ITEMS; i++) {
+        assert_true(octopus_concurrent_linked_queue_add(object, &i));
+    }
+    return NULL;
+}
+
+static void *event_fd_consume(void *arg) {
+    struct octopus_concurrent_linked_queue *const object = arg;
+    uintmax_t out;
+    for (uintmax_t i = 0; i < EVENT_FD_ITEMS;) {
+        if (octopus_concurrent_linked_queue_remove(object, (void **) &out)) {
+            i++;
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void check_event_fd_concurrently(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 2));
+    assert_true(octopus_concurrent_linked_queue_attach_event_fd(&object));
+    int fd;
+    assert_true(octopus_concurrent_linked_queue_event_fd(&object, &fd));
+    pthread_t threads[4];
+    for (uintmax_t i = 0; i < 4; i++) {
+        assert_int_equal(0, pthread_create(
+                &threads[i], NULL,
+                i % 2 ? event_fd_consume : event_fd_produce, &object));
+    }
+    for (uintmax_t i = 0; i < 4; i++) {
+        assert_int_equal(0, pthread_join(threads[i], NULL));
+    }
+    assert_false(is_readable(fd));
+    uintmax_t out = 0;
+    assert_true(octopus_concurrent_linked_queue_add(&object, &out));
+    assert_true(is_readable(fd));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+#endif /* __linux__ */
+
+static void check_attach_spill_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_queue_attach_spill(
+            NULL, P_tmpdir, 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_attach_spill_error_on_directory_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_queue_attach_spill(
+            (void *) 1, NULL, 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_DIRECTORY_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_attach_spill_error_on_spill_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 4));
+    assert_false(octopus_concurrent_linked_queue_attach_spill(
+            &object, "/nonexistent/octopus", 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_SPILL_FAILED,
+                     octopus_error);
+    for (uintmax_t i = 0; i < 4; i++) {
+        assert_null(object.queues[i].spill);
+    }
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_attach_spill(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 4));
+    assert_true(octopus_concurrent_linked_queue_attach_spill(
+            &object, P_tmpdir, 10));
+    /* threshold is split between the shards */
+    assert_int_equal(object.queues[0].threshold, 3);
+    assert_int_equal(object.queues[1].threshold, 3);
+    assert_int_equal(object.queues[2].threshold, 2);
+    assert_int_equal(object.queues[3].threshold, 2);
+    for (uintmax_t i = 0; i < 1000; i++) {
+        assert_true(octopus_concurrent_linked_queue_add(&object, &i));
+    }
+    uintmax_t spilled = 0;
+    for (uintmax_t i = 0; i < 4; i++) {
+        spilled += atomic_load(&object.queues[i].spill->count);
+    }
+    assert_int_equal(spilled, 990);
+    uintmax_t out;
+    uintmax_t sum = 0;
+    for (uintmax_t i = 0; i < 1000; i++) {
+        assert_true(octopus_concurrent_linked_queue_remove(
+                &object, (void **) &out));
+        sum += out;
+    }
+    assert_int_equal(sum, 999 * 1000 / 2);
+    assert_false(octopus_concurrent_linked_queue_remove(
+            &object, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                     octopus_error);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+#define SPILL_ITEMS                             20000
+
+static void *check_spill_concurrently_producer(void *arg) {
+    for (uintmax_t i = 0; i < SPILL_ITEMS; i++) {
+        assert_true(octopus_concurrent_linked_queue_add(arg, &i));
+    }
+    return NULL;
+}
+
+static void check_spill_concurrently(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 2));
+    assert_true(octopus_concurrent_linked_queue_attach_spill(
+            &object, P_tmpdir, 16));
+    pthread_t threads[2];
+    for (uintmax_t i = 0; i < 2; i++) {
+        assert_int_equal(0, pthread_create(
+                &threads[i], NULL, check_spill_concurrently_producer,
+                &object));
+    }
+    uintmax_t sum = 0;
+    uintmax_t out;
+    for (uintmax_t i = 0; i < 2 * SPILL_ITEMS; i++) {
+        while (!octopus_concurrent_linked_queue_remove(
+                &object, (void **) &out)) {
+            assert_int_equal(
+                    OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                    octopus_error);
+        }
+        sum += out;
+    }
+    for (uintmax_t i = 0; i < 2; i++) {
+        assert_int_equal(0, pthread_join(threads[i], NULL));
+    }
+    assert_int_equal(sum, (uintmax_t) SPILL_ITEMS * (SPILL_ITEMS - 1));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_set_probes_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_queue_set_probes(NULL, 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_moves_on_from_busy_shard(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 2));
+    assert_true(octopus_concurrent_linked_queue_set_probes(&object, 2));
+    /* the first ticket selects the first shard */
+    assert_false(pthread_mutex_lock(&object.queues[0].enqueue));
+    const uintmax_t item = 42;
+    assert_true(octopus_concurrent_linked_queue_add(&object, &item));
+    assert_false(pthread_mutex_unlock(&object.queues[0].enqueue));
+    uintmax_t count;
+    assert_true(octopus_linked_queue_count(&object.queues[0], &count));
+    assert_int_equal(count, 0);
+    assert_true(octopus_linked_queue_count(&object.queues[1], &count));
+    assert_int_equal(count, 1);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_moves_reservation_from_busy_shard(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init_with_capacity(
+            &object, sizeof(uintmax_t), 2, 2));
+    assert_true(octopus_concurrent_linked_queue_set_probes(&object, 2));
+    assert_false(pthread_mutex_lock(&object.queues[0].enqueue));
+    const uintmax_t item = 42;
+    assert_true(octopus_concurrent_linked_queue_add(&object, &item));
+    assert_false(pthread_mutex_unlock(&object.queues[0].enqueue));
+    /* the second ticket finds its shard full and uses the space left
+     * behind in the first shard */
+    assert_true(octopus_concurrent_linked_queue_add(&object, &item));
+    assert_false(octopus_concurrent_linked_queue_add(&object, &item));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_FULL,
+                     octopus_error);
+    uintmax_t count;
+    assert_true(octopus_linked_queue_count(&object.queues[0], &count));
+    assert_int_equal(count, 1);
+    assert_true(octopus_linked_queue_count(&object.queues[1], &count));
+    assert_int_equal(count, 1);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_moves_on_from_busy_shard(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 2));
+    assert_true(octopus_concurrent_linked_queue_set_probes(&object, 2));
+    for (uintmax_t i = 0; i < 2; i++) {
+        assert_true(octopus_concurrent_linked_queue_add(&object, &i));
+    }
+    /* the first ticket selects the first shard */
+    assert_false(pthread_mutex_lock(&object.queues[0].dequeue));
+    uintmax_t out;
+    assert_true(octopus_concurrent_linked_queue_remove(
+            &object, (void **) &out));
+    assert_int_equal(out, 1);
+    assert_false(pthread_mutex_unlock(&object.queues[0].dequeue));
+    assert_true(octopus_concurrent_linked_queue_remove(
+            &object, (void **) &out));
+    assert_int_equal(out, 0);
+    assert_false(octopus_concurrent_linked_queue_remove(
+            &object, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                     octopus_error);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+#define PROBE_ITEMS 20000
+
+static void *check_probes_concurrently_producer(void *arg) {
+    struct octopus_concurrent_linked_queue *const object = arg;
+    for (uintmax_t i = 0; i < PROBE_ITEMS; i++) {
+        assert_true(octopus_concurrent_linked_queue_put(object, &i, NULL));
+    }
+    return NULL;
+}
+
+static void check_probes_concurrently(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init_with_capacity(
+            &object, sizeof(uintmax_t), 4, 64));
+    assert_true(octopus_concurrent_linked_queue_set_probes(&object, 4));
+    pthread_t threads[4];
+    for (uintmax_t i = 0; i < 4; i++) {
+        assert_int_equal(0, pthread_create(
+                &threads[i], NULL, check_probes_concurrently_producer,
+                &object));
+    }
+    uintmax_t sum = 0;
+    uintmax_t out;
+    for (uintmax_t i = 0; i < 4 * PROBE_ITEMS; i++) {
+        while (!octopus_concurrent_linked_queue_remove(
+                &object, (void **) &out)) {
+            assert_int_equal(
+                    OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                    octopus_error);
+        }
+        sum += out;
+    }
+    for (uintmax_t i = 0; i < 4; i++) {
+        assert_int_equal(0, pthread_join(threads[i], NULL));
+    }
+    assert_int_equal(sum, (uintmax_t) 2 * PROBE_ITEMS * (PROBE_ITEMS - 1));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_attach_staging_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_queue_attach_staging(
+            NULL, 1, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_attach_staging_error_on_count_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_queue_attach_staging(
+            (void *) 1, 0, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_COUNT_IS_ZERO,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_attach_staging_error_on_size_is_too_large(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 1));
+    assert_false(octopus_concurrent_linked_queue_attach_staging(
+            &object, UINTMAX_MAX, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_SIZE_IS_TOO_LARGE,
+                     octopus_error);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_attach_staging_error_on_staging_is_attached(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 1));
+    assert_true(octopus_concurrent_linked_queue_attach_staging(
+            &object, 4, NULL));
+    assert_false(octopus_concurrent_linked_queue_attach_staging(
+            &object, 4, NULL));
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_STAGING_IS_ATTACHED,
+            octopus_error);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_stage_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_queue_stage(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_stage_error_on_item_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_queue_stage((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_ITEM_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_stage_error_on_staging_is_not_attached(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 1));
+    const uintmax_t item = 1;
+    assert_false(octopus_concurrent_linked_queue_stage(&object, &item));
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_STAGING_IS_NOT_ATTACHED,
+            octopus_error);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_stage_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 1));
+    assert_true(octopus_concurrent_linked_queue_attach_staging(
+            &object, 4, NULL));
+    const uintmax_t item = 1;
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_false(octopus_concurrent_linked_queue_stage(&object, &item));
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_stage(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 4));
+    assert_true(octopus_concurrent_linked_queue_attach_staging(
+            &object, 8, NULL));
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_concurrent_linked_queue_stage(&object, &i));
+    }
+    /* staged items are not seen until they are flushed */
+    uintmax_t out;
+    assert_false(octopus_concurrent_linked_queue_remove(
+            &object, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                     octopus_error);
+    assert_int_equal(atomic_load(&object.enqueue), 0);
+    assert_true(octopus_concurrent_linked_queue_flush(&object));
+    /* all of them went to one shard for a single ticket */
+    assert_int_equal(atomic_load(&object.enqueue), 1);
+    assert_true(octopus_linked_queue_count(&object.queues[0], &out));
+    assert_int_equal(out, 3);
+    for (uintmax_t i = 0; i < 3; i++) {
+        atomic_store(&object.dequeue, 0);
+        assert_true(octopus_concurrent_linked_queue_remove(
+                &object, (void **) &out));
+        assert_int_equal(out, i);
+    }
+    /* nothing is left to flush */
+    assert_true(octopus_concurrent_linked_queue_flush(&object));
+    assert_int_equal(atomic_load(&object.enqueue), 1);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_stage_flushes_when_full(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 1));
+    assert_true(octopus_concurrent_linked_queue_attach_staging(
+            &object, 3, NULL));
+    uintmax_t out;
+    for (uintmax_t i = 0; i < 2; i++) {
+        assert_true(octopus_concurrent_linked_queue_stage(&object, &i));
+        assert_true(octopus_linked_queue_count(&object.queues[0], &out));
+        assert_int_equal(out, 0);
+    }
+    const uintmax_t item = 2;
+    assert_true(octopus_concurrent_linked_queue_stage(&object, &item));
+    assert_true(octopus_linked_queue_count(&object.queues[0], &out));
+    assert_int_equal(out, 3);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_stage_flushes_after_latency(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 1));
+    const struct timespec latency = {0};
+    assert_true(octopus_concurrent_linked_queue_attach_staging(
+            &object, 8, &latency));
+    uintmax_t out;
+    for (uintmax_t i = 0; i < 3; i++) {
+        /* the items staged before have had their time */
+        assert_true(octopus_concurrent_linked_queue_stage(&object, &i));
+        assert_true(octopus_linked_queue_count(&object.queues[0], &out));
+        assert_int_equal(out, i);
+    }
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_stage_error_on_queue_is_full(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init_with_capacity(
+            &object, sizeof(uintmax_t), 2, 2));
+    assert_true(octopus_concurrent_linked_queue_attach_staging(
+            &object, 2, NULL));
+    /* the first two fill the queue, the next two fill the buffer */
+    for (uintmax_t i = 0; i < 4; i++) {
+        assert_true(octopus_concurrent_linked_queue_stage(&object, &i));
+    }
+    const uintmax_t item = 4;
+    assert_false(octopus_concurrent_linked_queue_stage(&object, &item));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_FULL,
+                     octopus_error);
+    uintmax_t sum = 0;
+    uintmax_t out;
+    assert_true(octopus_concurrent_linked_queue_remove(
+            &object, (void **) &out));
+    sum += out;
+    /* only one of the staged items fits */
+    assert_false(octopus_concurrent_linked_queue_flush(&object));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_FULL,
+                     octopus_error);
+    assert_true(octopus_concurrent_linked_queue_remove(
+            &object, (void **) &out));
+    sum += out;
+    assert_true(octopus_concurrent_linked_queue_flush(&object));
+    for (uintmax_t i = 0; i < 2; i++) {
+        assert_true(octopus_concurrent_linked_queue_remove(
+                &object, (void **) &out));
+        sum += out;
+    }
+    assert_int_equal(sum, 0 + 1 + 2 + 3);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_flush_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_queue_flush(NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_flush_error_on_staging_is_not_attached(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 1));
+    assert_false(octopus_concurrent_linked_queue_flush(&object));
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_STAGING_IS_NOT_ATTACHED,
+            octopus_error);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_flush_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 1));
+    assert_true(octopus_concurrent_linked_queue_attach_staging(
+            &object, 8, NULL));
+    for (uintmax_t i = 0; i < 2; i++) {
+        assert_true(octopus_concurrent_linked_queue_stage(&object, &i));
+    }
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_false(octopus_concurrent_linked_queue_flush(&object));
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    uintmax_t out;
+    assert_true(octopus_linked_queue_count(&object.queues[0], &out));
+    assert_int_equal(out, 0);
+    /* the items are still staged */
+    assert_true(octopus_concurrent_linked_queue_flush(&object));
+    assert_true(octopus_linked_queue_count(&object.queues[0], &out));
+    assert_int_equal(out, 2);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void *check_stage_flushes_on_thread_exit_producer(void *arg) {
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_concurrent_linked_queue_stage(arg, &i));
+    }
+    return NULL;
+}
+
+static void check_stage_flushes_on_thread_exit(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 1));
+    assert_true(octopus_concurrent_linked_queue_attach_staging(
+            &object, 8, NULL));
+    uintmax_t usage[2];
+    for (uintmax_t i = 0; i < 2; i++) {
+        pthread_t thread;
+        assert_int_equal(0, pthread_create(
+                &thread, NULL, check_stage_flushes_on_thread_exit_producer,
+                &object));
+        assert_int_equal(0, pthread_join(thread, NULL));
+        uintmax_t out;
+        assert_true(octopus_linked_queue_count(&object.queues[0], &out));
+        assert_int_equal(out, 3);
+        for (uintmax_t k = 0; k < 3; k++) {
+            assert_true(octopus_concurrent_linked_queue_remove(
+                    &object, (void **) &out));
+            assert_int_equal(out, k);
+        }
+        assert_true(octopus_concurrent_linked_queue_memory_usage(
+                &object, &usage[i]));
+    }
+    /* the second thread took over the buffer of the first */
+    assert_int_equal(usage[0], usage[1]);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static pthread_barrier_t quiet;
+
+static void *check_remove_flushes_quiet_producer_producer(void *arg) {
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_concurrent_linked_queue_stage(arg, &i));
+    }
+    /* stays alive without staging nor flushing */
+    pthread_barrier_wait(&quiet);
+    pthread_barrier_wait(&quiet);
+    return NULL;
+}
+
+static void check_remove_flushes_quiet_producer(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 1));
+    const struct timespec latency = {.tv_nsec = 50000000};
+    assert_true(octopus_concurrent_linked_queue_attach_staging(
+            &object, 8, &latency));
+    assert_int_equal(0, pthread_barrier_init(&quiet, NULL, 2));
+    pthread_t thread;
+    assert_int_equal(0, pthread_create(
+            &thread, NULL, check_remove_flushes_quiet_producer_producer,
+            &object));
+    pthread_barrier_wait(&quiet);
+    uintmax_t out;
+    assert_false(octopus_concurrent_linked_queue_remove(
+            &object, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                     octopus_error);
+    const struct timespec pause = {.tv_nsec = 100000000};
+    assert_int_equal(0, nanosleep(&pause, NULL));
+    /* the consumer adds the items once their latency has passed */
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_concurrent_linked_queue_remove(
+                &object, (void **) &out));
+        assert_int_equal(out, i);
+    }
+    assert_false(octopus_concurrent_linked_queue_remove(
+            &object, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                     octopus_error);
+    pthread_barrier_wait(&quiet);
+    assert_int_equal(0, pthread_join(thread, NULL));
+    assert_int_equal(0, pthread_barrier_destroy(&quiet));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static uintmax_t destroyed;
+
+static void on_destroy(void *item) {
+    /* the item itself is handed over rather than its address */
+    destroyed += (uintmax_t) item;
+}
+
+static void check_stage_invalidate(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 2));
+    assert_true(octopus_concurrent_linked_queue_attach_staging(
+            &object, 8, NULL));
+    for (uintmax_t i = 1; i <= 4; i++) {
+        assert_true(octopus_concurrent_linked_queue_stage(&object, &i));
+    }
+    const uintmax_t item = 5;
+    assert_true(octopus_concurrent_linked_queue_add(&object, &item));
+    destroyed = 0;
+    assert_true(octopus_concurrent_linked_queue_invalidate(
+            &object, on_destroy));
+    assert_int_equal(destroyed, 15);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+#define STAGE_ITEMS 20000
+
+static void *check_stage_concurrently_producer(void *arg) {
+    for (uintmax_t i = 0; i < STAGE_ITEMS; i++) {
+        assert_true(octopus_concurrent_linked_queue_stage(arg, &i));
+    }
+    assert_true(octopus_concurrent_linked_queue_flush(arg));
+    return NULL;
+}
+
+static void check_stage_concurrently(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 4));
+    const struct timespec latency = {
+            .tv_nsec = 100000
+    };
+    assert_true(octopus_concurrent_linked_queue_attach_staging(
+            &object, 16, &latency));
+    pthread_t threads[4];
+    for (uintmax_t i = 0; i < 4; i++) {
+        assert_int_equal(0, pthread_create(
+                &threads[i], NULL, check_stage_concurrently_producer,
+                &object));
+    }
+    uintmax_t sum = 0;
+    uintmax_t out;
+    for (uintmax_t i = 0; i < 4 * STAGE_ITEMS; i++) {
+        while (!octopus_concurrent_linked_queue_remove(
+                &object, (void **) &out)) {
+            assert_int_equal(
+                    OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                    octopus_error);
+        }
+        sum += out;
+    }
+    for (uintmax_t i = 0; i < 4; i++) {
+        assert_int_equal(0, pthread_join(threads[i], NULL));
+    }
+    assert_int_equal(sum, (uintmax_t) 2 * STAGE_ITEMS * (STAGE_ITEMS - 1));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_attach_combining_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_linked_queue_attach_combining(NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_attach_combining_error_on_combining_is_attached(
+        void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 1));
+    assert_true(octopus_concurrent_linked_queue_attach_combining(&object));
+    assert_false(octopus_concurrent_linked_queue_attach_combining(&object));
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_COMBINING_IS_ATTACHED,
+            octopus_error);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_attach_combining_error_on_memory_allocation_failed(
+        void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 1));
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_false(octopus_concurrent_linked_queue_attach_combining(&object));
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    assert_null(object.combiners);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_combining(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 1));
+    assert_true(octopus_concurrent_linked_queue_attach_combining(&object));
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_concurrent_linked_queue_add(&object, &i));
+    }
+    uintmax_t out;
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_concurrent_linked_queue_remove(
+                &object, (void **) &out));
+        assert_int_equal(out, i);
+    }
+    assert_false(octopus_concurrent_linked_queue_remove(
+            &object, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                     octopus_error);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_combining_without_record(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 1));
+    assert_true(octopus_concurrent_linked_queue_attach_combining(&object));
+    const uintmax_t item = 7;
+    assert_true(octopus_linked_queue_add(&object.queues[0], &item));
+    uintmax_t out;
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    /* the record cannot be allocated so the shard is locked instead */
+    assert_true(octopus_concurrent_linked_queue_remove(
+            &object, (void **) &out));
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+    assert_int_equal(out, item);
+    assert_null(atomic_load(&object.records));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void *check_combining_reuses_record_producer(void *arg) {
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_concurrent_linked_queue_add(arg, &i));
+    }
+    return NULL;
+}
+
+static void check_combining_reuses_record(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 1));
+    assert_true(octopus_concurrent_linked_queue_attach_combining(&object));
+    uintmax_t usage[2];
+    for (uintmax_t i = 0; i < 2; i++) {
+        pthread_t thread;
+        assert_int_equal(0, pthread_create(
+                &thread, NULL, check_combining_reuses_record_producer,
+                &object));
+        assert_int_equal(0, pthread_join(thread, NULL));
+        uintmax_t out;
+        for (uintmax_t k = 0; k < 3; k++) {
+            assert_true(octopus_linked_queue_remove(
+                    &object.queues[0], (void **) &out));
+            assert_int_equal(out, k);
+        }
+        assert_true(octopus_concurrent_linked_queue_memory_usage(
+                &object, &usage[i]));
+    }
+    /* the second thread took over the record of the first */
+    assert_int_equal(usage[0], usage[1]);
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_combining_invalidate(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 2));
+    assert_true(octopus_concurrent_linked_queue_attach_combining(&object));
+    for (uintmax_t i = 1; i <= 5; i++) {
+        assert_true(octopus_concurrent_linked_queue_add(&object, &i));
+    }
+    destroyed = 0;
+    assert_true(octopus_concurrent_linked_queue_invalidate(
+            &object, on_destroy));
+    assert_int_equal(destroyed, 15);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+#define COMBINE_ITEMS 20000
+
+static void *check_combining_concurrently_worker(void *arg) {
+    for (uintmax_t i = 0; i < COMBINE_ITEMS; i++) {
+        assert_true(octopus_concurrent_linked_queue_add(arg, &i));
+        uintmax_t out;
+        while (!octopus_concurrent_linked_queue_remove(arg, (void **) &out)) {
+            assert_int_equal(
+                    OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                    octopus_error);
+        }
+    }
+    return NULL;
+}
+
+static void *check_combining_concurrently_producer(void *arg) {
+    for (uintmax_t i = 0; i < COMBINE_ITEMS; i++) {
+        assert_true(octopus_concurrent_linked_queue_add(arg, &i));
+    }
+    return NULL;
+}
+
+static void check_combining_concurrently(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue object;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &object, sizeof(uintmax_t), 2));
+    assert_true(octopus_concurrent_linked_queue_attach_combining(&object));
+    pthread_t threads[4];
+    for (uintmax_t i = 0; i < 4; i++) {
+        assert_int_equal(0, pthread_create(
+                &threads[i], NULL, i % 2
+                                   ? check_combining_concurrently_worker
+                                   : check_combining_concurrently_producer,
+                &object));
+    }
+    uintmax_t count = 0;
+    uintmax_t out;
+    /* the workers take as many items as they add, so only those of the two
+     * producers are left for us */
+    while (count < 2 * COMBINE_ITEMS) {
+        if (octopus_concurrent_linked_queue_remove(&object, (void **) &out)) {
+            count++;
+            continue;
+        }
+        assert_int_equal(
+                OCTOPUS_CONCURRENT_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                octopus_error);
+    }
+    for (uintmax_t i = 0; i < 4; i++) {
+        assert_int_equal(0, pthread_join(threads[i], NULL));
+    }
+    assert_false(octopus_concurrent_linked_queue_remove(
+            &object, (void **) &out));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
 int main(int argc, char *argv[]) {
     const struct CMUnitTest tests[] = {
             cmocka_unit_test(check_invalidate_error_on_object_is_null),
@@ -427,9 +1877,11 @@ int main(int argc, char *argv[]) {
             cmocka_unit_test(check_concurrency_error_on_object_is_null),
             cmocka_unit_test(check_concurrency_error_on_out_is_null),
             cmocka_unit_test(check_concurrency),
+            cmocka_unit_test(check_concurrency_is_rounded_up),
             cmocka_unit_test(check_add_error_on_object_is_null),
             cmocka_unit_test(check_add_error_on_out_is_null),
             cmocka_unit_test(check_add),
+            cmocka_unit_test(check_add_wraps_around_shards),
             cmocka_unit_test(check_add_error_on_memory_allocation_failed),
             cmocka_unit_test(check_remove_error_on_object_is_null),
             cmocka_unit_test(check_remove_error_on_out_is_null),
@@ -443,6 +1895,79 @@ int main(int argc, char *argv[]) {
             cmocka_unit_test(check_peek_case_enqueue_dequeue_aligned),
             cmocka_unit_test(check_peek_case_enqueue_dequeue_misaligned),
             cmocka_unit_test(check_peek_case_enqueue_dequeue_integer_overflow),
+            cmocka_unit_test(check_init_with_capacity_error_on_object_is_null),
+            cmocka_unit_test(
+                    check_init_with_capacity_error_on_memory_allocation_failed),
+            cmocka_unit_test(
+                    check_init_with_allocator_error_on_allocator_is_invalid),
+            cmocka_unit_test(
+                    check_init_with_allocator_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_init_with_allocator),
+            cmocka_unit_test(check_capacity_error_on_object_is_null),
+            cmocka_unit_test(check_capacity_error_on_out_is_null),
+            cmocka_unit_test(check_capacity),
+            cmocka_unit_test(check_add_error_on_queue_is_full),
+            cmocka_unit_test(check_add_moves_on_from_full_shard),
+            cmocka_unit_test(check_put_error_on_object_is_null),
+            cmocka_unit_test(check_put_error_on_item_is_null),
+            cmocka_unit_test(check_put_error_on_timeout_is_invalid),
+            cmocka_unit_test(check_put_with_longest_timeout),
+            cmocka_unit_test(check_put_error_on_timed_out),
+            cmocka_unit_test(check_put_waits_for_space),
+            cmocka_unit_test(check_memory_usage_error_on_object_is_null),
+            cmocka_unit_test(check_memory_usage_error_on_out_is_null),
+            cmocka_unit_test(check_memory_usage),
+            cmocka_unit_test(check_trim_error_on_object_is_null),
+            cmocka_unit_test(check_trim),
+            cmocka_unit_test(check_attach_spill_error_on_object_is_null),
+            cmocka_unit_test(check_attach_spill_error_on_directory_is_null),
+            cmocka_unit_test(check_attach_spill_error_on_spill_failed),
+            cmocka_unit_test(check_attach_spill),
+            cmocka_unit_test(check_spill_concurrently),
+            cmocka_unit_test(check_set_probes_error_on_object_is_null),
+            cmocka_unit_test(check_add_moves_on_from_busy_shard),
+            cmocka_unit_test(check_add_moves_reservation_from_busy_shard),
+            cmocka_unit_test(check_remove_moves_on_from_busy_shard),
+            cmocka_unit_test(check_probes_concurrently),
+            cmocka_unit_test(check_attach_staging_error_on_object_is_null),
+            cmocka_unit_test(check_attach_staging_error_on_count_is_zero),
+            cmocka_unit_test(check_attach_staging_error_on_size_is_too_large),
+            cmocka_unit_test(check_attach_staging_error_on_staging_is_attached),
+            cmocka_unit_test(check_stage_error_on_object_is_null),
+            cmocka_unit_test(check_stage_error_on_item_is_null),
+            cmocka_unit_test(check_stage_error_on_staging_is_not_attached),
+            cmocka_unit_test(check_stage_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_stage),
+            cmocka_unit_test(check_stage_flushes_when_full),
+            cmocka_unit_test(check_stage_flushes_after_latency),
+            cmocka_unit_test(check_stage_error_on_queue_is_full),
+            cmocka_unit_test(check_flush_error_on_object_is_null),
+            cmocka_unit_test(check_flush_error_on_staging_is_not_attached),
+            cmocka_unit_test(check_flush_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_stage_flushes_on_thread_exit),
+            cmocka_unit_test(check_remove_flushes_quiet_producer),
+            cmocka_unit_test(check_stage_invalidate),
+            cmocka_unit_test(check_stage_concurrently),
+            cmocka_unit_test(check_attach_combining_error_on_object_is_null),
+            cmocka_unit_test(
+                    check_attach_combining_error_on_combining_is_attached),
+            cmocka_unit_test(
+                    check_attach_combining_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_combining),
+            cmocka_unit_test(check_combining_without_record),
+            cmocka_unit_test(check_combining_reuses_record),
+            cmocka_unit_test(check_combining_invalidate),
+            cmocka_unit_test(check_combining_concurrently),
+            cmocka_unit_test(check_attach_event_fd_error_on_object_is_null),
+            cmocka_unit_test(check_event_fd_error_on_object_is_null),
+            cmocka_unit_test(check_event_fd_error_on_out_is_null),
+            cmocka_unit_test(check_event_fd_error_on_event_fd_is_not_attached),
+#ifdef __linux__
+            cmocka_unit_test(check_event_fd),
+            cmocka_unit_test(check_attach_event_fd_when_not_empty),
+            cmocka_unit_test(check_event_fd_settles_late_write),
+            cmocka_unit_test(check_event_fd_concurrently),
+#endif /* __linux__ */
     };
     //cmocka_set_message_output(CM_OUTPUT_XML);
     return cmocka_run_group_tests(tests, NULL, NULL);
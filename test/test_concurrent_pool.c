@@ -0,0 +1,374 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <pthread.h>
+#include <octopus.h>
+
+#include "private/concurrent_pool.h"
+
+#include <test/cmocka.h>
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_pool_invalidate(NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_POOL_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_pool_init(NULL, 1, 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_POOL_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_size_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_pool_init((void *) 1, 0, 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_POOL_ERROR_SIZE_IS_ZERO,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_batch_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_pool_init((void *) 1, 1, 0));
+    assert_int_equal(OCTOPUS_CONCURRENT_POOL_ERROR_BATCH_IS_ZERO,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_size_is_too_large(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_pool object;
+    assert_false(octopus_concurrent_pool_init(&object, SIZE_MAX, 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_POOL_ERROR_SIZE_IS_TOO_LARGE,
+                     octopus_error);
+    assert_false(octopus_concurrent_pool_init(
+            &object, 1, (uintmax_t) UINT32_MAX + 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_POOL_ERROR_SIZE_IS_TOO_LARGE,
+                     octopus_error);
+    assert_false(octopus_concurrent_pool_init(
+            &object, SIZE_MAX >> 3, UINT32_MAX));
+    assert_int_equal(OCTOPUS_CONCURRENT_POOL_ERROR_SIZE_IS_TOO_LARGE,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_pool object;
+    assert_true(octopus_concurrent_pool_init(&object, 1, 4));
+    assert_int_equal(object.size, 1);
+    assert_int_equal(object.batch, 4);
+    assert_int_equal(object.stride % OCTOPUS_CACHE_LINE_SIZE, 0);
+    assert_true(object.stride >= sizeof(struct octopus_concurrent_pool_free));
+    assert_int_equal(object.slab, OCTOPUS_CONCURRENT_POOL_SLAB_SIZE);
+    assert_int_equal(object.header % OCTOPUS_CACHE_LINE_SIZE, 0);
+    assert_true(object.header
+                >= sizeof(struct octopus_concurrent_pool_slab)
+                   + object.objects * sizeof(atomic_uint_least32_t));
+    assert_true(object.header + object.objects * object.stride
+                <= object.slab);
+    assert_null(atomic_load(&object.table));
+    assert_int_equal(atomic_load(&object.depot), 0);
+    assert_true(octopus_concurrent_pool_invalidate(&object));
+    /* slab grows until it holds a whole batch */
+    assert_true(octopus_concurrent_pool_init(&object, 4096, 64));
+    assert_true(object.objects >= 64);
+    assert_int_equal(object.objects % object.batch, 0);
+    assert_int_equal(object.slab & (object.slab - 1), 0);
+    assert_true(object.slab > OCTOPUS_CONCURRENT_POOL_SLAB_SIZE);
+    assert_true(octopus_concurrent_pool_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_allocate_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_pool_allocate(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_POOL_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_allocate_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_pool_allocate((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_POOL_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_allocate_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_pool object;
+    assert_true(octopus_concurrent_pool_init(&object, sizeof(uintmax_t), 8));
+    void *out;
+    /* no cache for this thread yet */
+    posix_memalign_is_overridden = true;
+    assert_false(octopus_concurrent_pool_allocate(&object, &out));
+    posix_memalign_is_overridden = false;
+    assert_int_equal(OCTOPUS_CONCURRENT_POOL_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    /* no table for the first slab */
+    malloc_is_overridden = true;
+    assert_false(octopus_concurrent_pool_allocate(&object, &out));
+    malloc_is_overridden = false;
+    assert_int_equal(OCTOPUS_CONCURRENT_POOL_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    /* no memory for a further slab */
+    for (uintmax_t i = 0; i < object.objects; i++) {
+        assert_true(octopus_concurrent_pool_allocate(&object, &out));
+    }
+    posix_memalign_is_overridden = true;
+    assert_false(octopus_concurrent_pool_allocate(&object, &out));
+    posix_memalign_is_overridden = false;
+    assert_int_equal(OCTOPUS_CONCURRENT_POOL_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    assert_true(octopus_concurrent_pool_allocate(&object, &out));
+    assert_int_equal(atomic_load(&object.table)->count, 2);
+    assert_true(octopus_concurrent_pool_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_allocate(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_pool object;
+    assert_true(octopus_concurrent_pool_init(&object, 24, 8));
+    const uintmax_t count = 3 * object.objects;
+    unsigned char **items = calloc(count, sizeof(*items));
+    assert_non_null(items);
+    for (uintmax_t i = 0; i < count; i++) {
+        assert_true(octopus_concurrent_pool_allocate(
+                &object, (void **) &items[i]));
+        assert_int_equal((uintptr_t) items[i] % OCTOPUS_CACHE_LINE_SIZE, 0);
+        memset(items[i], (int) i, 24);
+    }
+    for (uintmax_t i = 0; i < count; i++) {
+        for (uintmax_t j = 0; j < 24; j++) {
+            assert_int_equal(items[i][j], (unsigned char) i);
+        }
+    }
+    assert_int_equal(atomic_load(&object.table)->count, 3);
+    assert_int_equal(atomic_load(&object.depot) & UINT32_MAX, 0);
+    free(items);
+    assert_true(octopus_concurrent_pool_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_release_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_pool_release(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_POOL_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_release_error_on_item_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_pool_release((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_POOL_ERROR_ITEM_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_release(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_pool object;
+    assert_true(octopus_concurrent_pool_init(&object, sizeof(uintmax_t), 4));
+    void *items[8];
+    for (uintmax_t i = 0; i < 8; i++) {
+        assert_true(octopus_concurrent_pool_allocate(&object, &items[i]));
+    }
+    struct octopus_concurrent_pool_cache *const cache = pthread_getspecific(
+            object.key);
+    assert_non_null(cache);
+    assert_int_equal(cache->count, 0);
+    /* last released is handed out first */
+    assert_true(octopus_concurrent_pool_release(&object, items[0]));
+    void *out;
+    assert_true(octopus_concurrent_pool_allocate(&object, &out));
+    assert_ptr_equal(out, items[0]);
+    const uint_least64_t depot = atomic_load(&object.depot);
+    for (uintmax_t i = 0; i < 7; i++) {
+        assert_true(octopus_concurrent_pool_release(&object, items[i]));
+    }
+    assert_int_equal(cache->count, 7);
+    assert_int_equal(atomic_load(&object.depot), depot);
+    /* twice the batch in the cache hands the older half over */
+    assert_true(octopus_concurrent_pool_release(&object, items[7]));
+    assert_int_equal(cache->count, 4);
+    assert_int_not_equal(atomic_load(&object.depot), depot);
+    for (uintmax_t i = 7; i >= 4; i--) {
+        assert_true(octopus_concurrent_pool_allocate(&object, &out));
+        assert_ptr_equal(out, items[i]);
+    }
+    /* the older half comes back from the global list */
+    for (uintmax_t i = 0; i < 4; i++) {
+        assert_true(octopus_concurrent_pool_allocate(&object, &out));
+        assert_ptr_equal(out, items[3 - i]);
+    }
+    assert_true(octopus_concurrent_pool_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_release_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_pool object;
+    assert_true(octopus_concurrent_pool_init(&object, sizeof(uintmax_t), 4));
+    uintmax_t item;
+    posix_memalign_is_overridden = true;
+    assert_false(octopus_concurrent_pool_release(&object, &item));
+    posix_memalign_is_overridden = false;
+    assert_int_equal(OCTOPUS_CONCURRENT_POOL_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    assert_true(octopus_concurrent_pool_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_flush_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_pool_flush(NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_POOL_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_flush(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_pool object;
+    assert_true(octopus_concurrent_pool_init(&object, sizeof(uintmax_t), 4));
+    /* without a cache there is nothing to do */
+    assert_true(octopus_concurrent_pool_flush(&object));
+    void *out;
+    assert_true(octopus_concurrent_pool_allocate(&object, &out));
+    struct octopus_concurrent_pool_cache *const cache = pthread_getspecific(
+            object.key);
+    assert_int_equal(cache->count, 3);
+    assert_true(octopus_concurrent_pool_flush(&object));
+    assert_int_equal(cache->count, 0);
+    assert_null(cache->head);
+    /* every object in the slab is back on the global list */
+    uintmax_t count = 1;
+    while (count < object.objects) {
+        assert_true(octopus_concurrent_pool_allocate(&object, &out));
+        count++;
+    }
+    assert_int_equal(atomic_load(&object.depot) & UINT32_MAX, 0);
+    assert_int_equal(atomic_load(&object.table)->count, 1);
+    assert_true(octopus_concurrent_pool_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+#define ITEMS                                   500
+
+static void *check_thread_exit_releaser(void *arg) {
+    void **items = arg;
+    struct octopus_concurrent_pool *const object = items[ITEMS];
+    for (uintmax_t i = 0; i < ITEMS; i++) {
+        assert_true(octopus_concurrent_pool_release(object, items[i]));
+    }
+    return NULL;
+}
+
+static void check_thread_exit(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_pool object;
+    assert_true(octopus_concurrent_pool_init(&object, sizeof(uintmax_t), 16));
+    void *items[ITEMS + 1];
+    for (uintmax_t i = 0; i < ITEMS; i++) {
+        assert_true(octopus_concurrent_pool_allocate(&object, &items[i]));
+    }
+    items[ITEMS] = &object;
+    pthread_t thread;
+    assert_int_equal(0, pthread_create(&thread, NULL,
+                                       check_thread_exit_releaser, items));
+    assert_int_equal(0, pthread_join(thread, NULL));
+    /* the exited thread's cache was flushed and is up for adoption */
+    uintmax_t caches = 0;
+    for (struct octopus_concurrent_pool_cache *cache
+            = atomic_load(&object.caches); cache; cache = cache->next) {
+        caches++;
+        if (cache != pthread_getspecific(object.key)) {
+            assert_false(atomic_load(&cache->used));
+            assert_int_equal(cache->count, 0);
+        }
+    }
+    assert_int_equal(caches, 2);
+    for (uintmax_t i = 0; i < object.objects - 1; i++) {
+        void *out;
+        assert_true(octopus_concurrent_pool_allocate(&object, &out));
+    }
+    assert_int_equal(atomic_load(&object.table)->count, 1);
+    assert_true(octopus_concurrent_pool_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+#define THREADS                                 4
+#define ROUNDS                                  2000
+
+static void *check_concurrently_worker(void *arg) {
+    struct octopus_concurrent_pool *const object = arg;
+    uintmax_t *items[64];
+    for (uintmax_t round = 0; round < ROUNDS; round++) {
+        const uintmax_t count = 1 + round % 64;
+        for (uintmax_t i = 0; i < count; i++) {
+            assert_true(octopus_concurrent_pool_allocate(
+                    object, (void **) &items[i]));
+            *items[i] = (uintptr_t) &items[i];
+        }
+        for (uintmax_t i = 0; i < count; i++) {
+            /* nobody else was handed the same object */
+            assert_int_equal(*items[i], (uintptr_t) &items[i]);
+            assert_true(octopus_concurrent_pool_release(object, items[i]));
+        }
+    }
+    return NULL;
+}
+
+static void check_concurrently(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_pool object;
+    assert_true(octopus_concurrent_pool_init(&object, sizeof(uintmax_t), 8));
+    pthread_t threads[THREADS];
+    for (uintmax_t i = 0; i < THREADS; i++) {
+        assert_int_equal(0, pthread_create(&threads[i], NULL,
+                                           check_concurrently_worker,
+                                           &object));
+    }
+    for (uintmax_t i = 0; i < THREADS; i++) {
+        assert_int_equal(0, pthread_join(threads[i], NULL));
+    }
+    assert_int_equal(atomic_load(&object.table)->count, 1);
+    assert_true(octopus_concurrent_pool_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_size_is_zero),
+            cmocka_unit_test(check_init_error_on_batch_is_zero),
+            cmocka_unit_test(check_init_error_on_size_is_too_large),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_allocate_error_on_object_is_null),
+            cmocka_unit_test(check_allocate_error_on_out_is_null),
+            cmocka_unit_test(check_allocate_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_allocate),
+            cmocka_unit_test(check_release_error_on_object_is_null),
+            cmocka_unit_test(check_release_error_on_item_is_null),
+            cmocka_unit_test(check_release),
+            cmocka_unit_test(check_release_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_flush_error_on_object_is_null),
+            cmocka_unit_test(check_flush),
+            cmocka_unit_test(check_thread_exit),
+            cmocka_unit_test(check_concurrently),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
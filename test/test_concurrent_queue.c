@@ -0,0 +1,309 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <octopus.h>
+
+#include <test/cmocka.h>
+
+OCTOPUS_DEFINE_CONCURRENT_QUEUE(uintmax_queue, uintmax_t)
+
+struct pair {
+    uint32_t a;
+    uint64_t b;
+};
+
+OCTOPUS_DEFINE_CONCURRENT_QUEUE(pair_queue, struct pair)
+
+static void check_shards(void **state) {
+    uintmax_t out;
+    assert_true(octopus_concurrent_queue_shards(1, &out));
+    assert_int_equal(out, 1);
+    assert_true(octopus_concurrent_queue_shards(5, &out));
+    assert_int_equal(out, 8);
+    assert_true(octopus_concurrent_queue_shards(8, &out));
+    assert_int_equal(out, 8);
+    assert_false(octopus_concurrent_queue_shards(UINTMAX_MAX, &out));
+}
+
+static void check_in_window(void **state) {
+    assert_true(octopus_concurrent_queue_in_window(0, 8, 0));
+    assert_true(octopus_concurrent_queue_in_window(0, 8, 7));
+    assert_false(octopus_concurrent_queue_in_window(0, 8, 8));
+    assert_true(octopus_concurrent_queue_in_window(UINTMAX_MAX, 7, 0));
+    assert_true(octopus_concurrent_queue_in_window(UINTMAX_MAX, 7, 6));
+    assert_false(octopus_concurrent_queue_in_window(UINTMAX_MAX, 7, 7));
+}
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(uintmax_queue_invalidate(NULL, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_invalidate(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct uintmax_queue object = {};
+    assert_true(uintmax_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static uintmax_t on_destroy_count;
+
+static void on_destroy(uintmax_t *item) {
+    assert_int_equal(*item, on_destroy_count++);
+}
+
+static void check_invalidate_with_items(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct uintmax_queue object;
+    assert_true(uintmax_queue_init(&object, 1));
+    for (uintmax_t i = 0; i < 10; i++) {
+        assert_true(uintmax_queue_add(&object, i));
+    }
+    on_destroy_count = 0;
+    assert_true(uintmax_queue_invalidate(&object, on_destroy));
+    assert_int_equal(on_destroy_count, 10);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(uintmax_queue_init(NULL, 8));
+    assert_int_equal(OCTOPUS_CONCURRENT_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_concurrency_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(uintmax_queue_init((void *) 1, 0));
+    assert_int_equal(OCTOPUS_CONCURRENT_QUEUE_ERROR_CONCURRENCY_IS_ZERO,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct uintmax_queue object;
+    assert_true(uintmax_queue_init(&object, 5));
+    assert_int_equal(object.mask, 7);
+    assert_int_equal(atomic_load(&object.enqueue), 0);
+    assert_int_equal(atomic_load(&object.dequeue), 0);
+    assert_int_equal((uintptr_t) object.shards % OCTOPUS_CACHE_LINE_SIZE, 0);
+    assert_true(uintmax_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct uintmax_queue object;
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_false(uintmax_queue_init(&object, 8));
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+    assert_int_equal(OCTOPUS_CONCURRENT_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_concurrency_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(uintmax_queue_concurrency(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_concurrency_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(uintmax_queue_concurrency((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_QUEUE_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_concurrency(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct uintmax_queue object;
+    assert_true(uintmax_queue_init(&object, 3));
+    uintmax_t out;
+    assert_true(uintmax_queue_concurrency(&object, &out));
+    assert_int_equal(out, 4);
+    assert_true(uintmax_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(uintmax_queue_add(NULL, 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct uintmax_queue object;
+    assert_true(uintmax_queue_init(&object, 8));
+    malloc_is_overridden = true;
+    assert_false(uintmax_queue_add(&object, 1));
+    malloc_is_overridden = false;
+    assert_int_equal(OCTOPUS_CONCURRENT_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    assert_int_equal(atomic_load(&object.enqueue), 0);
+    assert_true(uintmax_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(uintmax_queue_remove(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(uintmax_queue_remove((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_QUEUE_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_queue_is_empty(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct uintmax_queue object;
+    assert_true(uintmax_queue_init(&object, 8));
+    uintmax_t out;
+    assert_false(uintmax_queue_remove(&object, &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                     octopus_error);
+    assert_true(uintmax_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_remove(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct uintmax_queue object;
+    assert_true(uintmax_queue_init(&object, 8));
+    const uintmax_t check = 3 * 64;
+    for (uintmax_t i = 0; i < check; i++) {
+        assert_true(uintmax_queue_add(&object, i));
+    }
+    assert_int_equal(atomic_load(&object.enqueue), check);
+    for (uintmax_t i = 0; i < check; i++) {
+        uintmax_t out;
+        assert_true(uintmax_queue_remove(&object, &out));
+        assert_int_equal(out, i);
+    }
+    uintmax_t out;
+    assert_false(uintmax_queue_remove(&object, &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                     octopus_error);
+    assert_true(uintmax_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_remove_struct(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct pair_queue object;
+    assert_true(pair_queue_init(&object, 2));
+    const struct pair check = {.a = 7, .b = UINT64_MAX};
+    assert_true(pair_queue_add(&object, check));
+    struct pair out;
+    assert_true(pair_queue_peek(&object, &out));
+    assert_int_equal(out.a, check.a);
+    assert_int_equal(out.b, check.b);
+    out = (struct pair) {0};
+    assert_true(pair_queue_remove(&object, &out));
+    assert_int_equal(out.a, check.a);
+    assert_int_equal(out.b, check.b);
+    assert_true(pair_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_case_enqueue_dequeue_integer_overflow(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct uintmax_queue object;
+    assert_true(uintmax_queue_init(&object, 8));
+    atomic_store(&object.enqueue, 2);
+    assert_true(uintmax_queue_add(&object, 42));
+    atomic_store(&object.dequeue, UINTMAX_MAX);
+    uintmax_t out;
+    assert_true(uintmax_queue_remove(&object, &out));
+    assert_int_equal(atomic_load(&object.dequeue), 3);
+    assert_int_equal(out, 42);
+    assert_false(uintmax_queue_remove(&object, &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                     octopus_error);
+    assert_true(uintmax_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_peek_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(uintmax_queue_peek(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_peek_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(uintmax_queue_peek((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_QUEUE_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_peek(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct uintmax_queue object;
+    assert_true(uintmax_queue_init(&object, 8));
+    uintmax_t out;
+    assert_false(uintmax_queue_peek(&object, &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                     octopus_error);
+    assert_true(uintmax_queue_add(&object, 1));
+    assert_true(uintmax_queue_add(&object, 2));
+    assert_true(uintmax_queue_peek(&object, &out));
+    assert_int_equal(out, 1);
+    assert_int_equal(atomic_load(&object.dequeue), 0);
+    assert_true(uintmax_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_shards),
+            cmocka_unit_test(check_in_window),
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_invalidate),
+            cmocka_unit_test(check_invalidate_with_items),
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_concurrency_is_zero),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_init_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_concurrency_error_on_object_is_null),
+            cmocka_unit_test(check_concurrency_error_on_out_is_null),
+            cmocka_unit_test(check_concurrency),
+            cmocka_unit_test(check_add_error_on_object_is_null),
+            cmocka_unit_test(check_add_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_remove_error_on_object_is_null),
+            cmocka_unit_test(check_remove_error_on_out_is_null),
+            cmocka_unit_test(check_remove_error_on_queue_is_empty),
+            cmocka_unit_test(check_add_remove),
+            cmocka_unit_test(check_add_remove_struct),
+            cmocka_unit_test(check_remove_case_enqueue_dequeue_integer_overflow),
+            cmocka_unit_test(check_peek_error_on_object_is_null),
+            cmocka_unit_test(check_peek_error_on_out_is_null),
+            cmocka_unit_test(check_peek),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
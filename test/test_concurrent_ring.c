@@ -0,0 +1,523 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <octopus.h>
+#include <pthread.h>
+
+#include <test/cmocka.h>
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_ring_invalidate(NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_invalidate(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_ring object = {};
+    assert_true(octopus_concurrent_ring_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_ring_init(
+            NULL, 1, 1, OCTOPUS_CONCURRENT_RING_WAIT_BUSY_SPIN));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_size_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_ring_init(
+            (void *) 1, 0, 1, OCTOPUS_CONCURRENT_RING_WAIT_BUSY_SPIN));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_SIZE_IS_ZERO,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_capacity_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_ring_init(
+            (void *) 1, 1, 0, OCTOPUS_CONCURRENT_RING_WAIT_BUSY_SPIN));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_CAPACITY_IS_ZERO,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_wait_is_invalid(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_ring_init((void *) 1, 1, 1, -1));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_WAIT_IS_INVALID,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_size_is_too_large(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_ring_init(
+            (void *) 1, SIZE_MAX, 2, OCTOPUS_CONCURRENT_RING_WAIT_BUSY_SPIN));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_SIZE_IS_TOO_LARGE,
+                     octopus_error);
+    assert_false(octopus_concurrent_ring_init(
+            (void *) 1, 1, UINTMAX_MAX, OCTOPUS_CONCURRENT_RING_WAIT_BUSY_SPIN));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_SIZE_IS_TOO_LARGE,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_ring object;
+    posix_memalign_is_overridden = true;
+    assert_false(octopus_concurrent_ring_init(
+            &object, 1, 1, OCTOPUS_CONCURRENT_RING_WAIT_BUSY_SPIN));
+    posix_memalign_is_overridden = false;
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_ring object;
+    assert_true(octopus_concurrent_ring_init(
+            &object, sizeof(uintmax_t), 5, OCTOPUS_CONCURRENT_RING_WAIT_YIELD));
+    assert_int_equal(object.size, sizeof(uintmax_t));
+    assert_int_equal(object.mask, 7);
+    assert_int_equal(object.wait, OCTOPUS_CONCURRENT_RING_WAIT_YIELD);
+    assert_null(object.consumers);
+    assert_true(octopus_concurrent_ring_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_publish_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_ring_publish(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    assert_false(octopus_concurrent_ring_try_publish(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_publish_error_on_item_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_ring_publish((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_ITEM_IS_NULL,
+                     octopus_error);
+    assert_false(octopus_concurrent_ring_try_publish((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_ITEM_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_publish_without_consumers(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_ring object;
+    assert_true(octopus_concurrent_ring_init(
+            &object, sizeof(uintmax_t), 4,
+            OCTOPUS_CONCURRENT_RING_WAIT_BUSY_SPIN));
+    for (uintmax_t i = 0; i < 10; i++) {
+        assert_true(octopus_concurrent_ring_try_publish(&object, &i));
+        assert_true(octopus_concurrent_ring_publish(&object, &i));
+    }
+    assert_true(octopus_concurrent_ring_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_try_publish_error_on_ring_is_full(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_ring object;
+    assert_true(octopus_concurrent_ring_init(
+            &object, sizeof(uintmax_t), 4,
+            OCTOPUS_CONCURRENT_RING_WAIT_BUSY_SPIN));
+    struct octopus_concurrent_ring_consumer consumer;
+    assert_true(octopus_concurrent_ring_consumer_init(
+            &consumer, &object, NULL, 0));
+    for (uintmax_t i = 0; i < 4; i++) {
+        assert_true(octopus_concurrent_ring_try_publish(&object, &i));
+    }
+    uintmax_t item = 4;
+    assert_false(octopus_concurrent_ring_try_publish(&object, &item));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_RING_IS_FULL,
+                     octopus_error);
+    uintmax_t out;
+    assert_true(octopus_concurrent_ring_consumer_poll(
+            &consumer, (void **) &out));
+    assert_int_equal(out, 0);
+    assert_true(octopus_concurrent_ring_try_publish(&object, &item));
+    assert_false(octopus_concurrent_ring_try_publish(&object, &item));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_RING_IS_FULL,
+                     octopus_error);
+    /* once the consumer is gone nothing holds the producers back */
+    assert_true(octopus_concurrent_ring_consumer_invalidate(&consumer));
+    assert_true(octopus_concurrent_ring_try_publish(&object, &item));
+    assert_true(octopus_concurrent_ring_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_consumer_init_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_ring_consumer_init(
+            NULL, (void *) 1, NULL, 0));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_consumer_init_error_on_ring_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_ring_consumer_init(
+            (void *) 1, NULL, NULL, 0));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_RING_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_consumer_init_error_on_dependencies_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_ring_consumer_init(
+            (void *) 1, (void *) 1, NULL, 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_DEPENDENCIES_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_consumer_init_error_on_dependency_is_invalid(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_ring first;
+    assert_true(octopus_concurrent_ring_init(
+            &first, 1, 1, OCTOPUS_CONCURRENT_RING_WAIT_BUSY_SPIN));
+    struct octopus_concurrent_ring second;
+    assert_true(octopus_concurrent_ring_init(
+            &second, 1, 1, OCTOPUS_CONCURRENT_RING_WAIT_BUSY_SPIN));
+    struct octopus_concurrent_ring_consumer other;
+    assert_true(octopus_concurrent_ring_consumer_init(
+            &other, &second, NULL, 0));
+    struct octopus_concurrent_ring_consumer consumer;
+    struct octopus_concurrent_ring_consumer *dependencies[] = {NULL};
+    assert_false(octopus_concurrent_ring_consumer_init(
+            &consumer, &first, dependencies, 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_DEPENDENCY_IS_INVALID,
+                     octopus_error);
+    dependencies[0] = &other;
+    assert_false(octopus_concurrent_ring_consumer_init(
+            &consumer, &first, dependencies, 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_DEPENDENCY_IS_INVALID,
+                     octopus_error);
+    assert_null(first.consumers);
+    assert_true(octopus_concurrent_ring_consumer_invalidate(&other));
+    assert_true(octopus_concurrent_ring_invalidate(&second));
+    assert_true(octopus_concurrent_ring_invalidate(&first));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_consumer_init_error_on_memory_allocation_failed(
+        void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_ring object;
+    assert_true(octopus_concurrent_ring_init(
+            &object, 1, 1, OCTOPUS_CONCURRENT_RING_WAIT_BUSY_SPIN));
+    struct octopus_concurrent_ring_consumer first;
+    assert_true(octopus_concurrent_ring_consumer_init(
+            &first, &object, NULL, 0));
+    struct octopus_concurrent_ring_consumer *dependencies[] = {&first};
+    struct octopus_concurrent_ring_consumer second;
+    malloc_is_overridden = true;
+    assert_false(octopus_concurrent_ring_consumer_init(
+            &second, &object, dependencies, 1));
+    malloc_is_overridden = false;
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    assert_ptr_equal(object.consumers, &first);
+    assert_null(first.next);
+    assert_true(octopus_concurrent_ring_consumer_invalidate(&first));
+    assert_true(octopus_concurrent_ring_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_consumer_invalidate_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_ring_consumer_invalidate(NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_consumer_invalidate(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_ring object;
+    assert_true(octopus_concurrent_ring_init(
+            &object, 1, 1, OCTOPUS_CONCURRENT_RING_WAIT_BUSY_SPIN));
+    struct octopus_concurrent_ring_consumer consumers[3];
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_concurrent_ring_consumer_init(
+                &consumers[i], &object, NULL, 0));
+    }
+    assert_true(octopus_concurrent_ring_consumer_invalidate(&consumers[1]));
+    assert_ptr_equal(object.consumers, &consumers[2]);
+    assert_ptr_equal(consumers[2].next, &consumers[0]);
+    assert_true(octopus_concurrent_ring_consumer_invalidate(&consumers[2]));
+    assert_true(octopus_concurrent_ring_consumer_invalidate(&consumers[0]));
+    assert_null(object.consumers);
+    assert_true(octopus_concurrent_ring_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_consumer_poll_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_ring_consumer_poll(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    assert_false(octopus_concurrent_ring_consumer_take(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_consumer_poll_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_ring_consumer_poll((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    assert_false(octopus_concurrent_ring_consumer_take((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_consumer_poll_error_on_nothing_is_available(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_ring object;
+    assert_true(octopus_concurrent_ring_init(
+            &object, sizeof(uintmax_t), 4,
+            OCTOPUS_CONCURRENT_RING_WAIT_BUSY_SPIN));
+    struct octopus_concurrent_ring_consumer consumer;
+    assert_true(octopus_concurrent_ring_consumer_init(
+            &consumer, &object, NULL, 0));
+    uintmax_t out;
+    assert_false(octopus_concurrent_ring_consumer_poll(
+            &consumer, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_NOTHING_IS_AVAILABLE,
+                     octopus_error);
+    assert_true(octopus_concurrent_ring_consumer_invalidate(&consumer));
+    assert_true(octopus_concurrent_ring_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_consumer_poll_broadcast(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_ring object;
+    assert_true(octopus_concurrent_ring_init(
+            &object, sizeof(uintmax_t), 8,
+            OCTOPUS_CONCURRENT_RING_WAIT_BUSY_SPIN));
+    struct octopus_concurrent_ring_consumer first;
+    assert_true(octopus_concurrent_ring_consumer_init(
+            &first, &object, NULL, 0));
+    struct octopus_concurrent_ring_consumer second;
+    assert_true(octopus_concurrent_ring_consumer_init(
+            &second, &object, NULL, 0));
+    for (uintmax_t i = 0; i < 20; i++) {
+        assert_true(octopus_concurrent_ring_publish(&object, &i));
+        uintmax_t out;
+        assert_true(octopus_concurrent_ring_consumer_poll(
+                &first, (void **) &out));
+        assert_int_equal(out, i);
+        if (i % 2) {
+            for (uintmax_t o = i - 1; o <= i; o++) {
+                assert_true(octopus_concurrent_ring_consumer_poll(
+                        &second, (void **) &out));
+                assert_int_equal(out, o);
+            }
+        }
+    }
+    /* a consumer only sees what is published after it registered */
+    struct octopus_concurrent_ring_consumer third;
+    assert_true(octopus_concurrent_ring_consumer_init(
+            &third, &object, NULL, 0));
+    uintmax_t out;
+    assert_false(octopus_concurrent_ring_consumer_poll(
+            &third, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_NOTHING_IS_AVAILABLE,
+                     octopus_error);
+    const uintmax_t item = 20;
+    assert_true(octopus_concurrent_ring_publish(&object, &item));
+    assert_true(octopus_concurrent_ring_consumer_poll(
+            &third, (void **) &out));
+    assert_int_equal(out, item);
+    assert_true(octopus_concurrent_ring_consumer_invalidate(&third));
+    assert_true(octopus_concurrent_ring_consumer_invalidate(&second));
+    assert_true(octopus_concurrent_ring_consumer_invalidate(&first));
+    assert_true(octopus_concurrent_ring_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_consumer_poll_with_dependencies(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_ring object;
+    assert_true(octopus_concurrent_ring_init(
+            &object, sizeof(uintmax_t), 8,
+            OCTOPUS_CONCURRENT_RING_WAIT_BUSY_SPIN));
+    struct octopus_concurrent_ring_consumer first;
+    assert_true(octopus_concurrent_ring_consumer_init(
+            &first, &object, NULL, 0));
+    struct octopus_concurrent_ring_consumer second;
+    assert_true(octopus_concurrent_ring_consumer_init(
+            &second, &object, NULL, 0));
+    struct octopus_concurrent_ring_consumer *const dependencies[] = {
+            &first, &second
+    };
+    struct octopus_concurrent_ring_consumer last;
+    assert_true(octopus_concurrent_ring_consumer_init(
+            &last, &object, dependencies, 2));
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_concurrent_ring_publish(&object, &i));
+    }
+    uintmax_t out;
+    assert_false(octopus_concurrent_ring_consumer_poll(
+            &last, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_NOTHING_IS_AVAILABLE,
+                     octopus_error);
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_concurrent_ring_consumer_poll(
+                &first, (void **) &out));
+    }
+    assert_false(octopus_concurrent_ring_consumer_poll(
+            &last, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_NOTHING_IS_AVAILABLE,
+                     octopus_error);
+    assert_true(octopus_concurrent_ring_consumer_poll(
+            &second, (void **) &out));
+    assert_true(octopus_concurrent_ring_consumer_poll(
+            &last, (void **) &out));
+    assert_int_equal(out, 0);
+    assert_false(octopus_concurrent_ring_consumer_poll(
+            &last, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_RING_ERROR_NOTHING_IS_AVAILABLE,
+                     octopus_error);
+    assert_true(octopus_concurrent_ring_consumer_invalidate(&last));
+    assert_true(octopus_concurrent_ring_consumer_invalidate(&second));
+    assert_true(octopus_concurrent_ring_consumer_invalidate(&first));
+    assert_true(octopus_concurrent_ring_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+#define PRODUCERS                               2
+#define ITEMS                                   2000
+
+struct context {
+    struct octopus_concurrent_ring ring;
+    struct octopus_concurrent_ring_consumer consumers[3];
+    uintmax_t sums[3];
+};
+
+static void *producer(void *arg) {
+    struct context *const context = arg;
+    for (uintmax_t i = 1; i <= ITEMS; i++) {
+        assert_true(octopus_concurrent_ring_publish(&context->ring, &i));
+    }
+    return NULL;
+}
+
+static void *consumer(void *arg) {
+    struct octopus_concurrent_ring_consumer *const object = arg;
+    struct context *const context = (void *) object->ring;
+    const uintmax_t at = object - context->consumers;
+    for (uintmax_t i = 0; i < PRODUCERS * ITEMS; i++) {
+        uintmax_t out;
+        assert_true(octopus_concurrent_ring_consumer_take(
+                object, (void **) &out));
+        context->sums[at] += out;
+    }
+    return NULL;
+}
+
+static void check_concurrent(const int wait) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct context context = {};
+    assert_true(octopus_concurrent_ring_init(
+            &context.ring, sizeof(uintmax_t), 64, wait));
+    assert_true(octopus_concurrent_ring_consumer_init(
+            &context.consumers[0], &context.ring, NULL, 0));
+    assert_true(octopus_concurrent_ring_consumer_init(
+            &context.consumers[1], &context.ring, NULL, 0));
+    struct octopus_concurrent_ring_consumer *const dependencies[] = {
+            &context.consumers[0], &context.consumers[1]
+    };
+    assert_true(octopus_concurrent_ring_consumer_init(
+            &context.consumers[2], &context.ring, dependencies, 2));
+    pthread_t threads[3 + PRODUCERS];
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_int_equal(0, pthread_create(
+                &threads[i], NULL, consumer, &context.consumers[i]));
+    }
+    for (uintmax_t i = 3; i < 3 + PRODUCERS; i++) {
+        assert_int_equal(0, pthread_create(
+                &threads[i], NULL, producer, &context));
+    }
+    for (uintmax_t i = 0; i < 3 + PRODUCERS; i++) {
+        assert_int_equal(0, pthread_join(threads[i], NULL));
+    }
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_int_equal(context.sums[i],
+                         PRODUCERS * (ITEMS * (ITEMS + 1) / 2));
+        assert_true(octopus_concurrent_ring_consumer_invalidate(
+                &context.consumers[2 - i]));
+    }
+    assert_true(octopus_concurrent_ring_invalidate(&context.ring));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_concurrent_busy_spin(void **state) {
+    check_concurrent(OCTOPUS_CONCURRENT_RING_WAIT_BUSY_SPIN);
+}
+
+static void check_concurrent_yield(void **state) {
+    check_concurrent(OCTOPUS_CONCURRENT_RING_WAIT_YIELD);
+}
+
+static void check_concurrent_block(void **state) {
+    check_concurrent(OCTOPUS_CONCURRENT_RING_WAIT_BLOCK);
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_invalidate),
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_size_is_zero),
+            cmocka_unit_test(check_init_error_on_capacity_is_zero),
+            cmocka_unit_test(check_init_error_on_wait_is_invalid),
+            cmocka_unit_test(check_init_error_on_size_is_too_large),
+            cmocka_unit_test(check_init_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_publish_error_on_object_is_null),
+            cmocka_unit_test(check_publish_error_on_item_is_null),
+            cmocka_unit_test(check_publish_without_consumers),
+            cmocka_unit_test(check_try_publish_error_on_ring_is_full),
+            cmocka_unit_test(check_consumer_init_error_on_object_is_null),
+            cmocka_unit_test(check_consumer_init_error_on_ring_is_null),
+            cmocka_unit_test(check_consumer_init_error_on_dependencies_is_null),
+            cmocka_unit_test(check_consumer_init_error_on_dependency_is_invalid),
+            cmocka_unit_test(
+                    check_consumer_init_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_consumer_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_consumer_invalidate),
+            cmocka_unit_test(check_consumer_poll_error_on_object_is_null),
+            cmocka_unit_test(check_consumer_poll_error_on_out_is_null),
+            cmocka_unit_test(check_consumer_poll_error_on_nothing_is_available),
+            cmocka_unit_test(check_consumer_poll_broadcast),
+            cmocka_unit_test(check_consumer_poll_with_dependencies),
+            cmocka_unit_test(check_concurrent_busy_spin),
+            cmocka_unit_test(check_concurrent_yield),
+            cmocka_unit_test(check_concurrent_block),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,516 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <octopus.h>
+#include <pthread.h>
+
+#include "private/concurrent_skip_list.h"
+
+#include <test/cmocka.h>
+
+static int compare(const void *const first, const void *const second) {
+    const uintmax_t a = *(const uintmax_t *) first;
+    const uintmax_t b = *(const uintmax_t *) second;
+    return a < b ? -1 : a > b;
+}
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_skip_list_invalidate(NULL, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_invalidate(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_skip_list object = {};
+    assert_true(octopus_concurrent_skip_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_skip_list_init(
+            NULL, sizeof(uintmax_t), sizeof(uintmax_t), compare));
+    assert_int_equal(OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_key_size_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_skip_list_init(
+            (void *) 1, 0, sizeof(uintmax_t), compare));
+    assert_int_equal(OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_SIZE_IS_ZERO,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_compare_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_skip_list_init(
+            (void *) 1, sizeof(uintmax_t), sizeof(uintmax_t), NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_COMPARE_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_size_is_too_large(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_skip_list_init(
+            (void *) 1, SIZE_MAX, sizeof(uintmax_t), compare));
+    assert_int_equal(OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_SIZE_IS_TOO_LARGE,
+                     octopus_error);
+    assert_false(octopus_concurrent_skip_list_init(
+            (void *) 1, sizeof(uintmax_t), SIZE_MAX, compare));
+    assert_int_equal(OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_SIZE_IS_TOO_LARGE,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_skip_list object;
+    malloc_is_overridden = true;
+    assert_false(octopus_concurrent_skip_list_init(
+            &object, sizeof(uintmax_t), sizeof(uintmax_t), compare));
+    malloc_is_overridden = false;
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_skip_list object;
+    assert_true(octopus_concurrent_skip_list_init(
+            &object, sizeof(uint32_t), sizeof(uintmax_t), compare));
+    assert_int_equal(object.key, sizeof(uint32_t));
+    assert_int_equal(object.value, sizeof(uintmax_t));
+    assert_int_equal(object.next % _Alignof(atomic_uintptr_t), 0);
+    assert_non_null(object.head);
+    assert_int_equal(object.head->height,
+                     OCTOPUS_CONCURRENT_SKIP_LIST_MAX_HEIGHT);
+    assert_true(octopus_concurrent_skip_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_insert_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_skip_list_insert(
+            NULL, (void *) 1, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_insert_error_on_key_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_skip_list_insert(
+            (void *) 1, NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_insert_error_on_value_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_skip_list object;
+    assert_true(octopus_concurrent_skip_list_init(
+            &object, sizeof(uintmax_t), sizeof(uintmax_t), compare));
+    const uintmax_t key = 1;
+    assert_false(octopus_concurrent_skip_list_insert(&object, &key, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_VALUE_IS_NULL,
+                     octopus_error);
+    assert_true(octopus_concurrent_skip_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_insert_error_on_key_already_exists(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_skip_list object;
+    assert_true(octopus_concurrent_skip_list_init(
+            &object, sizeof(uintmax_t), sizeof(uintmax_t), compare));
+    const uintmax_t key = 1;
+    assert_true(octopus_concurrent_skip_list_insert(&object, &key, &key));
+    assert_false(octopus_concurrent_skip_list_insert(&object, &key, &key));
+    assert_int_equal(OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_ALREADY_EXISTS,
+                     octopus_error);
+    assert_true(octopus_concurrent_skip_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_insert_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_skip_list object;
+    assert_true(octopus_concurrent_skip_list_init(
+            &object, sizeof(uintmax_t), sizeof(uintmax_t), compare));
+    const uintmax_t key = 1;
+    malloc_is_overridden = true;
+    assert_false(octopus_concurrent_skip_list_insert(&object, &key, &key));
+    malloc_is_overridden = false;
+    assert_int_equal(
+            OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    assert_true(octopus_concurrent_skip_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_get_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_skip_list_get(
+            NULL, (void *) 1, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_get_error_on_key_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_skip_list_get(
+            (void *) 1, NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_get_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_skip_list_get(
+            (void *) 1, (void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_get_error_on_key_not_found(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_skip_list object;
+    assert_true(octopus_concurrent_skip_list_init(
+            &object, sizeof(uintmax_t), sizeof(uintmax_t), compare));
+    uintmax_t key = 1;
+    uintmax_t out;
+    assert_false(octopus_concurrent_skip_list_get(
+            &object, &key, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_NOT_FOUND,
+                     octopus_error);
+    assert_true(octopus_concurrent_skip_list_insert(&object, &key, &key));
+    key = 2;
+    assert_false(octopus_concurrent_skip_list_get(
+            &object, &key, (void **) &out));
+    assert_int_equal(OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_NOT_FOUND,
+                     octopus_error);
+    assert_true(octopus_concurrent_skip_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_get(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_skip_list object;
+    assert_true(octopus_concurrent_skip_list_init(
+            &object, sizeof(uintmax_t), sizeof(uintmax_t), compare));
+    /* insert in a scrambled order */
+    for (uintmax_t i = 0; i < 1000; i++) {
+        const uintmax_t key = (i * 7919) % 1000;
+        const uintmax_t value = 3 * key;
+        assert_true(octopus_concurrent_skip_list_insert(
+                &object, &key, &value));
+    }
+    for (uintmax_t key = 0; key < 1000; key++) {
+        uintmax_t out;
+        assert_true(octopus_concurrent_skip_list_get(
+                &object, &key, (void **) &out));
+        assert_int_equal(out, 3 * key);
+    }
+    assert_true(octopus_concurrent_skip_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_skip_list_remove(
+            NULL, (void *) 1, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_key_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_skip_list_remove(
+            (void *) 1, NULL, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_key_not_found(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_skip_list object;
+    assert_true(octopus_concurrent_skip_list_init(
+            &object, sizeof(uintmax_t), sizeof(uintmax_t), compare));
+    const uintmax_t key = 1;
+    assert_false(octopus_concurrent_skip_list_remove(&object, &key, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_KEY_NOT_FOUND,
+                     octopus_error);
+    assert_true(octopus_concurrent_skip_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_skip_list object;
+    assert_true(octopus_concurrent_skip_list_init(
+            &object, sizeof(uintmax_t), sizeof(uintmax_t), compare));
+    for (uintmax_t key = 0; key < 500; key++) {
+        const uintmax_t value = key + 1;
+        assert_true(octopus_concurrent_skip_list_insert(
+                &object, &key, &value));
+    }
+    for (uintmax_t key = 0; key < 500; key += 2) {
+        uintmax_t out;
+        assert_true(octopus_concurrent_skip_list_remove(
+                &object, &key, (void **) &out));
+        assert_int_equal(out, key + 1);
+    }
+    for (uintmax_t key = 0; key < 500; key++) {
+        uintmax_t out;
+        assert_int_equal(key % 2, octopus_concurrent_skip_list_get(
+                &object, &key, (void **) &out));
+    }
+    const uintmax_t key = 0;
+    assert_true(octopus_concurrent_skip_list_insert(&object, &key, &key));
+    assert_true(octopus_concurrent_skip_list_remove(&object, &key, NULL));
+    assert_true(octopus_concurrent_skip_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+struct collect {
+    uintmax_t keys[16];
+    uintmax_t count;
+    uintmax_t limit;
+};
+
+static bool on_entry(const void *const key, const void *const value,
+                     void *const arg) {
+    struct collect *const collect = arg;
+    assert_int_equal(*(const uintmax_t *) value,
+                     10 * *(const uintmax_t *) key);
+    collect->keys[collect->count++] = *(const uintmax_t *) key;
+    return collect->count < collect->limit;
+}
+
+static void check_range_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_skip_list_range(
+            NULL, NULL, NULL, on_entry, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_range_error_on_func_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_concurrent_skip_list_range(
+            (void *) 1, NULL, NULL, NULL, NULL));
+    assert_int_equal(OCTOPUS_CONCURRENT_SKIP_LIST_ERROR_FUNC_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_range(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_skip_list object;
+    assert_true(octopus_concurrent_skip_list_init(
+            &object, sizeof(uintmax_t), sizeof(uintmax_t), compare));
+    for (uintmax_t i = 10; i; i--) {
+        const uintmax_t key = 2 * i;
+        const uintmax_t value = 10 * key;
+        assert_true(octopus_concurrent_skip_list_insert(
+                &object, &key, &value));
+    }
+    struct collect collect = {.limit = 16};
+    assert_true(octopus_concurrent_skip_list_range(
+            &object, NULL, NULL, on_entry, &collect));
+    assert_int_equal(collect.count, 10);
+    for (uintmax_t i = 0; i < 10; i++) {
+        assert_int_equal(collect.keys[i], 2 * (i + 1));
+    }
+    /* [5, 12) */
+    const uintmax_t first = 5;
+    const uintmax_t last = 12;
+    collect = (struct collect) {.limit = 16};
+    assert_true(octopus_concurrent_skip_list_range(
+            &object, &first, &last, on_entry, &collect));
+    assert_int_equal(collect.count, 3);
+    assert_int_equal(collect.keys[0], 6);
+    assert_int_equal(collect.keys[2], 10);
+    /* stop early */
+    collect = (struct collect) {.limit = 2};
+    assert_true(octopus_concurrent_skip_list_range(
+            &object, &first, NULL, on_entry, &collect));
+    assert_int_equal(collect.count, 2);
+    assert_int_equal(collect.keys[1], 8);
+    assert_true(octopus_concurrent_skip_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static uintmax_t destroyed;
+
+static void on_destroy(void *const key, void *const value) {
+    destroyed += *(uintmax_t *) value;
+}
+
+static void check_invalidate_with_on_destroy(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_skip_list object;
+    assert_true(octopus_concurrent_skip_list_init(
+            &object, sizeof(uintmax_t), sizeof(uintmax_t), compare));
+    for (uintmax_t key = 1; key <= 10; key++) {
+        assert_true(octopus_concurrent_skip_list_insert(
+                &object, &key, &key));
+    }
+    destroyed = 0;
+    assert_true(octopus_concurrent_skip_list_invalidate(
+            &object, on_destroy));
+    assert_int_equal(destroyed, 55);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+#define THREADS                                 4
+#define KEYS                                    2000
+
+static void *check_concurrent_worker(void *arg) {
+    struct octopus_concurrent_skip_list *const object = arg;
+    for (uintmax_t round = 0; round < 5; round++) {
+        for (uintmax_t key = 0; key < KEYS; key++) {
+            octopus_concurrent_skip_list_insert(object, &key, &key);
+        }
+        for (uintmax_t key = 0; key < KEYS; key += 2) {
+            octopus_concurrent_skip_list_remove(object, &key, NULL);
+        }
+    }
+    octopus_epoch_synchronize();
+    return NULL;
+}
+
+static void check_concurrent(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_skip_list object;
+    assert_true(octopus_concurrent_skip_list_init(
+            &object, sizeof(uintmax_t), sizeof(uintmax_t), compare));
+    pthread_t threads[THREADS];
+    for (uintmax_t i = 0; i < THREADS; i++) {
+        assert_int_equal(0, pthread_create(
+                &threads[i], NULL, check_concurrent_worker, &object));
+    }
+    for (uintmax_t i = 0; i < THREADS; i++) {
+        assert_int_equal(0, pthread_join(threads[i], NULL));
+    }
+    /* all odd keys are present, the even keys depend on the interleaving */
+    for (uintmax_t key = 1; key < KEYS; key += 2) {
+        uintmax_t out;
+        assert_true(octopus_concurrent_skip_list_get(
+                &object, &key, (void **) &out));
+        assert_int_equal(out, key);
+    }
+    assert_true(octopus_concurrent_skip_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+#define TALL                                    16
+#define CONTENDED_KEYS                          8
+#define ROUNDS                                  2000
+
+static void *check_insert_remove_tall_inserter(void *arg) {
+    struct octopus_concurrent_skip_list *const object = arg;
+    for (uintmax_t round = 0; round < ROUNDS; round++) {
+        for (uintmax_t key = 0; key < CONTENDED_KEYS; key++) {
+            octopus_concurrent_skip_list_insert(object, &key, &key);
+        }
+    }
+    octopus_epoch_synchronize();
+    return NULL;
+}
+
+static void *check_insert_remove_tall_remover(void *arg) {
+    struct octopus_concurrent_skip_list *const object = arg;
+    for (uintmax_t round = 0; round < ROUNDS; round++) {
+        for (uintmax_t key = 0; key < CONTENDED_KEYS; key++) {
+            uintmax_t out;
+            if (octopus_concurrent_skip_list_remove(object, &key,
+                                                    (void **) &out)) {
+                assert_int_equal(out, key);
+            }
+        }
+    }
+    octopus_epoch_synchronize();
+    return NULL;
+}
+
+static void check_insert_remove_tall_concurrently(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_skip_list object;
+    assert_true(octopus_concurrent_skip_list_init(
+            &object, sizeof(uintmax_t), sizeof(uintmax_t), compare));
+    /* towers take long to link, so removes overlap with their linking */
+    octopus_concurrent_skip_list_height = TALL;
+    pthread_t threads[THREADS];
+    for (uintmax_t i = 0; i < THREADS; i++) {
+        assert_int_equal(0, pthread_create(
+                &threads[i], NULL, i % 2
+                                   ? check_insert_remove_tall_remover
+                                   : check_insert_remove_tall_inserter,
+                &object));
+    }
+    for (uintmax_t i = 0; i < THREADS; i++) {
+        assert_int_equal(0, pthread_join(threads[i], NULL));
+    }
+    octopus_concurrent_skip_list_height = 0;
+    for (uintmax_t key = 0; key < CONTENDED_KEYS; key++) {
+        octopus_concurrent_skip_list_remove(&object, &key, NULL);
+        uintmax_t out;
+        assert_false(octopus_concurrent_skip_list_get(
+                &object, &key, (void **) &out));
+    }
+    assert_true(octopus_concurrent_skip_list_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_invalidate),
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_key_size_is_zero),
+            cmocka_unit_test(check_init_error_on_compare_is_null),
+            cmocka_unit_test(check_init_error_on_size_is_too_large),
+            cmocka_unit_test(check_init_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_insert_error_on_object_is_null),
+            cmocka_unit_test(check_insert_error_on_key_is_null),
+            cmocka_unit_test(check_insert_error_on_value_is_null),
+            cmocka_unit_test(check_insert_error_on_key_already_exists),
+            cmocka_unit_test(check_insert_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_get_error_on_object_is_null),
+            cmocka_unit_test(check_get_error_on_key_is_null),
+            cmocka_unit_test(check_get_error_on_out_is_null),
+            cmocka_unit_test(check_get_error_on_key_not_found),
+            cmocka_unit_test(check_get),
+            cmocka_unit_test(check_remove_error_on_object_is_null),
+            cmocka_unit_test(check_remove_error_on_key_is_null),
+            cmocka_unit_test(check_remove_error_on_key_not_found),
+            cmocka_unit_test(check_remove),
+            cmocka_unit_test(check_range_error_on_object_is_null),
+            cmocka_unit_test(check_range_error_on_func_is_null),
+            cmocka_unit_test(check_range),
+            cmocka_unit_test(check_invalidate_with_on_destroy),
+            cmocka_unit_test(check_concurrent),
+            cmocka_unit_test(check_insert_remove_tall_concurrently),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
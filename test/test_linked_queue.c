@@ -2,13 +2,15 @@
 #include <stddef.h>
 #include <setjmp.h>
 #include <cmocka.h>
+#include <string.h>
 #include <errno.h>
+#include <stdio.h>
 #include <octopus.h>
 
 #include "private/linked_queue.h"
+#include "private/spill.h"
 
 #include <test/cmocka.h>
-#include "test/linked_queue.h"
 
 static void check_invalidate_error_on_object_is_null(void **state) {
     octopus_error = OCTOPUS_ERROR_NONE;
@@ -87,11 +89,11 @@ static void check_size(void **state) {
     srand(time(NULL));
     octopus_error = OCTOPUS_ERROR_NONE;
     struct octopus_linked_queue object = {
-            .queue.size = rand() % UINTMAX_MAX
+            .size = rand() % UINTMAX_MAX
     };
     uintmax_t out;
     assert_true(octopus_linked_queue_size(&object, &out));
-    assert_int_equal(out, object.queue.size);
+    assert_int_equal(out, object.size);
     octopus_error = OCTOPUS_ERROR_NONE;
 }
 
@@ -117,7 +119,7 @@ static void check_count(void **state) {
     assert_true(octopus_linked_queue_init(&object, sizeof(uintmax_t)));
     uintmax_t out;
     assert_true(octopus_linked_queue_count(&object, &out));
-    assert_int_equal(out, object.queue.count);
+    assert_int_equal(out, 0);
     assert_true(octopus_linked_queue_invalidate(&object, NULL));
     octopus_error = OCTOPUS_ERROR_NONE;
 }
@@ -152,7 +154,7 @@ static void check_add(void **state) {
     assert_int_equal(count, 1);
     uintmax_t value;
     /* bypass locks to check contents of linked queue */
-    assert_true(coral_linked_queue_peek(&object.queue, (void **) &value));
+    memcpy(&value, object.tail->item, sizeof(value));
     assert_int_equal(value, item);
     assert_true(octopus_linked_queue_invalidate(&object, NULL));
     octopus_error = OCTOPUS_ERROR_NONE;
@@ -224,6 +226,206 @@ static void check_remove_error_on_queue_is_empty(void **state) {
     octopus_error = OCTOPUS_ERROR_NONE;
 }
 
+static void check_add_unless_busy_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_linked_queue_add_unless_busy(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_unless_busy_error_on_item_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_linked_queue_add_unless_busy((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_ITEM_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_unless_busy_error_on_lock_is_busy(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_linked_queue object;
+    assert_true(octopus_linked_queue_init(&object, sizeof(uintmax_t)));
+    assert_false(pthread_mutex_lock(&object.enqueue));
+    const uintmax_t item = 42;
+    assert_false(octopus_linked_queue_add_unless_busy(&object, &item));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_LOCK_IS_BUSY,
+                     octopus_error);
+    assert_false(pthread_mutex_unlock(&object.enqueue));
+    uintmax_t count;
+    assert_true(octopus_linked_queue_count(&object, &count));
+    assert_int_equal(count, 0);
+    assert_true(octopus_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_unless_busy(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_linked_queue object;
+    assert_true(octopus_linked_queue_init(&object, sizeof(uintmax_t)));
+    /* only adding is locked out, removing takes the other lock */
+    assert_false(pthread_mutex_lock(&object.dequeue));
+    const uintmax_t item = 42;
+    assert_true(octopus_linked_queue_add_unless_busy(&object, &item));
+    assert_false(pthread_mutex_unlock(&object.dequeue));
+    uintmax_t out;
+    assert_true(octopus_linked_queue_remove(&object, (void **) &out));
+    assert_int_equal(out, item);
+    assert_true(octopus_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_all_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_linked_queue_add_all(NULL, (void *) 1, 1,
+                                              (void *) 1));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_all_error_on_item_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_linked_queue_add_all((void *) 1, NULL, 1,
+                                              (void *) 1));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_ITEM_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_all_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_linked_queue_add_all((void *) 1, (void *) 1, 1,
+                                              NULL));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_all(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_linked_queue object;
+    assert_true(octopus_linked_queue_init(&object, sizeof(uintmax_t)));
+    const uintmax_t first = 7;
+    assert_true(octopus_linked_queue_add(&object, &first));
+    const uintmax_t items[] = {1, 2, 3, 4};
+    uintmax_t out;
+    assert_true(octopus_linked_queue_add_all(&object, items, 0, &out));
+    assert_int_equal(out, 0);
+    assert_true(octopus_linked_queue_add_all(&object, items, 4, &out));
+    assert_int_equal(out, 4);
+    assert_true(octopus_linked_queue_count(&object, &out));
+    assert_int_equal(out, 5);
+    assert_true(octopus_linked_queue_remove(&object, (void **) &out));
+    assert_int_equal(out, first);
+    for (uintmax_t i = 0; i < 4; i++) {
+        assert_true(octopus_linked_queue_remove(&object, (void **) &out));
+        assert_int_equal(out, items[i]);
+    }
+    assert_false(octopus_linked_queue_remove(&object, (void **) &out));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                     octopus_error);
+    assert_true(octopus_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_all_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_linked_queue object;
+    assert_true(octopus_linked_queue_init(&object, sizeof(uintmax_t)));
+    const uintmax_t items[] = {1, 2, 3, 4};
+    uintmax_t out;
+    /* leave two consumed nodes behind so that only the third one has to
+     * be allocated */
+    assert_true(octopus_linked_queue_add_all(&object, items, 2, &out));
+    assert_true(octopus_linked_queue_remove(&object, (void **) &out));
+    assert_true(octopus_linked_queue_remove(&object, (void **) &out));
+    uintmax_t usage;
+    assert_true(octopus_linked_queue_memory_usage(&object, &usage));
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = true;
+    assert_false(octopus_linked_queue_add_all(&object, items, 4, &out));
+    malloc_is_overridden = calloc_is_overridden = realloc_is_overridden
+            = posix_memalign_is_overridden = false;
+    assert_int_equal(
+            OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED,
+            octopus_error);
+    assert_int_equal(out, 0);
+    assert_true(octopus_linked_queue_count(&object, &out));
+    assert_int_equal(out, 0);
+    /* the nodes taken for reuse have been handed back */
+    assert_true(octopus_linked_queue_add_all(&object, items, 2, &out));
+    assert_true(octopus_linked_queue_memory_usage(&object, &out));
+    assert_int_equal(out, usage);
+    assert_true(octopus_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_unless_busy_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_linked_queue_remove_unless_busy(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_unless_busy_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_linked_queue_remove_unless_busy((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_unless_busy_error_on_lock_is_busy(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_linked_queue object;
+    assert_true(octopus_linked_queue_init(&object, sizeof(uintmax_t)));
+    const uintmax_t item = 42;
+    assert_true(octopus_linked_queue_add(&object, &item));
+    assert_false(pthread_mutex_lock(&object.dequeue));
+    uintmax_t out;
+    assert_false(octopus_linked_queue_remove_unless_busy(
+            &object, (void **) &out));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_LOCK_IS_BUSY,
+                     octopus_error);
+    assert_false(pthread_mutex_unlock(&object.dequeue));
+    uintmax_t count;
+    assert_true(octopus_linked_queue_count(&object, &count));
+    assert_int_equal(count, 1);
+    assert_true(octopus_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_unless_busy_error_on_queue_is_empty(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_linked_queue object;
+    assert_true(octopus_linked_queue_init(&object, sizeof(uintmax_t)));
+    uintmax_t out;
+    assert_false(octopus_linked_queue_remove_unless_busy(
+            &object, (void **) &out));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                     octopus_error);
+    assert_true(octopus_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_unless_busy(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_linked_queue object;
+    assert_true(octopus_linked_queue_init(&object, sizeof(uintmax_t)));
+    const uintmax_t item = 42;
+    assert_true(octopus_linked_queue_add(&object, &item));
+    assert_false(pthread_mutex_lock(&object.enqueue));
+    uintmax_t out;
+    assert_true(octopus_linked_queue_remove_unless_busy(
+            &object, (void **) &out));
+    assert_int_equal(out, item);
+    assert_false(pthread_mutex_unlock(&object.enqueue));
+    assert_true(octopus_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
 static void check_peek_error_on_object_is_null(void **state) {
     octopus_error = OCTOPUS_ERROR_NONE;
     assert_false(octopus_linked_queue_peek(NULL, (void *) 1));
@@ -273,6 +475,317 @@ static void check_peek_error_on_queue_is_empty(void **state) {
     octopus_error = OCTOPUS_ERROR_NONE;
 }
 
+static void check_is_empty_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_linked_queue_is_empty(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_is_empty_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_linked_queue_is_empty((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_is_empty(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_linked_queue object;
+    assert_true(octopus_linked_queue_init(&object, sizeof(uintmax_t)));
+    bool out;
+    assert_true(octopus_linked_queue_is_empty(&object, &out));
+    assert_true(out);
+    const uintmax_t check = 1;
+    assert_true(octopus_linked_queue_add(&object, &check));
+    assert_true(octopus_linked_queue_is_empty(&object, &out));
+    assert_false(out);
+    uintmax_t item;
+    assert_true(octopus_linked_queue_remove(&object, (void **) &item));
+    assert_true(octopus_linked_queue_is_empty(&object, &out));
+    assert_true(out);
+    assert_true(octopus_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_memory_usage_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_linked_queue_memory_usage(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_memory_usage_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_linked_queue_memory_usage((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_memory_usage(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_linked_queue object;
+    assert_true(octopus_linked_queue_init(&object, sizeof(uintmax_t)));
+    uintmax_t out;
+    assert_true(octopus_linked_queue_memory_usage(&object, &out));
+    assert_int_equal(out, 0);
+    const uintmax_t node = sizeof(struct octopus_linked_queue_node)
+                           + sizeof(uintmax_t);
+    const uintmax_t item = rand() % UINTMAX_MAX;
+    assert_true(octopus_linked_queue_add(&object, &item));
+    assert_true(octopus_linked_queue_memory_usage(&object, &out));
+    assert_int_equal(out, 2 * node);
+    uintmax_t value;
+    assert_true(octopus_linked_queue_remove(&object, (void **) &value));
+    assert_true(octopus_linked_queue_memory_usage(&object, &out));
+    assert_int_equal(out, 2 * node);
+    /* node released by remove is reused */
+    assert_true(octopus_linked_queue_add(&object, &item));
+    assert_true(octopus_linked_queue_memory_usage(&object, &out));
+    assert_int_equal(out, 2 * node);
+    assert_true(octopus_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_trim_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_linked_queue_trim(NULL));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_trim(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_linked_queue object;
+    assert_true(octopus_linked_queue_init(&object, sizeof(uintmax_t)));
+    const uintmax_t node = sizeof(struct octopus_linked_queue_node)
+                           + sizeof(uintmax_t);
+    for (uintmax_t i = 0; i < 10; i++) {
+        assert_true(octopus_linked_queue_add(&object, &i));
+    }
+    uintmax_t out;
+    for (uintmax_t i = 0; i < 8; i++) {
+        assert_true(octopus_linked_queue_remove(&object, (void **) &out));
+        assert_int_equal(out, i);
+    }
+    assert_true(octopus_linked_queue_memory_usage(&object, &out));
+    assert_int_equal(out, 11 * node);
+    assert_true(octopus_linked_queue_trim(&object));
+    assert_true(octopus_linked_queue_memory_usage(&object, &out));
+    assert_int_equal(out, 3 * node);
+    for (uintmax_t i = 8; i < 10; i++) {
+        assert_true(octopus_linked_queue_remove(&object, (void **) &out));
+        assert_int_equal(out, i);
+    }
+    assert_true(octopus_linked_queue_trim(&object));
+    assert_true(octopus_linked_queue_memory_usage(&object, &out));
+    assert_int_equal(out, 0);
+    /* usable again once trimmed */
+    assert_true(octopus_linked_queue_add(&object, &out));
+    assert_true(octopus_linked_queue_remove(&object, (void **) &out));
+    assert_int_equal(out, 0);
+    assert_true(octopus_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_attach_spill_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_linked_queue_attach_spill(NULL, P_tmpdir, 1, 0));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_attach_spill_error_on_directory_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_linked_queue_attach_spill((void *) 1, NULL, 1, 0));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_DIRECTORY_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_attach_spill_error_on_spill_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_linked_queue object;
+    assert_true(octopus_linked_queue_init(&object, sizeof(uintmax_t)));
+    assert_false(octopus_linked_queue_attach_spill(
+            &object, "/nonexistent/octopus", 1, 0));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_SPILL_FAILED,
+                     octopus_error);
+    assert_null(object.spill);
+    assert_true(octopus_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_attach_spill_error_on_memory_allocation_failed(
+        void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_linked_queue object;
+    assert_true(octopus_linked_queue_init(&object, sizeof(uintmax_t)));
+    malloc_is_overridden = true;
+    assert_false(octopus_linked_queue_attach_spill(&object, P_tmpdir, 1, 0));
+    malloc_is_overridden = false;
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    assert_null(object.spill);
+    assert_true(octopus_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_attach_spill(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_linked_queue object;
+    assert_true(octopus_linked_queue_init(&object, sizeof(uintmax_t)));
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_linked_queue_add(&object, &i));
+    }
+    assert_true(octopus_linked_queue_attach_spill(
+            &object, P_tmpdir, 2, 4 * sizeof(uintmax_t)));
+    assert_non_null(object.spill);
+    assert_int_equal(object.threshold, 2);
+    assert_int_equal(atomic_load(&object.resident), 3);
+    /* attaching again does nothing */
+    struct octopus_spill *const spill = object.spill;
+    assert_true(octopus_linked_queue_attach_spill(&object, P_tmpdir, 5, 0));
+    assert_ptr_equal(object.spill, spill);
+    assert_int_equal(object.threshold, 2);
+    assert_true(octopus_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_detach_spill_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_linked_queue_detach_spill(NULL));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_detach_spill(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_linked_queue object;
+    assert_true(octopus_linked_queue_init(&object, sizeof(uintmax_t)));
+    assert_true(octopus_linked_queue_detach_spill(&object));
+    assert_true(octopus_linked_queue_attach_spill(&object, P_tmpdir, 1, 0));
+    assert_true(octopus_linked_queue_detach_spill(&object));
+    assert_null(object.spill);
+    /* no longer spills */
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_true(octopus_linked_queue_add(&object, &i));
+    }
+    assert_int_equal(atomic_load(&object.resident), 0);
+    assert_true(octopus_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_spill(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_linked_queue object;
+    assert_true(octopus_linked_queue_init(&object, sizeof(uintmax_t)));
+    assert_true(octopus_linked_queue_attach_spill(
+            &object, P_tmpdir, 2, 4 * sizeof(uintmax_t)));
+    for (uintmax_t i = 0; i < 10; i++) {
+        assert_true(octopus_linked_queue_add(&object, &i));
+    }
+    assert_int_equal(atomic_load(&object.resident), 2);
+    assert_int_equal(atomic_load(&object.spill->count), 8);
+    uintmax_t out;
+    assert_true(octopus_linked_queue_count(&object, &out));
+    assert_int_equal(out, 10);
+    for (uintmax_t i = 0; i < 5; i++) {
+        assert_true(octopus_linked_queue_peek(&object, (void **) &out));
+        assert_int_equal(out, i);
+        assert_true(octopus_linked_queue_remove(&object, (void **) &out));
+        assert_int_equal(out, i);
+    }
+    /* while anything is spilled new items follow it onto disk */
+    for (uintmax_t i = 10; i < 12; i++) {
+        assert_true(octopus_linked_queue_add(&object, &i));
+    }
+    assert_int_equal(atomic_load(&object.resident), 0);
+    assert_int_equal(atomic_load(&object.spill->count), 7);
+    for (uintmax_t i = 5; i < 12; i++) {
+        bool empty;
+        assert_true(octopus_linked_queue_is_empty(&object, &empty));
+        assert_false(empty);
+        assert_true(octopus_linked_queue_remove(&object, (void **) &out));
+        assert_int_equal(out, i);
+    }
+    bool empty;
+    assert_true(octopus_linked_queue_is_empty(&object, &empty));
+    assert_true(empty);
+    assert_false(octopus_linked_queue_remove(&object, (void **) &out));
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                     octopus_error);
+    /* memory is used again once the spill has drained */
+    assert_true(octopus_linked_queue_add(&object, &out));
+    assert_int_equal(atomic_load(&object.resident), 1);
+    assert_int_equal(atomic_load(&object.spill->count), 0);
+    assert_true(octopus_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_spill_add_all(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_linked_queue object;
+    assert_true(octopus_linked_queue_init(&object, sizeof(uintmax_t)));
+    assert_true(octopus_linked_queue_attach_spill(
+            &object, P_tmpdir, 2, 4 * sizeof(uintmax_t)));
+    const uintmax_t items[] = {0, 1, 2, 3, 4};
+    uintmax_t out;
+    assert_true(octopus_linked_queue_add_all(&object, items, 5, &out));
+    assert_int_equal(out, 5);
+    assert_int_equal(atomic_load(&object.resident), 2);
+    assert_int_equal(atomic_load(&object.spill->count), 3);
+    for (uintmax_t i = 0; i < 5; i++) {
+        assert_true(octopus_linked_queue_remove(&object, (void **) &out));
+        assert_int_equal(out, i);
+    }
+    assert_true(octopus_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_spill_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_linked_queue object;
+    assert_true(octopus_linked_queue_init(&object, sizeof(uintmax_t)));
+    assert_true(octopus_linked_queue_attach_spill(&object, P_tmpdir, 0, 0));
+    const uintmax_t item = 1;
+    malloc_is_overridden = true;
+    assert_false(octopus_linked_queue_add(&object, &item));
+    malloc_is_overridden = false;
+    assert_int_equal(OCTOPUS_LINKED_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    assert_true(octopus_linked_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static uintmax_t destroyed;
+
+static void on_destroy(void *item) {
+    destroyed += *(uintmax_t *) item;
+}
+
+static void check_spill_invalidate(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_linked_queue object;
+    assert_true(octopus_linked_queue_init(&object, sizeof(uintmax_t)));
+    assert_true(octopus_linked_queue_attach_spill(
+            &object, P_tmpdir, 3, 2 * sizeof(uintmax_t)));
+    for (uintmax_t i = 1; i <= 10; i++) {
+        assert_true(octopus_linked_queue_add(&object, &i));
+    }
+    destroyed = 0;
+    assert_true(octopus_linked_queue_invalidate(&object, on_destroy));
+    assert_int_equal(destroyed, 55);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
 int main(int argc, char *argv[]) {
     const struct CMUnitTest tests[] = {
             cmocka_unit_test(check_invalidate_error_on_object_is_null),
@@ -295,10 +808,47 @@ int main(int argc, char *argv[]) {
             cmocka_unit_test(check_remove_error_on_out_is_null),
             cmocka_unit_test(check_remove),
             cmocka_unit_test(check_remove_error_on_queue_is_empty),
+            cmocka_unit_test(check_add_unless_busy_error_on_object_is_null),
+            cmocka_unit_test(check_add_unless_busy_error_on_item_is_null),
+            cmocka_unit_test(check_add_unless_busy_error_on_lock_is_busy),
+            cmocka_unit_test(check_add_unless_busy),
+            cmocka_unit_test(check_add_all_error_on_object_is_null),
+            cmocka_unit_test(check_add_all_error_on_item_is_null),
+            cmocka_unit_test(check_add_all_error_on_out_is_null),
+            cmocka_unit_test(check_add_all),
+            cmocka_unit_test(
+                    check_add_all_error_on_memory_allocation_failed),
+            cmocka_unit_test(
+                    check_remove_unless_busy_error_on_object_is_null),
+            cmocka_unit_test(check_remove_unless_busy_error_on_out_is_null),
+            cmocka_unit_test(check_remove_unless_busy_error_on_lock_is_busy),
+            cmocka_unit_test(
+                    check_remove_unless_busy_error_on_queue_is_empty),
+            cmocka_unit_test(check_remove_unless_busy),
             cmocka_unit_test(check_peek_error_on_object_is_null),
             cmocka_unit_test(check_peek_error_on_out_is_null),
             cmocka_unit_test(check_peek),
             cmocka_unit_test(check_peek_error_on_queue_is_empty),
+            cmocka_unit_test(check_is_empty_error_on_object_is_null),
+            cmocka_unit_test(check_is_empty_error_on_out_is_null),
+            cmocka_unit_test(check_is_empty),
+            cmocka_unit_test(check_memory_usage_error_on_object_is_null),
+            cmocka_unit_test(check_memory_usage_error_on_out_is_null),
+            cmocka_unit_test(check_memory_usage),
+            cmocka_unit_test(check_trim_error_on_object_is_null),
+            cmocka_unit_test(check_trim),
+            cmocka_unit_test(check_attach_spill_error_on_object_is_null),
+            cmocka_unit_test(check_attach_spill_error_on_directory_is_null),
+            cmocka_unit_test(check_attach_spill_error_on_spill_failed),
+            cmocka_unit_test(
+                    check_attach_spill_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_attach_spill),
+            cmocka_unit_test(check_detach_spill_error_on_object_is_null),
+            cmocka_unit_test(check_detach_spill),
+            cmocka_unit_test(check_spill),
+            cmocka_unit_test(check_spill_add_all),
+            cmocka_unit_test(check_spill_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_spill_invalidate),
     };
     //cmocka_set_message_output(CM_OUTPUT_XML);
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -0,0 +1,377 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <pthread.h>
+#include <octopus.h>
+
+#include "private/mpsc_queue.h"
+
+#include <test/cmocka.h>
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_mpsc_queue_invalidate(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_mpsc_queue_init(NULL, 1));
+    assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_size_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_mpsc_queue_init((void *) 1, 0));
+    assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_SIZE_IS_ZERO, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_size_is_too_large(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_mpsc_queue_init((void *) 1, SIZE_MAX));
+    assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_SIZE_IS_TOO_LARGE,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_mpsc_queue object;
+    malloc_is_overridden = true;
+    assert_false(octopus_mpsc_queue_init(&object, 1));
+    malloc_is_overridden = false;
+    assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_mpsc_queue object;
+    assert_true(octopus_mpsc_queue_init(&object, sizeof(uintmax_t)));
+    assert_int_equal(object.size, sizeof(uintmax_t));
+    assert_non_null(object.tail);
+    assert_ptr_equal(object.tail, atomic_load(&object.head));
+    assert_null(atomic_load(&object.tail->next));
+    assert_int_equal(
+            (uintptr_t) &object.tail % OCTOPUS_CACHE_LINE_SIZE, 0);
+    assert_int_equal(
+            (uintptr_t) &object.head % OCTOPUS_CACHE_LINE_SIZE, 0);
+    assert_true(octopus_mpsc_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_mpsc_queue_add(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_error_on_item_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_mpsc_queue_add((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_ITEM_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_mpsc_queue object;
+    assert_true(octopus_mpsc_queue_init(&object, sizeof(uintmax_t)));
+    const uintmax_t item = rand();
+    malloc_is_overridden = true;
+    assert_false(octopus_mpsc_queue_add(&object, &item));
+    malloc_is_overridden = false;
+    assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    assert_ptr_equal(object.tail, atomic_load(&object.head));
+    assert_true(octopus_mpsc_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_mpsc_queue object;
+    assert_true(octopus_mpsc_queue_init(&object, sizeof(uintmax_t)));
+    const uintmax_t item = rand();
+    assert_true(octopus_mpsc_queue_add(&object, &item));
+    struct octopus_mpsc_queue_node *const node = atomic_load(&object.head);
+    assert_ptr_not_equal(object.tail, node);
+    assert_ptr_equal(atomic_load(&object.tail->next), node);
+    assert_null(atomic_load(&node->next));
+    assert_memory_equal(node->item, &item, sizeof(item));
+    assert_true(octopus_mpsc_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_mpsc_queue_remove(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_mpsc_queue_remove((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_OUT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_queue_is_empty(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_mpsc_queue object;
+    assert_true(octopus_mpsc_queue_init(&object, sizeof(uintmax_t)));
+    uintmax_t out;
+    assert_false(octopus_mpsc_queue_remove(&object, (void **) &out));
+    assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_QUEUE_IS_EMPTY, octopus_error);
+    assert_true(octopus_mpsc_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_when_link_is_pending(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_mpsc_queue object;
+    assert_true(octopus_mpsc_queue_init(&object, sizeof(uintmax_t)));
+    const uintmax_t item = rand();
+    assert_true(octopus_mpsc_queue_add(&object, &item));
+    /* act as if the producer has exchanged the head but has yet to link the
+     * node to its predecessor */
+    struct octopus_mpsc_queue_node *const node
+            = atomic_exchange(&object.tail->next, NULL);
+    uintmax_t out;
+    assert_false(octopus_mpsc_queue_remove(&object, (void **) &out));
+    assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_QUEUE_IS_EMPTY, octopus_error);
+    atomic_store(&object.tail->next, node);
+    assert_true(octopus_mpsc_queue_remove(&object, (void **) &out));
+    assert_int_equal(out, item);
+    assert_true(octopus_mpsc_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_mpsc_queue object;
+    assert_true(octopus_mpsc_queue_init(&object, sizeof(uintmax_t)));
+    for (uintmax_t i = 0; i < 5; i++) {
+        assert_true(octopus_mpsc_queue_add(&object, &i));
+    }
+    for (uintmax_t i = 0; i < 5; i++) {
+        uintmax_t out;
+        assert_true(octopus_mpsc_queue_remove(&object, (void **) &out));
+        assert_int_equal(out, i);
+    }
+    assert_ptr_equal(object.tail, atomic_load(&object.head));
+    assert_true(octopus_mpsc_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_batch_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_mpsc_queue_remove_batch(
+            NULL, (void *) 1, 1, (void *) 1));
+    assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_batch_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_mpsc_queue_remove_batch(
+            (void *) 1, NULL, 1, (void *) 1));
+    assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_OUT_IS_NULL, octopus_error);
+    assert_false(octopus_mpsc_queue_remove_batch(
+            (void *) 1, (void *) 1, 1, NULL));
+    assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_OUT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_batch_error_on_queue_is_empty(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_mpsc_queue object;
+    assert_true(octopus_mpsc_queue_init(&object, sizeof(uintmax_t)));
+    uintmax_t out[2];
+    uintmax_t removed = 0;
+    assert_false(octopus_mpsc_queue_remove_batch(&object, out, 2, &removed));
+    assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_QUEUE_IS_EMPTY, octopus_error);
+    const uintmax_t item = rand();
+    assert_true(octopus_mpsc_queue_add(&object, &item));
+    assert_false(octopus_mpsc_queue_remove_batch(&object, out, 0, &removed));
+    assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_QUEUE_IS_EMPTY, octopus_error);
+    assert_int_equal(removed, 0);
+    assert_true(octopus_mpsc_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_batch(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_mpsc_queue object;
+    assert_true(octopus_mpsc_queue_init(&object, sizeof(uintmax_t)));
+    for (uintmax_t i = 0; i < 5; i++) {
+        assert_true(octopus_mpsc_queue_add(&object, &i));
+    }
+    uintmax_t out[3];
+    uintmax_t removed;
+    assert_true(octopus_mpsc_queue_remove_batch(&object, out, 3, &removed));
+    assert_int_equal(removed, 3);
+    for (uintmax_t i = 0; i < removed; i++) {
+        assert_int_equal(out[i], i);
+    }
+    assert_true(octopus_mpsc_queue_remove_batch(&object, out, 3, &removed));
+    assert_int_equal(removed, 2);
+    assert_int_equal(out[0], 3);
+    assert_int_equal(out[1], 4);
+    assert_ptr_equal(object.tail, atomic_load(&object.head));
+    assert_true(octopus_mpsc_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_peek_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_mpsc_queue_peek(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_peek_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_mpsc_queue_peek((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_OUT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_peek_error_on_queue_is_empty(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_mpsc_queue object;
+    assert_true(octopus_mpsc_queue_init(&object, sizeof(uintmax_t)));
+    uintmax_t out;
+    assert_false(octopus_mpsc_queue_peek(&object, (void **) &out));
+    assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_QUEUE_IS_EMPTY, octopus_error);
+    assert_true(octopus_mpsc_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_peek(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_mpsc_queue object;
+    assert_true(octopus_mpsc_queue_init(&object, sizeof(uintmax_t)));
+    const uintmax_t item = rand();
+    assert_true(octopus_mpsc_queue_add(&object, &item));
+    uintmax_t out;
+    assert_true(octopus_mpsc_queue_peek(&object, (void **) &out));
+    assert_int_equal(out, item);
+    assert_true(octopus_mpsc_queue_peek(&object, (void **) &out));
+    assert_int_equal(out, item);
+    assert_true(octopus_mpsc_queue_remove(&object, (void **) &out));
+    assert_int_equal(out, item);
+    assert_true(octopus_mpsc_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static uintmax_t destroyed;
+
+static void on_destroy(void *item) {
+    destroyed += *(uintmax_t *) item;
+}
+
+static void check_invalidate(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_mpsc_queue object;
+    assert_true(octopus_mpsc_queue_init(&object, sizeof(uintmax_t)));
+    for (uintmax_t i = 1; i <= 4; i++) {
+        assert_true(octopus_mpsc_queue_add(&object, &i));
+    }
+    uintmax_t out;
+    assert_true(octopus_mpsc_queue_remove(&object, (void **) &out));
+    assert_int_equal(out, 1);
+    destroyed = 0;
+    assert_true(octopus_mpsc_queue_invalidate(&object, on_destroy));
+    assert_int_equal(destroyed, 2 + 3 + 4);
+    assert_null(object.tail);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+#define PRODUCERS                                   4
+#define ITEMS                                       10000
+
+static void *check_producers_producer(void *arg) {
+    struct octopus_mpsc_queue *const object = arg;
+    static atomic_uintmax_t id;
+    const uintmax_t producer = atomic_fetch_add(&id, 1) % PRODUCERS;
+    for (uintmax_t i = 0; i < ITEMS; i++) {
+        const uintmax_t item = producer * ITEMS + i;
+        while (!octopus_mpsc_queue_add(object, &item));
+    }
+    return NULL;
+}
+
+static void check_producers(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_mpsc_queue object;
+    assert_true(octopus_mpsc_queue_init(&object, sizeof(uintmax_t)));
+    pthread_t threads[PRODUCERS];
+    for (uintmax_t i = 0; i < PRODUCERS; i++) {
+        assert_int_equal(0, pthread_create(&threads[i], NULL,
+                                           check_producers_producer,
+                                           &object));
+    }
+    /* items from each producer arrive in the order they were added */
+    uintmax_t next[PRODUCERS] = {0};
+    uintmax_t total = 0;
+    while (total < PRODUCERS * ITEMS) {
+        uintmax_t out[16];
+        uintmax_t removed;
+        if (!octopus_mpsc_queue_remove_batch(&object, out, 16, &removed)) {
+            assert_int_equal(OCTOPUS_MPSC_QUEUE_ERROR_QUEUE_IS_EMPTY,
+                             octopus_error);
+            continue;
+        }
+        for (uintmax_t i = 0; i < removed; i++) {
+            const uintmax_t producer = out[i] / ITEMS;
+            assert_int_equal(out[i] % ITEMS, next[producer]++);
+        }
+        total += removed;
+    }
+    for (uintmax_t i = 0; i < PRODUCERS; i++) {
+        assert_int_equal(0, pthread_join(threads[i], NULL));
+        assert_int_equal(next[i], ITEMS);
+    }
+    assert_true(octopus_mpsc_queue_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_size_is_zero),
+            cmocka_unit_test(check_init_error_on_size_is_too_large),
+            cmocka_unit_test(check_init_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_add_error_on_object_is_null),
+            cmocka_unit_test(check_add_error_on_item_is_null),
+            cmocka_unit_test(check_add_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_add),
+            cmocka_unit_test(check_remove_error_on_object_is_null),
+            cmocka_unit_test(check_remove_error_on_out_is_null),
+            cmocka_unit_test(check_remove_error_on_queue_is_empty),
+            cmocka_unit_test(check_remove_when_link_is_pending),
+            cmocka_unit_test(check_remove),
+            cmocka_unit_test(check_remove_batch_error_on_object_is_null),
+            cmocka_unit_test(check_remove_batch_error_on_out_is_null),
+            cmocka_unit_test(check_remove_batch_error_on_queue_is_empty),
+            cmocka_unit_test(check_remove_batch),
+            cmocka_unit_test(check_peek_error_on_object_is_null),
+            cmocka_unit_test(check_peek_error_on_out_is_null),
+            cmocka_unit_test(check_peek_error_on_queue_is_empty),
+            cmocka_unit_test(check_peek),
+            cmocka_unit_test(check_invalidate),
+            cmocka_unit_test(check_producers),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,507 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <octopus.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <linux/membarrier.h>
+#endif
+
+#include <test/cmocka.h>
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rcu_invalidate(NULL, NULL));
+    assert_int_equal(OCTOPUS_RCU_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static uintmax_t destroyed;
+
+static void on_destroy(void *pointer) {
+    destroyed += *(uintmax_t *) pointer;
+}
+
+static void check_invalidate(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rcu object;
+    uintmax_t version = 7;
+    assert_true(octopus_rcu_init(&object, &version));
+    struct octopus_rcu_reader *reader;
+    assert_true(octopus_rcu_register(&object, &reader));
+    destroyed = 0;
+    assert_true(octopus_rcu_invalidate(&object, on_destroy));
+    assert_int_equal(destroyed, 7);
+    /* invalidating twice is harmless */
+    assert_true(octopus_rcu_invalidate(&object, on_destroy));
+    assert_int_equal(destroyed, 7);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rcu_init(NULL, NULL));
+    assert_int_equal(OCTOPUS_RCU_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rcu object;
+    pthread_mutex_init_is_overridden = true;
+    will_return(cmocka_test_pthread_mutex_init, ENOMEM);
+    assert_false(octopus_rcu_init(&object, NULL));
+    pthread_mutex_init_is_overridden = false;
+    assert_int_equal(OCTOPUS_RCU_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rcu object;
+    assert_true(octopus_rcu_init(&object, NULL));
+    assert_true(octopus_rcu_invalidate(&object, on_destroy));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_expedited(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    bool supported = false;
+#if defined(__linux__) && defined(__NR_membarrier)
+    const long commands = syscall(__NR_membarrier, MEMBARRIER_CMD_QUERY, 0);
+    supported = commands > 0
+                && (commands & MEMBARRIER_CMD_PRIVATE_EXPEDITED);
+#endif
+    struct octopus_rcu object;
+    assert_true(octopus_rcu_init(&object, NULL));
+    /* readers only skip their fence where the kernel fences for them */
+    assert_int_equal(object.expedited, supported);
+    assert_true(octopus_rcu_synchronize(&object));
+    assert_true(octopus_rcu_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_register_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rcu_register(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_RCU_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_register_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rcu_register((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_RCU_ERROR_OUT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_register_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rcu object;
+    assert_true(octopus_rcu_init(&object, NULL));
+    struct octopus_rcu_reader *reader;
+    posix_memalign_is_overridden = true;
+    assert_false(octopus_rcu_register(&object, &reader));
+    posix_memalign_is_overridden = false;
+    assert_int_equal(OCTOPUS_RCU_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    assert_true(octopus_rcu_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_register(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rcu object;
+    assert_true(octopus_rcu_init(&object, NULL));
+    struct octopus_rcu_reader *first;
+    assert_true(octopus_rcu_register(&object, &first));
+    struct octopus_rcu_reader *second;
+    assert_true(octopus_rcu_register(&object, &second));
+    assert_ptr_not_equal(first, second);
+    assert_true(octopus_rcu_unregister(&object, first));
+    /* released readers are reused */
+    struct octopus_rcu_reader *third;
+    assert_true(octopus_rcu_register(&object, &third));
+    assert_ptr_equal(first, third);
+    assert_true(octopus_rcu_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_unregister_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rcu_unregister(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_RCU_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_unregister_error_on_reader_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rcu_unregister((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_RCU_ERROR_READER_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_unregister_error_on_reader_is_active(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rcu object;
+    assert_true(octopus_rcu_init(&object, NULL));
+    struct octopus_rcu_reader *reader;
+    assert_true(octopus_rcu_register(&object, &reader));
+    assert_true(octopus_rcu_read_lock(reader));
+    assert_false(octopus_rcu_unregister(&object, reader));
+    assert_int_equal(OCTOPUS_RCU_ERROR_READER_IS_ACTIVE, octopus_error);
+    assert_true(octopus_rcu_read_unlock(reader));
+    assert_true(octopus_rcu_unregister(&object, reader));
+    assert_true(octopus_rcu_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_read_lock_error_on_reader_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rcu_read_lock(NULL));
+    assert_int_equal(OCTOPUS_RCU_ERROR_READER_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_read_unlock_error_on_reader_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rcu_read_unlock(NULL));
+    assert_int_equal(OCTOPUS_RCU_ERROR_READER_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_read_unlock_error_on_reader_is_not_active(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rcu object;
+    assert_true(octopus_rcu_init(&object, NULL));
+    struct octopus_rcu_reader *reader;
+    assert_true(octopus_rcu_register(&object, &reader));
+    assert_false(octopus_rcu_read_unlock(reader));
+    assert_int_equal(OCTOPUS_RCU_ERROR_READER_IS_NOT_ACTIVE, octopus_error);
+    assert_true(octopus_rcu_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_read_lock_nested(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rcu object;
+    assert_true(octopus_rcu_init(&object, NULL));
+    struct octopus_rcu_reader *reader;
+    assert_true(octopus_rcu_register(&object, &reader));
+    assert_true(octopus_rcu_read_lock(reader));
+    const uintmax_t entered = atomic_load(&reader->state);
+    assert_int_not_equal(entered, 0);
+    assert_true(octopus_rcu_read_lock(reader));
+    assert_true(octopus_rcu_read_unlock(reader));
+    assert_int_equal(atomic_load(&reader->state), entered);
+    assert_true(octopus_rcu_read_unlock(reader));
+    assert_int_equal(atomic_load(&reader->state), 0);
+    assert_true(octopus_rcu_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_dereference_error_on_reader_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rcu_dereference(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_RCU_ERROR_READER_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_dereference_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rcu_dereference((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_RCU_ERROR_OUT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_dereference_error_on_reader_is_not_active(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rcu object;
+    assert_true(octopus_rcu_init(&object, NULL));
+    struct octopus_rcu_reader *reader;
+    assert_true(octopus_rcu_register(&object, &reader));
+    void *out;
+    assert_false(octopus_rcu_dereference(reader, &out));
+    assert_int_equal(OCTOPUS_RCU_ERROR_READER_IS_NOT_ACTIVE, octopus_error);
+    assert_true(octopus_rcu_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_publish_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rcu_publish(NULL, NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_RCU_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_publish_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rcu_publish((void *) 1, NULL, NULL));
+    assert_int_equal(OCTOPUS_RCU_ERROR_OUT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_publish(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rcu object;
+    uintmax_t first = 1;
+    uintmax_t second = 2;
+    assert_true(octopus_rcu_init(&object, &first));
+    struct octopus_rcu_reader *reader;
+    assert_true(octopus_rcu_register(&object, &reader));
+    assert_true(octopus_rcu_read_lock(reader));
+    void *out;
+    assert_true(octopus_rcu_dereference(reader, &out));
+    assert_ptr_equal(out, &first);
+    assert_true(octopus_rcu_publish(&object, &second, &out));
+    assert_ptr_equal(out, &first);
+    assert_true(octopus_rcu_dereference(reader, &out));
+    assert_ptr_equal(out, &second);
+    assert_true(octopus_rcu_read_unlock(reader));
+    assert_true(octopus_rcu_synchronize(&object));
+    destroyed = 0;
+    assert_true(octopus_rcu_invalidate(&object, on_destroy));
+    assert_int_equal(destroyed, 2);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_synchronize_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rcu_synchronize(NULL));
+    assert_int_equal(OCTOPUS_RCU_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+struct synchronizer {
+    struct octopus_rcu *object;
+    atomic_bool done;
+};
+
+static void *check_synchronize_thread(void *arg) {
+    struct synchronizer *const synchronizer = arg;
+    assert_true(octopus_rcu_synchronize(synchronizer->object));
+    atomic_store(&synchronizer->done, true);
+    return NULL;
+}
+
+static void check_synchronize(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rcu object;
+    assert_true(octopus_rcu_init(&object, NULL));
+    struct octopus_rcu_reader *reader;
+    assert_true(octopus_rcu_register(&object, &reader));
+    assert_true(octopus_rcu_read_lock(reader));
+    struct synchronizer synchronizer = {
+            .object = &object
+    };
+    pthread_t thread;
+    assert_int_equal(0, pthread_create(&thread, NULL,
+                                       check_synchronize_thread,
+                                       &synchronizer));
+    usleep(50000);
+    /* still waiting for us to leave */
+    assert_false(atomic_load(&synchronizer.done));
+    assert_true(octopus_rcu_read_unlock(reader));
+    assert_int_equal(0, pthread_join(thread, NULL));
+    assert_true(atomic_load(&synchronizer.done));
+    assert_true(octopus_rcu_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+struct version {
+    struct octopus_rcu_head head;
+    uintmax_t value;
+};
+
+static uintmax_t released;
+
+static void on_release(struct octopus_rcu_head *head) {
+    struct version *const version = (struct version *)
+            ((unsigned char *) head - offsetof(struct version, head));
+    released += version->value;
+}
+
+static void check_defer_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rcu_defer(NULL, (void *) 1, on_release));
+    assert_int_equal(OCTOPUS_RCU_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_defer_error_on_head_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rcu_defer((void *) 1, NULL, on_release));
+    assert_int_equal(OCTOPUS_RCU_ERROR_HEAD_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_defer_error_on_func_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rcu_defer((void *) 1, (void *) 1, NULL));
+    assert_int_equal(OCTOPUS_RCU_ERROR_FUNC_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_defer(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rcu object;
+    assert_true(octopus_rcu_init(&object, NULL));
+    struct octopus_rcu_reader *reader;
+    assert_true(octopus_rcu_register(&object, &reader));
+    struct version versions[3] = {
+            {.value = 1},
+            {.value = 2},
+            {.value = 4}
+    };
+    released = 0;
+    /* nobody is reading */
+    assert_true(octopus_rcu_defer(&object, &versions[0].head, on_release));
+    assert_int_equal(released, 1);
+    assert_true(octopus_rcu_read_lock(reader));
+    assert_true(octopus_rcu_defer(&object, &versions[1].head, on_release));
+    assert_int_equal(released, 1);
+    assert_true(octopus_rcu_read_unlock(reader));
+    /* due once the reader has left */
+    assert_true(octopus_rcu_defer(&object, &versions[2].head, on_release));
+    assert_int_equal(released, 7);
+    assert_true(octopus_rcu_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_defer_invalidate(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rcu object;
+    assert_true(octopus_rcu_init(&object, NULL));
+    struct octopus_rcu_reader *reader;
+    assert_true(octopus_rcu_register(&object, &reader));
+    struct version version = {.value = 3};
+    released = 0;
+    assert_true(octopus_rcu_read_lock(reader));
+    assert_true(octopus_rcu_defer(&object, &version.head, on_release));
+    assert_true(octopus_rcu_read_unlock(reader));
+    assert_int_equal(released, 0);
+    assert_true(octopus_rcu_invalidate(&object, NULL));
+    assert_int_equal(released, 3);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_barrier_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rcu_barrier(NULL));
+    assert_int_equal(OCTOPUS_RCU_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_barrier(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rcu object;
+    assert_true(octopus_rcu_init(&object, NULL));
+    struct octopus_rcu_reader *reader;
+    assert_true(octopus_rcu_register(&object, &reader));
+    struct version version = {.value = 5};
+    released = 0;
+    assert_true(octopus_rcu_read_lock(reader));
+    assert_true(octopus_rcu_defer(&object, &version.head, on_release));
+    assert_true(octopus_rcu_read_unlock(reader));
+    assert_true(octopus_rcu_barrier(&object));
+    assert_int_equal(released, 5);
+    assert_true(octopus_rcu_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+#define ROUNDS 2000
+
+struct shared {
+    struct octopus_rcu object;
+    atomic_bool stop;
+};
+
+static void *check_concurrently_reader(void *arg) {
+    struct shared *const shared = arg;
+    struct octopus_rcu_reader *reader;
+    assert_true(octopus_rcu_register(&shared->object, &reader));
+    while (!atomic_load_explicit(&shared->stop, memory_order_relaxed)) {
+        assert_true(octopus_rcu_read_lock(reader));
+        uintmax_t *version;
+        assert_true(octopus_rcu_dereference(reader, (void **) &version));
+        /* a released version would have been poisoned */
+        assert_int_not_equal(*version, 0);
+        assert_true(octopus_rcu_read_unlock(reader));
+    }
+    assert_true(octopus_rcu_unregister(&shared->object, reader));
+    return NULL;
+}
+
+static void check_concurrently(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct shared shared;
+    uintmax_t versions[2] = {1, 0};
+    assert_true(octopus_rcu_init(&shared.object, &versions[0]));
+    atomic_init(&shared.stop, false);
+    pthread_t threads[3];
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_int_equal(0, pthread_create(
+                &threads[i], NULL, check_concurrently_reader, &shared));
+    }
+    for (uintmax_t i = 0; i < ROUNDS; i++) {
+        uintmax_t *const next = &versions[(i + 1) % 2];
+        *next = i + 2;
+        uintmax_t *previous;
+        assert_true(octopus_rcu_publish(&shared.object, next,
+                                        (void **) &previous));
+        assert_true(octopus_rcu_synchronize(&shared.object));
+        *previous = 0;
+    }
+    atomic_store(&shared.stop, true);
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_int_equal(0, pthread_join(threads[i], NULL));
+    }
+    assert_true(octopus_rcu_invalidate(&shared.object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_invalidate),
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_init_expedited),
+            cmocka_unit_test(check_register_error_on_object_is_null),
+            cmocka_unit_test(check_register_error_on_out_is_null),
+            cmocka_unit_test(check_register_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_register),
+            cmocka_unit_test(check_unregister_error_on_object_is_null),
+            cmocka_unit_test(check_unregister_error_on_reader_is_null),
+            cmocka_unit_test(check_unregister_error_on_reader_is_active),
+            cmocka_unit_test(check_read_lock_error_on_reader_is_null),
+            cmocka_unit_test(check_read_unlock_error_on_reader_is_null),
+            cmocka_unit_test(check_read_unlock_error_on_reader_is_not_active),
+            cmocka_unit_test(check_read_lock_nested),
+            cmocka_unit_test(check_dereference_error_on_reader_is_null),
+            cmocka_unit_test(check_dereference_error_on_out_is_null),
+            cmocka_unit_test(check_dereference_error_on_reader_is_not_active),
+            cmocka_unit_test(check_publish_error_on_object_is_null),
+            cmocka_unit_test(check_publish_error_on_out_is_null),
+            cmocka_unit_test(check_publish),
+            cmocka_unit_test(check_synchronize_error_on_object_is_null),
+            cmocka_unit_test(check_synchronize),
+            cmocka_unit_test(check_defer_error_on_object_is_null),
+            cmocka_unit_test(check_defer_error_on_head_is_null),
+            cmocka_unit_test(check_defer_error_on_func_is_null),
+            cmocka_unit_test(check_defer),
+            cmocka_unit_test(check_defer_invalidate),
+            cmocka_unit_test(check_barrier_error_on_object_is_null),
+            cmocka_unit_test(check_barrier),
+            cmocka_unit_test(check_concurrently),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
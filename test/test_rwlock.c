@@ -0,0 +1,339 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <sched.h>
+#include <time.h>
+#include <pthread.h>
+#include <octopus.h>
+
+#include "private/rwlock.h"
+
+#include <test/cmocka.h>
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rwlock_invalidate(NULL));
+    assert_int_equal(OCTOPUS_RWLOCK_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_invalidate(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rwlock object;
+    assert_true(octopus_rwlock_init(&object, 1));
+    assert_true(octopus_rwlock_invalidate(&object));
+    assert_null(object.slots);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rwlock_init(NULL, 1));
+    assert_int_equal(OCTOPUS_RWLOCK_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_concurrency_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rwlock_init((void *) 1, 0));
+    assert_int_equal(OCTOPUS_RWLOCK_ERROR_CONCURRENCY_IS_ZERO, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rwlock object;
+    posix_memalign_is_overridden = true;
+    assert_false(octopus_rwlock_init(&object, 1));
+    posix_memalign_is_overridden = false;
+    assert_int_equal(OCTOPUS_RWLOCK_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rwlock object;
+    assert_true(octopus_rwlock_init(&object, 3));
+    assert_int_equal(object.mask, 3);
+    for (uintmax_t i = 0; i <= object.mask; i++) {
+        assert_int_equal(atomic_load(&object.slots[i].readers), 0);
+    }
+    assert_false(atomic_load(&object.writer));
+    assert_false(object.held);
+    assert_int_equal(object.waiting, 0);
+    assert_true(octopus_rwlock_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_read_lock_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rwlock_read_lock(NULL));
+    assert_int_equal(OCTOPUS_RWLOCK_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_read_unlock_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rwlock_read_unlock(NULL));
+    assert_int_equal(OCTOPUS_RWLOCK_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_read_unlock_error_on_lock_is_not_held(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rwlock object;
+    assert_true(octopus_rwlock_init(&object, 1));
+    assert_false(octopus_rwlock_read_unlock(&object));
+    assert_int_equal(OCTOPUS_RWLOCK_ERROR_LOCK_IS_NOT_HELD, octopus_error);
+    assert_true(octopus_rwlock_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_write_lock_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rwlock_write_lock(NULL));
+    assert_int_equal(OCTOPUS_RWLOCK_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_write_unlock_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_rwlock_write_unlock(NULL));
+    assert_int_equal(OCTOPUS_RWLOCK_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_write_unlock_error_on_lock_is_not_held(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rwlock object;
+    assert_true(octopus_rwlock_init(&object, 1));
+    assert_false(octopus_rwlock_write_unlock(&object));
+    assert_int_equal(OCTOPUS_RWLOCK_ERROR_LOCK_IS_NOT_HELD, octopus_error);
+    assert_true(octopus_rwlock_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static uintmax_t readers(struct octopus_rwlock *const object) {
+    uintmax_t count = 0;
+    for (uintmax_t i = 0; i <= object->mask; i++) {
+        count += atomic_load(&object->slots[i].readers);
+    }
+    return count;
+}
+
+static void check_read_lock(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rwlock object;
+    assert_true(octopus_rwlock_init(&object, 4));
+    assert_true(octopus_rwlock_read_lock(&object));
+    assert_int_equal(readers(&object), 1);
+    assert_true(octopus_rwlock_read_unlock(&object));
+    assert_int_equal(readers(&object), 0);
+    assert_false(octopus_rwlock_read_unlock(&object));
+    assert_int_equal(OCTOPUS_RWLOCK_ERROR_LOCK_IS_NOT_HELD, octopus_error);
+    assert_true(octopus_rwlock_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_write_lock(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rwlock object;
+    assert_true(octopus_rwlock_init(&object, 4));
+    assert_true(octopus_rwlock_write_lock(&object));
+    assert_true(object.held);
+    assert_true(atomic_load(&object.writer));
+    assert_true(octopus_rwlock_write_unlock(&object));
+    assert_false(object.held);
+    assert_false(atomic_load(&object.writer));
+    assert_false(octopus_rwlock_write_unlock(&object));
+    assert_int_equal(OCTOPUS_RWLOCK_ERROR_LOCK_IS_NOT_HELD, octopus_error);
+    /* readers get in again once the writer is done */
+    assert_true(octopus_rwlock_read_lock(&object));
+    assert_true(octopus_rwlock_read_unlock(&object));
+    assert_true(octopus_rwlock_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void settle(void) {
+    const struct timespec delay = {.tv_nsec = 10000000};
+    nanosleep(&delay, NULL);
+}
+
+static atomic_bool entered;
+
+static void *check_write_lock_waits_for_reader_writer(void *arg) {
+    assert_true(octopus_rwlock_write_lock(arg));
+    atomic_store(&entered, true);
+    assert_true(octopus_rwlock_write_unlock(arg));
+    return NULL;
+}
+
+static void check_write_lock_waits_for_reader(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rwlock object;
+    assert_true(octopus_rwlock_init(&object, 4));
+    assert_true(octopus_rwlock_read_lock(&object));
+    atomic_store(&entered, false);
+    pthread_t thread;
+    assert_int_equal(0, pthread_create(
+            &thread, NULL, check_write_lock_waits_for_reader_writer,
+            &object));
+    while (!atomic_load(&object.writer)) {
+        sched_yield();
+    }
+    settle();
+    assert_false(atomic_load(&entered));
+    assert_true(octopus_rwlock_read_unlock(&object));
+    assert_int_equal(0, pthread_join(thread, NULL));
+    assert_true(atomic_load(&entered));
+    assert_true(octopus_rwlock_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void *check_read_lock_waits_for_writer_reader(void *arg) {
+    assert_true(octopus_rwlock_read_lock(arg));
+    atomic_store(&entered, true);
+    assert_true(octopus_rwlock_read_unlock(arg));
+    return NULL;
+}
+
+static void check_read_lock_waits_for_writer(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rwlock object;
+    assert_true(octopus_rwlock_init(&object, 4));
+    assert_true(octopus_rwlock_write_lock(&object));
+    atomic_store(&entered, false);
+    pthread_t thread;
+    assert_int_equal(0, pthread_create(
+            &thread, NULL, check_read_lock_waits_for_writer_reader,
+            &object));
+    settle();
+    assert_false(atomic_load(&entered));
+    assert_true(octopus_rwlock_write_unlock(&object));
+    assert_int_equal(0, pthread_join(thread, NULL));
+    assert_true(atomic_load(&entered));
+    assert_true(octopus_rwlock_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static atomic_uintmax_t order;
+static uintmax_t written_at;
+static uintmax_t read_at;
+
+static void *check_writer_is_preferred_writer(void *arg) {
+    assert_true(octopus_rwlock_write_lock(arg));
+    written_at = 1 + atomic_fetch_add(&order, 1);
+    assert_true(octopus_rwlock_write_unlock(arg));
+    return NULL;
+}
+
+static void *check_writer_is_preferred_reader(void *arg) {
+    assert_true(octopus_rwlock_read_lock(arg));
+    read_at = 1 + atomic_fetch_add(&order, 1);
+    assert_true(octopus_rwlock_read_unlock(arg));
+    return NULL;
+}
+
+static void check_writer_is_preferred(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_rwlock object;
+    assert_true(octopus_rwlock_init(&object, 4));
+    atomic_store(&order, 0);
+    assert_true(octopus_rwlock_read_lock(&object));
+    pthread_t writer;
+    assert_int_equal(0, pthread_create(
+            &writer, NULL, check_writer_is_preferred_writer, &object));
+    while (!atomic_load(&object.writer)) {
+        sched_yield();
+    }
+    /* a reader arriving while the writer waits lets the writer go first */
+    pthread_t reader;
+    assert_int_equal(0, pthread_create(
+            &reader, NULL, check_writer_is_preferred_reader, &object));
+    settle();
+    assert_int_equal(atomic_load(&order), 0);
+    assert_true(octopus_rwlock_read_unlock(&object));
+    assert_int_equal(0, pthread_join(writer, NULL));
+    assert_int_equal(0, pthread_join(reader, NULL));
+    assert_int_equal(written_at, 1);
+    assert_int_equal(read_at, 2);
+    assert_true(octopus_rwlock_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+#define OPERATIONS 20000
+
+struct pair {
+    struct octopus_rwlock lock;
+    uintmax_t a;
+    uintmax_t b;
+};
+
+static void *check_concurrently_reader(void *arg) {
+    struct pair *const pair = arg;
+    for (uintmax_t i = 0; i < OPERATIONS; i++) {
+        assert_true(octopus_rwlock_read_lock(&pair->lock));
+        assert_int_equal(pair->a, pair->b);
+        assert_true(octopus_rwlock_read_unlock(&pair->lock));
+    }
+    return NULL;
+}
+
+static void *check_concurrently_writer(void *arg) {
+    struct pair *const pair = arg;
+    for (uintmax_t i = 0; i < OPERATIONS / 10; i++) {
+        assert_true(octopus_rwlock_write_lock(&pair->lock));
+        pair->a++;
+        pair->b++;
+        assert_true(octopus_rwlock_write_unlock(&pair->lock));
+    }
+    return NULL;
+}
+
+static void check_concurrently(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct pair pair = {0};
+    assert_true(octopus_rwlock_init(&pair.lock, 2));
+    pthread_t threads[6];
+    for (uintmax_t i = 0; i < 6; i++) {
+        assert_int_equal(0, pthread_create(
+                &threads[i], NULL,
+                i < 2 ? check_concurrently_writer : check_concurrently_reader,
+                &pair));
+    }
+    for (uintmax_t i = 0; i < 6; i++) {
+        assert_int_equal(0, pthread_join(threads[i], NULL));
+    }
+    assert_int_equal(pair.a, 2 * (OPERATIONS / 10));
+    assert_int_equal(pair.b, pair.a);
+    assert_int_equal(readers(&pair.lock), 0);
+    assert_true(octopus_rwlock_invalidate(&pair.lock));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_invalidate),
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_concurrency_is_zero),
+            cmocka_unit_test(check_init_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_read_lock_error_on_object_is_null),
+            cmocka_unit_test(check_read_unlock_error_on_object_is_null),
+            cmocka_unit_test(check_read_unlock_error_on_lock_is_not_held),
+            cmocka_unit_test(check_write_lock_error_on_object_is_null),
+            cmocka_unit_test(check_write_unlock_error_on_object_is_null),
+            cmocka_unit_test(check_write_unlock_error_on_lock_is_not_held),
+            cmocka_unit_test(check_read_lock),
+            cmocka_unit_test(check_write_lock),
+            cmocka_unit_test(check_write_lock_waits_for_reader),
+            cmocka_unit_test(check_read_lock_waits_for_writer),
+            cmocka_unit_test(check_writer_is_preferred),
+            cmocka_unit_test(check_concurrently),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,248 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <octopus.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <test/cmocka.h>
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_select_invalidate(NULL));
+    assert_int_equal(OCTOPUS_SELECT_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_invalidate(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_select object = {};
+    assert_true(octopus_select_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_select_init(NULL, (void *) 1, 1, false));
+    assert_int_equal(OCTOPUS_SELECT_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_queues_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_select_init((void *) 1, NULL, 1, false));
+    assert_int_equal(OCTOPUS_SELECT_ERROR_QUEUES_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_count_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_select_init((void *) 1, (void *) 1, 0, false));
+    assert_int_equal(OCTOPUS_SELECT_ERROR_COUNT_IS_ZERO, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_select object;
+    struct octopus_concurrent_linked_queue *queues[] = {(void *) 1};
+    malloc_is_overridden = calloc_is_overridden = true;
+    assert_false(octopus_select_init(&object, queues, 1, false));
+    malloc_is_overridden = calloc_is_overridden = false;
+    assert_int_equal(OCTOPUS_SELECT_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_select object;
+    struct octopus_concurrent_linked_queue *queues[] = {
+            (void *) 1, (void *) 2
+    };
+    assert_true(octopus_select_init(&object, queues, 2, true));
+    assert_int_equal(object.count, 2);
+    assert_ptr_equal(object.queues[0], queues[0]);
+    assert_ptr_equal(object.queues[1], queues[1]);
+    assert_true(object.priority);
+    assert_true(octopus_select_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_select_remove(NULL, NULL, (void *) 1, (void *) 1));
+    assert_int_equal(OCTOPUS_SELECT_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_at_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_select_remove((void *) 1, NULL, NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_SELECT_ERROR_AT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_select_remove((void *) 1, NULL, (void *) 1, NULL));
+    assert_int_equal(OCTOPUS_SELECT_ERROR_OUT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_timeout_is_invalid(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    const struct timespec timeouts[] = {
+            {.tv_sec = -1},
+            {.tv_nsec = -1},
+            {.tv_nsec = 1000000000L}
+    };
+    for (uintmax_t i = 0; i < sizeof(timeouts) / sizeof(timeouts[0]); i++) {
+        assert_false(octopus_select_remove((void *) 1, &timeouts[i],
+                                           (void *) 1, (void *) 1));
+        assert_int_equal(OCTOPUS_SELECT_ERROR_TIMEOUT_IS_INVALID,
+                         octopus_error);
+    }
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_timed_out(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue queue;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &queue, sizeof(uintmax_t), 2));
+    struct octopus_concurrent_linked_queue *queues[] = {&queue};
+    struct octopus_select object;
+    assert_true(octopus_select_init(&object, queues, 1, false));
+    const struct timespec timeout = {.tv_nsec = 10000000};
+    uintmax_t at;
+    uintmax_t out;
+    assert_false(octopus_select_remove(&object, &timeout, &at,
+                                       (void **) &out));
+    assert_int_equal(OCTOPUS_SELECT_ERROR_TIMED_OUT, octopus_error);
+    assert_int_equal(atomic_load(&queue.waiters), 0);
+    assert_null(queue.waiting);
+    assert_true(octopus_select_invalidate(&object));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&queue, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_with_priority(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue a;
+    struct octopus_concurrent_linked_queue b;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &a, sizeof(uintmax_t), 1));
+    assert_true(octopus_concurrent_linked_queue_init(
+            &b, sizeof(uintmax_t), 1));
+    struct octopus_concurrent_linked_queue *queues[] = {&a, &b};
+    struct octopus_select object;
+    assert_true(octopus_select_init(&object, queues, 2, true));
+    for (uintmax_t i = 0; i < 2; i++) {
+        assert_true(octopus_concurrent_linked_queue_add(&b, &i));
+    }
+    const uintmax_t check = 10;
+    assert_true(octopus_concurrent_linked_queue_add(&a, &check));
+    uintmax_t at;
+    uintmax_t out;
+    assert_true(octopus_select_remove(&object, NULL, &at, (void **) &out));
+    assert_int_equal(at, 0);
+    assert_int_equal(out, check);
+    for (uintmax_t i = 0; i < 2; i++) {
+        assert_true(octopus_select_remove(&object, NULL, &at,
+                                          (void **) &out));
+        assert_int_equal(at, 1);
+        assert_int_equal(out, i);
+    }
+    assert_true(octopus_select_invalidate(&object));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&a, NULL));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&b, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_round_robin(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue a;
+    struct octopus_concurrent_linked_queue b;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &a, sizeof(uintmax_t), 1));
+    assert_true(octopus_concurrent_linked_queue_init(
+            &b, sizeof(uintmax_t), 1));
+    struct octopus_concurrent_linked_queue *queues[] = {&a, &b};
+    struct octopus_select object;
+    assert_true(octopus_select_init(&object, queues, 2, false));
+    for (uintmax_t i = 0; i < 2; i++) {
+        assert_true(octopus_concurrent_linked_queue_add(&a, &i));
+        assert_true(octopus_concurrent_linked_queue_add(&b, &i));
+    }
+    for (uintmax_t i = 0; i < 4; i++) {
+        uintmax_t at;
+        uintmax_t out;
+        assert_true(octopus_select_remove(&object, NULL, &at,
+                                          (void **) &out));
+        assert_int_equal(at, i % 2);
+        assert_int_equal(out, i / 2);
+    }
+    assert_true(octopus_select_invalidate(&object));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&a, NULL));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&b, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void *check_remove_wakes_up_producer(void *arg) {
+    usleep(10000);
+    const uintmax_t check = 42;
+    assert_true(octopus_concurrent_linked_queue_add(arg, &check));
+    return NULL;
+}
+
+static void check_remove_wakes_up(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_concurrent_linked_queue a;
+    struct octopus_concurrent_linked_queue b;
+    assert_true(octopus_concurrent_linked_queue_init(
+            &a, sizeof(uintmax_t), 2));
+    assert_true(octopus_concurrent_linked_queue_init(
+            &b, sizeof(uintmax_t), 2));
+    struct octopus_concurrent_linked_queue *queues[] = {&a, &b};
+    struct octopus_select object;
+    assert_true(octopus_select_init(&object, queues, 2, false));
+    pthread_t thread;
+    assert_int_equal(0, pthread_create(
+            &thread, NULL, check_remove_wakes_up_producer, &b));
+    uintmax_t at;
+    uintmax_t out;
+    assert_true(octopus_select_remove(&object, NULL, &at, (void **) &out));
+    assert_int_equal(at, 1);
+    assert_int_equal(out, 42);
+    assert_int_equal(0, pthread_join(thread, NULL));
+    assert_int_equal(atomic_load(&a.waiters), 0);
+    assert_int_equal(atomic_load(&b.waiters), 0);
+    assert_true(octopus_select_invalidate(&object));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&a, NULL));
+    assert_true(octopus_concurrent_linked_queue_invalidate(&b, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_invalidate),
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_queues_is_null),
+            cmocka_unit_test(check_init_error_on_count_is_zero),
+            cmocka_unit_test(check_init_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_remove_error_on_object_is_null),
+            cmocka_unit_test(check_remove_error_on_at_is_null),
+            cmocka_unit_test(check_remove_error_on_out_is_null),
+            cmocka_unit_test(check_remove_error_on_timeout_is_invalid),
+            cmocka_unit_test(check_remove_error_on_timed_out),
+            cmocka_unit_test(check_remove_with_priority),
+            cmocka_unit_test(check_remove_round_robin),
+            cmocka_unit_test(check_remove_wakes_up),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
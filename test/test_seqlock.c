@@ -0,0 +1,221 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <pthread.h>
+#include <octopus.h>
+
+#include <test/cmocka.h>
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_seqlock_invalidate(NULL));
+    assert_int_equal(OCTOPUS_SEQLOCK_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_invalidate(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_seqlock object;
+    assert_true(octopus_seqlock_init(&object, sizeof(uintmax_t)));
+    assert_true(octopus_seqlock_invalidate(&object));
+    assert_null(object.words);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_seqlock_init(NULL, 1));
+    assert_int_equal(OCTOPUS_SEQLOCK_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_size_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_seqlock_init((void *) 1, 0));
+    assert_int_equal(OCTOPUS_SEQLOCK_ERROR_SIZE_IS_ZERO, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_size_is_too_large(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_seqlock_init((void *) 1, SIZE_MAX));
+    assert_int_equal(OCTOPUS_SEQLOCK_ERROR_SIZE_IS_TOO_LARGE, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_seqlock object;
+    posix_memalign_is_overridden = true;
+    assert_false(octopus_seqlock_init(&object, sizeof(uintmax_t)));
+    posix_memalign_is_overridden = false;
+    assert_int_equal(OCTOPUS_SEQLOCK_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_seqlock object;
+    assert_true(octopus_seqlock_init(&object, 13));
+    assert_int_equal(object.size, 13);
+    assert_int_equal(atomic_load(&object.sequence), 0);
+    const unsigned char zero[13] = {0};
+    unsigned char out[13];
+    memset(out, 0xff, sizeof(out));
+    assert_true(octopus_seqlock_read(&object, out));
+    assert_memory_equal(out, zero, sizeof(out));
+    assert_true(octopus_seqlock_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_size_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_seqlock_size(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_SEQLOCK_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_size_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_seqlock_size((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_SEQLOCK_ERROR_OUT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_size(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_seqlock object;
+    assert_true(octopus_seqlock_init(&object, 13));
+    size_t out;
+    assert_true(octopus_seqlock_size(&object, &out));
+    assert_int_equal(out, 13);
+    assert_true(octopus_seqlock_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_write_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_seqlock_write(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_SEQLOCK_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_write_error_on_value_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_seqlock_write((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_SEQLOCK_ERROR_VALUE_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_read_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_seqlock_read(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_SEQLOCK_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_read_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_seqlock_read((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_SEQLOCK_ERROR_OUT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_write(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_seqlock object;
+    unsigned char value[13];
+    for (size_t i = 0; i < sizeof(value); i++) {
+        value[i] = (unsigned char) (1 + i);
+    }
+    assert_true(octopus_seqlock_init(&object, sizeof(value)));
+    assert_true(octopus_seqlock_write(&object, value));
+    assert_int_equal(atomic_load(&object.sequence), 2);
+    /* the bytes past the value in the last word are left alone */
+    unsigned char out[16];
+    memset(out, 0xff, sizeof(out));
+    assert_true(octopus_seqlock_read(&object, out));
+    assert_memory_equal(out, value, sizeof(value));
+    for (size_t i = sizeof(value); i < sizeof(out); i++) {
+        assert_int_equal(out[i], 0xff);
+    }
+    assert_true(octopus_seqlock_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+struct snapshot {
+    uintmax_t a;
+    uintmax_t b;
+    uintmax_t c;
+};
+
+#define WRITES 100000
+
+static atomic_bool writing;
+
+static void *check_read_concurrently_reader(void *arg) {
+    uintmax_t last = 0;
+    while (atomic_load(&writing)) {
+        struct snapshot out;
+        assert_true(octopus_seqlock_read(arg, &out));
+        /* never torn and never going backwards */
+        assert_int_equal(out.b, 2 * out.a);
+        assert_int_equal(out.c, 3 * out.a);
+        assert_true(out.a >= last);
+        last = out.a;
+    }
+    return NULL;
+}
+
+static void check_read_concurrently(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_seqlock object;
+    assert_true(octopus_seqlock_init(&object, sizeof(struct snapshot)));
+    atomic_store(&writing, true);
+    pthread_t threads[3];
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_int_equal(0, pthread_create(
+                &threads[i], NULL, check_read_concurrently_reader, &object));
+    }
+    for (uintmax_t i = 1; i <= WRITES; i++) {
+        const struct snapshot value = {
+                .a = i,
+                .b = 2 * i,
+                .c = 3 * i
+        };
+        assert_true(octopus_seqlock_write(&object, &value));
+    }
+    atomic_store(&writing, false);
+    for (uintmax_t i = 0; i < 3; i++) {
+        assert_int_equal(0, pthread_join(threads[i], NULL));
+    }
+    assert_int_equal(atomic_load(&object.sequence), 2 * WRITES);
+    assert_true(octopus_seqlock_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_invalidate),
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_size_is_zero),
+            cmocka_unit_test(check_init_error_on_size_is_too_large),
+            cmocka_unit_test(check_init_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_size_error_on_object_is_null),
+            cmocka_unit_test(check_size_error_on_out_is_null),
+            cmocka_unit_test(check_size),
+            cmocka_unit_test(check_write_error_on_object_is_null),
+            cmocka_unit_test(check_write_error_on_value_is_null),
+            cmocka_unit_test(check_read_error_on_object_is_null),
+            cmocka_unit_test(check_read_error_on_out_is_null),
+            cmocka_unit_test(check_write),
+            cmocka_unit_test(check_read_concurrently),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
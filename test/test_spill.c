@@ -0,0 +1,267 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <octopus.h>
+
+#include "private/spill.h"
+
+#include <test/cmocka.h>
+
+#define SEGMENT                                 (4 * sizeof(uintmax_t))
+
+static char directory[] = "/tmp/octopus-spill-test-XXXXXX";
+
+static int setup(void **state) {
+    return mkdtemp(directory) ? 0 : -1;
+}
+
+static int teardown(void **state) {
+    /* fails unless every segment file has been deleted */
+    return rmdir(directory);
+}
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_spill_invalidate(NULL, NULL));
+    assert_int_equal(OCTOPUS_SPILL_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_spill_init(NULL, directory, 1, SEGMENT));
+    assert_int_equal(OCTOPUS_SPILL_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_directory_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_spill_init((void *) 1, NULL, 1, SEGMENT));
+    assert_int_equal(OCTOPUS_SPILL_ERROR_DIRECTORY_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_size_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_spill_init((void *) 1, directory, 0, SEGMENT));
+    assert_int_equal(OCTOPUS_SPILL_ERROR_SIZE_IS_ZERO, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_size_is_too_large(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_spill_init((void *) 1, directory, SIZE_MAX, 0));
+    assert_int_equal(OCTOPUS_SPILL_ERROR_SIZE_IS_TOO_LARGE, octopus_error);
+    assert_false(octopus_spill_init((void *) 1, directory, 1, UINTMAX_MAX));
+    assert_int_equal(OCTOPUS_SPILL_ERROR_SIZE_IS_TOO_LARGE, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_file_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_spill object;
+    assert_false(octopus_spill_init(&object, "/nonexistent/octopus", 1,
+                                    SEGMENT));
+    assert_int_equal(OCTOPUS_SPILL_ERROR_FILE_FAILED, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_spill object;
+    malloc_is_overridden = true;
+    assert_false(octopus_spill_init(&object, directory, 1, SEGMENT));
+    malloc_is_overridden = false;
+    assert_int_equal(OCTOPUS_SPILL_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_spill object;
+    assert_true(octopus_spill_init(&object, directory, sizeof(uintmax_t),
+                                   SEGMENT + 1));
+    assert_int_equal(object.size, sizeof(uintmax_t));
+    assert_int_equal(object.items, 4);
+    assert_int_equal(0, strcmp(object.directory, directory));
+    assert_null(object.head);
+    assert_int_equal(atomic_load(&object.count), 0);
+    assert_true(octopus_spill_invalidate(&object, NULL));
+    /* a segment holds at least one item */
+    assert_true(octopus_spill_init(&object, directory, 2 * SEGMENT,
+                                   SEGMENT));
+    assert_int_equal(object.items, 1);
+    assert_true(octopus_spill_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_spill_add(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_SPILL_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_error_on_item_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_spill_add((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_SPILL_ERROR_ITEM_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_spill object;
+    assert_true(octopus_spill_init(&object, directory, sizeof(uintmax_t),
+                                   SEGMENT));
+    const uintmax_t item = 1;
+    malloc_is_overridden = true;
+    assert_false(octopus_spill_add(&object, &item));
+    malloc_is_overridden = false;
+    assert_int_equal(OCTOPUS_SPILL_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    assert_int_equal(atomic_load(&object.count), 0);
+    assert_true(octopus_spill_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_error_on_file_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    char other[] = "/tmp/octopus-spill-test-XXXXXX";
+    assert_non_null(mkdtemp(other));
+    struct octopus_spill object;
+    assert_true(octopus_spill_init(&object, other, sizeof(uintmax_t),
+                                   SEGMENT));
+    assert_int_equal(0, rmdir(other));
+    const uintmax_t item = 1;
+    assert_false(octopus_spill_add(&object, &item));
+    assert_int_equal(OCTOPUS_SPILL_ERROR_FILE_FAILED, octopus_error);
+    assert_int_equal(atomic_load(&object.count), 0);
+    assert_true(octopus_spill_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_spill_remove(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_SPILL_ERROR_OBJECT_IS_NULL, octopus_error);
+    assert_false(octopus_spill_peek(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_SPILL_ERROR_OBJECT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_spill_remove((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_SPILL_ERROR_OUT_IS_NULL, octopus_error);
+    assert_false(octopus_spill_peek((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_SPILL_ERROR_OUT_IS_NULL, octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove_error_on_spill_is_empty(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_spill object;
+    assert_true(octopus_spill_init(&object, directory, sizeof(uintmax_t),
+                                   SEGMENT));
+    uintmax_t out;
+    assert_false(octopus_spill_remove(&object, (void **) &out));
+    assert_int_equal(OCTOPUS_SPILL_ERROR_SPILL_IS_EMPTY, octopus_error);
+    assert_false(octopus_spill_peek(&object, (void **) &out));
+    assert_int_equal(OCTOPUS_SPILL_ERROR_SPILL_IS_EMPTY, octopus_error);
+    /* a partially drained segment stays around for further items */
+    assert_true(octopus_spill_add(&object, &out));
+    assert_true(octopus_spill_remove(&object, (void **) &out));
+    assert_non_null(object.head);
+    assert_false(octopus_spill_remove(&object, (void **) &out));
+    assert_int_equal(OCTOPUS_SPILL_ERROR_SPILL_IS_EMPTY, octopus_error);
+    assert_true(octopus_spill_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_remove(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_spill object;
+    assert_true(octopus_spill_init(&object, directory, sizeof(uintmax_t),
+                                   SEGMENT));
+    for (uintmax_t i = 0; i < 10; i++) {
+        assert_true(octopus_spill_add(&object, &i));
+    }
+    assert_int_equal(atomic_load(&object.count), 10);
+    assert_ptr_equal(object.head->next->next, object.tail);
+    uintmax_t out;
+    for (uintmax_t i = 0; i < 10; i++) {
+        assert_true(octopus_spill_peek(&object, (void **) &out));
+        assert_int_equal(out, i);
+        assert_true(octopus_spill_remove(&object, (void **) &out));
+        assert_int_equal(out, i);
+        if (3 == i) {
+            /* first segment has been drained and released */
+            assert_int_equal(object.head->read, 0);
+        }
+        if (i < 9) {
+            /* later items are added while earlier ones are drained */
+            const uintmax_t item = 10 + i;
+            assert_true(octopus_spill_add(&object, &item));
+        }
+    }
+    for (uintmax_t i = 10; i < 19; i++) {
+        assert_true(octopus_spill_remove(&object, (void **) &out));
+        assert_int_equal(out, i);
+    }
+    assert_int_equal(atomic_load(&object.count), 0);
+    assert_true(octopus_spill_invalidate(&object, NULL));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static uintmax_t destroyed;
+
+static void on_destroy(void *item) {
+    destroyed += *(uintmax_t *) item;
+}
+
+static void check_invalidate(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_spill object;
+    assert_true(octopus_spill_init(&object, directory, sizeof(uintmax_t),
+                                   SEGMENT));
+    for (uintmax_t i = 1; i <= 10; i++) {
+        assert_true(octopus_spill_add(&object, &i));
+    }
+    uintmax_t out;
+    assert_true(octopus_spill_remove(&object, (void **) &out));
+    destroyed = 0;
+    assert_true(octopus_spill_invalidate(&object, on_destroy));
+    assert_int_equal(destroyed, 55 - 1);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_directory_is_null),
+            cmocka_unit_test(check_init_error_on_size_is_zero),
+            cmocka_unit_test(check_init_error_on_size_is_too_large),
+            cmocka_unit_test(check_init_error_on_file_failed),
+            cmocka_unit_test(check_init_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_add_error_on_object_is_null),
+            cmocka_unit_test(check_add_error_on_item_is_null),
+            cmocka_unit_test(check_add_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_add_error_on_file_failed),
+            cmocka_unit_test(check_remove_error_on_object_is_null),
+            cmocka_unit_test(check_remove_error_on_out_is_null),
+            cmocka_unit_test(check_remove_error_on_spill_is_empty),
+            cmocka_unit_test(check_remove),
+            cmocka_unit_test(check_invalidate),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, setup, teardown);
+}
@@ -0,0 +1,246 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <pthread.h>
+#include <octopus.h>
+
+#include "private/striped_counter.h"
+
+#include <test/cmocka.h>
+
+static void check_invalidate_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_striped_counter_invalidate(NULL));
+    assert_int_equal(OCTOPUS_STRIPED_COUNTER_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_striped_counter_init(NULL, 1));
+    assert_int_equal(OCTOPUS_STRIPED_COUNTER_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_concurrency_is_zero(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_striped_counter_init((void *) 1, 0));
+    assert_int_equal(OCTOPUS_STRIPED_COUNTER_ERROR_CONCURRENCY_IS_ZERO,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init_error_on_memory_allocation_failed(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_striped_counter object;
+    posix_memalign_is_overridden = true;
+    assert_false(octopus_striped_counter_init(&object, 4));
+    posix_memalign_is_overridden = false;
+    assert_int_equal(OCTOPUS_STRIPED_COUNTER_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    assert_false(octopus_striped_counter_init(&object, UINTMAX_MAX));
+    assert_int_equal(OCTOPUS_STRIPED_COUNTER_ERROR_MEMORY_ALLOCATION_FAILED,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_init(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_striped_counter object;
+    assert_true(octopus_striped_counter_init(&object, 3));
+    assert_int_equal(object.limit, 4);
+    uintmax_t out;
+    assert_true(octopus_striped_counter_cells(&object, &out));
+    assert_int_equal(out, 0);
+    assert_true(octopus_striped_counter_sum(&object, &out));
+    assert_int_equal(out, 0);
+    assert_true(octopus_striped_counter_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_striped_counter_add(NULL, 1));
+    assert_int_equal(OCTOPUS_STRIPED_COUNTER_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_striped_counter object;
+    assert_true(octopus_striped_counter_init(&object, 4));
+    assert_true(octopus_striped_counter_add(&object, 3));
+    assert_true(octopus_striped_counter_add(&object, 4));
+    uintmax_t out;
+    assert_true(octopus_striped_counter_sum(&object, &out));
+    assert_int_equal(out, 7);
+    /* without contention everything goes to the base */
+    assert_true(octopus_striped_counter_cells(&object, &out));
+    assert_int_equal(out, 0);
+    assert_true(octopus_striped_counter_add(&object, UINTMAX_MAX));
+    assert_true(octopus_striped_counter_sum(&object, &out));
+    assert_int_equal(out, 6);
+    assert_true(octopus_striped_counter_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_add_to_cells(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_striped_counter object;
+    assert_true(octopus_striped_counter_init(&object, 4));
+    assert_true(octopus_striped_counter_add(&object, 1));
+    assert_true(octopus_striped_counter_grow(&object, 0));
+    for (uintmax_t i = 0; i < 10; i++) {
+        assert_true(octopus_striped_counter_add(&object, 2));
+    }
+    assert_int_equal(atomic_load(&object.base), 1);
+    uintmax_t out;
+    assert_true(octopus_striped_counter_sum(&object, &out));
+    assert_int_equal(out, 21);
+    assert_true(octopus_striped_counter_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_sum_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_striped_counter_sum(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_STRIPED_COUNTER_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_sum_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_striped_counter_sum((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_STRIPED_COUNTER_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_cells_error_on_object_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_striped_counter_cells(NULL, (void *) 1));
+    assert_int_equal(OCTOPUS_STRIPED_COUNTER_ERROR_OBJECT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_cells_error_on_out_is_null(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    assert_false(octopus_striped_counter_cells((void *) 1, NULL));
+    assert_int_equal(OCTOPUS_STRIPED_COUNTER_ERROR_OUT_IS_NULL,
+                     octopus_error);
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_grow(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_striped_counter object;
+    assert_true(octopus_striped_counter_init(&object, 8));
+    uintmax_t out;
+    assert_true(octopus_striped_counter_grow(&object, 0));
+    assert_true(octopus_striped_counter_cells(&object, &out));
+    assert_int_equal(out, 2);
+    /* another thread has already grown it */
+    assert_false(octopus_striped_counter_grow(&object, 0));
+    assert_true(octopus_striped_counter_grow(&object, 2));
+    assert_true(octopus_striped_counter_grow(&object, 4));
+    assert_true(octopus_striped_counter_cells(&object, &out));
+    assert_int_equal(out, 8);
+    /* at its limit */
+    assert_false(octopus_striped_counter_grow(&object, 8));
+    assert_true(octopus_striped_counter_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_grow_case_single_cell(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_striped_counter object;
+    assert_true(octopus_striped_counter_init(&object, 1));
+    assert_false(octopus_striped_counter_grow(&object, 0));
+    uintmax_t out;
+    assert_true(octopus_striped_counter_cells(&object, &out));
+    assert_int_equal(out, 0);
+    assert_true(octopus_striped_counter_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+static void check_grow_case_never_allocates(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_striped_counter object;
+    assert_true(octopus_striped_counter_init(&object, 8));
+    malloc_is_overridden = true;
+    posix_memalign_is_overridden = true;
+    assert_true(octopus_striped_counter_grow(&object, 0));
+    assert_true(octopus_striped_counter_grow(&object, 2));
+    for (uintmax_t i = 0; i < 10; i++) {
+        assert_true(octopus_striped_counter_add(&object, 1));
+    }
+    malloc_is_overridden = false;
+    posix_memalign_is_overridden = false;
+    uintmax_t out;
+    assert_true(octopus_striped_counter_cells(&object, &out));
+    assert_int_equal(out, 4);
+    assert_true(octopus_striped_counter_sum(&object, &out));
+    assert_int_equal(out, 10);
+    assert_true(octopus_striped_counter_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+#define ADDITIONS 100000
+
+static void *check_add_concurrently_thread(void *arg) {
+    struct octopus_striped_counter *const object = arg;
+    for (uintmax_t i = 0; i < ADDITIONS; i++) {
+        assert_true(octopus_striped_counter_add(object, 1));
+    }
+    return NULL;
+}
+
+static void check_add_concurrently(void **state) {
+    octopus_error = OCTOPUS_ERROR_NONE;
+    struct octopus_striped_counter object;
+    assert_true(octopus_striped_counter_init(&object, 4));
+    pthread_t threads[4];
+    for (uintmax_t i = 0; i < 4; i++) {
+        assert_int_equal(0, pthread_create(
+                &threads[i], NULL, check_add_concurrently_thread, &object));
+    }
+    for (uintmax_t i = 0; i < 4; i++) {
+        assert_int_equal(0, pthread_join(threads[i], NULL));
+    }
+    uintmax_t out;
+    assert_true(octopus_striped_counter_sum(&object, &out));
+    assert_int_equal(out, 4 * ADDITIONS);
+    assert_true(octopus_striped_counter_cells(&object, &out));
+    assert_true(out <= 4);
+    assert_true(octopus_striped_counter_invalidate(&object));
+    octopus_error = OCTOPUS_ERROR_NONE;
+}
+
+int main(int argc, char *argv[]) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(check_invalidate_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_object_is_null),
+            cmocka_unit_test(check_init_error_on_concurrency_is_zero),
+            cmocka_unit_test(check_init_error_on_memory_allocation_failed),
+            cmocka_unit_test(check_init),
+            cmocka_unit_test(check_add_error_on_object_is_null),
+            cmocka_unit_test(check_add),
+            cmocka_unit_test(check_add_to_cells),
+            cmocka_unit_test(check_sum_error_on_object_is_null),
+            cmocka_unit_test(check_sum_error_on_out_is_null),
+            cmocka_unit_test(check_cells_error_on_object_is_null),
+            cmocka_unit_test(check_cells_error_on_out_is_null),
+            cmocka_unit_test(check_grow),
+            cmocka_unit_test(check_grow_case_single_cell),
+            cmocka_unit_test(check_grow_case_never_allocates),
+            cmocka_unit_test(check_add_concurrently),
+    };
+    //cmocka_set_message_output(CM_OUTPUT_XML);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}